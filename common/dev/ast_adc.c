@@ -70,7 +70,7 @@ static void init_adc_dev()
 #endif
 }
 
-static bool adc_read_mv(uint8_t sensor_num, uint32_t index, uint32_t channel, int *adc_val)
+static bool adc_read_mv(uint16_t sensor_num, uint32_t index, uint32_t channel, int *adc_val)
 {
 	CHECK_NULL_ARG_WITH_RETURN(adc_val, false);
 
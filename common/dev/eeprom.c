@@ -15,116 +15,206 @@
  */
 
 #include <stdio.h>
+#include <zephyr.h>
 #include "eeprom.h"
 #include "hal_i2c.h"
+#include "libutil.h"
 #include <string.h>
 #include <logging/log.h>
 
 LOG_MODULE_REGISTER(dev_eeprom);
 
-bool eeprom_mux_check(EEPROM_ENTRY *entry)
+uint16_t eeprom_get_page_size(uint8_t dev_type)
 {
-	if (entry == NULL) {
-		LOG_DBG("entry pointer passed in as NULL");
-		return false;
+	switch (dev_type) {
+	case NV_ATMEL_24C64:
+	case ST_M24C64_W:
+		return 32;
+	case NV_ATMEL_24C128:
+	case PUYA_P24C128F:
+	case ST_M24128_BW:
+		return 64;
+	default:
+		return EEPROM_PAGE_SIZE_DEFAULT;
 	}
+}
+
+static bool eeprom_mux_check(const EEPROM_CFG *cfg)
+{
 	I2C_MSG msg;
-	uint8_t retry = 5;
-	if (entry->config.mux_present) {
-		msg.bus = entry->config.port;
-		msg.target_addr = entry->config.mux_addr;
+	uint8_t retry = EEPROM_RETRY;
+	if (cfg->mux_present) {
+		msg.bus = cfg->port;
+		msg.target_addr = cfg->mux_addr;
 		msg.tx_len = 1;
-		msg.data[0] = (1 << (entry->config.mux_channel));
+		msg.data[0] = (1 << (cfg->mux_channel));
 		return ((i2c_master_write(&msg, retry) == 0) ? true : false);
 	} else {
 		return true;
 	}
 }
 
-bool eeprom_write(EEPROM_ENTRY *entry)
+/* The bus is held for the whole access behind a mux so the channel is set only once */
+static bool eeprom_access_begin(const EEPROM_CFG *cfg)
 {
-	if (entry == NULL) {
-		LOG_DBG("entry pointer passed in as NULL");
-		return false;
-	}
-	I2C_MSG msg;
-	uint8_t retry = 5;
-	uint8_t i;
-
-	if (entry->config.bus_mutex) {
-		if (k_mutex_lock(entry->config.bus_mutex, K_MSEC(1000))) {
-			LOG_ERR("Failed to lock mutex on bus %d", entry->config.port);
+	if (cfg->bus_mutex) {
+		if (k_mutex_lock(cfg->bus_mutex, K_MSEC(1000))) {
+			LOG_ERR("Failed to lock mutex on bus %d", cfg->port);
 			return false;
 		}
 	}
 
-	for (i = 0; i < retry; i++) {
-		/* Check if there have a MUX before EEPROM and access it to change channel first */
-		if (eeprom_mux_check(entry) == false)
-			continue;
+	if (cfg->mux_present) {
+		if (i2c_bus_lock(cfg->port) == 0) {
+			if (eeprom_mux_check(cfg)) {
+				return true;
+			}
+			LOG_ERR("Failed to switch mux 0x%x on bus %d", cfg->mux_addr, cfg->port);
+			i2c_bus_unlock(cfg->port);
+		}
 
-		msg.bus = entry->config.port;
-		msg.target_addr = entry->config.target_addr;
-		msg.tx_len = entry->data_len + 2; // write 2 byte offset to EEPROM
-		msg.data[0] =
-			((entry->config.start_offset + entry->offset) >> 8) & 0xFF; // offset msb
-		msg.data[1] = (entry->config.start_offset + entry->offset) & 0xFF; // offset lsb
-		memcpy(&msg.data[2], &entry->data[0], entry->data_len);
+		if (cfg->bus_mutex) {
+			k_mutex_unlock(cfg->bus_mutex);
+		}
+		return false;
+	}
 
-		if (i2c_master_write(&msg, retry) == 0)
-			break;
+	return true;
+}
+
+static void eeprom_access_end(const EEPROM_CFG *cfg)
+{
+	if (cfg->mux_present) {
+		i2c_bus_unlock(cfg->port);
 	}
 
-	if (entry->config.bus_mutex) {
-		if (k_mutex_unlock(entry->config.bus_mutex))
-			LOG_ERR("Failed to unlock mutex on bus %d", entry->config.port);
+	if (cfg->bus_mutex) {
+		if (k_mutex_unlock(cfg->bus_mutex))
+			LOG_ERR("Failed to unlock mutex on bus %d", cfg->port);
 	}
+}
 
-	return ((i >= retry) ? false : true);
+/* The EEPROM does not acknowledge its address until the internal write cycle is done */
+static bool eeprom_wait_write_cycle(const EEPROM_CFG *cfg)
+{
+	int64_t end_ms = k_uptime_get() + EEPROM_WRITE_CYCLE_TIMEOUT_MS;
+
+	do {
+		k_usleep(EEPROM_ACK_POLL_INTERVAL_US);
+		if (i2c_master_probe(cfg->port, cfg->target_addr) == 0) {
+			return true;
+		}
+	} while (k_uptime_get() < end_ms);
+
+	return false;
 }
 
-bool eeprom_read(EEPROM_ENTRY *entry)
+bool eeprom_write_buf(const EEPROM_CFG *cfg, uint16_t offset, const uint8_t *buf, uint16_t len)
 {
-	if (entry == NULL) {
-		LOG_DBG("entry pointer passed in as NULL");
+	CHECK_NULL_ARG_WITH_RETURN(cfg, false);
+	CHECK_NULL_ARG_WITH_RETURN(buf, false);
+
+	uint16_t page_size = eeprom_get_page_size(cfg->dev_type);
+	uint16_t addr = cfg->start_offset + offset;
+	bool is_success = true;
+
+	if (!eeprom_access_begin(cfg)) {
 		return false;
 	}
 
-	I2C_MSG msg;
-	uint8_t retry = 5;
-	uint8_t i;
+	while (len > 0) {
+		uint16_t write_len = MIN(len, page_size - (addr % page_size));
+		uint8_t word_addr[2] = { (addr >> 8) & 0xFF, addr & 0xFF };
+		struct i2c_msg msgs[2];
+		msgs[0].buf = word_addr;
+		msgs[0].len = sizeof(word_addr);
+		msgs[0].flags = I2C_MSG_WRITE;
+		msgs[1].buf = (uint8_t *)buf;
+		msgs[1].len = write_len;
+		msgs[1].flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+
+		if (i2c_master_transfer(cfg->port, cfg->target_addr, msgs, 2, EEPROM_RETRY)) {
+			LOG_ERR("Failed to write EEPROM bus %d addr 0x%x offset 0x%x", cfg->port,
+				cfg->target_addr, addr);
+			is_success = false;
+			break;
+		}
 
-	if (entry->config.bus_mutex) {
-		if (k_mutex_lock(entry->config.bus_mutex, K_MSEC(1000))) {
-			LOG_ERR("Failed to lock mutex on bus %d", entry->config.port);
-			return false;
+		if (!eeprom_wait_write_cycle(cfg)) {
+			LOG_ERR("EEPROM bus %d addr 0x%x write cycle timeout", cfg->port,
+				cfg->target_addr);
+			is_success = false;
+			break;
 		}
+
+		addr += write_len;
+		buf += write_len;
+		len -= write_len;
 	}
 
-	for (i = 0; i < retry; i++) {
-		/* Check if there have a MUX before EEPROM and access it to change channel first */
-		if (eeprom_mux_check(entry) == false)
-			continue;
-
-		msg.bus = entry->config.port;
-		msg.target_addr = entry->config.target_addr;
-		msg.tx_len = 2; // write 2 byte offset to EEPROM
-		msg.rx_len = entry->data_len;
-		msg.data[0] =
-			((entry->config.start_offset + entry->offset) >> 8) & 0xFF; // offset msb
-		msg.data[1] = (entry->config.start_offset + entry->offset) & 0xFF; // offset lsb
-
-		if (i2c_master_read(&msg, retry) == 0) {
-			entry->data_len = msg.rx_len;
-			memcpy(&entry->data, &msg.data, msg.rx_len);
+	eeprom_access_end(cfg);
+	return is_success;
+}
+
+bool eeprom_read_buf(const EEPROM_CFG *cfg, uint16_t offset, uint8_t *buf, uint16_t len)
+{
+	CHECK_NULL_ARG_WITH_RETURN(cfg, false);
+	CHECK_NULL_ARG_WITH_RETURN(buf, false);
+
+	uint16_t addr = cfg->start_offset + offset;
+	bool is_success = true;
+
+	if (!eeprom_access_begin(cfg)) {
+		return false;
+	}
+
+	while (len > 0) {
+		uint16_t read_len = MIN(len, EEPROM_READ_CHUNK_SIZE);
+		uint8_t word_addr[2] = { (addr >> 8) & 0xFF, addr & 0xFF };
+
+		if (i2c_master_write_read_buf(cfg->port, cfg->target_addr, word_addr,
+					      sizeof(word_addr), buf, read_len, EEPROM_RETRY)) {
+			LOG_ERR("Failed to read EEPROM bus %d addr 0x%x offset 0x%x", cfg->port,
+				cfg->target_addr, addr);
+			is_success = false;
 			break;
 		}
+
+		addr += read_len;
+		buf += read_len;
+		len -= read_len;
+	}
+
+	eeprom_access_end(cfg);
+	return is_success;
+}
+
+bool eeprom_write(EEPROM_ENTRY *entry)
+{
+	if (entry == NULL) {
+		LOG_DBG("entry pointer passed in as NULL");
+		return false;
 	}
 
-	if (entry->config.bus_mutex) {
-		if (k_mutex_unlock(entry->config.bus_mutex))
-			LOG_ERR("Failed to unlock mutex on bus %d", entry->config.port);
+	if (entry->data_len > EEPROM_WRITE_SIZE) {
+		LOG_ERR("EEPROM write length %d over %d", entry->data_len, EEPROM_WRITE_SIZE);
+		return false;
+	}
+
+	return eeprom_write_buf(&entry->config, entry->offset, entry->data, entry->data_len);
+}
+
+bool eeprom_read(EEPROM_ENTRY *entry)
+{
+	if (entry == NULL) {
+		LOG_DBG("entry pointer passed in as NULL");
+		return false;
+	}
+
+	if (entry->data_len > EEPROM_WRITE_SIZE) {
+		LOG_ERR("EEPROM read length %d over %d", entry->data_len, EEPROM_WRITE_SIZE);
+		return false;
 	}
 
-	return ((i >= retry) ? false : true);
+	return eeprom_read_buf(&entry->config, entry->offset, entry->data, entry->data_len);
 }
@@ -20,12 +20,68 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <zephyr.h>
 #include <logging/log.h>
 
 LOG_MODULE_REGISTER(dev_fru);
 
 EEPROM_CFG fru_config[FRU_CFG_NUM];
 
+/* FRU contents in RAM, filled by the first read and dropped on a write */
+static uint8_t *fru_cache[FRU_CFG_NUM];
+static K_MUTEX_DEFINE(fru_cache_mutex);
+
+/* FRUs of hot-pluggable cards must not be cached */
+__weak bool pal_is_fru_cacheable(uint8_t fru_id)
+{
+	return true;
+}
+
+static bool fru_cache_read(uint8_t fru_index, EEPROM_ENTRY *entry)
+{
+	const EEPROM_CFG *cfg = &fru_config[fru_index];
+
+	if (!pal_is_fru_cacheable(cfg->dev_id) || (cfg->max_size == 0) ||
+	    (entry->data_len > EEPROM_WRITE_SIZE) ||
+	    ((entry->offset + entry->data_len) > cfg->max_size)) {
+		return false;
+	}
+
+	k_mutex_lock(&fru_cache_mutex, K_FOREVER);
+
+	if (fru_cache[fru_index] == NULL) {
+		uint8_t *buf = (uint8_t *)malloc(cfg->max_size);
+		if (buf == NULL) {
+			LOG_ERR("Failed to allocate FRU 0x%x cache", cfg->dev_id);
+			k_mutex_unlock(&fru_cache_mutex);
+			return false;
+		}
+
+		if (!eeprom_read_buf(cfg, 0, buf, cfg->max_size)) {
+			SAFE_FREE(buf);
+			k_mutex_unlock(&fru_cache_mutex);
+			return false;
+		}
+		fru_cache[fru_index] = buf;
+	}
+
+	memcpy(entry->data, fru_cache[fru_index] + entry->offset, entry->data_len);
+
+	k_mutex_unlock(&fru_cache_mutex);
+	return true;
+}
+
+void FRU_cache_invalidate(uint8_t FRUID)
+{
+	k_mutex_lock(&fru_cache_mutex, K_FOREVER);
+	for (uint8_t i = 0; i < FRU_CFG_NUM; i++) {
+		if ((FRUID == 0xFF) || (fru_config[i].dev_id == FRUID)) {
+			SAFE_FREE(fru_cache[i]);
+		}
+	}
+	k_mutex_unlock(&fru_cache_mutex);
+}
+
 bool find_FRU_ID(uint8_t FRUID, uint8_t *fru_id)
 {
 	CHECK_NULL_ARG_WITH_RETURN(fru_id, false);
@@ -100,6 +156,10 @@ uint8_t FRU_read(EEPROM_ENTRY *entry)
 
 	memcpy(&entry->config, &fru_config[fru_index], sizeof(fru_config[fru_index]));
 
+	if (fru_cache_read(fru_index, entry)) {
+		return FRU_READ_SUCCESS;
+	}
+
 	if (!eeprom_read(entry)) {
 		return FRU_FAIL_TO_ACCESS;
 	}
@@ -134,7 +194,13 @@ uint8_t FRU_write(EEPROM_ENTRY *entry)
 
 	memcpy(&entry->config, &fru_config[fru_index], sizeof(fru_config[fru_index]));
 
-	if (!eeprom_write(entry)) {
+	/* Hold the cache so a concurrent read cannot refill it with the old contents */
+	k_mutex_lock(&fru_cache_mutex, K_FOREVER);
+	bool is_success = eeprom_write(entry);
+	SAFE_FREE(fru_cache[fru_index]);
+	k_mutex_unlock(&fru_cache_mutex);
+
+	if (!is_success) {
 		return FRU_FAIL_TO_ACCESS;
 	}
 
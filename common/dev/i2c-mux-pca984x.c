@@ -39,15 +39,15 @@ bool set_pca9846_channel_and_transfer(uint8_t bus, uint8_t mux_addr, uint8_t mux
 	mux_msg.tx_len = 1;
 	mux_msg.data[0] = mux_channel;
 
-	/* Mutex lock */
-	status = k_mutex_lock(&msg->lock, K_MSEC(PCA9846_MUTEX_LOCK_MS));
+	/* Hold the bus so no other master switches the channel in between */
+	status = i2c_bus_lock(bus);
 	if (status != 0) {
-		LOG_ERR("Mutex lock fail, status: %d, bus: %d, mux addr: 0x%x", status, bus,
+		LOG_ERR("Bus lock fail, status: %d, bus: %d, mux addr: 0x%x", status, bus,
 			mux_addr);
 		return false;
 	}
 
-	status = i2c_master_write(&mux_msg, retry);
+	status = i2c_master_write_without_mutex(&mux_msg, retry);
 	if (status != 0) {
 		LOG_ERR("Set channel fail, status: %d", status);
 		ret = false;
@@ -57,10 +57,10 @@ bool set_pca9846_channel_and_transfer(uint8_t bus, uint8_t mux_addr, uint8_t mux
 	/* Transfer via i2c */
 	switch (tran_type) {
 	case I2C_READ:
-		status = i2c_master_read(msg, retry);
+		status = i2c_master_read_without_mutex(msg, retry);
 		break;
 	case I2C_WRITE:
-		status = i2c_master_write(msg, retry);
+		status = i2c_master_write_without_mutex(msg, retry);
 		break;
 	default:
 		LOG_ERR("Transfer type is invalid, transfer type: %d", tran_type);
@@ -80,16 +80,16 @@ bool set_pca9846_channel_and_transfer(uint8_t bus, uint8_t mux_addr, uint8_t mux
 	mux_msg.tx_len = 1;
 	mux_msg.data[0] = PCA9846_DEFAULT_CHANNEL;
 
-	status = i2c_master_write(&mux_msg, retry);
+	status = i2c_master_write_without_mutex(&mux_msg, retry);
 	if (status != 0) {
 		LOG_ERR("Disable all channels fail, status: %d", status);
 		ret = false;
 	}
 
 mutex_unlock:
-	status = k_mutex_unlock(&msg->lock);
+	status = i2c_bus_unlock(bus);
 	if (status != 0) {
-		LOG_ERR("Mutex unlock fail, status: %d", status);
+		LOG_ERR("Bus unlock fail, status: %d", status);
 		ret = false;
 	}
 
@@ -21,6 +21,13 @@
 #include <stdint.h>
 
 #define EEPROM_WRITE_SIZE 0x20
+#define EEPROM_RETRY 5
+/* Page size of an unknown part, the smallest of the 2-byte addressed EEPROMs in use */
+#define EEPROM_PAGE_SIZE_DEFAULT 8
+#define EEPROM_READ_CHUNK_SIZE 256
+/* Longest write cycle of the parts in use is 5ms */
+#define EEPROM_WRITE_CYCLE_TIMEOUT_MS 10
+#define EEPROM_ACK_POLL_INTERVAL_US 500
 
 // define offset, size and order for EEPROM write/read
 #define FRU_START 0x0000 // start at 0x000
@@ -36,6 +43,15 @@
 #define BIC_CONFIG_SIZE 0x0100
 // next start should be 0x0A00
 
+enum FRU_DEV_TYPE {
+	NV_ATMEL_24C02,
+	NV_ATMEL_24C64,
+	NV_ATMEL_24C128,
+	PUYA_P24C128F,
+	ST_M24C64_W,
+	ST_M24128_BW,
+};
+
 typedef struct _EEPROM_CFG_ {
 	uint8_t dev_type;
 	uint8_t dev_id;
@@ -57,6 +73,12 @@ typedef struct _EEPROM_ENTRY_ {
 	uint8_t data[EEPROM_WRITE_SIZE];
 } EEPROM_ENTRY;
 
+uint16_t eeprom_get_page_size(uint8_t dev_type);
+/* Offset is relative to cfg->start_offset. Writes are split on page boundaries and each page
+ * waits for the write cycle by ACK polling, reads are sequential reads of any length.
+ */
+bool eeprom_write_buf(const EEPROM_CFG *cfg, uint16_t offset, const uint8_t *buf, uint16_t len);
+bool eeprom_read_buf(const EEPROM_CFG *cfg, uint16_t offset, uint8_t *buf, uint16_t len);
 bool eeprom_write(EEPROM_ENTRY *entry);
 bool eeprom_read(EEPROM_ENTRY *entry);
 
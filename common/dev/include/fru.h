@@ -21,15 +21,6 @@
 
 #define FRU_ID_NOT_FOUND 0xFF
 
-enum FRU_DEV_TYPE {
-	NV_ATMEL_24C02,
-	NV_ATMEL_24C64,
-	NV_ATMEL_24C128,
-	PUYA_P24C128F,
-	ST_M24C64_W,
-	ST_M24128_BW,
-};
-
 enum {
 	FRU_WRITE_SUCCESS,
 	FRU_READ_SUCCESS,
@@ -50,6 +41,9 @@ uint8_t get_FRU_access(uint8_t FRUID);
 uint16_t find_FRU_size(uint8_t FRUID);
 uint8_t FRU_read(EEPROM_ENTRY *entry);
 uint8_t FRU_write(EEPROM_ENTRY *entry);
+/* Drop the cached contents of a FRU, 0xFF for all */
+void FRU_cache_invalidate(uint8_t FRUID);
+bool pal_is_fru_cacheable(uint8_t fru_id);
 void pal_load_fru_config(void);
 void FRU_init(void);
 bool write_psb_inform(EEPROM_ENTRY *entry);
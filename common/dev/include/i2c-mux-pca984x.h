@@ -17,7 +17,6 @@
 #ifndef I2C_MUX_PCA984X_H
 #define I2C_MUX_PCA984X_H
 
-#define PCA9846_MUTEX_LOCK_MS 1000
 #define PCA9846_DEFAULT_CHANNEL 0
 
 enum PCA9846_CHANNEL {
@@ -66,6 +66,18 @@ typedef struct lattice_update_config {
 	uint32_t next_len; //next request data's length
 } lattice_update_config_t;
 
+/* Pre-compiled image, this header followed by cfg_row_count rows of LATTICE_BIN_ROW_SIZE bytes
+ * in the order and bit order they are written to the device. Fields are little endian.
+ */
+#define LATTICE_BIN_MAGIC "LBIN"
+#define LATTICE_BIN_ROW_SIZE 16
+
+typedef struct __attribute__((__packed__)) lattice_bin_header {
+	uint8_t magic[4];
+	uint32_t cfg_row_count;
+	uint32_t user_code;
+} lattice_bin_header_t;
+
 typedef bool (*cpld_i2C_update_func)(lattice_update_config_t *config);
 typedef bool (*cpld_jtag_update_func)(lattice_update_config_t *config);
 
@@ -22,11 +22,15 @@
 #define PCC_STACK_SIZE 512
 #define PCC_BUFFER_LEN 1024
 #define PROCESS_POSTCODE_STACK_SIZE 2048
+#define PCC_CONSUME_CHUNK 16
+/* 4-byte post codes sent to BMC in one message, the same payload as the 1-byte path */
+#define PCC_SEND_MAX_NUM 61
 
 uint16_t copy_pcc_read_buffer(uint16_t start, uint16_t length, uint8_t *buffer,
 			      uint16_t buffer_len);
 void pcc_init();
 void reset_pcc_buffer();
+uint32_t get_pcc_overrun_count();
 bool get_4byte_postcode_ok();
 void reset_4byte_postcode_ok();
 
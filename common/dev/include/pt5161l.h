@@ -36,6 +36,8 @@
 #define PT5161L_MM_EEPROM_READ_REG_CODE 4
 #define PT5161L_MM_STATUS_TIME_5MS 5
 #define PT5161L_MM_STATUS_TIME_10MS 10
+#define PT5161L_MM_STATUS_POLL_US 500
+#define PT5161L_MM_STATUS_TIMEOUT_MS 150
 #define PT5161L_MM_EEPROM_ASSIST_CMD_ADDR 0x920
 #define PT5161L_EEPROM_BLOCK_BASE_ADDR 0x88e7
 #define PT5161L_EEPROM_BLOCK_CMD_MODIFIER 0x80
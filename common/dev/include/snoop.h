@@ -22,14 +22,17 @@
 #define SENDPOSTCODE_STACK_SIZE 2048
 #define SNOOP_STACK_SIZE 512
 #define SNOOP_MAX_LEN 244
+#define SNOOP_RING_LEN 256
+/* Flush right away once this many post codes are queued */
+#define SNOOP_BURST_LEN 64
+/* Otherwise wait this long for more post codes before sending them to BMC */
+#define SNOOP_COALESCE_MS 20
+#define SNOOP_IDLE_CHECK_MS 100
+#define SNOOP_CONSUME_CHUNK 16
 
-enum POSTCODE_COPY_TYPES {
-	COPY_ALL_POSTCODE,
-	COPY_SPECIFIC_POSTCODE,
-};
-
-extern int snoop_read_num;
-void copy_snoop_read_buffer(uint8_t offset, int size_num, uint8_t *buffer, uint8_t copy_mode);
+uint16_t copy_snoop_read_buffer(uint8_t *buffer, uint16_t buffer_len);
+uint16_t get_snoop_read_num();
+uint32_t get_snoop_overrun_count();
 bool get_postcode_ok();
 void reset_postcode_ok();
 void init_snoop_thread();
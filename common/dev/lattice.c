@@ -18,6 +18,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <logging/log.h>
+#include <sys/byteorder.h>
 #include "hal_i2c.h"
 #include "pldm_firmware_update.h"
 #include "libutil.h"
@@ -40,13 +41,14 @@ LOG_MODULE_REGISTER(lattice);
 #define ISC_ERASE 0x0E
 #define ISC_DISABLE 0x26
 
-uint8_t new_line[] = { 0x0d, 0x0a };
 #define TAG_CFG_START_STR "L000"
 #define TAG_CFG_END_STR "*"
 #define TAG_USER_CODE_STR "UH"
 #define CFG_BYTE_PER_LINE 128
-#define MAX_TRANS_LEN (CFG_BYTE_PER_LINE + 2) //add new line ascii bytes
+#define USER_CODE_LEN 8
 #define CPLD_FW_BOTTOM_PART_LENGTH 260
+/* Holds a partial JEDEC line or binary row carried across requested chunks */
+#define STREAM_BUF_SIZE 256
 
 enum data_passing_state {
 	DATA_PASSING_FIRST,
@@ -58,6 +60,23 @@ enum data_passing_state {
 	DATA_PASSING_ENDED,
 };
 
+typedef struct _lattice_stream {
+	uint8_t buf[STREAM_BUF_SIZE];
+	uint16_t len;
+	/* Image offset right after the last byte taken from the requested chunks */
+	uint32_t ofs;
+	uint8_t state;
+	bool is_bin;
+	bool is_first_row;
+	/* Drop the rest of a line too long for buf, it is outside the CFG data */
+	bool is_skip_line;
+	uint32_t row_count;
+	uint32_t row_left;
+	uint32_t user_code;
+} lattice_stream;
+
+static lattice_stream stream;
+
 static bool x02x03_i2c_update(lattice_update_config_t *config);
 static bool x02x03_jtag_update(lattice_update_config_t *config);
 
@@ -134,10 +153,14 @@ static bool cfg_data_parsing(char *data, uint32_t *result, int len)
 
 	int result_index = 0, data_index = 0;
 	int bit_count = 0;
-	memset(result, 0, len);
+	memset(result, 0, len / 8);
 
 	for (int i = 0; i < len; i++) {
 		data[i] = data[i] - 0x30;
+		if ((uint8_t)data[i] > 1) {
+			LOG_ERR("Unexpected character 0x%x in CFG data", data[i] + 0x30);
+			return false;
+		}
 
 		result[result_index] |= ((unsigned char)data[i] << data_index);
 
@@ -166,7 +189,7 @@ static bool user_code_parsing(char *data, uint32_t *result, int len)
 
 	int result_index = 0, data_index = 8;
 	int bit_count = 0;
-	memset(result, 0, len);
+	memset(result, 0, len / 2);
 
 	for (int i = 0; i < len; i++) {
 		data[i] = ascii_to_val(data[i]);
@@ -517,24 +540,266 @@ static bool cpld_program_i2c(uint8_t bus, uint8_t addr, uint8_t *buff, lattice_d
 	i2c_msg.bus = bus;
 	i2c_msg.target_addr = addr;
 
-	i2c_msg.tx_len = 4 + 16;
+	i2c_msg.tx_len = 4 + LATTICE_BIN_ROW_SIZE;
 	memset(i2c_msg.data, 0, i2c_msg.tx_len);
 	i2c_msg.data[0] = LSC_PROG_INCR_NV;
 	i2c_msg.data[3] = 0x01;
-
-	for (int index = 0; index < 16; index++) {
-		i2c_msg.data[index + 4] = bit_swap(buff[index]);
-	}
+	memcpy(&i2c_msg.data[4], buff, LATTICE_BIN_ROW_SIZE);
 
 	if (i2c_master_write(&i2c_msg, retry)) {
 		LOG_ERR("Failed to send program page command");
 		return false;
 	}
 
-	if (read_cpld_busy_flag(bus, addr, 10) == false) {
+	/* A page programs in well under a millisecond */
+	if (read_cpld_busy_flag(bus, addr, 1) == false) {
+		return false;
+	}
+
+	return true;
+}
+
+static bool line_has_tag(const char *line, uint16_t len, const char *tag)
+{
+	return (len >= strlen(tag)) && !memcmp(line, tag, strlen(tag));
+}
+
+static bool program_cfg_row(lattice_update_config_t *config, uint8_t *row)
+{
+	if (cpld_program_i2c(config->bus, config->addr, row, config->type, CFG0,
+			     stream.is_first_row) == false) {
+		LOG_ERR("Failed to program cpld via i2c");
 		return false;
 	}
 
+	stream.is_first_row = false;
+	stream.row_count++;
+	return true;
+}
+
+static bool program_jedec_row(lattice_update_config_t *config, char *line, uint16_t len)
+{
+	uint32_t program_buff[LATTICE_BIN_ROW_SIZE / sizeof(uint32_t)];
+	uint8_t row[LATTICE_BIN_ROW_SIZE];
+
+	if (len < CFG_BYTE_PER_LINE) {
+		LOG_ERR("CFG row length %d is shorter than %d", len, CFG_BYTE_PER_LINE);
+		return false;
+	}
+
+	if (cfg_data_parsing(line, program_buff, CFG_BYTE_PER_LINE) == false) {
+		return false;
+	}
+
+	for (int index = 0; index < LATTICE_BIN_ROW_SIZE; index++) {
+		row[index] = bit_swap(((uint8_t *)program_buff)[index]);
+	}
+
+	return program_cfg_row(config, row);
+}
+
+/* Program the whole rows of a pre-compiled image in buf, returns the bytes used or -1 */
+static int bin_program_rows(lattice_update_config_t *config, uint8_t *buf, uint32_t len)
+{
+	uint32_t ofs = 0;
+
+	for (; (stream.row_left > 0) && ((len - ofs) >= LATTICE_BIN_ROW_SIZE);
+	     ofs += LATTICE_BIN_ROW_SIZE) {
+		if (program_cfg_row(config, buf + ofs) == false) {
+			return -1;
+		}
+		stream.row_left--;
+	}
+
+	if (stream.row_left == 0) {
+		if (program_user_code(config->bus, config->addr, stream.user_code, config->type) ==
+		    false) {
+			return -1;
+		}
+		stream.state = DATA_PASSING_ENDED;
+	}
+
+	return ofs;
+}
+
+/* Handle the complete lines of the stream buffer, *used is set to the bytes consumed */
+static bool jedec_process(lattice_update_config_t *config, uint16_t *used)
+{
+	uint16_t start = 0;
+
+	while (stream.state != DATA_PASSING_ENDED) {
+		uint8_t *eol = memchr(stream.buf + start, '\n', stream.len - start);
+		if (eol == NULL) {
+			break;
+		}
+
+		char *line = (char *)stream.buf + start;
+		uint16_t line_len = eol - (stream.buf + start);
+		uint16_t next = start + line_len + 1;
+
+		if (stream.is_skip_line) {
+			stream.is_skip_line = false;
+			start = next;
+			continue;
+		}
+
+		if ((line_len > 0) && (line[line_len - 1] == '\r')) {
+			line_len--;
+		}
+
+		switch (stream.state) {
+		case DATA_PASSING_FIRST:
+			if (line_has_tag(line, line_len, TAG_CFG_START_STR)) {
+				stream.state = DATA_PASSING_CFG_STARTED;
+			}
+			break;
+
+		case DATA_PASSING_CFG_STARTED:
+			if (line_has_tag(line, line_len, TAG_CFG_END_STR)) {
+				stream.state = DATA_PASSING_CFG_ENDED;
+
+				/* To reduce update time, jump to the bottom part of the image after
+				 * config data transfered, it must be in front of the user code
+				 */
+				uint32_t bottom_ofs =
+					fw_update_cfg.image_size - CPLD_FW_BOTTOM_PART_LENGTH;
+				if (bottom_ofs > (stream.ofs - (stream.len - next))) {
+					stream.ofs = bottom_ofs;
+					stream.len = 0;
+					*used = 0;
+					return true;
+				}
+				break;
+			}
+
+			if (program_jedec_row(config, line, line_len) == false) {
+				return false;
+			}
+			break;
+
+		case DATA_PASSING_CFG_ENDED:
+			if (!line_has_tag(line, line_len, TAG_USER_CODE_STR)) {
+				break;
+			}
+
+			uint16_t code_ofs = start + strlen(TAG_USER_CODE_STR) + 2;
+			if ((code_ofs + USER_CODE_LEN) > stream.len) {
+				/* Wait for the rest of the user code in the next chunk */
+				*used = start;
+				return true;
+			}
+
+			uint32_t user_code_buff[1];
+			if (user_code_parsing((char *)stream.buf + code_ofs, user_code_buff,
+					      USER_CODE_LEN) == false) {
+				LOG_ERR("Failed to parsing user code");
+				return false;
+			}
+
+			if (program_user_code(config->bus, config->addr, user_code_buff[0],
+					      config->type) == false) {
+				return false;
+			}
+
+			stream.state = DATA_PASSING_ENDED;
+			break;
+
+		default:
+			LOG_ERR("Unexpected passing state %d", stream.state);
+			return false;
+		}
+
+		start = next;
+	}
+
+	*used = start;
+	return true;
+}
+
+/* Program every complete row of the requested chunk and carry a partial line or row over to the
+ * next one, so a chunk can be as large as the update agent allows
+ */
+static bool stream_feed(lattice_update_config_t *config)
+{
+	uint8_t *data = config->data;
+	uint32_t len = config->data_len;
+
+	if (config->data_ofs == 0) {
+		memset(&stream, 0, sizeof(stream));
+		stream.state = DATA_PASSING_FIRST;
+		stream.is_first_row = true;
+
+		lattice_bin_header_t *header = (lattice_bin_header_t *)data;
+		if ((len >= sizeof(lattice_bin_header_t)) &&
+		    !memcmp(header->magic, LATTICE_BIN_MAGIC, sizeof(header->magic))) {
+			stream.is_bin = true;
+			stream.state = DATA_PASSING_CFG_STARTED;
+			stream.row_left = sys_le32_to_cpu(header->cfg_row_count);
+			stream.user_code = sys_le32_to_cpu(header->user_code);
+			if (stream.row_left == 0) {
+				LOG_ERR("Pre-compiled image has no CFG row");
+				return false;
+			}
+
+			LOG_INF("Pre-compiled image with %d CFG rows", stream.row_left);
+			data += sizeof(lattice_bin_header_t);
+			len -= sizeof(lattice_bin_header_t);
+			stream.ofs = sizeof(lattice_bin_header_t);
+		}
+	}
+
+	while ((len > 0) && (stream.state != DATA_PASSING_ENDED)) {
+		if (stream.is_bin && (stream.len == 0)) {
+			/* Whole rows go to the device straight from the request buffer */
+			int ret = bin_program_rows(config, data, len);
+			if (ret < 0) {
+				return false;
+			}
+			data += ret;
+			len -= ret;
+			stream.ofs += ret;
+			if ((len == 0) || (stream.state == DATA_PASSING_ENDED)) {
+				break;
+			}
+		}
+
+		uint16_t copy_len = MIN(len, sizeof(stream.buf) - stream.len);
+		memcpy(stream.buf + stream.len, data, copy_len);
+		stream.len += copy_len;
+		stream.ofs += copy_len;
+		data += copy_len;
+		len -= copy_len;
+
+		uint32_t ofs = stream.ofs;
+		uint16_t used = 0;
+		if (stream.is_bin) {
+			int ret = bin_program_rows(config, stream.buf, stream.len);
+			if (ret < 0) {
+				return false;
+			}
+			used = ret;
+		} else if (jedec_process(config, &used) == false) {
+			return false;
+		}
+
+		/* Jumped to the bottom part, the rest of the chunk is not needed */
+		if (stream.ofs != ofs) {
+			return true;
+		}
+
+		memmove(stream.buf, stream.buf + used, stream.len - used);
+		stream.len -= used;
+
+		if (stream.len == sizeof(stream.buf)) {
+			if (stream.state == DATA_PASSING_CFG_STARTED) {
+				LOG_ERR("CFG row longer than %d bytes", STREAM_BUF_SIZE);
+				return false;
+			}
+			stream.len = 0;
+			stream.is_skip_line = true;
+		}
+	}
+
 	return true;
 }
 
@@ -618,107 +883,32 @@ static bool x02x03_i2c_update(lattice_update_config_t *config)
 			LOG_ERR("Failed to erase flash");
 			return false;
 		}
-	}
-
-	/* Step2. Image parsing and update */
-	uint8_t data_buff[CFG_BYTE_PER_LINE];
-	memset(data_buff, 0, sizeof(data_buff));
-	uint32_t program_buff[4];
-	memset(program_buff, 0, sizeof(program_buff));
-	uint32_t user_code_buff[1];
-	memset(user_code_buff, 0, sizeof(user_code_buff));
-
-	static bool first_flag = false;
-	static uint8_t passing_state = DATA_PASSING_FIRST;
-
-	memcpy(data_buff, config->data, config->data_len);
-
-	int idx = 0;
-	for (idx = 0; idx < (config->data_len - sizeof(new_line) + 1); idx++) {
-		if (!memcmp(config->data + idx, new_line, sizeof(new_line))) {
-			config->next_ofs = config->data_ofs + idx + 2;
-			config->next_len = MAX_TRANS_LEN;
-			break;
-		}
-	}
-
-	// if '\n' not found
-	if (idx == (config->data_len - sizeof(new_line) + 1)) {
-		LOG_ERR("Failed to find new line ascii bytes in received data");
+	} else if (config->data_ofs != stream.ofs) {
+		LOG_ERR("Unexpected image offset 0x%x, expected 0x%x", config->data_ofs,
+			stream.ofs);
 		return false;
 	}
 
-	switch (passing_state) {
-	case DATA_PASSING_FIRST:
-	case DATA_PASSING_STARTED:
-		if (!memcmp(config->data, TAG_CFG_START_STR, strlen(TAG_CFG_START_STR))) {
-			passing_state = DATA_PASSING_CFG_STARTED;
-			first_flag = true;
-		}
-		break;
-
-	case DATA_PASSING_CFG_STARTED:
-		if (!memcmp(config->data, TAG_CFG_END_STR, strlen(TAG_CFG_END_STR))) {
-			passing_state = DATA_PASSING_CFG_ENDED;
-
-			/*To reduce update time, jump offset to the bottom part of the image after 
-			config data transfered, the offset must be in front of the user code*/
-			config->next_ofs = fw_update_cfg.image_size - CPLD_FW_BOTTOM_PART_LENGTH;
-		} else {
-			if (cfg_data_parsing(config->data, program_buff, CFG_BYTE_PER_LINE) ==
-			    false) {
-				return false;
-			}
-
-			if (cpld_program_i2c(config->bus, config->addr, (uint8_t *)&program_buff,
-					     config->type, CFG0, first_flag) == false) {
-				LOG_ERR("Failed to program cpld via i2c");
-				return false;
-			}
-
-			first_flag = false;
-		}
-		break;
-
-	case DATA_PASSING_CFG_ENDED:
-		if (!memcmp(config->data, TAG_USER_CODE_STR, strlen(TAG_USER_CODE_STR))) {
-			if (user_code_parsing(data_buff + strlen(TAG_USER_CODE_STR) + 2,
-					      user_code_buff, 8) == false) {
-				LOG_ERR("Failed to parsing user code");
-				return false;
-			}
-
-			uint32_t user_code = user_code_buff[0];
-			if (program_user_code(config->bus, config->addr, user_code, config->type) ==
-			    false) {
-				return false;
-			}
-
-			config->next_len = 0;
-			passing_state = DATA_PASSING_FIRST;
-		}
-		break;
-
-	default:
-		LOG_ERR("Unexpected passing state %d", passing_state);
+	/* Step2. Image parsing and update */
+	if (stream_feed(config) == false) {
 		return false;
 	}
 
-	// if next_ofs not set
-	if (config->next_ofs == 0) {
-		LOG_INF("next_ofs = data_ofs");
-		config->next_ofs = config->data_ofs + MAX_TRANS_LEN;
-		config->next_len = MAX_TRANS_LEN;
-	}
-
 	/* Step3. After update*/
-	if (config->next_len != 0) {
-		if (config->next_ofs + config->next_len >= fw_update_cfg.image_size) {
-			config->next_len = fw_update_cfg.image_size - config->next_ofs;
+	if (stream.state != DATA_PASSING_ENDED) {
+		if (stream.ofs >= fw_update_cfg.image_size) {
+			LOG_ERR("Image ended before the user code");
+			return false;
 		}
+		config->next_ofs = stream.ofs;
+		config->next_len =
+			MIN(fw_update_cfg.max_buff_size, fw_update_cfg.image_size - stream.ofs);
 		return true;
 	}
 
+	LOG_INF("Programmed %d CFG rows", stream.row_count);
+	config->next_len = 0;
+
 	if (program_done(config->bus, config->addr, config->type) == false) {
 		LOG_ERR("Failed to send program done command");
 		return false;
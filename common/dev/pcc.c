@@ -24,6 +24,8 @@
 #include "ipmi.h"
 #include "libutil.h"
 #include "pcc.h"
+#include "util_postcode.h"
+#include "boot_timeline.h"
 #include <logging/log.h>
 #include "libipmi.h"
 #include "plat_sensor_table.h"
@@ -38,11 +40,11 @@ K_THREAD_STACK_DEFINE(process_postcode_thread, PROCESS_POSTCODE_STACK_SIZE);
 static struct k_thread process_postcode_thread_handler;
 
 const struct device *pcc_dev;
-static uint32_t pcc_read_buffer[PCC_BUFFER_LEN];
-static uint16_t pcc_read_len = 0, pcc_read_index = 0;
 static bool proc_4byte_postcode_ok = false;
 static struct k_sem get_postcode_sem;
 
+POSTCODE_RING_DEFINE(pcc_ring, PCC_BUFFER_LEN);
+
 static uint8_t PSB_error_code_list[] = { 0x03, 0x04, 0x05, 0x0B, 0x10, 0x13, 0x14, 0x18, 0x22, 0x3E,
 					 0x62, 0x64, 0x69, 0x6C, 0x6F, 0x78, 0x79, 0x7A, 0x7B, 0x7C,
 					 0x7D, 0x7E, 0x7F, 0x80, 0x81, 0x82, 0x83, 0x92 };
@@ -55,34 +57,22 @@ static uint16_t ABL_error_code_list[] = { 0x3000, 0x3001, 0x3002, 0x3003, 0xE2A4
 					  0xE2EF, 0xE2C2, 0xE2C3, 0xE2E3, 0xE2C6, 0xE310, 0xE2E7,
 					  0xE32D, 0xE33E, 0xE328, 0xE345, 0xE32B, 0xE332 };
 
+/* Copy "length" 4-byte post codes to buffer, newest first, skipping the newest "start" ones.
+ *
+ * @retval number of bytes copied
+ */
 uint16_t copy_pcc_read_buffer(uint16_t start, uint16_t length, uint8_t *buffer, uint16_t buffer_len)
 {
 	if ((buffer == NULL) || (buffer_len < (length * 4))) {
 		return 0;
 	}
 
-	uint16_t current_index, i = 0;
-	uint16_t current_read_len = pcc_read_len;
-	uint16_t current_read_index = pcc_read_index;
-	if (start < current_read_index) {
-		current_index = current_read_index - start - 1;
-	} else {
-		current_index = current_read_index + PCC_BUFFER_LEN - start - 1;
-	}
-
-	for (; (i < length) && ((i + start) < current_read_len); i++) {
-		buffer[4 * i] = pcc_read_buffer[current_index] & 0xFF;
-		buffer[(4 * i) + 1] = (pcc_read_buffer[current_index] >> 8) & 0xFF;
-		buffer[(4 * i) + 2] = (pcc_read_buffer[current_index] >> 16) & 0xFF;
-		buffer[(4 * i) + 3] = (pcc_read_buffer[current_index] >> 24) & 0xFF;
+	return 4 * postcode_ring_copy_codes(&pcc_ring, start, buffer, length, sizeof(uint32_t));
+}
 
-		if (current_index == 0) {
-			current_index = PCC_BUFFER_LEN - 1;
-		} else {
-			current_index--;
-		}
-	}
-	return 4 * i;
+uint32_t get_pcc_overrun_count()
+{
+	return postcode_ring_get_overrun(&pcc_ring);
 }
 
 void check_PSB_error(uint32_t postcode)
@@ -189,49 +179,73 @@ void check_ABL_error(uint32_t postcode)
 	SAFE_FREE(msg);
 }
 
+static void send_4byte_postcode_to_BMC(ipmi_msg *msg, uint16_t num)
+{
+	msg->InF_source = SELF;
+	msg->InF_target = BMC_IPMB;
+	msg->netfn = NETFN_OEM_1S_REQ;
+	msg->cmd = CMD_OEM_1S_SEND_4BYTE_POST_CODE_TO_BMC;
+	msg->data_len = 4 + (num * 4);
+	msg->data[0] = IANA_ID & 0xFF;
+	msg->data[1] = (IANA_ID >> 8) & 0xFF;
+	msg->data[2] = (IANA_ID >> 16) & 0xFF;
+	msg->data[3] = num * 4;
+
+	ipmb_error status = ipmb_read(msg, IPMB_inf_index_map[msg->InF_target]);
+	if (status != IPMB_ERROR_SUCCESS) {
+		LOG_ERR("Failed to send %d 4-byte post code to BMC, status %d.", num, status);
+	}
+}
+
 static void process_postcode(void *arvg0, void *arvg1, void *arvg2)
 {
-	uint16_t send_index = 0;
+	static ipmi_msg msg;
+	postcode_entry entry[PCC_CONSUME_CHUNK];
+	uint32_t cursor = postcode_ring_oldest(&pcc_ring);
+	uint32_t last_overrun_count = 0;
+	uint16_t num, total;
+
 	while (1) {
 		k_sem_take(&get_postcode_sem, K_FOREVER);
-		ipmi_msg *msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
-		if (msg == NULL) {
-			LOG_ERR("Memory allocation failed.");
-			continue;
-		}
 
-		uint16_t current_read_index = pcc_read_index;
-		for (; send_index != current_read_index;
-		     send_index = (send_index + 1) % PCC_BUFFER_LEN) {
-			if (((pcc_read_buffer[send_index] >> 24) & 0xFF) == PSB_POSTCODE_PREFIX) {
-				check_PSB_error(pcc_read_buffer[send_index]);
-			} else if (((pcc_read_buffer[send_index] >> 24) & 0xFF) ==
-				   ABL_POSTCODE_PREFIX) {
-				check_ABL_error(pcc_read_buffer[send_index]);
+		/* Everything drained goes out in as few messages as the payload allows */
+		total = 0;
+		while ((num = postcode_ring_consume(&pcc_ring, &cursor, entry,
+						    MIN(PCC_CONSUME_CHUNK,
+							PCC_SEND_MAX_NUM - total))) != 0) {
+			boot_timeline_add(entry, num);
+			for (uint16_t i = 0; i < num; i++) {
+				uint32_t postcode = entry[i].code;
+				if (((postcode >> 24) & 0xFF) == PSB_POSTCODE_PREFIX) {
+					check_PSB_error(postcode);
+				} else if (((postcode >> 24) & 0xFF) == ABL_POSTCODE_PREFIX) {
+					check_ABL_error(postcode);
+				}
+
+				uint8_t *data = &msg.data[4 + ((total + i) * 4)];
+				data[0] = postcode & 0xFF;
+				data[1] = (postcode >> 8) & 0xFF;
+				data[2] = (postcode >> 16) & 0xFF;
+				data[3] = (postcode >> 24) & 0xFF;
 			}
 
-			memset(msg, 0, sizeof(ipmi_msg));
-			msg->InF_source = SELF;
-			msg->InF_target = BMC_IPMB;
-			msg->netfn = NETFN_OEM_1S_REQ;
-			msg->cmd = CMD_OEM_1S_SEND_4BYTE_POST_CODE_TO_BMC;
-			msg->data_len = 8;
-			msg->data[0] = IANA_ID & 0xFF;
-			msg->data[1] = (IANA_ID >> 8) & 0xFF;
-			msg->data[2] = (IANA_ID >> 16) & 0xFF;
-			msg->data[3] = 4;
-			msg->data[4] = pcc_read_buffer[send_index] & 0xFF;
-			msg->data[5] = (pcc_read_buffer[send_index] >> 8) & 0xFF;
-			msg->data[6] = (pcc_read_buffer[send_index] >> 16) & 0xFF;
-			msg->data[7] = (pcc_read_buffer[send_index] >> 24) & 0xFF;
-			ipmb_error status = ipmb_read(msg, IPMB_inf_index_map[msg->InF_target]);
-			if (status != IPMB_ERROR_SUCCESS) {
-				LOG_ERR("Failed to send 4-byte post code to BMC, status %d.",
-					status);
+			total += num;
+			if (total == PCC_SEND_MAX_NUM) {
+				send_4byte_postcode_to_BMC(&msg, total);
+				total = 0;
 			}
-			k_yield();
 		}
-		SAFE_FREE(msg)
+
+		if (total != 0) {
+			send_4byte_postcode_to_BMC(&msg, total);
+		}
+
+		uint32_t overrun = get_pcc_overrun_count();
+		if (overrun != last_overrun_count) {
+			LOG_WRN("%u 4-byte post code overwritten before sent to BMC",
+				overrun - last_overrun_count);
+			last_overrun_count = overrun;
+		}
 	}
 }
 
@@ -254,15 +268,8 @@ void pcc_rx_callback(const uint8_t *rb, uint32_t rb_sz, uint32_t st_idx, uint32_
 		addr = rb[i + 1];
 		four_byte_data |= data << (8 * (addr & 0x0F));
 		if ((addr & 0x0F) == 0x03) {
-			pcc_read_buffer[pcc_read_index] = four_byte_data;
+			postcode_ring_put(&pcc_ring, four_byte_data);
 			four_byte_data = 0;
-			if (pcc_read_len < PCC_BUFFER_LEN) {
-				pcc_read_len++;
-			}
-			pcc_read_index++;
-			if (pcc_read_index == PCC_BUFFER_LEN) {
-				pcc_read_index = 0;
-			}
 		}
 		i = (i + 2) % rb_sz;
 	} while (i != ed_idx);
@@ -302,7 +309,7 @@ void pcc_init()
 
 void reset_pcc_buffer()
 {
-	pcc_read_len = 0;
+	postcode_ring_clear(&pcc_ring);
 	return;
 }
 
@@ -18,6 +18,7 @@
 #include "util_spi.h"
 #include "pt5161l.h"
 #include "hal_i2c.h"
+#include "i2c_scheduler.h"
 #include "libutil.h"
 #include "sensor.h"
 
@@ -26,6 +27,8 @@ LOG_MODULE_REGISTER(dev_pt5161l);
 K_MUTEX_DEFINE(pt5161l_mutex);
 
 static bool is_update_ongoing = false;
+/* 64K page the retimer I2C master currently addresses, -1 when unknown */
+static int eeprom_page = -1;
 uint8_t PT5161L_VENDOR_ID[7] = { 0x06, 0x04, 0x00, 0x01, 0x00, 0xFA, 0x1D };
 
 bool pt5161l_get_vendor_id(I2C_MSG *msg)
@@ -106,22 +109,19 @@ bool pt5161l_write_block_data(I2C_MSG *msg, uint32_t address, uint8_t num_bytes,
 		 * 1 extra byte for num bytes in buffer
 		 */
 		int write_num_bytes = 2 + 1 + curr_bytes;
-		msg->data[0] = cmd_code;
-		msg->data[1] = write_num_bytes - 1;
-		msg->data[2] = lower_addr;
-		msg->data[3] = upper_addr;
+		uint8_t header[4] = { cmd_code, write_num_bytes - 1, lower_addr, upper_addr };
 
 		LOG_DBG("Write:");
-		LOG_DBG("msg->data[0] = 0x%02x", msg->data[0]);
-		LOG_DBG("msg->data[1] = 0x%02x", msg->data[1]);
-		LOG_DBG("msg->data[2] = 0x%02x", msg->data[2]);
-		LOG_DBG("msg->data[3] = 0x%02x", msg->data[3]);
-
-		memcpy(&(msg->data[4]), values, curr_bytes);
+		LOG_HEXDUMP_DBG(header, sizeof(header), "header");
 
-		msg->tx_len = write_num_bytes + 1;
+		// Header and data go out in one transaction without merging them first
+		struct i2c_msg msgs[2] = {
+			{ .buf = header, .len = sizeof(header), .flags = I2C_MSG_WRITE },
+			{ .buf = values, .len = curr_bytes, .flags = I2C_MSG_WRITE | I2C_MSG_STOP },
+		};
 
-		if (i2c_master_write(msg, retry)) {
+		if (i2c_master_transfer(msg->bus, msg->target_addr, msgs, ARRAY_SIZE(msgs),
+					retry)) {
 			LOG_ERR("pt5161l write block failed");
 			return false;
 		}
@@ -133,6 +133,69 @@ bool pt5161l_write_block_data(I2C_MSG *msg, uint32_t address, uint8_t num_bytes,
 	return true;
 }
 
+#define PT5161L_EEPROM_BLOCK_REG_NUM (PT5161L_EEPROM_BLOCK_WRITE_SIZE / 4)
+
+/* Only used by the update, which holds pt5161l_mutex */
+static I2C_MSG block_reg_msg[PT5161L_EEPROM_BLOCK_REG_NUM];
+static i2c_sched_xfer block_reg_xfer[PT5161L_EEPROM_BLOCK_REG_NUM];
+
+static void pt5161l_block_reg_done(i2c_sched_xfer *xfer, int ret)
+{
+	k_sem_give((struct k_sem *)xfer->arg);
+}
+
+/* The holding register writes of a block are queued on the I2C scheduler as bulk transfers in
+ * one go. They go out in order while IPMB and sensor transfers may still go in between, and the
+ * update thread wakes up once per block.
+ */
+static bool pt5161l_write_block_regs(I2C_MSG *msg, uint8_t *values)
+{
+	struct k_sem done;
+	uint8_t num = 0;
+	bool ret = true;
+
+	k_sem_init(&done, 0, PT5161L_EEPROM_BLOCK_REG_NUM);
+
+	for (; num < PT5161L_EEPROM_BLOCK_REG_NUM; num++) {
+		uint32_t reg = PT5161L_EEPROM_BLOCK_BASE_ADDR + 4 * num;
+		I2C_MSG *reg_msg = &block_reg_msg[num];
+		i2c_sched_xfer *xfer = &block_reg_xfer[num];
+
+		// Same transaction as pt5161l_write_block_data() for 4 bytes
+		reg_msg->bus = msg->bus;
+		reg_msg->target_addr = msg->target_addr;
+		reg_msg->data[0] = (1 << 2) + (1 << 1) + (1 << 0); // func 1, start and end
+		reg_msg->data[1] = 2 + 4; // address and data bytes
+		reg_msg->data[2] = reg & 0xff;
+		reg_msg->data[3] = (reg >> 8) & 0xff;
+		memcpy(&reg_msg->data[4], &values[num * 4], 4);
+		reg_msg->tx_len = 8;
+		reg_msg->rx_len = 0;
+
+		memset(xfer, 0, sizeof(i2c_sched_xfer));
+		xfer->msg = reg_msg;
+		xfer->type = I2C_WRITE;
+		xfer->retry = 3;
+		xfer->prio = I2C_SCHED_PRIO_BULK;
+		xfer->done_fn = pt5161l_block_reg_done;
+		xfer->arg = &done;
+		if (!i2c_sched_submit(xfer)) {
+			ret = false;
+			break;
+		}
+	}
+
+	// The transfers and the semaphore live until every submitted one is done
+	for (uint8_t i = 0; i < num; i++) {
+		k_sem_take(&done, K_FOREVER);
+		if (block_reg_xfer[i].ret) {
+			ret = false;
+		}
+	}
+
+	return ret;
+}
+
 /*
  * Read multiple data bytes from Aries over I2C
  */
@@ -209,20 +272,19 @@ bool pt5161l_read_block_data(I2C_MSG *msg, uint32_t address, uint8_t num_bytes,
 
 		rd_cmd_code = (rsvd << 5) + (func_code << 2) + (start << 1) + (end << 0);
 
-		msg->data[0] = rd_cmd_code;
-		msg->tx_len = 1;
-		msg->rx_len = read_buf_len;
+		uint8_t read_buf[3 + 4];
 
 		LOG_DBG("Read:");
 		LOG_DBG("cmd_code = 0x%02x", rd_cmd_code);
 
-		if (i2c_master_read(msg, retry)) {
+		if (i2c_master_write_read_buf(msg->bus, msg->target_addr, &rd_cmd_code, 1, read_buf,
+					      read_buf_len, retry)) {
 			LOG_ERR("pt5161l read failed");
 			return false;
 		}
 
 		// Fill up user given array
-		memcpy(values, &(msg->data[3]), curr_bytes);
+		memcpy(values, &read_buf[3], curr_bytes);
 
 		// Increment iteration count
 		values += curr_bytes;
@@ -612,12 +674,10 @@ bool pt5161l_i2c_master_multi_block_write(I2C_MSG *msg, uint16_t offset, int num
 
 	int num_iters = num_bytes / PT5161L_EEPROM_BLOCK_WRITE_SIZE;
 	int iter_idx;
-	int num_blocks = PT5161L_EEPROM_BLOCK_WRITE_SIZE / 4; // 4-byte blocks
-	int block_idx;
 	int oft = 0;
 	uint8_t cmd;
 	int try;
-	int max_tries = 30;
+	int max_tries = PT5161L_MM_STATUS_TIMEOUT_MS * 1000 / PT5161L_MM_STATUS_POLL_US;
 	bool is_busy = false;
 
 	for (iter_idx = 0; iter_idx < num_iters; iter_idx++) {
@@ -628,16 +688,11 @@ bool pt5161l_i2c_master_multi_block_write(I2C_MSG *msg, uint16_t offset, int num
 		}
 		cmd = cmd | PT5161L_EEPROM_BLOCK_CMD_MODIFIER;
 
-		// Write data
-		for (block_idx = 0; block_idx < num_blocks; block_idx++) {
-			memcpy(data_bytes, &(values[(oft + block_idx * 4)]), 4);
-			// write the data to Retimer holding registers
-			ret = pt5161l_write_block_data(
-				msg, PT5161L_EEPROM_BLOCK_BASE_ADDR + 4 * block_idx, 4, data_bytes);
-			if (!ret) {
-				LOG_ERR("pt5161l write the data to Retimer holding registers failed");
-				return ret;
-			}
+		// write the data to Retimer holding registers
+		ret = pt5161l_write_block_regs(msg, &values[oft]);
+		if (!ret) {
+			LOG_ERR("pt5161l write the data to Retimer holding registers failed");
+			return ret;
 		}
 
 		// Write cmd
@@ -663,7 +718,7 @@ bool pt5161l_i2c_master_multi_block_write(I2C_MSG *msg, uint16_t offset, int num
 				is_busy = false;
 				break;
 			}
-			k_msleep(PT5161L_MM_STATUS_TIME_5MS);
+			k_usleep(PT5161L_MM_STATUS_POLL_US);
 		}
 
 		// If status not reset to 0, return BUSY error
@@ -682,6 +737,8 @@ bool pt5161l_pre_update(I2C_MSG *msg)
 {
 	bool ret;
 
+	eeprom_page = -1;
+
 	// Deassert HW and SW resets
 	uint8_t tmp_data[2];
 	tmp_data[0] = 0;
@@ -739,7 +796,8 @@ bool pt5161l_write_eeprom_image(I2C_MSG *msg, uint32_t offset, uint8_t *txbuf, u
 	int amend_len;
 	int oft_msb;
 	int oft_i2c;
-	uint8_t data[PT5161L_EEPROM_PAGE_SIZE];
+	uint8_t pad_buf[PT5161L_EEPROM_PAGE_SIZE];
+	uint8_t *data = txbuf;
 	bool ret = false;
 
 	if (length > PT5161L_EEPROM_PAGE_SIZE) {
@@ -751,19 +809,24 @@ bool pt5161l_write_eeprom_image(I2C_MSG *msg, uint32_t offset, uint8_t *txbuf, u
 	oft_msb = offset / SECTOR_SZ_64K;
 	oft_i2c = offset % SECTOR_SZ_64K;
 
-	// Set Page address
-	ret = pt5161l_i2c_master_set_page(msg, oft_msb);
-	if (!ret) {
-		LOG_ERR("pt5161l i2c master set page %x failed", oft_msb);
-		return false;
+	// Set Page address, only when it changes
+	if (oft_msb != eeprom_page) {
+		ret = pt5161l_i2c_master_set_page(msg, oft_msb);
+		if (!ret) {
+			LOG_ERR("pt5161l i2c master set page %x failed", oft_msb);
+			eeprom_page = -1;
+			return false;
+		}
+		eeprom_page = oft_msb;
 	}
 
-	memcpy(data, txbuf, length);
-
+	// Only the padded tail of the image needs a copy
 	if (is_end && (length % PT5161L_EEPROM_BLOCK_WRITE_SIZE)) {
 		amend_len = PT5161L_EEPROM_BLOCK_WRITE_SIZE -
 			    (length % PT5161L_EEPROM_BLOCK_WRITE_SIZE);
-		memset(&(data[length]), 0, amend_len);
+		memcpy(pad_buf, txbuf, length);
+		memset(&(pad_buf[length]), 0, amend_len);
+		data = pad_buf;
 	} else {
 		amend_len = 0;
 	}
@@ -837,82 +900,96 @@ uint8_t pt5161l_do_update(I2C_MSG *msg, uint32_t update_offset, uint8_t *txbuf,
 	return FWUPDATE_SUCCESS;
 }
 
+/* The image is streamed to the EEPROM a page at a time. Whole pages are written straight from
+ * the request, only a page split across requests is gathered in the page buffer. Requests must
+ * come in order, an update starts over at offset 0. A resend of the last accepted request, as the
+ * BMC does when the response got lost, is acknowledged without writing it again.
+ */
 uint8_t pcie_retimer_fw_update(I2C_MSG *msg, uint32_t offset, uint16_t msg_len, uint8_t *msg_buf,
 			       uint8_t flag)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg, FWUPDATE_UPDATE_FAIL);
 	CHECK_NULL_ARG_WITH_RETURN(msg_buf, FWUPDATE_UPDATE_FAIL);
-	static bool is_init = false;
-	static uint8_t *txbuf = NULL;
-	static uint32_t start_offset = 0, buf_offset = 0;
-	uint32_t ret = 0;
-	bool is_end = false;
-
-	if (!is_init) {
-		SAFE_FREE(txbuf);
-		txbuf = (uint8_t *)malloc(SECTOR_SZ_256);
-		if (txbuf == NULL) { // Retry alloc
-			k_msleep(100);
-			txbuf = (uint8_t *)malloc(SECTOR_SZ_256);
-		}
-		if (txbuf == NULL) {
-			LOG_ERR("eeprom offset %x, failed to allocate txbuf.", offset);
-			return FWUPDATE_OUT_OF_HEAP;
-		}
-		is_init = true;
-		start_offset = offset;
-		buf_offset = 0;
-		k_msleep(10);
+	static uint8_t page_buf[PT5161L_EEPROM_PAGE_SIZE];
+	static uint32_t page_offset = 0;
+	static uint16_t page_len = 0;
+	static uint32_t next_offset = 0;
+	static uint32_t last_offset = UINT32_MAX;
+	bool is_end = (flag & SECTOR_END_FLAG) ? true : false;
+	uint8_t ret = FWUPDATE_SUCCESS;
+
+	if ((offset == last_offset) && (offset != next_offset)) {
+		LOG_WRN("eeprom offset %x resent, skip", offset);
+		return FWUPDATE_SUCCESS;
+	}
+
+	if (offset == 0) {
+		page_len = 0;
+		next_offset = 0;
 	}
 
-	if (msg_len > SECTOR_SZ_256) {
-		LOG_ERR("eeprom offset %x, recv data 0x%x over sector size 0x%x", offset,
-			buf_offset + msg_len, SECTOR_SZ_256);
-		SAFE_FREE(txbuf);
-		k_msleep(10);
-		is_init = false;
-		return FWUPDATE_OVER_LENGTH;
+	if (offset != next_offset) {
+		LOG_ERR("eeprom offset %x, expected offset %x", offset, next_offset);
+		return FWUPDATE_ERROR_OFFSET;
 	}
 
+	uint32_t start_offset = offset;
+
 	LOG_DBG("update offset %x , msg_len %d, flag 0x%x, msg_buf: %2x %2x %2x %2x", offset,
 		msg_len, flag, msg_buf[0], msg_buf[1], msg_buf[2], msg_buf[3]);
 
-	memcpy(&txbuf[buf_offset], msg_buf, msg_len);
-	buf_offset += msg_len;
+	if (k_mutex_lock(&pt5161l_mutex, K_FOREVER)) {
+		LOG_ERR("pt5161l mutex lock failed");
+		return FWUPDATE_UPDATE_FAIL;
+	}
 
-	if ((buf_offset == SECTOR_SZ_256) || (flag & SECTOR_END_FLAG)) {
-		if (flag & SECTOR_END_FLAG) {
-			is_end = true;
-		}
+	while (msg_len > 0) {
+		uint16_t room = PT5161L_EEPROM_PAGE_SIZE - (offset % PT5161L_EEPROM_PAGE_SIZE);
+		uint16_t len = MIN(msg_len, room);
+		bool is_last = is_end && (len == msg_len);
 
-		if (k_mutex_lock(&pt5161l_mutex, K_FOREVER)) {
-			LOG_ERR("pt5161l mutex lock failed");
-			SAFE_FREE(txbuf);
-			k_msleep(10);
-			return FWUPDATE_UPDATE_FAIL;
+		if ((page_len == 0) && ((len == room) || is_last)) {
+			ret = pt5161l_do_update(msg, offset, msg_buf, len, is_last);
+		} else {
+			if (page_len == 0) {
+				page_offset = offset;
+			}
+			memcpy(&page_buf[page_len], msg_buf, len);
+			page_len += len;
+			if ((len == room) || is_last) {
+				ret = pt5161l_do_update(msg, page_offset, page_buf, page_len,
+							is_last);
+				page_len = 0;
+			}
 		}
 
-		ret = pt5161l_do_update(msg, start_offset, txbuf, buf_offset, is_end);
-
-		if (k_mutex_unlock(&pt5161l_mutex)) {
-			LOG_ERR("pt5161l mutex unlock failed");
-			SAFE_FREE(txbuf);
-			return FWUPDATE_UPDATE_FAIL;
+		if (ret != FWUPDATE_SUCCESS) {
+			LOG_ERR("Failed to update PCIE retimer eeprom offset %x, status %d", offset,
+				ret);
+			break;
 		}
 
-		SAFE_FREE(txbuf);
-		k_msleep(10);
+		offset += len;
+		msg_buf += len;
+		msg_len -= len;
+	}
 
-		if (ret) {
-			LOG_ERR("Failed to update PCIE retimer eeprom, status %d", ret);
-			return FWUPDATE_UPDATE_FAIL;
-		} else {
-			LOG_INF("PCIE retimer %x update success", start_offset);
-		}
+	if (k_mutex_unlock(&pt5161l_mutex)) {
+		LOG_ERR("pt5161l mutex unlock failed");
+	}
 
-		is_init = false;
+	if (ret != FWUPDATE_SUCCESS) {
+		page_len = 0;
+		next_offset = 0;
+		last_offset = UINT32_MAX;
+		return FWUPDATE_UPDATE_FAIL;
+	}
 
-		return ret;
+	last_offset = start_offset;
+	next_offset = offset;
+	if (is_end) {
+		LOG_INF("PCIE retimer update success, size 0x%x", offset);
+		next_offset = 0;
 	}
 
 	return FWUPDATE_SUCCESS;
@@ -27,16 +27,19 @@
 #include "ipmi.h"
 #include "pldm.h"
 #include "power_status.h"
+#include "util_postcode.h"
+#include "boot_timeline.h"
 #include <logging/log.h>
 
 LOG_MODULE_REGISTER(dev_snoop);
 
 const struct device *snoop_dev;
-uint8_t *snoop_data;
-static uint8_t *snoop_read_buffer;
-int snoop_read_num = 0;
-int send_postcode_start_position = 0;
 static bool proc_postcode_ok = false;
+static uint32_t send_postcode_cursor = 0;
+static uint32_t last_overrun_count = 0;
+
+POSTCODE_RING_DEFINE(snoop_ring, SNOOP_RING_LEN);
+K_SEM_DEFINE(snoop_postcode_sem, 0, 1);
 
 K_THREAD_STACK_DEFINE(snoop_thread, SNOOP_STACK_SIZE);
 struct k_thread snoop_thread_handler;
@@ -46,8 +49,6 @@ K_THREAD_STACK_DEFINE(send_postcode_thread, SENDPOSTCODE_STACK_SIZE);
 struct k_thread send_postcode_thread_handler;
 k_tid_t send_postcode_tid;
 
-struct k_mutex snoop_mutex;
-
 void snoop_init()
 {
 	snoop_dev = device_get_binding(DT_LABEL(DT_NODELABEL(snoop)));
@@ -58,36 +59,26 @@ void snoop_init()
 	return;
 }
 
-void copy_snoop_read_buffer(uint8_t offset, int size_num, uint8_t *buffer, uint8_t copy_mode)
+/* Copy the newest post codes to buffer, newest first.
+ *
+ * @retval number of post codes copied
+ */
+uint16_t copy_snoop_read_buffer(uint8_t *buffer, uint16_t buffer_len)
 {
-	if (buffer == NULL) {
-		return;
-	}
+	CHECK_NULL_ARG_WITH_RETURN(buffer, 0);
 
-	if (size_num > SNOOP_MAX_LEN) {
-		LOG_ERR("copy snoop buffer size exceeded");
-		return;
-	}
-	if (!k_mutex_lock(&snoop_mutex, K_MSEC(1000))) {
-		if (copy_mode == COPY_ALL_POSTCODE) {
-			memcpy(&buffer[0], &snoop_read_buffer[offset], size_num - offset);
-			memcpy(&buffer[size_num - offset], &snoop_read_buffer[0], offset);
-		} else {
-			if (offset + size_num > SNOOP_MAX_LEN) {
-				memcpy(&buffer[0], &snoop_read_buffer[offset],
-				       SNOOP_MAX_LEN - offset);
-				memcpy(&buffer[SNOOP_MAX_LEN - offset], &snoop_read_buffer[0],
-				       size_num - (SNOOP_MAX_LEN - offset));
-			} else {
-				memcpy(&buffer[0], &snoop_read_buffer[offset], size_num);
-			}
-		}
-	} else {
-		LOG_ERR("copy snoop buffer lock fail");
-	}
-	if (k_mutex_unlock(&snoop_mutex)) {
-		LOG_ERR("copy snoop buffer unlock fail");
-	}
+	return postcode_ring_copy_codes(&snoop_ring, 0, buffer, MIN(buffer_len, SNOOP_MAX_LEN),
+					sizeof(uint8_t));
+}
+
+uint16_t get_snoop_read_num()
+{
+	return postcode_ring_count(&snoop_ring);
+}
+
+uint32_t get_snoop_overrun_count()
+{
+	return postcode_ring_get_overrun(&snoop_ring);
 }
 
 bool get_postcode_ok()
@@ -103,27 +94,14 @@ void reset_postcode_ok()
 void snoop_read()
 {
 	int rc;
-	if (snoop_read_buffer == NULL) {
-		snoop_read_buffer = malloc(sizeof(uint8_t) * SNOOP_MAX_LEN);
-	}
-	if (snoop_read_buffer == NULL) {
-		LOG_ERR("snoop read buffer alloc fail");
-		return;
-	}
+	uint8_t snoop_data;
 
 	while (1) {
-		rc = snoop_aspeed_read(snoop_dev, 0, snoop_data, true);
+		rc = snoop_aspeed_read(snoop_dev, 0, &snoop_data, true);
 		if (rc == 0) {
 			proc_postcode_ok = true;
-			if (!k_mutex_lock(&snoop_mutex, K_MSEC(1000))) {
-				snoop_read_buffer[snoop_read_num % SNOOP_MAX_LEN] = *snoop_data;
-				snoop_read_num++;
-			} else {
-				LOG_ERR("snoop read lock fail");
-			}
-			if (k_mutex_unlock(&snoop_mutex)) {
-				LOG_ERR("snoop read unlock fail");
-			}
+			postcode_ring_put(&snoop_ring, snoop_data);
+			k_sem_give(&snoop_postcode_sem);
 		}
 	}
 }
@@ -131,7 +109,7 @@ void snoop_read()
 void init_snoop_thread()
 {
 	snoop_init();
-	snoop_read_num = 0;
+	postcode_ring_clear(&snoop_ring);
 	if (snoop_tid != NULL && strcmp(k_thread_state_str(snoop_tid), "dead") != 0) {
 		return;
 	}
@@ -148,90 +126,107 @@ void abort_snoop_thread()
 	}
 }
 
-void send_post_code_to_BMC()
+/* Wait until enough post codes are queued to fill a burst, or the coalesce window ends.
+ * A fast booting host triggers an immediate flush while slow progress is batched.
+ */
+static void wait_postcode_coalesce()
 {
-	int send_postcode_end_position;
-	ipmi_msg *send_postcode_msg;
-	ipmb_error status;
+	int64_t deadline = k_uptime_get() + SNOOP_COALESCE_MS;
 
-	while (1) {
-		k_msleep(100); // send post code to BMC once 100 ms
-		send_postcode_end_position = snoop_read_num;
-		if (get_DC_status() == 0) {
-			return;
+	while (postcode_ring_pending(&snoop_ring, send_postcode_cursor) < SNOOP_BURST_LEN) {
+		int64_t remain = deadline - k_uptime_get();
+		if (remain <= 0) {
+			break;
 		}
-		if (send_postcode_start_position != send_postcode_end_position) {
-			send_postcode_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
-			static uint8_t alloc_sendmsg_retry = 0;
-			if (send_postcode_msg == NULL) {
-				if (get_post_status()) {
-					alloc_sendmsg_retry += 1;
-					if (alloc_sendmsg_retry > 3) {
-						LOG_ERR("post complete and send post code thread alloc fail three times continuously");
-						return;
-					} else {
-						continue;
-					}
-				} else {
-					LOG_ERR("send post code thread alloc fail");
-					continue;
-				}
-			}
-
-			alloc_sendmsg_retry = 0;
+		k_sem_take(&snoop_postcode_sem, K_MSEC(remain));
+	}
+}
 
-			if (send_postcode_end_position - send_postcode_start_position >
-			    SNOOP_MAX_LEN) {
-				send_postcode_end_position =
-					send_postcode_start_position + SNOOP_MAX_LEN;
+static void flush_postcode_to_BMC(ipmi_msg *send_postcode_msg)
+{
+	postcode_entry entry[SNOOP_CONSUME_CHUNK];
+	ipmb_error status;
+	uint16_t num, total;
+
+	while (postcode_ring_pending(&snoop_ring, send_postcode_cursor) != 0) {
+		memset(send_postcode_msg, 0, sizeof(ipmi_msg));
+		for (total = 0; total < SNOOP_MAX_LEN; total += num) {
+			num = postcode_ring_consume(&snoop_ring, &send_postcode_cursor, entry,
+						    MIN(SNOOP_CONSUME_CHUNK, SNOOP_MAX_LEN - total));
+			if (num == 0) {
+				break;
 			}
-			memset(send_postcode_msg, 0, sizeof(ipmi_msg));
-			send_postcode_msg->InF_source = SELF;
-			send_postcode_msg->InF_target = BMC_IPMB;
-			send_postcode_msg->netfn = NETFN_OEM_1S_REQ;
-			send_postcode_msg->cmd = CMD_OEM_1S_SEND_POST_CODE_TO_BMC;
-			send_postcode_msg->data_len =
-				send_postcode_end_position - send_postcode_start_position + 4;
-			send_postcode_msg->data[0] = IANA_ID & 0xFF;
-			send_postcode_msg->data[1] = (IANA_ID >> 8) & 0xFF;
-			send_postcode_msg->data[2] = (IANA_ID >> 16) & 0xFF;
-			send_postcode_msg->data[3] =
-				send_postcode_end_position - send_postcode_start_position;
-			copy_snoop_read_buffer(send_postcode_start_position % SNOOP_MAX_LEN,
-					       send_postcode_msg->data[3],
-					       &send_postcode_msg->data[4], COPY_SPECIFIC_POSTCODE);
-
-			// Check BMC communication interface if use IPMB or not
-			if (pal_is_interface_use_ipmb(IPMB_inf_index_map[BMC_IPMB])) {
-				status = ipmb_read(
-					send_postcode_msg,
-					IPMB_inf_index_map[send_postcode_msg->InF_target]);
-				SAFE_FREE(send_postcode_msg);
-				if (status == IPMB_ERROR_FAILURE) {
-					LOG_ERR("Fail to post msg to txqueue for send post code from %d to %d",
-						send_postcode_start_position,
-						send_postcode_end_position);
-					continue;
-				} else if (status == IPMB_ERROR_GET_MESSAGE_QUEUE) {
-					LOG_ERR("No response from bmc for send post code");
-					continue;
-				}
-			} else {
-				status = pldm_send_ipmi_request(send_postcode_msg);
-				SAFE_FREE(send_postcode_msg);
+			boot_timeline_add(entry, num);
+			for (uint16_t i = 0; i < num; i++) {
+				send_postcode_msg->data[4 + total + i] = entry[i].code & 0xFF;
+			}
+		}
+		if (total == 0) {
+			break;
+		}
+
+		send_postcode_msg->InF_source = SELF;
+		send_postcode_msg->InF_target = BMC_IPMB;
+		send_postcode_msg->netfn = NETFN_OEM_1S_REQ;
+		send_postcode_msg->cmd = CMD_OEM_1S_SEND_POST_CODE_TO_BMC;
+		send_postcode_msg->data_len = total + 4;
+		send_postcode_msg->data[0] = IANA_ID & 0xFF;
+		send_postcode_msg->data[1] = (IANA_ID >> 8) & 0xFF;
+		send_postcode_msg->data[2] = (IANA_ID >> 16) & 0xFF;
+		send_postcode_msg->data[3] = total;
+
+		// Check BMC communication interface if use IPMB or not
+		if (pal_is_interface_use_ipmb(IPMB_inf_index_map[BMC_IPMB])) {
+			status = ipmb_read(send_postcode_msg,
+					   IPMB_inf_index_map[send_postcode_msg->InF_target]);
+			if (status == IPMB_ERROR_FAILURE) {
+				LOG_ERR("Fail to post msg to txqueue for send %d post code", total);
+			} else if (status == IPMB_ERROR_GET_MESSAGE_QUEUE) {
+				LOG_ERR("No response from bmc for send post code");
 			}
-			send_postcode_start_position = send_postcode_end_position;
 		} else {
-			if (CPU_power_good() == false) {
+			pldm_send_ipmi_request(send_postcode_msg);
+		}
+	}
+
+	uint32_t overrun = get_snoop_overrun_count();
+	if (overrun != last_overrun_count) {
+		LOG_WRN("%u post code overwritten before sent to BMC", overrun - last_overrun_count);
+		last_overrun_count = overrun;
+	}
+}
+
+void send_post_code_to_BMC()
+{
+	static ipmi_msg send_postcode_msg;
+
+	while (1) {
+		/* Sleep until the snoop thread has something for us, wake up periodically only to
+		 * follow the host power state.
+		 */
+		if (k_sem_take(&snoop_postcode_sem, K_MSEC(SNOOP_IDLE_CHECK_MS)) != 0) {
+			if (get_DC_status() == 0) {
 				return;
 			}
+			if (postcode_ring_pending(&snoop_ring, send_postcode_cursor) == 0) {
+				if (CPU_power_good() == false) {
+					return;
+				}
+				continue;
+			}
+		}
+
+		wait_postcode_coalesce();
+		flush_postcode_to_BMC(&send_postcode_msg);
+		if (get_DC_status() == 0) {
+			return;
 		}
 	}
 }
 
 void init_send_postcode_thread()
 {
-	send_postcode_start_position = 0;
+	send_postcode_cursor = postcode_ring_oldest(&snoop_ring);
 	if (send_postcode_tid != NULL &&
 	    strcmp(k_thread_state_str(send_postcode_tid), "dead") != 0) {
 		return;
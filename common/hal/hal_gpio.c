@@ -20,6 +20,7 @@
 #include <logging/log.h>
 #include "hal_gpio.h"
 #include "util_sys.h"
+#include "libutil.h"
 
 LOG_MODULE_REGISTER(hal_gpio);
 
@@ -30,7 +31,34 @@ static struct gpio_callback callbacks[TOTAL_GPIO_NUM];
 static struct k_work_q gpio_work_queue;
 static K_THREAD_STACK_DEFINE(gpio_work_stack, GPIO_STACK_SIZE);
 
-struct k_work gpio_work[TOTAL_GPIO_NUM];
+/* Ring entry, seq is written last and tells the consumer that the entry is complete */
+typedef struct {
+	uint32_t seq;
+	uint32_t cycle;
+	uint8_t gpio_num;
+	uint8_t level;
+} gpio_event_entry;
+
+typedef struct {
+	uint8_t gpio_num;
+	gpio_event_handler handler;
+	void *arg;
+} gpio_event_subscriber;
+
+BUILD_ASSERT((GPIO_EVENT_RING_SIZE & (GPIO_EVENT_RING_SIZE - 1)) == 0,
+	     "gpio event ring size must be a power of two");
+
+static gpio_event_entry gpio_event_ring[GPIO_EVENT_RING_SIZE];
+/* Total entries reserved by the ISR and consumed by the work queue */
+static atomic_t gpio_event_head = ATOMIC_INIT(0);
+static atomic_t gpio_event_tail = ATOMIC_INIT(0);
+static atomic_t gpio_edge_count[TOTAL_GPIO_NUM];
+static atomic_t gpio_overflow_count[TOTAL_GPIO_NUM];
+static struct k_work gpio_event_work;
+static const GPIO_EVENT *current_event = NULL;
+
+static gpio_event_subscriber gpio_event_subscriber_list[GPIO_EVENT_MAX_SUBSCRIBER];
+K_MUTEX_DEFINE(gpio_event_mutex);
 
 uint8_t gpio_ind_to_num_table[TOTAL_GPIO_NUM];
 uint8_t gpio_ind_to_num_table_cnt;
@@ -72,45 +100,183 @@ uint32_t GPIO_MULTI_FUNC_PIN_CTL_REG_ACCESS[] = {
 };
 const int GPIO_MULTI_FUNC_CFG_SIZE = ARRAY_SIZE(GPIO_MULTI_FUNC_PIN_CTL_REG_ACCESS);
 
+/* Reserve a ring entry, only the ISR produces but GPIO groups may interrupt each other */
+static void gpio_event_put(uint8_t gpio_num, uint8_t level, uint32_t cycle)
+{
+	atomic_val_t head;
+
+	do {
+		head = atomic_get(&gpio_event_head);
+		if ((uint32_t)(head - atomic_get(&gpio_event_tail)) >= GPIO_EVENT_RING_SIZE) {
+			atomic_inc(&gpio_overflow_count[gpio_num]);
+			return;
+		}
+	} while (!atomic_cas(&gpio_event_head, head, head + 1));
+
+	gpio_event_entry *entry = &gpio_event_ring[head & (GPIO_EVENT_RING_SIZE - 1)];
+	entry->cycle = cycle;
+	entry->gpio_num = gpio_num;
+	entry->level = level;
+	compiler_barrier();
+	entry->seq = (uint32_t)head + 1;
+}
+
 void irq_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
-	uint8_t group, index, gpio_num;
-
-	if (dev == dev_gpio[GPIO_A_D]) {
-		group = GPIO_A_D;
-	} else if (dev == dev_gpio[GPIO_E_H]) {
-		group = GPIO_E_H;
-	} else if (dev == dev_gpio[GPIO_I_L]) {
-		group = GPIO_I_L;
-	} else if (dev == dev_gpio[GPIO_M_P]) {
-		group = GPIO_M_P;
-	} else if (dev == dev_gpio[GPIO_Q_T]) {
-		group = GPIO_Q_T;
-	} else if (dev == dev_gpio[GPIO_U_V]) {
-		group = GPIO_U_V;
-	} else {
+	uint32_t cycle = k_cycle_get_32();
+	uint8_t group;
+
+	for (group = 0; group < GPIO_GROUP_NUM; group++) {
+		if ((dev_gpio[group] != NULL) && (dev == dev_gpio[group])) {
+			break;
+		}
+	}
+	if (group == GPIO_GROUP_NUM) {
 		LOG_ERR("Invalid dev group for isr cb");
 		return;
 	}
 
-	for (index = 0; index < GPIO_GROUP_SIZE; index++) {
-		if ((pins >> index) & 0x1) {
-			pins = index;
+	/* Several pins of one group may be reported by the same interrupt */
+	while (pins) {
+		uint8_t index = find_lsb_set(pins) - 1;
+		uint8_t gpio_num = (group * GPIO_GROUP_SIZE) + index;
+		pins &= ~BIT(index);
+
+		atomic_inc(&gpio_edge_count[gpio_num]);
+		gpio_event_put(gpio_num, gpio_get_reg_value(gpio_num, 0), cycle);
+	}
+
+	k_work_submit_to_queue(&gpio_work_queue, &gpio_event_work);
+}
+
+static void gpio_event_dispatch(const GPIO_EVENT *event)
+{
+	gpio_event_subscriber subscriber[GPIO_EVENT_MAX_SUBSCRIBER];
+	uint8_t num = 0;
+
+	k_mutex_lock(&gpio_event_mutex, K_FOREVER);
+	for (uint8_t i = 0; i < GPIO_EVENT_MAX_SUBSCRIBER; i++) {
+		gpio_event_subscriber *p = &gpio_event_subscriber_list[i];
+		if ((p->handler != NULL) && ((p->gpio_num == event->gpio_num) ||
+					     (p->gpio_num == GPIO_EVENT_ALL_PIN))) {
+			subscriber[num++] = *p;
+		}
+	}
+	k_mutex_unlock(&gpio_event_mutex);
+
+	for (uint8_t i = 0; i < num; i++) {
+		subscriber[i].handler(event, subscriber[i].arg);
+	}
+
+	if (gpio_cfg[event->gpio_num].int_cb != NULL) {
+		current_event = event;
+		gpio_cfg[event->gpio_num].int_cb();
+		current_event = NULL;
+	}
+}
+
+static void gpio_event_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	uint32_t tail = (uint32_t)atomic_get(&gpio_event_tail);
+
+	while (tail != (uint32_t)atomic_get(&gpio_event_head)) {
+		gpio_event_entry *entry = &gpio_event_ring[tail & (GPIO_EVENT_RING_SIZE - 1)];
+		/* Reserved but still being written by an ISR that got interrupted */
+		if (entry->seq != tail + 1) {
+			k_work_submit_to_queue(&gpio_work_queue, &gpio_event_work);
 			break;
 		}
+		compiler_barrier();
+
+		GPIO_EVENT event = { .gpio_num = entry->gpio_num,
+				     .level = entry->level,
+				     .cycle = entry->cycle };
+		int64_t now_us = k_ticks_to_us_floor64(k_uptime_ticks());
+		event.timestamp_us = now_us - k_cyc_to_us_floor64(k_cycle_get_32() - event.cycle);
+
+		/* Free the entry before the handlers run, they may take a while */
+		atomic_inc(&gpio_event_tail);
+		tail++;
+
+		gpio_event_dispatch(&event);
 	}
-	if (index == GPIO_GROUP_SIZE) {
-		LOG_ERR("irq_callback: pin %x not found", pins);
-		return;
+}
+
+/* Subscribe to edges of one pin, or of every pin with GPIO_EVENT_ALL_PIN. Handlers run in the
+ * GPIO work queue, in edge order, before the pin's int_cb.
+ */
+bool gpio_event_subscribe(uint8_t gpio_num, gpio_event_handler handler, void *arg)
+{
+	CHECK_NULL_ARG_WITH_RETURN(handler, false);
+	CHECK_ARG_WITH_RETURN((gpio_num >= TOTAL_GPIO_NUM) && (gpio_num != GPIO_EVENT_ALL_PIN),
+			      false);
+
+	bool ret = false;
+	k_mutex_lock(&gpio_event_mutex, K_FOREVER);
+	for (uint8_t i = 0; i < GPIO_EVENT_MAX_SUBSCRIBER; i++) {
+		gpio_event_subscriber *p = &gpio_event_subscriber_list[i];
+		if (p->handler == NULL) {
+			p->gpio_num = gpio_num;
+			p->handler = handler;
+			p->arg = arg;
+			ret = true;
+			break;
+		}
 	}
-	gpio_num = (group * GPIO_GROUP_SIZE) + pins;
+	k_mutex_unlock(&gpio_event_mutex);
 
-	if (gpio_cfg[gpio_num].int_cb == NULL) {
-		LOG_ERR("Callback function pointer NULL for gpio num %d", gpio_num);
-		return;
+	if (!ret) {
+		LOG_ERR("No free gpio event subscriber for gpio num %d", gpio_num);
+	}
+	return ret;
+}
+
+bool gpio_event_unsubscribe(uint8_t gpio_num, gpio_event_handler handler, void *arg)
+{
+	CHECK_NULL_ARG_WITH_RETURN(handler, false);
+
+	bool ret = false;
+	k_mutex_lock(&gpio_event_mutex, K_FOREVER);
+	for (uint8_t i = 0; i < GPIO_EVENT_MAX_SUBSCRIBER; i++) {
+		gpio_event_subscriber *p = &gpio_event_subscriber_list[i];
+		if ((p->gpio_num == gpio_num) && (p->handler == handler) && (p->arg == arg)) {
+			p->handler = NULL;
+			ret = true;
+			break;
+		}
 	}
+	k_mutex_unlock(&gpio_event_mutex);
 
-	k_work_submit_to_queue(&gpio_work_queue, &gpio_work[gpio_num]);
+	return ret;
+}
+
+/* The edge being handled, valid only while a pin's int_cb runs. The pin may have changed
+ * again since, so prefer the sampled level and timestamp over reading the pin.
+ */
+const GPIO_EVENT *gpio_event_current(void)
+{
+	return current_event;
+}
+
+bool gpio_event_get_count(uint8_t gpio_num, uint32_t *edge_count, uint32_t *overflow_count)
+{
+	CHECK_NULL_ARG_WITH_RETURN(edge_count, false);
+	CHECK_NULL_ARG_WITH_RETURN(overflow_count, false);
+	CHECK_ARG_WITH_RETURN(gpio_num >= TOTAL_GPIO_NUM, false);
+
+	*edge_count = (uint32_t)atomic_get(&gpio_edge_count[gpio_num]);
+	*overflow_count = (uint32_t)atomic_get(&gpio_overflow_count[gpio_num]);
+	return true;
+}
+
+void gpio_event_reset_count(void)
+{
+	for (uint8_t i = 0; i < TOTAL_GPIO_NUM; i++) {
+		atomic_clear(&gpio_edge_count[i]);
+		atomic_clear(&gpio_overflow_count[i]);
+	}
 }
 
 static void gpio_init_cb(uint8_t gpio_num)
@@ -147,8 +313,6 @@ void gpio_cb_irq_init(uint8_t gpio_num, gpio_flags_t flags)
 	gpio_init_cb(gpio_num);
 	gpio_add_cb(gpio_num);
 	gpio_interrupt_conf(gpio_num, flags);
-
-	k_work_init(&gpio_work[gpio_num], gpio_cfg[gpio_num].int_cb);
 }
 
 uint8_t gpio_conf(uint8_t gpio_num, int dir)
@@ -273,6 +437,7 @@ int gpio_init(const struct device *args)
 	k_work_queue_start(&gpio_work_queue, gpio_work_stack, GPIO_STACK_SIZE,
 			   K_PRIO_PREEMPT(CONFIG_MAIN_THREAD_PRIORITY), NULL);
 	k_thread_name_set(&gpio_work_queue.thread, "gpio_workq");
+	k_work_init(&gpio_event_work, gpio_event_work_handler);
 
 	for (i = 0; i < TOTAL_GPIO_NUM; i++) {
 		if (gpio_cfg[i].is_init == ENABLE) {
@@ -122,6 +122,28 @@ extern char * gpio_name[];
 extern uint8_t gpio_ind_to_num_table[];
 extern uint8_t gpio_ind_to_num_table_cnt;
 
+/* Edges are recorded by the ISR into a ring drained by the GPIO work queue, so every edge is
+ * delivered in order with the time it happened even when the pin toggles again before the
+ * handler runs.
+ */
+#ifndef GPIO_EVENT_RING_SIZE
+#define GPIO_EVENT_RING_SIZE 64
+#endif
+#define GPIO_EVENT_MAX_SUBSCRIBER 16
+#define GPIO_EVENT_ALL_PIN 0xFF
+
+typedef struct _GPIO_EVENT_ {
+	uint8_t gpio_num;
+	/* Pin level sampled in the ISR */
+	uint8_t level;
+	/* Hardware cycle counter when the edge was taken, use it for fine ordering */
+	uint32_t cycle;
+	/* Uptime of the edge in microseconds */
+	int64_t timestamp_us;
+} GPIO_EVENT;
+
+typedef void (*gpio_event_handler)(const GPIO_EVENT *event, void *arg);
+
 typedef struct _SCU_CFG_ {
 	int reg;
 	int value;
@@ -138,5 +160,10 @@ uint8_t gpio_get_reg_value(uint8_t gpio_num, uint8_t reg_offset);
 uint8_t gpio_conf(uint8_t gpio_num, int dir);
 int gpio_get_direction(uint8_t gpio_num);
 void scu_init(SCU_CFG cfg[], size_t size);
+bool gpio_event_subscribe(uint8_t gpio_num, gpio_event_handler handler, void *arg);
+bool gpio_event_unsubscribe(uint8_t gpio_num, gpio_event_handler handler, void *arg);
+const GPIO_EVENT *gpio_event_current(void);
+bool gpio_event_get_count(uint8_t gpio_num, uint32_t *edge_count, uint32_t *overflow_count);
+void gpio_event_reset_count(void);
 
 #endif
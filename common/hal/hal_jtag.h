@@ -4,7 +4,7 @@
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
  * You may obtain a copy of the License at
- * 
+ *
  *     http://www.apache.org/licenses/LICENSE-2.0
  *
  * Unless required by applicable law or agreed to in writing, software
@@ -19,7 +19,12 @@
 
 #include <drivers/jtag.h>
 
+/* The TAP is moved and shifted by the controller's hardware engine whenever the state it is in is
+ * known to the controller, otherwise each TCK cycle is toggled by software. Shift data is LSB
+ * first, lastidx raises TMS on the last bit to leave the shift state.
+ */
 void jtag_set_tap(uint8_t data, uint8_t bitlength);
-void jtag_shift_data(uint16_t Wbit, uint8_t *Wdate, uint16_t Rbit, uint8_t *Rdate, uint8_t lastidx);
+void jtag_shift_data(uint16_t Wbit, const uint8_t *Wdate, uint16_t Rbit, uint8_t *Rdate,
+		     uint8_t lastidx);
 
 #endif
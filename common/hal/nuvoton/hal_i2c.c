@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include "cmsis_os2.h"
 #include "hal_i2c.h"
+#include "i2c_scheduler.h"
 #include "timer.h"
 #include "plat_i2c.h"
 #include "libutil.h"
@@ -52,8 +53,6 @@ LOG_MODULE_REGISTER(hal_i2c);
 
 static const struct device *dev_i2c[I2C_BUS_MAX_NUM];
 
-struct k_mutex i2c_mutex[I2C_BUS_MAX_NUM];
-
 int i2c_freq_set(uint8_t i2c_bus, uint8_t i2c_speed_mode, uint8_t en_slave)
 {
 	if (check_i2c_bus_valid(i2c_bus) < 0) {
@@ -99,6 +98,164 @@ int i2c_addr_set(uint8_t i2c_bus, uint8_t i2c_addr)
 	return 0;
 }
 
+/* Transfer with retry, the caller owns the bus */
+static int i2c_master_xfer(uint8_t bus, uint8_t addr, struct i2c_msg *msgs, uint8_t num_msgs,
+			   uint8_t retry)
+{
+	int ret = -1;
+	uint8_t i;
+	for (i = 0; i <= retry; i++) {
+		ret = i2c_transfer(dev_i2c[bus], msgs, num_msgs, addr);
+		if (ret == 0) {
+			break;
+		}
+	}
+
+	if (i > retry)
+		LOG_ERR("I2C %d addr 0x%x transfer retry reach max with ret %d", bus, addr, ret);
+
+	return ret;
+}
+
+/* I2C_MSG on top of the segment transfer, the response is read straight into msg->data */
+static int i2c_master_msg_xfer(I2C_MSG *msg, uint8_t retry, uint8_t type)
+{
+	struct i2c_msg msgs[2];
+	uint8_t num_msgs = 0;
+	int ret;
+
+	if (type == I2C_WRITE) {
+		msgs[0].buf = msg->data;
+		msgs[0].len = msg->tx_len;
+		msgs[0].flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+		return i2c_master_xfer(msg->bus, msg->target_addr, msgs, 1, retry);
+	}
+
+	/* The response overwrites msg->data, keep the request for the retries */
+	uint8_t tx_copy[I2C_TX_INLINE_SIZE];
+	uint8_t *txbuf = tx_copy;
+	if (msg->tx_len > I2C_TX_INLINE_SIZE) {
+		txbuf = (uint8_t *)malloc(msg->tx_len);
+		if (!txbuf) {
+			LOG_ERR("Failed to malloc txbuf");
+			return -1;
+		}
+	}
+
+	if (msg->tx_len > 0) {
+		memcpy(txbuf, msg->data, msg->tx_len);
+		msgs[num_msgs].buf = txbuf;
+		msgs[num_msgs].len = msg->tx_len;
+		msgs[num_msgs].flags = I2C_MSG_WRITE;
+		num_msgs++;
+	}
+	msgs[num_msgs].buf = msg->data;
+	msgs[num_msgs].len = msg->rx_len;
+	msgs[num_msgs].flags = I2C_MSG_READ | I2C_MSG_STOP | ((num_msgs > 0) ? I2C_MSG_RESTART : 0);
+	num_msgs++;
+
+	ret = i2c_master_xfer(msg->bus, msg->target_addr, msgs, num_msgs, retry);
+	if (ret == 0) {
+		LOG_HEXDUMP_DBG(msg->data, msg->rx_len, "rxbuf");
+	}
+
+	if (txbuf != tx_copy) {
+		SAFE_FREE(txbuf);
+	}
+	return ret;
+}
+
+int i2c_master_transfer(uint8_t bus, uint8_t addr, struct i2c_msg *msgs, uint8_t num_msgs,
+			uint8_t retry)
+{
+	CHECK_NULL_ARG_WITH_RETURN(msgs, -1);
+
+	if (check_i2c_bus_valid(bus) < 0) {
+		LOG_ERR("i2c bus %d is invalid", bus);
+		return -1;
+	}
+
+	int status = i2c_sched_acquire(bus, i2c_sched_get_thread_prio(), K_MSEC(1000));
+	if (status) {
+		LOG_ERR("I2C %d transfer get bus timeout with ret %d", bus, status);
+		return ENOLCK;
+	}
+
+	int ret = i2c_master_xfer(bus, addr, msgs, num_msgs, retry);
+
+	status = i2c_sched_release(bus);
+	if (status)
+		LOG_ERR("I2C %d transfer release bus fail with ret %d", bus, status);
+
+	return ret;
+}
+
+int i2c_master_transfer_without_mutex(uint8_t bus, uint8_t addr, struct i2c_msg *msgs,
+				      uint8_t num_msgs, uint8_t retry)
+{
+	CHECK_NULL_ARG_WITH_RETURN(msgs, -1);
+
+	if (check_i2c_bus_valid(bus) < 0) {
+		LOG_ERR("i2c bus %d is invalid", bus);
+		return -1;
+	}
+
+	return i2c_master_xfer(bus, addr, msgs, num_msgs, retry);
+}
+
+int i2c_master_write_read_buf(uint8_t bus, uint8_t addr, const uint8_t *tx_buf, uint32_t tx_len,
+			      uint8_t *rx_buf, uint32_t rx_len, uint8_t retry)
+{
+	CHECK_NULL_ARG_WITH_RETURN(rx_buf, -1);
+
+	struct i2c_msg msgs[2];
+	uint8_t num_msgs = 0;
+
+	if (tx_len > 0) {
+		CHECK_NULL_ARG_WITH_RETURN(tx_buf, -1);
+		msgs[num_msgs].buf = (uint8_t *)tx_buf;
+		msgs[num_msgs].len = tx_len;
+		msgs[num_msgs].flags = I2C_MSG_WRITE;
+		num_msgs++;
+	}
+	msgs[num_msgs].buf = rx_buf;
+	msgs[num_msgs].len = rx_len;
+	msgs[num_msgs].flags = I2C_MSG_READ | I2C_MSG_STOP | ((num_msgs > 0) ? I2C_MSG_RESTART : 0);
+	num_msgs++;
+
+	return i2c_master_transfer(bus, addr, msgs, num_msgs, retry);
+}
+
+/* Single address-only write, no retry and not counted in the device health since a NACK is the
+ * expected answer from a target that is busy, e.g. an EEPROM in its write cycle.
+ */
+int i2c_master_probe(uint8_t bus, uint8_t addr)
+{
+	if (check_i2c_bus_valid(bus) < 0) {
+		LOG_ERR("i2c bus %d is invalid", bus);
+		return -1;
+	}
+
+	int status = i2c_sched_acquire(bus, i2c_sched_get_thread_prio(), K_MSEC(1000));
+	if (status) {
+		LOG_ERR("I2C %d probe get bus timeout with ret %d", bus, status);
+		return ENOLCK;
+	}
+
+	struct i2c_msg msg;
+	uint8_t dummy;
+	msg.buf = &dummy;
+	msg.len = 0U;
+	msg.flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+	int ret = i2c_transfer(dev_i2c[bus], &msg, 1, addr);
+
+	status = i2c_sched_release(bus);
+	if (status)
+		LOG_ERR("I2C %d probe release bus fail with ret %d", bus, status);
+
+	return ret;
+}
+
 int i2c_master_read(I2C_MSG *msg, uint8_t retry)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg, -1);
@@ -123,51 +280,17 @@ int i2c_master_read(I2C_MSG *msg, uint8_t retry)
 	}
 
 	int status;
-	status = k_mutex_lock(&i2c_mutex[msg->bus], K_MSEC(1000));
+	status = i2c_sched_acquire(msg->bus, i2c_sched_get_thread_prio(), K_MSEC(1000));
 	if (status) {
-		LOG_ERR("I2C %d master read get mutex timeout with ret %d", msg->bus, status);
+		LOG_ERR("I2C %d master read get bus timeout with ret %d", msg->bus, status);
 		return ENOLCK;
 	}
 
-	int ret = -1;
-	uint8_t *txbuf = NULL, *rxbuf = NULL;
-	txbuf = (uint8_t *)malloc(I2C_BUFF_SIZE * sizeof(uint8_t));
-	if (!txbuf) {
-		LOG_ERR("Failed to malloc txbuf");
-		goto exit;
-	}
-	rxbuf = (uint8_t *)malloc(I2C_BUFF_SIZE * sizeof(uint8_t));
-	if (!rxbuf) {
-		LOG_ERR("Failed to malloc rxbuf");
-		goto exit;
-	}
-	memcpy(txbuf, &msg->data[0], msg->tx_len);
-
-	uint8_t i;
-	for (i = 0; i <= retry; i++) {
-		if (msg->tx_len > 0) {
-			ret = i2c_write_read(dev_i2c[msg->bus], msg->target_addr, txbuf,
-					     msg->tx_len, rxbuf, msg->rx_len);
-		} else {
-			ret = i2c_read(dev_i2c[msg->bus], rxbuf, msg->rx_len, msg->target_addr);
-		}
-		if (ret == 0) { // i2c write read success
-			memcpy(&msg->data[0], rxbuf, msg->rx_len);
-			LOG_HEXDUMP_DBG(msg->data, msg->rx_len, "rxbuf");
-			break;
-		}
-	}
-
-	if (i > retry)
-		LOG_ERR("I2C %d master read retry reach max with ret %d", msg->bus, ret);
-
-exit:
-	SAFE_FREE(txbuf);
-	SAFE_FREE(rxbuf);
+	int ret = i2c_master_msg_xfer(msg, retry, I2C_READ);
 
-	status = k_mutex_unlock(&i2c_mutex[msg->bus]);
+	status = i2c_sched_release(msg->bus);
 	if (status)
-		LOG_ERR("I2C %d master read release mutex fail with ret %d", msg->bus, status);
+		LOG_ERR("I2C %d master read release bus fail with ret %d", msg->bus, status);
 
 	return ret;
 }
@@ -190,37 +313,17 @@ int i2c_master_write(I2C_MSG *msg, uint8_t retry)
 	}
 
 	int status;
-	status = k_mutex_lock(&i2c_mutex[msg->bus], K_MSEC(1000));
+	status = i2c_sched_acquire(msg->bus, i2c_sched_get_thread_prio(), K_MSEC(1000));
 	if (status) {
-		LOG_ERR("I2C %d master write get mutex timeout with ret %d", msg->bus, status);
+		LOG_ERR("I2C %d master write get bus timeout with ret %d", msg->bus, status);
 		return ENOLCK;
 	}
 
-	int ret = -1;
-	uint8_t *txbuf = NULL;
-	txbuf = (uint8_t *)malloc(I2C_BUFF_SIZE * sizeof(uint8_t));
-	if (!txbuf) {
-		LOG_ERR("Failed to malloc txbuf");
-		goto exit;
-	}
-	memcpy(txbuf, &msg->data[0], msg->tx_len);
-
-	uint8_t i;
-	for (i = 0; i <= retry; i++) {
-		ret = i2c_write(dev_i2c[msg->bus], txbuf, msg->tx_len, msg->target_addr);
-		if (ret == 0) // i2c write success
-			break;
-	}
-
-	if (i > retry)
-		LOG_ERR("I2C %d master write retry reach max with ret %d", msg->bus, ret);
-
-exit:
-	SAFE_FREE(txbuf);
+	int ret = i2c_master_msg_xfer(msg, retry, I2C_WRITE);
 
-	status = k_mutex_unlock(&i2c_mutex[msg->bus]);
+	status = i2c_sched_release(msg->bus);
 	if (status)
-		LOG_ERR("I2C %d master write release mutex fail with ret %d", msg->bus, status);
+		LOG_ERR("I2C %d master write release bus fail with ret %d", msg->bus, status);
 
 	return ret;
 }
@@ -248,43 +351,7 @@ int i2c_master_read_without_mutex(I2C_MSG *msg, uint8_t retry)
 		return -1;
 	}
 
-	int ret = -1;
-	uint8_t *txbuf = NULL, *rxbuf = NULL;
-	txbuf = (uint8_t *)malloc(I2C_BUFF_SIZE * sizeof(uint8_t));
-	if (!txbuf) {
-		LOG_ERR("Failed to malloc txbuf");
-		goto exit;
-	}
-	rxbuf = (uint8_t *)malloc(I2C_BUFF_SIZE * sizeof(uint8_t));
-	if (!rxbuf) {
-		LOG_ERR("Failed to malloc rxbuf");
-		goto exit;
-	}
-	memcpy(txbuf, &msg->data[0], msg->tx_len);
-
-	uint8_t i;
-	for (i = 0; i <= retry; i++) {
-		if (msg->tx_len > 0) {
-			ret = i2c_write_read(dev_i2c[msg->bus], msg->target_addr, txbuf,
-					     msg->tx_len, rxbuf, msg->rx_len);
-		} else {
-			ret = i2c_read(dev_i2c[msg->bus], rxbuf, msg->rx_len, msg->target_addr);
-		}
-		if (ret == 0) { // i2c write read success
-			memcpy(&msg->data[0], rxbuf, msg->rx_len);
-			LOG_HEXDUMP_DBG(msg->data, msg->rx_len, "rxbuf");
-			break;
-		}
-	}
-
-	if (i > retry)
-		LOG_ERR("I2C %d master read retry reach max with ret %d", msg->bus, ret);
-
-exit:
-	SAFE_FREE(txbuf);
-	SAFE_FREE(rxbuf);
-
-	return ret;
+	return i2c_master_msg_xfer(msg, retry, I2C_READ);
 }
 
 int i2c_master_write_without_mutex(I2C_MSG *msg, uint8_t retry)
@@ -304,29 +371,38 @@ int i2c_master_write_without_mutex(I2C_MSG *msg, uint8_t retry)
 		return -1;
 	}
 
-	int ret = -1;
-	uint8_t *txbuf = NULL;
-	txbuf = (uint8_t *)malloc(I2C_BUFF_SIZE * sizeof(uint8_t));
-	if (!txbuf) {
-		LOG_ERR("Failed to malloc txbuf");
-		goto exit;
-	}
-	memcpy(txbuf, &msg->data[0], msg->tx_len);
+	return i2c_master_msg_xfer(msg, retry, I2C_WRITE);
+}
 
-	uint8_t i;
-	for (i = 0; i <= retry; i++) {
-		ret = i2c_write(dev_i2c[msg->bus], txbuf, msg->tx_len, msg->target_addr);
-		if (ret == 0) // i2c write success
-			break;
+/* Hold a bus across a sequence of transactions that must not be interleaved with other
+ * masters' ones, use the *_without_mutex functions while holding it.
+ */
+int i2c_bus_lock(uint8_t bus)
+{
+	if (check_i2c_bus_valid(bus) < 0) {
+		LOG_ERR("i2c bus %d is invalid", bus);
+		return -1;
 	}
 
-	if (i > retry)
-		LOG_ERR("I2C %d master write retry reach max with ret %d", msg->bus, ret);
+	int status = i2c_sched_acquire(bus, i2c_sched_get_thread_prio(), K_MSEC(1000));
+	if (status)
+		LOG_ERR("I2C %d get bus timeout with ret %d", bus, status);
 
-exit:
-	SAFE_FREE(txbuf);
+	return status;
+}
 
-	return ret;
+int i2c_bus_unlock(uint8_t bus)
+{
+	if (check_i2c_bus_valid(bus) < 0) {
+		LOG_ERR("i2c bus %d is invalid", bus);
+		return -1;
+	}
+
+	int status = i2c_sched_release(bus);
+	if (status)
+		LOG_ERR("I2C %d release bus fail with ret %d", bus, status);
+
+	return status;
 }
 
 void i2c_scan(uint8_t bus, uint8_t *target_addr, uint8_t *target_addr_len)
@@ -365,37 +441,25 @@ void i2c_scan(uint8_t bus, uint8_t *target_addr, uint8_t *target_addr_len)
 
 void util_init_I2C(void)
 {
-	int status;
-
 #ifdef DEV_I2C_0
 	dev_i2c[0] = device_get_binding("I2C_0");
-	status = k_mutex_init(&i2c_mutex[0]);
-	if (status)
-		LOG_ERR("i2c0 mutex init fail");
+	i2c_sched_init(0);
 #endif
 #ifdef DEV_I2C_1
 	dev_i2c[1] = device_get_binding("I2C_1");
-	status = k_mutex_init(&i2c_mutex[1]);
-	if (status)
-		LOG_ERR("i2c1 mutex init fail");
+	i2c_sched_init(1);
 #endif
 #ifdef DEV_I2C_2
 	dev_i2c[2] = device_get_binding("I2C_2");
-	status = k_mutex_init(&i2c_mutex[2]);
-	if (status)
-		LOG_ERR("i2c2 mutex init fail");
+	i2c_sched_init(2);
 #endif
 #ifdef DEV_I2C_3
 	dev_i2c[3] = device_get_binding("I2C_3");
-	status = k_mutex_init(&i2c_mutex[3]);
-	if (status)
-		LOG_ERR("i2c3 mutex init fail");
+	i2c_sched_init(3);
 #endif
 #ifdef DEV_I2C_4
 	dev_i2c[4] = device_get_binding("I2C_4");
-	status = k_mutex_init(&i2c_mutex[4]);
-	if (status)
-		LOG_ERR("i2c4 mutex init fail");
+	i2c_sched_init(4);
 #endif
 }
 
@@ -47,6 +47,8 @@
 #define DEV_I2C(n) DEV_I2C_##n
 
 #define I2C_BUFF_SIZE 256
+/* Longest write-read request kept on the stack for the retries */
+#define I2C_TX_INLINE_SIZE 16
 #define MUTEX_LOCK_ENABLE true
 #define MUTEX_LOCK_DISENABLE false
 
@@ -61,7 +63,6 @@ typedef struct _I2C_MSG_ {
 	uint8_t rx_len;
 	uint8_t tx_len;
 	uint8_t data[I2C_BUFF_SIZE];
-	struct k_mutex lock;
 } I2C_MSG;
 
 int i2c_freq_set(uint8_t i2c_bus, uint8_t i2c_speed_mode, uint8_t en_slave);
@@ -70,6 +71,20 @@ int i2c_master_read(I2C_MSG *msg, uint8_t retry);
 int i2c_master_read_without_mutex(I2C_MSG *msg, uint8_t retry);
 int i2c_master_write(I2C_MSG *msg, uint8_t retry);
 int i2c_master_write_without_mutex(I2C_MSG *msg, uint8_t retry);
+/* One transaction of caller-owned segments, addr is 7-bit. Consecutive segments of the same
+ * direction are concatenated on the bus unless I2C_MSG_RESTART is set, so a register address
+ * and its payload need no copy into one buffer.
+ */
+int i2c_master_transfer(uint8_t bus, uint8_t addr, struct i2c_msg *msgs, uint8_t num_msgs,
+			uint8_t retry);
+int i2c_master_transfer_without_mutex(uint8_t bus, uint8_t addr, struct i2c_msg *msgs,
+				      uint8_t num_msgs, uint8_t retry);
+/* tx_buf and rx_buf must not overlap, tx_len 0 is a plain read */
+int i2c_master_write_read_buf(uint8_t bus, uint8_t addr, const uint8_t *tx_buf, uint32_t tx_len,
+			      uint8_t *rx_buf, uint32_t rx_len, uint8_t retry);
+int i2c_master_probe(uint8_t bus, uint8_t addr);
+int i2c_bus_lock(uint8_t bus);
+int i2c_bus_unlock(uint8_t bus);
 void i2c_scan(uint8_t bus, uint8_t *target_addr, uint8_t *target_addr_len);
 void util_init_I2C(void);
 int check_i2c_bus_valid(uint8_t bus);
@@ -16,101 +16,224 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <zephyr.h>
 #include "hal_jtag.h"
 #include <logging/log.h>
 
 LOG_MODULE_REGISTER(hal_jtag);
 
+/* Bits moved by one hardware scan, a longer shift is split and stays in the shift state between
+ * the scans
+ */
+#define JTAG_HW_SHIFT_BYTES 64
+
 static char *jtag_device = "JTAG1";
+static const struct device *jtag_dev = NULL;
+
+/* TAP state the target is in. The hardware engine moves the TAP from the state it last drove it
+ * to, so it can only be used while no software toggle has moved the TAP behind its back.
+ */
+static enum tap_state tap_state = TAP_RESET;
+static bool is_hw_synced = false;
+
+static const struct device *get_jtag_dev()
+{
+	if (jtag_dev == NULL) {
+		jtag_dev = device_get_binding(jtag_device);
+		if (jtag_dev == NULL) {
+			LOG_ERR("JTAG device not found");
+		}
+	}
+
+	return jtag_dev;
+}
+
+static enum tap_state tap_next_state(enum tap_state state, uint8_t tms)
+{
+	switch (state) {
+	case TAP_RESET:
+		return tms ? TAP_RESET : TAP_IDLE;
+	case TAP_IDLE:
+		return tms ? TAP_DRSELECT : TAP_IDLE;
+	case TAP_DRSELECT:
+		return tms ? TAP_IRSELECT : TAP_DRCAPTURE;
+	case TAP_DRCAPTURE:
+		return tms ? TAP_DREXIT1 : TAP_DRSHIFT;
+	case TAP_DRSHIFT:
+		return tms ? TAP_DREXIT1 : TAP_DRSHIFT;
+	case TAP_DREXIT1:
+		return tms ? TAP_DRUPDATE : TAP_DRPAUSE;
+	case TAP_DRPAUSE:
+		return tms ? TAP_DREXIT2 : TAP_DRPAUSE;
+	case TAP_DREXIT2:
+		return tms ? TAP_DRUPDATE : TAP_DRSHIFT;
+	case TAP_DRUPDATE:
+		return tms ? TAP_DRSELECT : TAP_IDLE;
+	case TAP_IRSELECT:
+		return tms ? TAP_RESET : TAP_IRCAPTURE;
+	case TAP_IRCAPTURE:
+		return tms ? TAP_IREXIT1 : TAP_IRSHIFT;
+	case TAP_IRSHIFT:
+		return tms ? TAP_IREXIT1 : TAP_IRSHIFT;
+	case TAP_IREXIT1:
+		return tms ? TAP_IRUPDATE : TAP_IRPAUSE;
+	case TAP_IRPAUSE:
+		return tms ? TAP_IREXIT2 : TAP_IRPAUSE;
+	case TAP_IREXIT2:
+		return tms ? TAP_IRUPDATE : TAP_IRSHIFT;
+	case TAP_IRUPDATE:
+		return tms ? TAP_DRSELECT : TAP_IDLE;
+	default:
+		return tms ? TAP_RESET : TAP_IDLE;
+	}
+}
+
+/* States the TAP can be left in, the only ones the controller is asked to go to */
+static bool is_stable_state(enum tap_state state)
+{
+	switch (state) {
+	case TAP_RESET:
+	case TAP_IDLE:
+	case TAP_DRSHIFT:
+	case TAP_DRPAUSE:
+	case TAP_IRSHIFT:
+	case TAP_IRPAUSE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static uint8_t sw_clock(const struct device *dev, uint8_t tdi, uint8_t tms, bool is_read)
+{
+	uint8_t tdo_val = 0;
+
+	jtag_sw_xfer(dev, JTAG_TCK, 0);
+	jtag_sw_xfer(dev, JTAG_TDI, tdi);
+	jtag_sw_xfer(dev, JTAG_TMS, tms);
+	jtag_sw_xfer(dev, JTAG_TCK, 1);
+	jtag_sw_xfer(dev, JTAG_TDI, tdi);
+	jtag_sw_xfer(dev, JTAG_TMS, tms);
+	if (is_read) {
+		jtag_tdo_get(dev, &tdo_val);
+	}
+
+	return tdo_val;
+}
 
 void jtag_set_tap(uint8_t data, uint8_t bitlength)
 {
-	const struct device *dev;
-	dev = device_get_binding(jtag_device);
+	const struct device *dev = get_jtag_dev();
 	if (!dev) {
-		LOG_ERR("JTAG device not found");
 		return;
 	}
-	uint8_t value, index;
 
-	for (index = 0; index < bitlength; index++) {
-		value = data & 0x01;
+	enum tap_state end_state = tap_state;
+	for (uint8_t index = 0; index < bitlength; index++) {
+		end_state = tap_next_state(end_state, (index < 8) ? ((data >> index) & 0x01) : 0);
+	}
 
-		jtag_sw_xfer(dev, JTAG_TCK, 0);
-		jtag_sw_xfer(dev, JTAG_TDI, 0);
-		jtag_sw_xfer(dev, JTAG_TMS, value);
-		jtag_sw_xfer(dev, JTAG_TCK, 1);
-		jtag_sw_xfer(dev, JTAG_TDI, 0);
-		jtag_sw_xfer(dev, JTAG_TMS, value);
+	/* The controller takes the shortest path, which passes the same capture and update states
+	 * as the sequences debuggers send to reach a stable state. A reset resyncs it from any
+	 * state.
+	 */
+	if (is_stable_state(end_state) && (is_hw_synced || (end_state == TAP_RESET))) {
+		if (jtag_tap_set(dev, end_state) == 0) {
+			tap_state = end_state;
+			is_hw_synced = true;
+			return;
+		}
+		LOG_WRN("Failed to move TAP to state 0x%x, fall back to software", end_state);
+	}
 
+	for (uint8_t index = 0; index < bitlength; index++) {
+		sw_clock(dev, 0, data & 0x01, false);
 		data = data >> 1;
 	}
+
+	tap_state = end_state;
+	is_hw_synced = false;
 }
 
-void jtag_shift_data(uint16_t Wbit, uint8_t *Wdate, uint16_t Rbit, uint8_t *Rdate, uint8_t lastidx)
+static void copy_bits(uint8_t *dst, const uint8_t *src, uint16_t bit_num)
 {
-	const struct device *dev;
-	dev = device_get_binding(jtag_device);
-	if (!dev) {
-		LOG_ERR("JTAG device not found");
-		return;
+	memcpy(dst, src, (bit_num + 7) >> 3);
+	if (bit_num % 8) {
+		dst[bit_num >> 3] &= BIT_MASK(bit_num % 8);
 	}
+}
 
-	uint8_t value, tdo_val, TMS_val = 0;
-	uint16_t RnWbit, RnWbyte, index;
+/* Shift in chunks with the hardware engine, returns the bits shifted before a failure */
+static uint16_t hw_shift_data(const struct device *dev, uint16_t Wbit, const uint8_t *Wdate,
+			      uint16_t Rbit, uint8_t *Rdate, uint8_t lastidx)
+{
+	bool is_ir = (tap_state == TAP_IRSHIFT);
+	uint16_t RnWbit = MAX(Wbit, Rbit);
+	uint8_t tdi[JTAG_HW_SHIFT_BYTES], tdo[JTAG_HW_SHIFT_BYTES];
+	uint16_t index;
+
+	for (index = 0; index < RnWbit;) {
+		uint16_t bit_num = MIN(RnWbit - index, JTAG_HW_SHIFT_BYTES * 8);
+		enum tap_state end_state = tap_state;
+		if (lastidx && ((index + bit_num) == RnWbit)) {
+			end_state = is_ir ? TAP_IREXIT1 : TAP_DREXIT1;
+		}
 
-	RnWbit = (Wbit > Rbit) ? Wbit : Rbit;
-	RnWbyte = (RnWbit + 7) >> 3;
+		memset(tdi, 0, sizeof(tdi));
+		if (index < Wbit) {
+			copy_bits(tdi, Wdate + (index >> 3), MIN(Wbit - index, bit_num));
+		}
 
-	for (index = 0; index < RnWbit; index++) {
-		if ((Wbit != 0) && (Rbit != 0)) {
-			value = Wdate[index / 8] & 0x01;
-			if ((Wbit == 1) && (Rbit == 1)) {
-				TMS_val = lastidx;
-			}
+		int ret = is_ir ? jtag_ir_scan(dev, bit_num, tdi, tdo, end_state) :
+				  jtag_dr_scan(dev, bit_num, tdi, tdo, end_state);
+		if (ret) {
+			LOG_ERR("Failed to shift %d bits at %d, ret %d", bit_num, index, ret);
+			is_hw_synced = false;
+			break;
+		}
 
-			jtag_sw_xfer(dev, JTAG_TCK, 0);
-			jtag_sw_xfer(dev, JTAG_TDI, value);
-			jtag_sw_xfer(dev, JTAG_TMS, TMS_val);
-			jtag_sw_xfer(dev, JTAG_TCK, 1);
-			jtag_sw_xfer(dev, JTAG_TDI, value);
-			jtag_sw_xfer(dev, JTAG_TMS, TMS_val);
-			jtag_tdo_get(dev, &tdo_val);
+		if (index < Rbit) {
+			copy_bits(Rdate + (index >> 3), tdo, MIN(Rbit - index, bit_num));
+		}
 
-			Wdate[index / 8] = Wdate[index / 8] >> 1;
-			Rdate[index / 8] |= tdo_val << index % 8;
-			Wbit--;
-			Rbit--;
-		} else if (Wbit != 0) {
-			value = Wdate[index / 8] & 0x01;
-			if ((Wbit == 1)) {
-				TMS_val = lastidx;
-			}
-
-			jtag_sw_xfer(dev, JTAG_TCK, 0);
-			jtag_sw_xfer(dev, JTAG_TDI, value);
-			jtag_sw_xfer(dev, JTAG_TMS, TMS_val);
-			jtag_sw_xfer(dev, JTAG_TCK, 1);
-			jtag_sw_xfer(dev, JTAG_TDI, value);
-			jtag_sw_xfer(dev, JTAG_TMS, TMS_val);
-
-			Wdate[index / 8] = Wdate[index / 8] >> 1;
-			Wbit--;
-		} else if (Rbit != 0) {
-			if ((Rbit == 1)) {
-				TMS_val = lastidx;
-			}
-
-			jtag_sw_xfer(dev, JTAG_TCK, 0);
-			jtag_sw_xfer(dev, JTAG_TDI, 0);
-			jtag_sw_xfer(dev, JTAG_TMS, TMS_val);
-			jtag_sw_xfer(dev, JTAG_TCK, 1);
-			jtag_sw_xfer(dev, JTAG_TDI, 0);
-			jtag_sw_xfer(dev, JTAG_TMS, TMS_val);
-			jtag_tdo_get(dev, &tdo_val);
+		tap_state = end_state;
+		index += bit_num;
+	}
+
+	return index;
+}
 
+void jtag_shift_data(uint16_t Wbit, const uint8_t *Wdate, uint16_t Rbit, uint8_t *Rdate,
+		     uint8_t lastidx)
+{
+	const struct device *dev = get_jtag_dev();
+	if (!dev) {
+		return;
+	}
+
+	uint16_t RnWbit = MAX(Wbit, Rbit);
+	uint16_t index = 0;
+
+	if (is_hw_synced && ((tap_state == TAP_DRSHIFT) || (tap_state == TAP_IRSHIFT))) {
+		index = hw_shift_data(dev, Wbit, Wdate, Rbit, Rdate, lastidx);
+		if (index == RnWbit) {
+			return;
+		}
+	}
+
+	/* Not in a shift state the controller knows of, toggle the rest of the bits */
+	for (; index < RnWbit; index++) {
+		uint8_t value = (index < Wbit) ? ((Wdate[index / 8] >> (index % 8)) & 0x01) : 0;
+		uint8_t TMS_val = (index == (RnWbit - 1)) ? lastidx : 0;
+		uint8_t tdo_val = sw_clock(dev, value, TMS_val, index < Rbit);
+
+		if (index < Rbit) {
 			Rdate[index / 8] |= tdo_val << index % 8;
-			Rbit--;
 		}
 	}
+
+	if (lastidx && (RnWbit > 0)) {
+		tap_state = tap_next_state(tap_state, 1);
+		is_hw_synced = false;
+	}
 }
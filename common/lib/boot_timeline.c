@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include "boot_timeline.h"
+#include "libutil.h"
+
+#include <logging/log.h>
+
+LOG_MODULE_REGISTER(boot_timeline);
+
+#ifdef ENABLE_BOOT_TIMELINE
+
+#define BOOT_HISTORY_MAGIC 0x424F4F54 /* "BOOT" */
+
+/* Boot summaries and milestone codes live in retained RAM so a BIC reset during or after a
+ * host boot does not lose the history.
+ */
+typedef struct {
+	uint32_t magic;
+	uint8_t latest;
+	uint8_t count;
+	uint8_t milestone_num;
+	uint8_t reserved;
+	uint32_t milestone_code[BOOT_TIMELINE_MAX_MILESTONE];
+	boot_record record[BOOT_TIMELINE_HISTORY_NUM];
+	uint32_t checksum;
+} boot_history_t;
+
+static __noinit boot_history_t boot_history;
+
+static boot_code_record code_record[BOOT_TIMELINE_MAX_CODE];
+static uint16_t code_record_num = 0;
+static uint16_t last_code_index = 0;
+static uint32_t boot_start_us = 0;
+static bool is_boot_started = false;
+K_MUTEX_DEFINE(boot_timeline_mutex);
+
+__weak const uint32_t *pal_get_boot_milestone(uint8_t *num)
+{
+	*num = 0;
+	return NULL;
+}
+
+static uint32_t boot_history_checksum()
+{
+	uint32_t checksum = 0;
+	uint8_t *data = (uint8_t *)&boot_history;
+	for (int i = 0; i < offsetof(boot_history_t, checksum); i++) {
+		checksum = (checksum << 1 | checksum >> 31) + data[i];
+	}
+	return checksum;
+}
+
+static void boot_history_update_checksum()
+{
+	boot_history.checksum = boot_history_checksum();
+}
+
+static void boot_history_reset()
+{
+	uint8_t num = 0;
+	const uint32_t *milestone = pal_get_boot_milestone(&num);
+
+	memset(&boot_history, 0, sizeof(boot_history));
+	boot_history.magic = BOOT_HISTORY_MAGIC;
+	boot_history.milestone_num = MIN(num, BOOT_TIMELINE_MAX_MILESTONE);
+	if (milestone != NULL) {
+		memcpy(boot_history.milestone_code, milestone,
+		       boot_history.milestone_num * sizeof(uint32_t));
+	}
+	boot_history_update_checksum();
+}
+
+void boot_timeline_init()
+{
+	if ((boot_history.magic != BOOT_HISTORY_MAGIC) ||
+	    (boot_history.checksum != boot_history_checksum()) ||
+	    (boot_history.latest >= BOOT_TIMELINE_HISTORY_NUM) ||
+	    (boot_history.milestone_num > BOOT_TIMELINE_MAX_MILESTONE)) {
+		boot_history_reset();
+		return;
+	}
+
+	/* History kept by a firmware without platform milestones has nothing to show */
+	uint8_t num = 0;
+	pal_get_boot_milestone(&num);
+	if ((boot_history.milestone_num == 0) && (num != 0)) {
+		boot_history_reset();
+		return;
+	}
+
+	LOG_INF("Keep %d boot timeline record from retained RAM", boot_history.count);
+}
+
+/* Open a new boot record, the oldest record is dropped when history is full */
+void boot_timeline_start()
+{
+	if (k_mutex_lock(&boot_timeline_mutex, K_MSEC(1000))) {
+		LOG_ERR("Failed to lock boot timeline mutex");
+		return;
+	}
+
+	if (boot_history.count != 0) {
+		boot_history.latest = (boot_history.latest + 1) % BOOT_TIMELINE_HISTORY_NUM;
+	}
+	if (boot_history.count < BOOT_TIMELINE_HISTORY_NUM) {
+		boot_history.count++;
+	}
+
+	boot_record *record = &boot_history.record[boot_history.latest];
+	memset(record, 0, sizeof(boot_record));
+	memset(record->milestone_us, 0xFF, sizeof(record->milestone_us));
+	boot_history_update_checksum();
+
+	code_record_num = 0;
+	last_code_index = 0;
+	boot_start_us = postcode_timestamp_us();
+	is_boot_started = true;
+
+	k_mutex_unlock(&boot_timeline_mutex);
+}
+
+void boot_timeline_finish()
+{
+	if (k_mutex_lock(&boot_timeline_mutex, K_MSEC(1000))) {
+		LOG_ERR("Failed to lock boot timeline mutex");
+		return;
+	}
+
+	if (is_boot_started) {
+		boot_history.record[boot_history.latest].flags |= BOOT_RECORD_POST_COMPLETE;
+		boot_history_update_checksum();
+		is_boot_started = false;
+	}
+
+	k_mutex_unlock(&boot_timeline_mutex);
+}
+
+static boot_code_record *find_code_record(uint32_t code)
+{
+	if ((code_record_num != 0) && (code_record[last_code_index].code == code)) {
+		return &code_record[last_code_index];
+	}
+
+	for (uint16_t i = 0; i < code_record_num; i++) {
+		if (code_record[i].code == code) {
+			last_code_index = i;
+			return &code_record[i];
+		}
+	}
+
+	if (code_record_num >= BOOT_TIMELINE_MAX_CODE) {
+		return NULL;
+	}
+
+	last_code_index = code_record_num++;
+	boot_code_record *new_record = &code_record[last_code_index];
+	new_record->code = code;
+	new_record->count = 0;
+	return new_record;
+}
+
+/* Account post codes consumed from a post code ring to the current boot */
+void boot_timeline_add(const postcode_entry *entry, uint16_t num)
+{
+	CHECK_NULL_ARG(entry);
+
+	if (k_mutex_lock(&boot_timeline_mutex, K_MSEC(1000))) {
+		LOG_ERR("Failed to lock boot timeline mutex");
+		return;
+	}
+
+	if (!is_boot_started) {
+		goto exit;
+	}
+
+	boot_record *record = &boot_history.record[boot_history.latest];
+	for (uint16_t i = 0; i < num; i++) {
+		uint32_t offset_us = entry[i].timestamp_us - boot_start_us;
+		/* Left over from before DC on */
+		if ((int32_t)offset_us < 0) {
+			continue;
+		}
+
+		boot_code_record *code = find_code_record(entry[i].code);
+		if (code == NULL) {
+			record->flags |= BOOT_RECORD_CODE_OVERFLOW;
+		} else {
+			if (code->count == 0) {
+				code->first_us = offset_us;
+			}
+			code->last_us = offset_us;
+			if (code->count != UINT16_MAX) {
+				code->count++;
+			}
+		}
+
+		for (uint8_t j = 0; j < boot_history.milestone_num; j++) {
+			if ((boot_history.milestone_code[j] == entry[i].code) &&
+			    (record->milestone_us[j] == BOOT_TIMELINE_NOT_SEEN)) {
+				record->milestone_us[j] = offset_us;
+			}
+		}
+
+		record->total_us = offset_us;
+		record->last_code = entry[i].code;
+	}
+	record->code_num = code_record_num;
+	boot_history_update_checksum();
+
+exit:
+	k_mutex_unlock(&boot_timeline_mutex);
+}
+
+/* Replace the milestone codes, history is dropped since it no longer matches them */
+bool boot_timeline_set_milestone(const uint32_t *code, uint8_t num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(code, false);
+	CHECK_ARG_WITH_RETURN(num > BOOT_TIMELINE_MAX_MILESTONE, false);
+
+	if (k_mutex_lock(&boot_timeline_mutex, K_MSEC(1000))) {
+		LOG_ERR("Failed to lock boot timeline mutex");
+		return false;
+	}
+
+	memset(&boot_history, 0, sizeof(boot_history));
+	boot_history.magic = BOOT_HISTORY_MAGIC;
+	boot_history.milestone_num = num;
+	memcpy(boot_history.milestone_code, code, num * sizeof(uint32_t));
+	boot_history_update_checksum();
+	is_boot_started = false;
+
+	k_mutex_unlock(&boot_timeline_mutex);
+	return true;
+}
+
+uint8_t boot_timeline_get_milestone(uint32_t *code, uint8_t max_num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(code, 0);
+
+	if (k_mutex_lock(&boot_timeline_mutex, K_MSEC(1000))) {
+		LOG_ERR("Failed to lock boot timeline mutex");
+		return 0;
+	}
+
+	uint8_t num = MIN(boot_history.milestone_num, max_num);
+	memcpy(code, boot_history.milestone_code, num * sizeof(uint32_t));
+
+	k_mutex_unlock(&boot_timeline_mutex);
+	return num;
+}
+
+/* Get a boot summary, index 0 is the latest boot and may still be in progress */
+bool boot_timeline_get_record(uint8_t index, boot_record *record)
+{
+	CHECK_NULL_ARG_WITH_RETURN(record, false);
+
+	if (k_mutex_lock(&boot_timeline_mutex, K_MSEC(1000))) {
+		LOG_ERR("Failed to lock boot timeline mutex");
+		return false;
+	}
+
+	if (index >= boot_history.count) {
+		k_mutex_unlock(&boot_timeline_mutex);
+		return false;
+	}
+
+	uint8_t slot = (boot_history.latest + BOOT_TIMELINE_HISTORY_NUM - index) %
+		       BOOT_TIMELINE_HISTORY_NUM;
+	memcpy(record, &boot_history.record[slot], sizeof(boot_record));
+
+	k_mutex_unlock(&boot_timeline_mutex);
+	return true;
+}
+
+/* Copy per-code first and last seen time of the current boot in first-seen order */
+uint16_t boot_timeline_get_codes(uint16_t start, boot_code_record *out, uint16_t max_num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(out, 0);
+
+	if (k_mutex_lock(&boot_timeline_mutex, K_MSEC(1000))) {
+		LOG_ERR("Failed to lock boot timeline mutex");
+		return 0;
+	}
+
+	uint16_t num = 0;
+	for (; (num < max_num) && ((start + num) < code_record_num); num++) {
+		out[num] = code_record[start + num];
+	}
+
+	k_mutex_unlock(&boot_timeline_mutex);
+	return num;
+}
+
+#endif
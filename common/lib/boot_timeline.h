@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "util_postcode.h"
+
+#if defined(CONFIG_SNOOP_ASPEED) || defined(CONFIG_PCC_ASPEED)
+#define ENABLE_BOOT_TIMELINE
+#endif
+
+#ifdef ENABLE_BOOT_TIMELINE
+
+#ifndef BOOT_TIMELINE_MAX_CODE
+#define BOOT_TIMELINE_MAX_CODE 128
+#endif
+
+#define BOOT_TIMELINE_MAX_MILESTONE 8
+#define BOOT_TIMELINE_HISTORY_NUM 4
+#define BOOT_TIMELINE_NOT_SEEN 0xFFFFFFFF
+
+enum BOOT_RECORD_FLAG {
+	BOOT_RECORD_POST_COMPLETE = 0x01,
+	BOOT_RECORD_CODE_OVERFLOW = 0x02,
+};
+
+/* First and last time a post code is seen in the current boot, relative to DC on */
+typedef struct {
+	uint32_t code;
+	uint32_t first_us;
+	uint32_t last_us;
+	uint16_t count;
+} boot_code_record;
+
+/* Summary of one boot, kept in retained RAM across BIC resets */
+typedef struct {
+	uint32_t total_us;
+	uint32_t last_code;
+	uint16_t code_num;
+	uint8_t flags;
+	uint8_t reserved;
+	/* Time each milestone is first seen after DC on, BOOT_TIMELINE_NOT_SEEN if never */
+	uint32_t milestone_us[BOOT_TIMELINE_MAX_MILESTONE];
+} boot_record;
+
+/* Platform default milestones, e.g. memory training done, enter BDS */
+const uint32_t *pal_get_boot_milestone(uint8_t *num);
+
+void boot_timeline_init();
+void boot_timeline_start();
+void boot_timeline_finish();
+void boot_timeline_add(const postcode_entry *entry, uint16_t num);
+bool boot_timeline_set_milestone(const uint32_t *code, uint8_t num);
+uint8_t boot_timeline_get_milestone(uint32_t *code, uint8_t max_num);
+bool boot_timeline_get_record(uint8_t index, boot_record *record);
+uint16_t boot_timeline_get_codes(uint16_t start, boot_code_record *out, uint16_t max_num);
+
+#endif
+
+#endif
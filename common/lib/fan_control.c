@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include "fan_control.h"
+#include "libutil.h"
+#include "sensor.h"
+#include <logging/log.h>
+
+LOG_MODULE_REGISTER(fan_control);
+
+typedef struct _fan_ctrl_zone {
+	const fan_ctrl_zone_cfg *cfg;
+	fan_ctrl_profile profile;
+	/* Runtime of the profile in use, reset whenever the profile changes */
+	const fan_ctrl_profile *active;
+	uint8_t step_index;
+	int32_t integral;
+	int32_t last_err;
+	int16_t temp;
+	uint8_t duty;
+} fan_ctrl_zone;
+
+static fan_ctrl_zone zone_list[FAN_CTRL_MAX_ZONE];
+static uint8_t zone_num = 0;
+static uint8_t pwm_num = 0;
+static bool is_enabled = false;
+static bool is_init = false;
+static uint8_t last_state = FAN_CTRL_STATE_BMC;
+static int64_t bmc_last_ms = 0;
+static struct k_work_delayable fan_ctrl_work;
+K_MUTEX_DEFINE(fan_ctrl_mutex);
+
+__weak int pal_fan_ctrl_set_duty(uint8_t pwm_id, uint8_t duty)
+{
+	return -1;
+}
+
+/* Hottest readable sensor of the zone in milli degree C */
+static bool get_zone_temp(const fan_ctrl_zone_cfg *cfg, int32_t *temp)
+{
+	bool is_valid = false;
+
+	for (uint8_t i = 0; i < cfg->sensor_count; i++) {
+		int reading = 0;
+		uint8_t status = get_sensor_reading(sensor_config, sensor_config_count,
+						    cfg->sensor_num[i], &reading, GET_FROM_CACHE);
+		if ((status != SENSOR_READ_SUCCESS) && (status != SENSOR_READ_ACUR_SUCCESS)) {
+			continue;
+		}
+
+		sensor_val *sval = (sensor_val *)&reading;
+		int32_t value = sval->integer * 1000 + sval->fraction;
+		if (!is_valid || (value > *temp)) {
+			*temp = value;
+			is_valid = true;
+		}
+	}
+
+	return is_valid;
+}
+
+static uint8_t run_stepwise(fan_ctrl_zone *zone, const fan_ctrl_profile *profile, int32_t temp)
+{
+	if (profile->step_count == 0) {
+		return profile->fail_duty;
+	}
+
+	uint8_t index = MIN(zone->step_index, profile->step_count - 1);
+	while ((index + 1 < profile->step_count) &&
+	       (temp >= profile->step[index + 1].temp * 1000)) {
+		index++;
+	}
+	while ((index > 0) &&
+	       (temp < (profile->step[index].temp - profile->hysteresis) * 1000)) {
+		index--;
+	}
+
+	zone->step_index = index;
+	return profile->step[index].duty;
+}
+
+static uint8_t run_pid(fan_ctrl_zone *zone, const fan_ctrl_profile *profile, int32_t temp)
+{
+	/* Error in milli degree C, output and integral in milli duty percent */
+	int32_t err = temp - profile->setpoint * 1000;
+	int32_t max_milli = profile->max_duty * 1000;
+
+	zone->integral += (int64_t)profile->ki * err * FAN_CTRL_PERIOD_MS / 100000;
+	zone->integral = MIN(MAX(zone->integral, 0), max_milli);
+
+	int64_t out = (int64_t)profile->kp * err / 100 + zone->integral +
+		      (int64_t)profile->kd * (err - zone->last_err) * 10 / FAN_CTRL_PERIOD_MS;
+	zone->last_err = err;
+
+	return MIN(MAX(out, 0), max_milli) / 1000;
+}
+
+static void run_zone(fan_ctrl_zone *zone, bool is_failsafe)
+{
+	const fan_ctrl_profile *profile = is_failsafe ? &zone->cfg->failsafe : &zone->profile;
+	int32_t temp = 0;
+	uint8_t duty = 0;
+
+	if (zone->active != profile) {
+		zone->active = profile;
+		zone->step_index = 0;
+		zone->integral = 0;
+		zone->last_err = 0;
+	}
+
+	if (!get_zone_temp(zone->cfg, &temp)) {
+		zone->temp = FAN_CTRL_TEMP_INVALID;
+		zone->duty = profile->fail_duty;
+		return;
+	}
+
+	if (profile->type == FAN_CTRL_TYPE_PID) {
+		duty = run_pid(zone, profile, temp);
+	} else {
+		duty = run_stepwise(zone, profile, temp);
+	}
+
+	zone->temp = temp / 1000;
+	zone->duty = MIN(MAX(duty, profile->min_duty), profile->max_duty);
+}
+
+static uint8_t get_state()
+{
+	if (is_enabled) {
+		return FAN_CTRL_STATE_LOCAL;
+	}
+	return fan_ctrl_is_bmc_alive() ? FAN_CTRL_STATE_BMC : FAN_CTRL_STATE_FAILSAFE;
+}
+
+static void fan_ctrl_handler(struct k_work *work)
+{
+	uint8_t pwm_duty[FAN_CTRL_MAX_PWM] = { 0 };
+
+	k_mutex_lock(&fan_ctrl_mutex, K_FOREVER);
+
+	uint8_t state = get_state();
+	if (state != last_state) {
+		LOG_INF("Fan control state %d -> %d", last_state, state);
+	}
+
+	if (state != FAN_CTRL_STATE_BMC) {
+		for (uint8_t i = 0; i < zone_num; i++) {
+			run_zone(&zone_list[i], state == FAN_CTRL_STATE_FAILSAFE);
+			for (uint8_t pwm = 0; pwm < pwm_num; pwm++) {
+				if (zone_list[i].cfg->pwm_mask & BIT(pwm)) {
+					pwm_duty[pwm] = MAX(pwm_duty[pwm], zone_list[i].duty);
+				}
+			}
+		}
+	}
+
+	/* Release the local duty once when the BMC takes the fans back */
+	if ((state != FAN_CTRL_STATE_BMC) || (last_state != FAN_CTRL_STATE_BMC)) {
+		for (uint8_t pwm = 0; pwm < pwm_num; pwm++) {
+			pal_fan_ctrl_set_duty(pwm, pwm_duty[pwm]);
+		}
+	}
+	last_state = state;
+
+	k_mutex_unlock(&fan_ctrl_mutex);
+
+	k_work_schedule(&fan_ctrl_work, K_MSEC(FAN_CTRL_PERIOD_MS));
+}
+
+bool fan_ctrl_init(const fan_ctrl_zone_cfg *cfg, uint8_t zone_count, uint8_t pwm_count)
+{
+	CHECK_NULL_ARG_WITH_RETURN(cfg, false);
+	CHECK_ARG_WITH_RETURN(zone_count > FAN_CTRL_MAX_ZONE, false);
+	CHECK_ARG_WITH_RETURN(pwm_count > FAN_CTRL_MAX_PWM, false);
+
+	k_mutex_lock(&fan_ctrl_mutex, K_FOREVER);
+	for (uint8_t i = 0; i < zone_count; i++) {
+		memset(&zone_list[i], 0, sizeof(fan_ctrl_zone));
+		zone_list[i].cfg = &cfg[i];
+		zone_list[i].profile = cfg[i].profile;
+		zone_list[i].temp = FAN_CTRL_TEMP_INVALID;
+	}
+	zone_num = zone_count;
+	pwm_num = pwm_count;
+	/* Give the BMC a full timeout to show up after BIC boot */
+	bmc_last_ms = k_uptime_get();
+	k_mutex_unlock(&fan_ctrl_mutex);
+
+	if (!is_init) {
+		k_work_init_delayable(&fan_ctrl_work, fan_ctrl_handler);
+		is_init = true;
+	}
+	k_work_schedule(&fan_ctrl_work, K_MSEC(FAN_CTRL_PERIOD_MS));
+	return true;
+}
+
+void fan_ctrl_enable(bool enable)
+{
+	is_enabled = enable;
+	if (is_init) {
+		k_work_reschedule(&fan_ctrl_work, K_NO_WAIT);
+	}
+}
+
+bool fan_ctrl_is_enabled()
+{
+	return is_enabled;
+}
+
+uint8_t fan_ctrl_get_state()
+{
+	return get_state();
+}
+
+void fan_ctrl_bmc_heartbeat()
+{
+	bmc_last_ms = k_uptime_get();
+}
+
+bool fan_ctrl_is_bmc_alive()
+{
+	return (k_uptime_get() - bmc_last_ms) < FAN_CTRL_BMC_TIMEOUT_MS;
+}
+
+uint8_t fan_ctrl_get_zone_count()
+{
+	return zone_num;
+}
+
+static bool is_profile_valid(const fan_ctrl_profile *profile)
+{
+	if ((profile->type > FAN_CTRL_TYPE_PID) || (profile->min_duty > profile->max_duty) ||
+	    (profile->max_duty > 100) || (profile->fail_duty > 100) ||
+	    (profile->step_count > FAN_CTRL_MAX_STEP)) {
+		return false;
+	}
+
+	if (profile->type == FAN_CTRL_TYPE_STEPWISE) {
+		if (profile->step_count == 0) {
+			return false;
+		}
+		for (uint8_t i = 0; i < profile->step_count; i++) {
+			if ((profile->step[i].duty > 100) ||
+			    ((i > 0) && (profile->step[i].temp <= profile->step[i - 1].temp))) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool fan_ctrl_set_profile(uint8_t zone, const fan_ctrl_profile *profile)
+{
+	CHECK_NULL_ARG_WITH_RETURN(profile, false);
+
+	if ((zone >= zone_num) || !is_profile_valid(profile)) {
+		return false;
+	}
+
+	k_mutex_lock(&fan_ctrl_mutex, K_FOREVER);
+	zone_list[zone].profile = *profile;
+	zone_list[zone].active = NULL;
+	k_mutex_unlock(&fan_ctrl_mutex);
+	return true;
+}
+
+bool fan_ctrl_reset_profile(uint8_t zone)
+{
+	if (zone >= zone_num) {
+		return false;
+	}
+
+	k_mutex_lock(&fan_ctrl_mutex, K_FOREVER);
+	zone_list[zone].profile = zone_list[zone].cfg->profile;
+	zone_list[zone].active = NULL;
+	k_mutex_unlock(&fan_ctrl_mutex);
+	return true;
+}
+
+bool fan_ctrl_get_zone_status(uint8_t zone, fan_ctrl_zone_status *status)
+{
+	CHECK_NULL_ARG_WITH_RETURN(status, false);
+
+	if (zone >= zone_num) {
+		return false;
+	}
+
+	k_mutex_lock(&fan_ctrl_mutex, K_FOREVER);
+	status->type = (zone_list[zone].active != NULL) ? zone_list[zone].active->type :
+							    zone_list[zone].profile.type;
+	status->temp = zone_list[zone].temp;
+	status->duty = zone_list[zone].duty;
+	k_mutex_unlock(&fan_ctrl_mutex);
+	return true;
+}
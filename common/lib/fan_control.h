@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FAN_CONTROL_H
+#define FAN_CONTROL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Local closed-loop fan control.
+ *
+ * Each zone reads its temperature sensors from the sensor cache, takes the hottest one and
+ * runs either a stepwise curve or a PID loop on it. A PWM shared by several zones gets the
+ * highest zone duty, and the platform merges that with the duty requested by the BMC.
+ *
+ * The local loop is off by default and the BMC drives the fans as before. If no BMC fan
+ * request arrives for FAN_CTRL_BMC_TIMEOUT_MS, every zone falls back to its failsafe curve
+ * until the BMC comes back.
+ */
+
+#define FAN_CTRL_MAX_ZONE 4
+#define FAN_CTRL_MAX_SENSOR 4
+#define FAN_CTRL_MAX_STEP 8
+#define FAN_CTRL_MAX_PWM 8
+#define FAN_CTRL_PERIOD_MS 500
+#define FAN_CTRL_BMC_TIMEOUT_MS 30000
+#define FAN_CTRL_TEMP_INVALID INT16_MIN
+
+enum FAN_CTRL_TYPE {
+	FAN_CTRL_TYPE_STEPWISE = 0x00,
+	FAN_CTRL_TYPE_PID,
+};
+
+enum FAN_CTRL_STATE {
+	/* The BMC drives the fans */
+	FAN_CTRL_STATE_BMC = 0x00,
+	FAN_CTRL_STATE_LOCAL,
+	FAN_CTRL_STATE_FAILSAFE,
+};
+
+typedef struct _fan_ctrl_step {
+	/* Degree C, steps are in ascending order */
+	int8_t temp;
+	uint8_t duty;
+} fan_ctrl_step;
+
+typedef struct _fan_ctrl_profile {
+	uint8_t type;
+	uint8_t min_duty;
+	uint8_t max_duty;
+	/* Duty when no sensor of the zone can be read */
+	uint8_t fail_duty;
+
+	/* Stepwise, a step is left downward once the temperature is hysteresis below it */
+	uint8_t hysteresis;
+	uint8_t step_count;
+	fan_ctrl_step step[FAN_CTRL_MAX_STEP];
+
+	/* PID on the hottest sensor, gains are duty percent per degree C in 1/100 units */
+	int8_t setpoint;
+	int16_t kp;
+	int16_t ki;
+	int16_t kd;
+} fan_ctrl_profile;
+
+typedef struct _fan_ctrl_zone_cfg {
+	uint16_t sensor_num[FAN_CTRL_MAX_SENSOR];
+	uint8_t sensor_count;
+	/* Bit mask of the PWM this zone drives */
+	uint8_t pwm_mask;
+	fan_ctrl_profile profile;
+	/* Always stepwise */
+	fan_ctrl_profile failsafe;
+} fan_ctrl_zone_cfg;
+
+typedef struct _fan_ctrl_zone_status {
+	uint8_t type;
+	/* Hottest sensor in degree C, FAN_CTRL_TEMP_INVALID if none can be read */
+	int16_t temp;
+	uint8_t duty;
+} fan_ctrl_zone_status;
+
+/* Write the locally computed duty, the platform merges it with BMC requests */
+int pal_fan_ctrl_set_duty(uint8_t pwm_id, uint8_t duty);
+
+bool fan_ctrl_init(const fan_ctrl_zone_cfg *cfg, uint8_t zone_count, uint8_t pwm_count);
+void fan_ctrl_enable(bool enable);
+bool fan_ctrl_is_enabled();
+uint8_t fan_ctrl_get_state();
+void fan_ctrl_bmc_heartbeat();
+bool fan_ctrl_is_bmc_alive();
+uint8_t fan_ctrl_get_zone_count();
+bool fan_ctrl_set_profile(uint8_t zone, const fan_ctrl_profile *profile);
+bool fan_ctrl_reset_profile(uint8_t zone);
+bool fan_ctrl_get_zone_status(uint8_t zone, fan_ctrl_zone_status *status);
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "i2c_fault.h"
+#include <errno.h>
+#include <logging/log.h>
+#include <string.h>
+#include <zephyr.h>
+#include "libutil.h"
+#include "plat_i2c.h"
+
+LOG_MODULE_REGISTER(i2c_fault);
+
+static i2c_fault_rule rule_list[I2C_FAULT_MAX_RULE];
+static volatile uint8_t rule_num = 0;
+static K_MUTEX_DEFINE(i2c_fault_mutex);
+
+static i2c_fault_rule *find_rule(uint8_t bus, uint8_t addr)
+{
+	for (uint8_t i = 0; i < rule_num; i++) {
+		if ((rule_list[i].bus == bus) && (rule_list[i].addr == addr)) {
+			return &rule_list[i];
+		}
+	}
+	return NULL;
+}
+
+bool i2c_fault_set(const i2c_fault_rule *rule)
+{
+	CHECK_NULL_ARG_WITH_RETURN(rule, false);
+
+	if ((rule->bus >= I2C_BUS_MAX_NUM) || (rule->delay_us > I2C_FAULT_MAX_DELAY_US)) {
+		return false;
+	}
+
+	k_mutex_lock(&i2c_fault_mutex, K_FOREVER);
+
+	i2c_fault_rule *entry = find_rule(rule->bus, rule->addr);
+	if ((entry == NULL) && (rule_num < I2C_FAULT_MAX_RULE)) {
+		entry = &rule_list[rule_num++];
+	}
+
+	if (entry != NULL) {
+		memcpy(entry, rule, sizeof(i2c_fault_rule));
+		entry->attempt_count = 0;
+		entry->inject_count = 0;
+		LOG_WRN("I2C %d addr 0x%x fault set, delay %d us, nack interval %d, stuck %d",
+			rule->bus, rule->addr, rule->delay_us, rule->nack_interval, rule->is_stuck);
+	}
+
+	k_mutex_unlock(&i2c_fault_mutex);
+	return (entry != NULL);
+}
+
+void i2c_fault_clear(uint8_t bus)
+{
+	k_mutex_lock(&i2c_fault_mutex, K_FOREVER);
+
+	uint8_t num = 0;
+	for (uint8_t i = 0; i < rule_num; i++) {
+		if ((bus != I2C_FAULT_ALL_BUS) && (rule_list[i].bus != bus)) {
+			rule_list[num++] = rule_list[i];
+		}
+	}
+	rule_num = num;
+
+	k_mutex_unlock(&i2c_fault_mutex);
+}
+
+uint8_t i2c_fault_get_rules(i2c_fault_rule *rule, uint8_t max_num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(rule, 0);
+
+	k_mutex_lock(&i2c_fault_mutex, K_FOREVER);
+	uint8_t num = MIN(rule_num, max_num);
+	memcpy(rule, rule_list, num * sizeof(i2c_fault_rule));
+	k_mutex_unlock(&i2c_fault_mutex);
+
+	return num;
+}
+
+int i2c_fault_inject(uint8_t bus, uint8_t addr)
+{
+	/* Nothing to take a lock for on a BIC without rules */
+	if (rule_num == 0) {
+		return 0;
+	}
+
+	int ret = 0;
+	uint32_t delay_us = 0;
+
+	k_mutex_lock(&i2c_fault_mutex, K_FOREVER);
+
+	i2c_fault_rule *rule = find_rule(bus, addr);
+	if (rule == NULL) {
+		rule = find_rule(bus, I2C_FAULT_ANY_ADDR);
+	}
+
+	if (rule != NULL) {
+		rule->attempt_count++;
+		delay_us = rule->delay_us;
+		if (rule->is_stuck) {
+			ret = -ETIMEDOUT;
+		} else if ((rule->nack_interval != 0) &&
+			   ((rule->attempt_count % rule->nack_interval) == 0)) {
+			ret = -EIO;
+		}
+		if (ret) {
+			rule->inject_count++;
+		}
+	}
+
+	k_mutex_unlock(&i2c_fault_mutex);
+
+	/* Spin rather than sleep so the delay is not rounded to the tick */
+	if (delay_us) {
+		k_busy_wait(delay_us);
+	}
+
+	return ret;
+}
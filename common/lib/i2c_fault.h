@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef I2C_FAULT_H
+#define I2C_FAULT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* I2C fault injection.
+ *
+ * A rule set on a bus and 7-bit address is checked by the HAL before each transfer attempt to
+ * that target, a rule on I2C_FAULT_ANY_ADDR covers the targets of the bus without a rule of
+ * their own. The attempt is held for delay_us with the bus owned, then fails with a NACK every
+ * nack_interval attempts, or always times out while the bus is stuck. The faults are counted,
+ * so the same rules give the same sequence of results. A stuck bus stays stuck through the
+ * recoveries until its rule is cleared.
+ */
+
+#define I2C_FAULT_MAX_RULE 8
+#define I2C_FAULT_ANY_ADDR 0xFF
+#define I2C_FAULT_ALL_BUS 0xFF
+#define I2C_FAULT_MAX_DELAY_US 100000
+
+typedef struct _i2c_fault_rule {
+	uint8_t bus;
+	uint8_t addr;
+	uint32_t delay_us;
+	/* Every nack_interval-th attempt NACKs, 0 for none */
+	uint16_t nack_interval;
+	bool is_stuck;
+	uint32_t attempt_count;
+	uint32_t inject_count;
+} i2c_fault_rule;
+
+/* Replaces the rule of the same bus and address, the counters start from 0 */
+bool i2c_fault_set(const i2c_fault_rule *rule);
+/* Remove the rules of a bus, I2C_FAULT_ALL_BUS for all */
+void i2c_fault_clear(uint8_t bus);
+uint8_t i2c_fault_get_rules(i2c_fault_rule *rule, uint8_t max_num);
+/* Returns 0 to go on with the transfer, otherwise the error the attempt fails with */
+int i2c_fault_inject(uint8_t bus, uint8_t addr);
+
+#endif
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "i2c_health.h"
+#include <errno.h>
+#include <logging/log.h>
+#include <string.h>
+#include <sys/atomic.h>
+#include <zephyr.h>
+#include "libutil.h"
+#include "plat_i2c.h"
+
+LOG_MODULE_REGISTER(i2c_health);
+
+#define I2C_HEALTH_ADDR_NUM 128
+
+const uint32_t i2c_health_latency_bound_us[I2C_HEALTH_LATENCY_BUCKET_NUM] = {
+	100, 250, 500, 1000, 2500, 5000, 10000, UINT32_MAX,
+};
+
+/* Writers of a device or a bus are serialized by the bus owner, the counters are atomic only
+ * for the readers and the clear
+ */
+typedef struct _dev_entry {
+	uint8_t bus;
+	uint8_t addr;
+	atomic_t count[I2C_HEALTH_RESULT_NUM];
+	atomic_t latency[I2C_HEALTH_LATENCY_BUCKET_NUM];
+	uint8_t fail_streak;
+	uint8_t backoff_shift;
+	uint32_t quarantine_count;
+	/* Uptime in ms, valid while backoff_shift is not 0 */
+	uint32_t quarantine_until_ms;
+} dev_entry;
+
+static dev_entry dev_list[I2C_HEALTH_MAX_DEV];
+static uint8_t dev_num = 0;
+/* Entry index + 1 of each bus and 7-bit address, 0 if not seen yet */
+static uint8_t dev_map[I2C_BUS_MAX_NUM][I2C_HEALTH_ADDR_NUM];
+static i2c_bus_health bus_health[I2C_BUS_MAX_NUM];
+static atomic_t attempt_count = ATOMIC_INIT(0);
+/* Only taken to add a device and by the readers */
+static K_MUTEX_DEFINE(i2c_health_mutex);
+
+BUILD_ASSERT(I2C_HEALTH_MAX_DEV < I2C_HEALTH_NO_DEV, "Device index collides with no device");
+
+static dev_entry *get_dev(uint8_t id)
+{
+	return (id < dev_num) ? &dev_list[id] : NULL;
+}
+
+static const dev_entry *find_dev(uint8_t bus, uint8_t addr)
+{
+	if ((bus >= I2C_BUS_MAX_NUM) || (addr >= I2C_HEALTH_ADDR_NUM) ||
+	    (dev_map[bus][addr] == 0)) {
+		return NULL;
+	}
+	return &dev_list[dev_map[bus][addr] - 1];
+}
+
+uint8_t i2c_health_get_id(uint8_t bus, uint8_t addr)
+{
+	if ((bus >= I2C_BUS_MAX_NUM) || (addr >= I2C_HEALTH_ADDR_NUM)) {
+		return I2C_HEALTH_NO_DEV;
+	}
+
+	if (dev_map[bus][addr] != 0) {
+		return dev_map[bus][addr] - 1;
+	}
+
+	uint8_t id = I2C_HEALTH_NO_DEV;
+
+	k_mutex_lock(&i2c_health_mutex, K_FOREVER);
+	if (dev_map[bus][addr] != 0) {
+		id = dev_map[bus][addr] - 1;
+	} else if (dev_num < I2C_HEALTH_MAX_DEV) {
+		id = dev_num;
+		dev_entry *dev = &dev_list[id];
+		memset(dev, 0, sizeof(dev_entry));
+		dev->bus = bus;
+		dev->addr = addr;
+		/* The entry is complete before a lockless lookup can find it */
+		dev_num++;
+		compiler_barrier();
+		dev_map[bus][addr] = id + 1;
+	}
+	k_mutex_unlock(&i2c_health_mutex);
+
+	return id;
+}
+
+/* Drivers report a NACK as -EIO or -ENXIO, a timeout as -ETIMEDOUT or -EAGAIN and a lost
+ * arbitration or a bus held by someone else as -EBUSY
+ */
+uint8_t i2c_health_classify(int ret)
+{
+	switch (ret) {
+	case 0:
+		return I2C_HEALTH_SUCCESS;
+	case -EIO:
+	case -ENXIO:
+		return I2C_HEALTH_NACK;
+	case -ETIMEDOUT:
+	case -EAGAIN:
+		return I2C_HEALTH_TIMEOUT;
+	case -EBUSY:
+		return I2C_HEALTH_ARB_LOST;
+	default:
+		return I2C_HEALTH_OTHER;
+	}
+}
+
+void i2c_health_record(uint8_t bus, uint8_t id, int ret, uint32_t latency_us)
+{
+	if (bus >= I2C_BUS_MAX_NUM) {
+		return;
+	}
+
+	uint8_t result = i2c_health_classify(ret);
+
+	atomic_inc(&attempt_count);
+	dev_entry *dev = get_dev(id);
+	if (dev != NULL) {
+		atomic_inc(&dev->count[result]);
+		for (uint8_t i = 0; i < I2C_HEALTH_LATENCY_BUCKET_NUM; i++) {
+			if (latency_us <= i2c_health_latency_bound_us[i]) {
+				atomic_inc(&dev->latency[i]);
+				break;
+			}
+		}
+	}
+
+	/* A NACK still means the bus is alive */
+	if ((result == I2C_HEALTH_TIMEOUT) || (result == I2C_HEALTH_ARB_LOST)) {
+		if (bus_health[bus].stuck_streak < UINT8_MAX) {
+			bus_health[bus].stuck_streak++;
+		}
+	} else {
+		bus_health[bus].stuck_streak = 0;
+	}
+}
+
+uint32_t i2c_health_get_attempt_count()
+{
+	return (uint32_t)atomic_get(&attempt_count);
+}
+
+void i2c_health_record_xfer(uint8_t id, bool is_success)
+{
+	dev_entry *dev = get_dev(id);
+	if (dev == NULL) {
+		return;
+	}
+
+	if (is_success) {
+		if (dev->backoff_shift) {
+			LOG_INF("I2C %d addr 0x%x is back", dev->bus, dev->addr);
+		}
+		dev->fail_streak = 0;
+		dev->backoff_shift = 0;
+		return;
+	}
+
+	if (dev->fail_streak < UINT8_MAX) {
+		dev->fail_streak++;
+	}
+
+	/* A device failing its first transaction after a quarantine goes back at once */
+	if ((dev->backoff_shift > 0) || (dev->fail_streak >= I2C_HEALTH_QUARANTINE_THRESHOLD)) {
+		uint32_t quarantine_ms = I2C_HEALTH_QUARANTINE_BASE_MS << dev->backoff_shift;
+		dev->quarantine_until_ms = k_uptime_get_32() + quarantine_ms;
+		dev->quarantine_count++;
+		dev->backoff_shift = MIN(dev->backoff_shift + 1, I2C_HEALTH_QUARANTINE_MAX_SHIFT);
+		LOG_WRN("I2C %d addr 0x%x quarantined for %d ms", dev->bus, dev->addr,
+			quarantine_ms);
+	}
+}
+
+bool i2c_health_is_quarantined(uint8_t id)
+{
+	const dev_entry *dev = get_dev(id);
+
+	return (dev != NULL) && (dev->backoff_shift > 0) &&
+	       ((int32_t)(dev->quarantine_until_ms - k_uptime_get_32()) > 0);
+}
+
+bool i2c_health_need_recovery(uint8_t bus)
+{
+	if (bus >= I2C_BUS_MAX_NUM) {
+		return false;
+	}
+
+	i2c_bus_health *health = &bus_health[bus];
+	return (health->stuck_streak >= I2C_HEALTH_BUS_STUCK_THRESHOLD) &&
+	       ((health->recovery_count == 0) ||
+		((k_uptime_get() - health->last_recovery_ms) >= I2C_HEALTH_RECOVERY_INTERVAL_MS));
+}
+
+void i2c_health_record_recovery(uint8_t bus, bool is_success)
+{
+	if (bus >= I2C_BUS_MAX_NUM) {
+		return;
+	}
+
+	k_mutex_lock(&i2c_health_mutex, K_FOREVER);
+	i2c_bus_health *health = &bus_health[bus];
+	health->recovery_count++;
+	health->last_recovery_ms = k_uptime_get();
+	health->stuck_streak = 0;
+	if (!is_success) {
+		health->recovery_fail_count++;
+	}
+	k_mutex_unlock(&i2c_health_mutex);
+
+	if (is_success) {
+		LOG_WRN("I2C %d recovered", bus);
+	} else {
+		LOG_ERR("I2C %d recovery failed", bus);
+	}
+}
+
+bool i2c_health_get_bus(uint8_t bus, i2c_bus_health *health)
+{
+	CHECK_NULL_ARG_WITH_RETURN(health, false);
+
+	if (bus >= I2C_BUS_MAX_NUM) {
+		return false;
+	}
+
+	k_mutex_lock(&i2c_health_mutex, K_FOREVER);
+	memcpy(health, &bus_health[bus], sizeof(i2c_bus_health));
+	k_mutex_unlock(&i2c_health_mutex);
+	return true;
+}
+
+uint8_t i2c_health_get_dev_list(uint8_t bus, uint8_t *addr, uint8_t max_num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(addr, 0);
+
+	uint8_t num = 0;
+
+	k_mutex_lock(&i2c_health_mutex, K_FOREVER);
+	for (uint8_t i = 0; (i < dev_num) && (num < max_num); i++) {
+		if (dev_list[i].bus == bus) {
+			addr[num++] = dev_list[i].addr;
+		}
+	}
+	k_mutex_unlock(&i2c_health_mutex);
+
+	return num;
+}
+
+bool i2c_health_get_dev(uint8_t bus, uint8_t addr, i2c_dev_health *health)
+{
+	CHECK_NULL_ARG_WITH_RETURN(health, false);
+
+	const dev_entry *dev = find_dev(bus, addr);
+	if (dev == NULL) {
+		return false;
+	}
+
+	memset(health, 0, sizeof(i2c_dev_health));
+	health->bus = dev->bus;
+	health->addr = dev->addr;
+	for (uint8_t i = 0; i < I2C_HEALTH_RESULT_NUM; i++) {
+		health->count[i] = atomic_get(&dev->count[i]);
+	}
+	for (uint8_t i = 0; i < I2C_HEALTH_LATENCY_BUCKET_NUM; i++) {
+		health->latency[i] = atomic_get(&dev->latency[i]);
+	}
+	health->fail_streak = dev->fail_streak;
+	health->backoff_shift = dev->backoff_shift;
+	health->quarantine_count = dev->quarantine_count;
+	if (dev->backoff_shift > 0) {
+		int32_t remain_ms = dev->quarantine_until_ms - k_uptime_get_32();
+		health->quarantine_until_ms = k_uptime_get() + MAX(remain_ms, 0);
+	}
+
+	return true;
+}
+
+void i2c_health_clear(uint8_t bus)
+{
+	k_mutex_lock(&i2c_health_mutex, K_FOREVER);
+
+	/* Entries stay in place, a transfer in flight may still hold the id */
+	for (uint8_t i = 0; i < dev_num; i++) {
+		dev_entry *dev = &dev_list[i];
+		if ((bus != 0xFF) && (dev->bus != bus)) {
+			continue;
+		}
+		for (uint8_t j = 0; j < I2C_HEALTH_RESULT_NUM; j++) {
+			atomic_clear(&dev->count[j]);
+		}
+		for (uint8_t j = 0; j < I2C_HEALTH_LATENCY_BUCKET_NUM; j++) {
+			atomic_clear(&dev->latency[j]);
+		}
+		dev->fail_streak = 0;
+		dev->backoff_shift = 0;
+		dev->quarantine_count = 0;
+	}
+
+	for (uint8_t i = 0; i < I2C_BUS_MAX_NUM; i++) {
+		if ((bus == 0xFF) || (bus == i)) {
+			memset(&bus_health[i], 0, sizeof(i2c_bus_health));
+		}
+	}
+
+	k_mutex_unlock(&i2c_health_mutex);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef I2C_HEALTH_H
+#define I2C_HEALTH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* I2C bus and device health.
+ *
+ * Every transfer attempt is counted per (bus, 7-bit address) by result with its latency. A bus
+ * that keeps timing out or losing arbitration is considered wedged and the HAL recovers it. A
+ * device whose transactions keep failing after all retries is quarantined, transactions to it
+ * fail at once until the quarantine expires. The quarantine time doubles each time the device
+ * fails again right after it, up to I2C_HEALTH_QUARANTINE_MAX_SHIFT, and resets on a success.
+ * Threads of the I2C_SCHED_PRIO_IPMB class, IPMB and MCTP messaging, are not held back by it.
+ *
+ * A transaction looks its device up once with i2c_health_get_id() and records by id. Recording
+ * is done by the bus owner and takes no lock.
+ */
+
+#define I2C_HEALTH_MAX_DEV 64
+#define I2C_HEALTH_LATENCY_BUCKET_NUM 8
+#define I2C_HEALTH_BUS_STUCK_THRESHOLD 3
+#define I2C_HEALTH_RECOVERY_INTERVAL_MS 1000
+#define I2C_HEALTH_QUARANTINE_THRESHOLD 3
+#define I2C_HEALTH_QUARANTINE_BASE_MS 1000
+#define I2C_HEALTH_QUARANTINE_MAX_SHIFT 6
+/* Device table is full, the transaction is not counted per device */
+#define I2C_HEALTH_NO_DEV 0xFF
+
+enum I2C_HEALTH_RESULT {
+	I2C_HEALTH_SUCCESS = 0x00,
+	I2C_HEALTH_NACK,
+	I2C_HEALTH_TIMEOUT,
+	I2C_HEALTH_ARB_LOST,
+	I2C_HEALTH_OTHER,
+	I2C_HEALTH_RESULT_NUM,
+};
+
+typedef struct _i2c_dev_health {
+	uint8_t bus;
+	uint8_t addr;
+	uint32_t count[I2C_HEALTH_RESULT_NUM];
+	/* Attempt latency, bucket upper bounds are in i2c_health_latency_bound_us */
+	uint32_t latency[I2C_HEALTH_LATENCY_BUCKET_NUM];
+	uint8_t fail_streak;
+	uint8_t backoff_shift;
+	uint32_t quarantine_count;
+	int64_t quarantine_until_ms;
+} i2c_dev_health;
+
+typedef struct _i2c_bus_health {
+	uint8_t stuck_streak;
+	uint32_t recovery_count;
+	uint32_t recovery_fail_count;
+	int64_t last_recovery_ms;
+} i2c_bus_health;
+
+extern const uint32_t i2c_health_latency_bound_us[I2C_HEALTH_LATENCY_BUCKET_NUM];
+
+uint8_t i2c_health_classify(int ret);
+/* Adds the device on first use, I2C_HEALTH_NO_DEV if the table is full */
+uint8_t i2c_health_get_id(uint8_t bus, uint8_t addr);
+/* One attempt, ret is the driver return value */
+void i2c_health_record(uint8_t bus, uint8_t id, int ret, uint32_t latency_us);
+/* Attempts on all buses since boot, for callers to take the difference over a period */
+uint32_t i2c_health_get_attempt_count();
+/* One transaction after all its retries */
+void i2c_health_record_xfer(uint8_t id, bool is_success);
+bool i2c_health_is_quarantined(uint8_t id);
+bool i2c_health_need_recovery(uint8_t bus);
+void i2c_health_record_recovery(uint8_t bus, bool is_success);
+bool i2c_health_get_bus(uint8_t bus, i2c_bus_health *health);
+uint8_t i2c_health_get_dev_list(uint8_t bus, uint8_t *addr, uint8_t max_num);
+bool i2c_health_get_dev(uint8_t bus, uint8_t addr, i2c_dev_health *health);
+/* Clear counters and quarantine of a bus, 0xFF for all */
+void i2c_health_clear(uint8_t bus);
+
+#endif
@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "i2c_scheduler.h"
+#include <logging/log.h>
+#include <string.h>
+#include <sys/slist.h>
+#include <zephyr.h>
+#include "libutil.h"
+#include "plat_i2c.h"
+
+LOG_MODULE_REGISTER(i2c_scheduler);
+
+typedef struct _i2c_bus_sched {
+	bool is_init;
+	/* Thread which owns the bus, NULL when the bus is idle */
+	k_tid_t owner;
+	uint8_t nest;
+	sys_slist_t wait_list[I2C_SCHED_PRIO_NUM];
+	i2c_sched_xfer *async_xfer;
+	struct k_work async_work;
+	i2c_sched_stat stat;
+} i2c_bus_sched;
+
+typedef struct _i2c_thread_prio {
+	k_tid_t tid;
+	uint8_t prio;
+} i2c_thread_prio;
+
+static i2c_bus_sched bus_sched[I2C_BUS_MAX_NUM];
+static i2c_thread_prio thread_prio[I2C_SCHED_MAX_THREAD];
+static K_THREAD_STACK_DEFINE(i2c_sched_stack, I2C_SCHED_STACK_SIZE);
+static struct k_work_q i2c_sched_work_q;
+static bool is_work_q_init = false;
+static K_MUTEX_DEFINE(i2c_sched_mutex);
+
+static bool is_bus_valid(uint8_t bus)
+{
+	return (bus < I2C_BUS_MAX_NUM) && bus_sched[bus].is_init;
+}
+
+static bool is_bus_waiting(i2c_bus_sched *sched)
+{
+	for (uint8_t i = 0; i < I2C_SCHED_PRIO_NUM; i++) {
+		if (!sys_slist_is_empty(&sched->wait_list[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Highest class first, unless a lower class head has waited over the aging time */
+static i2c_sched_xfer *pick_next(i2c_bus_sched *sched, int64_t now)
+{
+	i2c_sched_xfer *next = NULL;
+
+	for (uint8_t i = 0; i < I2C_SCHED_PRIO_NUM; i++) {
+		sys_snode_t *node = sys_slist_peek_head(&sched->wait_list[i]);
+		if (node == NULL) {
+			continue;
+		}
+
+		i2c_sched_xfer *head = CONTAINER_OF(node, i2c_sched_xfer, node);
+		if ((next == NULL) || (((now - head->enqueue_ms) >= I2C_SCHED_AGING_MS) &&
+				       (head->enqueue_ms < next->enqueue_ms))) {
+			next = head;
+		}
+	}
+
+	return next;
+}
+
+static void enqueue(i2c_bus_sched *sched, i2c_sched_xfer *xfer)
+{
+	xfer->enqueue_ms = k_uptime_get();
+	sys_slist_append(&sched->wait_list[xfer->prio], &xfer->node);
+	sched->stat.depth[xfer->prio]++;
+	sched->stat.depth_max[xfer->prio] =
+		MAX(sched->stat.depth_max[xfer->prio], sched->stat.depth[xfer->prio]);
+}
+
+static void grant(i2c_bus_sched *sched, i2c_sched_xfer *xfer, int64_t now)
+{
+	uint32_t wait_ms = now - xfer->enqueue_ms;
+	i2c_sched_stat *stat = &sched->stat;
+
+	stat->xfer_count[xfer->prio]++;
+	stat->wait_total_ms[xfer->prio] += wait_ms;
+	stat->wait_max_ms[xfer->prio] = MAX(stat->wait_max_ms[xfer->prio], wait_ms);
+
+	sched->nest = 1;
+	if (xfer->sem != NULL) {
+		sched->owner = xfer->tid;
+		k_sem_give(xfer->sem);
+	} else {
+		sched->owner = &i2c_sched_work_q.thread;
+		sched->async_xfer = xfer;
+		k_work_submit_to_queue(&i2c_sched_work_q, &sched->async_work);
+	}
+}
+
+static void grant_next(i2c_bus_sched *sched)
+{
+	int64_t now = k_uptime_get();
+	i2c_sched_xfer *next = pick_next(sched, now);
+
+	if (next == NULL) {
+		return;
+	}
+
+	sys_slist_remove(&sched->wait_list[next->prio], NULL, &next->node);
+	sched->stat.depth[next->prio]--;
+	grant(sched, next, now);
+}
+
+static void i2c_sched_async_handler(struct k_work *work)
+{
+	i2c_bus_sched *sched = CONTAINER_OF(work, i2c_bus_sched, async_work);
+	uint8_t bus = sched - bus_sched;
+	i2c_sched_xfer *xfer = sched->async_xfer;
+
+	if (xfer->type == I2C_READ) {
+		xfer->ret = i2c_master_read_without_mutex(xfer->msg, xfer->retry);
+	} else {
+		xfer->ret = i2c_master_write_without_mutex(xfer->msg, xfer->retry);
+	}
+
+	i2c_sched_release(bus);
+
+	if (xfer->done_fn) {
+		xfer->done_fn(xfer, xfer->ret);
+	}
+}
+
+void i2c_sched_init(uint8_t bus)
+{
+	if (bus >= I2C_BUS_MAX_NUM) {
+		return;
+	}
+
+	k_mutex_lock(&i2c_sched_mutex, K_FOREVER);
+
+	if (!is_work_q_init) {
+		k_work_queue_start(&i2c_sched_work_q, i2c_sched_stack,
+				   K_THREAD_STACK_SIZEOF(i2c_sched_stack),
+				   CONFIG_MAIN_THREAD_PRIORITY, NULL);
+		k_thread_name_set(&i2c_sched_work_q.thread, "i2c_sched_workq");
+		is_work_q_init = true;
+	}
+
+	i2c_bus_sched *sched = &bus_sched[bus];
+	if (!sched->is_init) {
+		for (uint8_t i = 0; i < I2C_SCHED_PRIO_NUM; i++) {
+			sys_slist_init(&sched->wait_list[i]);
+		}
+		k_work_init(&sched->async_work, i2c_sched_async_handler);
+		sched->is_init = true;
+	}
+
+	k_mutex_unlock(&i2c_sched_mutex);
+}
+
+int i2c_sched_acquire(uint8_t bus, uint8_t prio, k_timeout_t timeout)
+{
+	if (!is_bus_valid(bus)) {
+		return -EINVAL;
+	}
+
+	i2c_bus_sched *sched = &bus_sched[bus];
+	k_tid_t tid = k_current_get();
+	prio = MIN(prio, I2C_SCHED_PRIO_NUM - 1);
+
+	k_mutex_lock(&i2c_sched_mutex, K_FOREVER);
+
+	if (sched->owner == tid) {
+		sched->nest++;
+		k_mutex_unlock(&i2c_sched_mutex);
+		return 0;
+	}
+
+	struct k_sem sem;
+	i2c_sched_xfer waiter = { .prio = prio, .sem = &sem, .tid = tid };
+	k_sem_init(&sem, 0, 1);
+
+	if ((sched->owner == NULL) && !is_bus_waiting(sched)) {
+		waiter.enqueue_ms = k_uptime_get();
+		grant(sched, &waiter, waiter.enqueue_ms);
+		k_mutex_unlock(&i2c_sched_mutex);
+		return 0;
+	}
+
+	enqueue(sched, &waiter);
+	k_mutex_unlock(&i2c_sched_mutex);
+
+	int ret = k_sem_take(&sem, timeout);
+	if (ret == 0) {
+		return 0;
+	}
+
+	k_mutex_lock(&i2c_sched_mutex, K_FOREVER);
+	/* The bus may have been granted between the timeout and the lock */
+	if (sched->owner == tid) {
+		ret = 0;
+	} else {
+		sys_slist_find_and_remove(&sched->wait_list[prio], &waiter.node);
+		sched->stat.depth[prio]--;
+		sched->stat.timeout_count[prio]++;
+	}
+	k_mutex_unlock(&i2c_sched_mutex);
+
+	return ret;
+}
+
+int i2c_sched_release(uint8_t bus)
+{
+	if (!is_bus_valid(bus)) {
+		return -EINVAL;
+	}
+
+	i2c_bus_sched *sched = &bus_sched[bus];
+
+	k_mutex_lock(&i2c_sched_mutex, K_FOREVER);
+
+	if (sched->owner != k_current_get()) {
+		k_mutex_unlock(&i2c_sched_mutex);
+		return -EPERM;
+	}
+
+	if (--sched->nest == 0) {
+		sched->owner = NULL;
+		grant_next(sched);
+	}
+
+	k_mutex_unlock(&i2c_sched_mutex);
+	return 0;
+}
+
+uint8_t i2c_sched_set_thread_prio(uint8_t prio)
+{
+	k_tid_t tid = k_current_get();
+	uint8_t old_prio = I2C_SCHED_PRIO_DEFAULT;
+	i2c_thread_prio *entry = NULL;
+
+	k_mutex_lock(&i2c_sched_mutex, K_FOREVER);
+
+	for (uint8_t i = 0; i < I2C_SCHED_MAX_THREAD; i++) {
+		if (thread_prio[i].tid == tid) {
+			entry = &thread_prio[i];
+			old_prio = entry->prio;
+			break;
+		}
+		if ((entry == NULL) && (thread_prio[i].tid == NULL)) {
+			entry = &thread_prio[i];
+		}
+	}
+
+	if (entry == NULL) {
+		LOG_WRN("No free entry to set thread i2c priority %d", prio);
+	} else if (prio == I2C_SCHED_PRIO_DEFAULT) {
+		entry->tid = NULL;
+	} else {
+		entry->tid = tid;
+		entry->prio = MIN(prio, I2C_SCHED_PRIO_NUM - 1);
+	}
+
+	k_mutex_unlock(&i2c_sched_mutex);
+	return old_prio;
+}
+
+uint8_t i2c_sched_get_thread_prio()
+{
+	k_tid_t tid = k_current_get();
+
+	for (uint8_t i = 0; i < I2C_SCHED_MAX_THREAD; i++) {
+		if (thread_prio[i].tid == tid) {
+			return thread_prio[i].prio;
+		}
+	}
+	return I2C_SCHED_PRIO_DEFAULT;
+}
+
+bool i2c_sched_submit(i2c_sched_xfer *xfer)
+{
+	CHECK_NULL_ARG_WITH_RETURN(xfer, false);
+	CHECK_NULL_ARG_WITH_RETURN(xfer->msg, false);
+
+	if (!is_bus_valid(xfer->msg->bus)) {
+		LOG_ERR("i2c bus %d is invalid", xfer->msg->bus);
+		return false;
+	}
+
+	i2c_bus_sched *sched = &bus_sched[xfer->msg->bus];
+	xfer->prio = MIN(xfer->prio, I2C_SCHED_PRIO_NUM - 1);
+	xfer->sem = NULL;
+	xfer->tid = NULL;
+
+	k_mutex_lock(&i2c_sched_mutex, K_FOREVER);
+	if ((sched->owner == NULL) && !is_bus_waiting(sched)) {
+		xfer->enqueue_ms = k_uptime_get();
+		grant(sched, xfer, xfer->enqueue_ms);
+	} else {
+		enqueue(sched, xfer);
+	}
+	k_mutex_unlock(&i2c_sched_mutex);
+
+	return true;
+}
+
+bool i2c_sched_get_stat(uint8_t bus, i2c_sched_stat *stat)
+{
+	CHECK_NULL_ARG_WITH_RETURN(stat, false);
+
+	if (!is_bus_valid(bus)) {
+		return false;
+	}
+
+	k_mutex_lock(&i2c_sched_mutex, K_FOREVER);
+	memcpy(stat, &bus_sched[bus].stat, sizeof(i2c_sched_stat));
+	k_mutex_unlock(&i2c_sched_mutex);
+	return true;
+}
+
+void i2c_sched_reset_stat(uint8_t bus)
+{
+	if (!is_bus_valid(bus)) {
+		return;
+	}
+
+	k_mutex_lock(&i2c_sched_mutex, K_FOREVER);
+	i2c_sched_stat *stat = &bus_sched[bus].stat;
+	/* Keep the current queue depth, it is state rather than a counter */
+	for (uint8_t i = 0; i < I2C_SCHED_PRIO_NUM; i++) {
+		stat->xfer_count[i] = 0;
+		stat->timeout_count[i] = 0;
+		stat->wait_total_ms[i] = 0;
+		stat->wait_max_ms[i] = 0;
+		stat->depth_max[i] = stat->depth[i];
+	}
+	k_mutex_unlock(&i2c_sched_mutex);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef I2C_SCHEDULER_H
+#define I2C_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr.h>
+#include "hal_i2c.h"
+
+/* Per-bus I2C arbitration.
+ *
+ * Masters on a bus are served one at a time in priority class order, first come first served
+ * within a class, so IPMB and sensor traffic waits for at most the transaction in progress
+ * instead of a whole firmware update. A waiter of a lower class that has waited for
+ * I2C_SCHED_AGING_MS goes ahead of newer higher class waiters, so bulk transfers still make
+ * progress on a busy bus.
+ *
+ * The class of a synchronous transaction is the one set for the calling thread, default
+ * I2C_SCHED_PRIO_SENSOR. Asynchronous transactions carry their own class and run on the
+ * scheduler work queue.
+ */
+
+#define I2C_SCHED_AGING_MS 100
+#define I2C_SCHED_MAX_THREAD 8
+#define I2C_SCHED_STACK_SIZE 1024
+
+enum I2C_SCHED_PRIO {
+	/* IPMB and MCTP messaging */
+	I2C_SCHED_PRIO_IPMB = 0x00,
+	I2C_SCHED_PRIO_SENSOR,
+	/* Firmware update and EEPROM dump */
+	I2C_SCHED_PRIO_BULK,
+	I2C_SCHED_PRIO_NUM,
+};
+
+#define I2C_SCHED_PRIO_DEFAULT I2C_SCHED_PRIO_SENSOR
+
+typedef struct _i2c_sched_xfer {
+	I2C_MSG *msg;
+	/* I2C_READ or I2C_WRITE */
+	uint8_t type;
+	uint8_t retry;
+	uint8_t prio;
+	/* Called on the scheduler work queue after the bus is released */
+	void (*done_fn)(struct _i2c_sched_xfer *xfer, int ret);
+	void *arg;
+
+	/* Owned by the scheduler */
+	sys_snode_t node;
+	int64_t enqueue_ms;
+	int ret;
+	/* Set for a synchronous waiter, given when it owns the bus */
+	struct k_sem *sem;
+	k_tid_t tid;
+} i2c_sched_xfer;
+
+typedef struct _i2c_sched_stat {
+	uint32_t xfer_count[I2C_SCHED_PRIO_NUM];
+	uint32_t timeout_count[I2C_SCHED_PRIO_NUM];
+	uint32_t wait_total_ms[I2C_SCHED_PRIO_NUM];
+	uint32_t wait_max_ms[I2C_SCHED_PRIO_NUM];
+	uint8_t depth[I2C_SCHED_PRIO_NUM];
+	uint8_t depth_max[I2C_SCHED_PRIO_NUM];
+} i2c_sched_stat;
+
+void i2c_sched_init(uint8_t bus);
+/* Recursive for the owner thread, like the bus mutex it replaces */
+int i2c_sched_acquire(uint8_t bus, uint8_t prio, k_timeout_t timeout);
+int i2c_sched_release(uint8_t bus);
+/* Returns the previous class of the calling thread */
+uint8_t i2c_sched_set_thread_prio(uint8_t prio);
+uint8_t i2c_sched_get_thread_prio();
+/* The xfer and its msg belong to the scheduler until done_fn is called */
+bool i2c_sched_submit(i2c_sched_xfer *xfer);
+bool i2c_sched_get_stat(uint8_t bus, i2c_sched_stat *stat);
+void i2c_sched_reset_stat(uint8_t bus);
+
+#endif
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "i2c_sim.h"
+#include <errno.h>
+#include <logging/log.h>
+#include <string.h>
+#include <sys/crc.h>
+#include <zephyr.h>
+#include "libutil.h"
+#include "plat_i2c.h"
+#include "pmbus.h"
+
+LOG_MODULE_REGISTER(i2c_sim);
+
+/* Start or repeated start plus the address byte with its ACK */
+#define I2C_SIM_MSG_OVERHEAD_BITS 10
+#define I2C_SIM_BYTE_BITS 9
+#define I2C_SIM_STOP_BITS 1
+/* A mux behind a mux behind a mux is as deep as the boards go */
+#define I2C_SIM_MAX_MUX_DEPTH 3
+
+#define TMP75_TEMP_REG 0x00
+#define TMP75_REG_MASK 0x03
+#define TMP75_TEMP_VAL 0x1900 /* 25 degrees */
+#define TMP75_TLOW_VAL 0x4B00
+#define TMP75_THIGH_VAL 0x5000
+
+#define NVME_MI_BASIC_MGMT_OFFSET 0x00
+#define NVME_MI_BASIC_MGMT_LEN 8
+#define NVME_MI_PEC_INDEX 7
+
+const char *const i2c_sim_dev_type_name[I2C_SIM_DEV_TYPE_MAX] = {
+	"mux", "vr", "hsc", "tmp75", "nvme",
+};
+
+static i2c_sim_dev dev_list[I2C_SIM_MAX_DEV];
+static uint8_t dev_num = 0;
+static bool is_bus_sim[I2C_BUS_MAX_NUM];
+static K_MUTEX_DEFINE(i2c_sim_mutex);
+
+static i2c_sim_dev *find_mux(uint8_t bus, uint8_t addr)
+{
+	for (uint8_t i = 0; i < dev_num; i++) {
+		if ((dev_list[i].bus == bus) && (dev_list[i].addr == addr) &&
+		    (dev_list[i].type == I2C_SIM_DEV_MUX)) {
+			return &dev_list[i];
+		}
+	}
+	return NULL;
+}
+
+static bool is_dev_reachable(const i2c_sim_dev *dev)
+{
+	for (uint8_t depth = 0; depth <= I2C_SIM_MAX_MUX_DEPTH; depth++) {
+		if (dev->mux_addr == I2C_SIM_NO_MUX) {
+			return true;
+		}
+
+		const i2c_sim_dev *mux = find_mux(dev->bus, dev->mux_addr);
+		if ((mux == NULL) || !(mux->reg & BIT(dev->mux_channel))) {
+			return false;
+		}
+		dev = mux;
+	}
+	return false;
+}
+
+/* The model that answers the address, NULL and a NACK counted when none does */
+static i2c_sim_dev *find_target(uint8_t bus, uint8_t addr)
+{
+	i2c_sim_dev *closed = NULL;
+
+	for (uint8_t i = 0; i < dev_num; i++) {
+		if ((dev_list[i].bus != bus) || (dev_list[i].addr != addr)) {
+			continue;
+		}
+		if (is_dev_reachable(&dev_list[i])) {
+			return &dev_list[i];
+		}
+		closed = &dev_list[i];
+	}
+
+	if (closed != NULL) {
+		closed->nack_count++;
+	}
+	return NULL;
+}
+
+static uint16_t pmbus_read_word(const i2c_sim_dev *dev)
+{
+	/* Linear format readings, a few amps more on each VR page so the pages tell apart */
+	switch (dev->reg) {
+	case PMBUS_PAGE:
+		return dev->page;
+	case PMBUS_VOUT_MODE:
+		return 0x17; /* linear, exponent -9 */
+	case PMBUS_READ_VIN:
+		return 12;
+	case PMBUS_READ_IIN:
+		return 2;
+	case PMBUS_READ_VOUT:
+		return (dev->type == I2C_SIM_DEV_PMBUS_HSC) ? (12 << 9) : (1 << 9);
+	case PMBUS_READ_IOUT:
+		return 20 + dev->page;
+	case PMBUS_READ_TEMPERATURE_1:
+		return 40;
+	case PMBUS_READ_POUT:
+		return 20 + dev->page;
+	case PMBUS_READ_PIN:
+		return 24;
+	default:
+		return 0;
+	}
+}
+
+static void sim_write(i2c_sim_dev *dev, const uint8_t *buf, uint16_t len)
+{
+	if (len == 0) {
+		return;
+	}
+
+	dev->reg = buf[0];
+
+	switch (dev->type) {
+	case I2C_SIM_DEV_PMBUS_VR:
+		if ((dev->reg == PMBUS_PAGE) && (len > 1) && (buf[1] < I2C_SIM_PMBUS_PAGE_NUM)) {
+			dev->page = buf[1];
+		}
+		break;
+	case I2C_SIM_DEV_TMP75:
+		dev->reg &= TMP75_REG_MASK;
+		if ((dev->reg != TMP75_TEMP_REG) && (len > 2)) {
+			dev->reg_val[dev->reg] = (buf[1] << 8) | buf[2];
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static void sim_read(i2c_sim_dev *dev, uint8_t *buf, uint16_t len)
+{
+	uint16_t val;
+
+	memset(buf, 0, len);
+
+	switch (dev->type) {
+	case I2C_SIM_DEV_MUX:
+		memset(buf, dev->reg, len);
+		break;
+	case I2C_SIM_DEV_PMBUS_VR:
+	case I2C_SIM_DEV_PMBUS_HSC:
+		/* Little endian word, a longer read gets zeros after it */
+		val = pmbus_read_word(dev);
+		buf[0] = val & 0xFF;
+		if (len > 1) {
+			buf[1] = val >> 8;
+		}
+		break;
+	case I2C_SIM_DEV_TMP75:
+		/* Big endian, the register is read again from the pointer past 2 bytes */
+		val = (dev->reg == TMP75_TEMP_REG) ? TMP75_TEMP_VAL : dev->reg_val[dev->reg];
+		for (uint16_t i = 0; i < len; i++) {
+			buf[i] = (i & 1) ? (val & 0xFF) : (val >> 8);
+		}
+		break;
+	case I2C_SIM_DEV_NVME_MI:
+		if (dev->reg == NVME_MI_BASIC_MGMT_OFFSET) {
+			/* Length, status with the drive ready, no SMART warning, 35 degrees */
+			uint8_t data[NVME_MI_BASIC_MGMT_LEN] = { 6, 0xBF, 0xFF, 35, 0, 0, 0, 0 };
+			uint8_t pec_buf[NVME_MI_PEC_INDEX + 3] = { dev->addr << 1, dev->reg,
+								   (dev->addr << 1) + 1 };
+			memcpy(pec_buf + 3, data, NVME_MI_PEC_INDEX);
+			data[NVME_MI_PEC_INDEX] = crc8(pec_buf, sizeof(pec_buf), 0x07, 0x00, false);
+			memcpy(buf, data, MIN(len, sizeof(data)));
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+bool i2c_sim_add(const i2c_sim_dev *dev)
+{
+	CHECK_NULL_ARG_WITH_RETURN(dev, false);
+
+	if ((dev->bus >= I2C_BUS_MAX_NUM) || (dev->type >= I2C_SIM_DEV_TYPE_MAX) ||
+	    (dev->latency_us > I2C_SIM_MAX_LATENCY_US) || (dev->mux_channel >= I2C_SIM_MUX_CHANNEL_NUM)) {
+		return false;
+	}
+
+	k_mutex_lock(&i2c_sim_mutex, K_FOREVER);
+
+	bool ret = (dev_num < I2C_SIM_MAX_DEV);
+	if (ret) {
+		i2c_sim_dev *entry = &dev_list[dev_num++];
+		memcpy(entry, dev, sizeof(i2c_sim_dev));
+		entry->xfer_count = 0;
+		entry->nack_count = 0;
+		entry->reg = 0;
+		entry->page = 0;
+		memset(entry->reg_val, 0, sizeof(entry->reg_val));
+		if (entry->type == I2C_SIM_DEV_TMP75) {
+			entry->reg_val[2] = TMP75_TLOW_VAL;
+			entry->reg_val[3] = TMP75_THIGH_VAL;
+		}
+		is_bus_sim[dev->bus] = true;
+		LOG_WRN("I2C %d addr 0x%x simulated as %s, mux 0x%x channel %d, latency %d us",
+			dev->bus, dev->addr, i2c_sim_dev_type_name[dev->type], dev->mux_addr,
+			dev->mux_channel, dev->latency_us);
+	}
+
+	k_mutex_unlock(&i2c_sim_mutex);
+	return ret;
+}
+
+void i2c_sim_clear(uint8_t bus)
+{
+	k_mutex_lock(&i2c_sim_mutex, K_FOREVER);
+
+	uint8_t num = 0;
+	for (uint8_t i = 0; i < dev_num; i++) {
+		if ((bus != I2C_SIM_ALL_BUS) && (dev_list[i].bus != bus)) {
+			dev_list[num++] = dev_list[i];
+		}
+	}
+	dev_num = num;
+
+	for (uint8_t i = 0; i < I2C_BUS_MAX_NUM; i++) {
+		if ((bus == I2C_SIM_ALL_BUS) || (bus == i)) {
+			is_bus_sim[i] = false;
+		}
+	}
+
+	k_mutex_unlock(&i2c_sim_mutex);
+}
+
+uint8_t i2c_sim_get_devs(i2c_sim_dev *dev, uint8_t max_num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(dev, 0);
+
+	k_mutex_lock(&i2c_sim_mutex, K_FOREVER);
+	uint8_t num = MIN(dev_num, max_num);
+	memcpy(dev, dev_list, num * sizeof(i2c_sim_dev));
+	k_mutex_unlock(&i2c_sim_mutex);
+
+	return num;
+}
+
+bool i2c_sim_has_dev(uint8_t bus, uint8_t addr)
+{
+	bool ret = false;
+
+	k_mutex_lock(&i2c_sim_mutex, K_FOREVER);
+	for (uint8_t i = 0; i < dev_num; i++) {
+		if ((dev_list[i].bus == bus) && (dev_list[i].addr == addr)) {
+			ret = true;
+			break;
+		}
+	}
+	k_mutex_unlock(&i2c_sim_mutex);
+
+	return ret;
+}
+
+bool i2c_sim_is_bus_sim(uint8_t bus)
+{
+	return (bus < I2C_BUS_MAX_NUM) && is_bus_sim[bus];
+}
+
+int i2c_sim_transfer(uint8_t bus, uint8_t addr, struct i2c_msg *msgs, uint8_t num_msgs,
+		     uint32_t bitrate)
+{
+	CHECK_NULL_ARG_WITH_RETURN(msgs, -EINVAL);
+	CHECK_ARG_WITH_RETURN(bitrate == 0, -EINVAL);
+
+	int ret = 0;
+	uint64_t bits = I2C_SIM_STOP_BITS;
+	uint32_t latency_us = 0;
+
+	k_mutex_lock(&i2c_sim_mutex, K_FOREVER);
+
+	i2c_sim_dev *dev = find_target(bus, addr);
+	if (dev == NULL) {
+		/* The address byte goes out and is not acked */
+		bits += I2C_SIM_MSG_OVERHEAD_BITS;
+		ret = -EIO;
+	} else {
+		for (uint8_t i = 0; i < num_msgs; i++) {
+			bits += I2C_SIM_MSG_OVERHEAD_BITS + (msgs[i].len * I2C_SIM_BYTE_BITS);
+			if (msgs[i].flags & I2C_MSG_READ) {
+				sim_read(dev, msgs[i].buf, msgs[i].len);
+			} else {
+				sim_write(dev, msgs[i].buf, msgs[i].len);
+			}
+		}
+		dev->xfer_count++;
+		latency_us = dev->latency_us;
+	}
+
+	k_mutex_unlock(&i2c_sim_mutex);
+
+	/* Spin rather than sleep so the bus time is not rounded to the tick */
+	k_busy_wait(latency_us + (uint32_t)((bits * 1000000) / bitrate));
+
+	return ret;
+}
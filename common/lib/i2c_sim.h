@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef I2C_SIM_H
+#define I2C_SIM_H
+
+#include <drivers/i2c.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Simulated I2C devices.
+ *
+ * Once a model is added on a bus the HAL hands every transfer on that bus to the models instead
+ * of the controller, so a sensor sweep runs with the same timing on every BIC. A transfer takes
+ * the wire time of its bytes at the bus speed plus the latency of the model, an address without
+ * a model NACKs. A model behind a mux only answers while its channel is enabled in the mux
+ * control register. NACKs and a stuck bus are injected on the models with the i2c_fault rules,
+ * which are checked before the transfer gets here.
+ */
+
+#define I2C_SIM_MAX_DEV 32
+#define I2C_SIM_NO_MUX 0
+#define I2C_SIM_ALL_BUS 0xFF
+#define I2C_SIM_MAX_LATENCY_US 10000
+#define I2C_SIM_MUX_CHANNEL_NUM 8
+#define I2C_SIM_PMBUS_PAGE_NUM 4
+
+enum I2C_SIM_DEV_TYPE {
+	/* TCA9548 and PCA984x, a control register with a bit per channel */
+	I2C_SIM_DEV_MUX,
+	/* PMBus VR, PAGE selects the rail the commands after it go to */
+	I2C_SIM_DEV_PMBUS_VR,
+	/* PMBus hot swap controller, one page */
+	I2C_SIM_DEV_PMBUS_HSC,
+	/* TMP75 class temperature sensor with a pointer register */
+	I2C_SIM_DEV_TMP75,
+	/* NVMe-MI basic management command over SMBus */
+	I2C_SIM_DEV_NVME_MI,
+	I2C_SIM_DEV_TYPE_MAX,
+};
+
+typedef struct _i2c_sim_dev {
+	uint8_t bus;
+	uint8_t addr;
+	uint8_t type;
+	/* 7-bit address of the mux in front of the model on the same bus and its channel */
+	uint8_t mux_addr;
+	uint8_t mux_channel;
+	/* Added to the wire time of each transfer, the way a target stretches the clock */
+	uint16_t latency_us;
+	uint32_t xfer_count;
+	uint32_t nack_count;
+
+	/* Model state: command or pointer register, PMBus page and written registers */
+	uint8_t reg;
+	uint8_t page;
+	uint16_t reg_val[4];
+} i2c_sim_dev;
+
+extern const char *const i2c_sim_dev_type_name[I2C_SIM_DEV_TYPE_MAX];
+
+/* Adds a model, the same address can be added again behind another mux channel */
+bool i2c_sim_add(const i2c_sim_dev *dev);
+/* Remove the models of a bus, I2C_SIM_ALL_BUS for all */
+void i2c_sim_clear(uint8_t bus);
+uint8_t i2c_sim_get_devs(i2c_sim_dev *dev, uint8_t max_num);
+bool i2c_sim_has_dev(uint8_t bus, uint8_t addr);
+bool i2c_sim_is_bus_sim(uint8_t bus);
+/* Runs the transfer on the models of the bus, returns 0 or the error the transfer fails with */
+int i2c_sim_transfer(uint8_t bus, uint8_t addr, struct i2c_msg *msgs, uint8_t num_msgs,
+		     uint32_t bitrate);
+
+#endif
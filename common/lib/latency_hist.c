@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "latency_hist.h"
+#include <logging/log.h>
+#include <string.h>
+#include <zephyr.h>
+#include "libutil.h"
+
+LOG_MODULE_REGISTER(latency_hist);
+
+typedef struct _latency_hist_entry {
+	uint8_t group;
+	uint16_t key;
+	latency_hist hist;
+} latency_hist_entry;
+
+const char *const latency_hist_group_name[LATENCY_HIST_GROUP_NUM] = {
+	"ipmb", "mctp_rx", "pldm_req", "pldm_cmd", "sensor", "i2c",
+};
+
+static latency_hist_entry entry_list[LATENCY_HIST_MAX_ENTRY];
+static uint8_t entry_num = 0;
+static uint32_t dropped_count = 0;
+static K_MUTEX_DEFINE(latency_hist_mutex);
+
+static latency_hist_entry *find_entry(uint8_t group, uint16_t key, bool is_add)
+{
+	for (uint8_t i = 0; i < entry_num; i++) {
+		if ((entry_list[i].group == group) && (entry_list[i].key == key)) {
+			return &entry_list[i];
+		}
+	}
+
+	if (!is_add || (entry_num >= LATENCY_HIST_MAX_ENTRY)) {
+		return NULL;
+	}
+
+	latency_hist_entry *entry = &entry_list[entry_num++];
+	memset(entry, 0, sizeof(latency_hist_entry));
+	entry->group = group;
+	entry->key = key;
+	return entry;
+}
+
+static uint8_t get_bucket(uint32_t latency_us)
+{
+	uint8_t bucket = (latency_us == 0) ? 0 : (32 - __builtin_clz(latency_us));
+	return MIN(bucket, LATENCY_HIST_BUCKET_NUM - 1);
+}
+
+void latency_hist_add(latency_hist *hist, uint32_t value)
+{
+	CHECK_NULL_ARG(hist);
+
+	hist->count++;
+	hist->total_us += value;
+	hist->max_us = MAX(hist->max_us, value);
+	hist->bucket[get_bucket(value)]++;
+}
+
+void latency_hist_record(uint8_t group, uint16_t key, uint32_t latency_us)
+{
+	if (group >= LATENCY_HIST_GROUP_NUM) {
+		return;
+	}
+
+	k_mutex_lock(&latency_hist_mutex, K_FOREVER);
+
+	latency_hist_entry *entry = find_entry(group, key, true);
+	if (entry == NULL) {
+		dropped_count++;
+		k_mutex_unlock(&latency_hist_mutex);
+		return;
+	}
+
+	latency_hist_add(&entry->hist, latency_us);
+
+	k_mutex_unlock(&latency_hist_mutex);
+}
+
+void latency_hist_record_since(uint8_t group, uint16_t key, uint32_t start_cycle)
+{
+	latency_hist_record(group, key, k_cyc_to_us_floor32(k_cycle_get_32() - start_cycle));
+}
+
+uint8_t latency_hist_get_keys(uint8_t group, uint16_t *key, uint8_t max_num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(key, 0);
+
+	uint8_t num = 0;
+
+	k_mutex_lock(&latency_hist_mutex, K_FOREVER);
+	for (uint8_t i = 0; (i < entry_num) && (num < max_num); i++) {
+		if (entry_list[i].group == group) {
+			key[num++] = entry_list[i].key;
+		}
+	}
+	k_mutex_unlock(&latency_hist_mutex);
+
+	return num;
+}
+
+bool latency_hist_get(uint8_t group, uint16_t key, latency_hist *hist)
+{
+	CHECK_NULL_ARG_WITH_RETURN(hist, false);
+
+	k_mutex_lock(&latency_hist_mutex, K_FOREVER);
+	latency_hist_entry *entry = find_entry(group, key, false);
+	if (entry != NULL) {
+		memcpy(hist, &entry->hist, sizeof(latency_hist));
+	}
+	k_mutex_unlock(&latency_hist_mutex);
+
+	return (entry != NULL);
+}
+
+uint32_t latency_hist_percentile(const latency_hist *hist, uint8_t percent)
+{
+	CHECK_NULL_ARG_WITH_RETURN(hist, 0);
+
+	if (hist->count == 0) {
+		return 0;
+	}
+
+	uint64_t target = ((uint64_t)hist->count * percent + 99) / 100;
+	uint64_t sum = 0;
+
+	for (uint8_t i = 0; i < LATENCY_HIST_BUCKET_NUM - 1; i++) {
+		sum += hist->bucket[i];
+		if (sum >= target) {
+			return BIT(i);
+		}
+	}
+
+	return UINT32_MAX;
+}
+
+uint32_t latency_hist_get_dropped()
+{
+	return dropped_count;
+}
+
+void latency_hist_clear(uint8_t group)
+{
+	k_mutex_lock(&latency_hist_mutex, K_FOREVER);
+
+	uint8_t num = 0;
+	for (uint8_t i = 0; i < entry_num; i++) {
+		if ((group != LATENCY_HIST_ALL_GROUP) && (entry_list[i].group != group)) {
+			entry_list[num++] = entry_list[i];
+		}
+	}
+	entry_num = num;
+	dropped_count = 0;
+
+	k_mutex_unlock(&latency_hist_mutex);
+}
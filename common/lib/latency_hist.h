@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Latency histograms of the message and sensor hot paths.
+ *
+ * Each histogram is kept per (group, key) and created on the first sample. Bucket 0 counts
+ * samples under 1 us and bucket n samples from 2^(n-1) up to 2^n us, the last bucket takes
+ * everything longer. Samples of new keys are dropped once LATENCY_HIST_MAX_ENTRY histograms
+ * exist.
+ */
+
+#define LATENCY_HIST_MAX_ENTRY 48
+#define LATENCY_HIST_BUCKET_NUM 24
+#define LATENCY_HIST_ALL_GROUP 0xFF
+
+enum LATENCY_HIST_GROUP {
+	/* Request sent by BIC to its response, key is the IPMB channel index */
+	LATENCY_HIST_IPMB = 0x00,
+	/* Complete message received to rx_cb done, key is the MCTP message type */
+	LATENCY_HIST_MCTP_RX,
+	/* Request sent by BIC to its response, key is PLDM type << 8 | command */
+	LATENCY_HIST_PLDM_REQ,
+	/* Request received to response sent, key is PLDM type << 8 | command. Responses sent
+	 * later by the handler are not counted.
+	 */
+	LATENCY_HIST_PLDM_CMD,
+	/* Pre read hook and driver read of GET_FROM_SENSOR, key is the sensor driver type */
+	LATENCY_HIST_SENSOR,
+	/* One I2C transfer attempt, key is the bus */
+	LATENCY_HIST_I2C,
+	LATENCY_HIST_GROUP_NUM,
+};
+
+typedef struct _latency_hist {
+	uint32_t count;
+	uint32_t max_us;
+	uint64_t total_us;
+	uint32_t bucket[LATENCY_HIST_BUCKET_NUM];
+} latency_hist;
+
+extern const char *const latency_hist_group_name[LATENCY_HIST_GROUP_NUM];
+
+/* Add a sample to a histogram kept by the caller, the buckets count any unit */
+void latency_hist_add(latency_hist *hist, uint32_t value);
+void latency_hist_record(uint8_t group, uint16_t key, uint32_t latency_us);
+/* Record the time since start_cycle, a k_cycle_get_32() value */
+void latency_hist_record_since(uint8_t group, uint16_t key, uint32_t start_cycle);
+uint8_t latency_hist_get_keys(uint8_t group, uint16_t *key, uint8_t max_num);
+bool latency_hist_get(uint8_t group, uint16_t key, latency_hist *hist);
+/* Upper bound in us of the bucket holding the given percentile, UINT32_MAX for the last one */
+uint32_t latency_hist_percentile(const latency_hist *hist, uint8_t percent);
+uint32_t latency_hist_get_dropped();
+/* Remove the histograms of a group, LATENCY_HIST_ALL_GROUP for all */
+void latency_hist_clear(uint8_t group);
+
+#endif
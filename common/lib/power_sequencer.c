@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "power_sequencer.h"
+#include <logging/log.h>
+#include <sys/slist.h>
+#include <zephyr.h>
+#include "hal_gpio.h"
+#include "libutil.h"
+
+LOG_MODULE_REGISTER(power_sequencer);
+
+static K_THREAD_STACK_DEFINE(power_seq_stack, POWER_SEQ_STACK_SIZE);
+static struct k_work_q power_seq_work_q;
+static sys_slist_t power_seq_list = SYS_SLIST_STATIC_INIT(&power_seq_list);
+static bool is_power_seq_q_init = false;
+static K_MUTEX_DEFINE(power_seq_list_mutex);
+
+static bool is_gpio_good(const power_seq_gpio *gpio, uint8_t num)
+{
+	for (uint8_t i = 0; i < num; i++) {
+		if (gpio_get(gpio[i].gpio_num) != gpio[i].level) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool is_stage_good(power_seq *seq, const power_seq_stage *stage)
+{
+	if (!is_gpio_good(stage->pwrgd, stage->pwrgd_num)) {
+		return false;
+	}
+	return (stage->check == NULL) || stage->check(seq);
+}
+
+static void log_stage_fail(power_seq *seq, const power_seq_stage *stage)
+{
+	for (uint8_t i = 0; i < stage->pwrgd_num; i++) {
+		if (gpio_get(stage->pwrgd[i].gpio_num) != stage->pwrgd[i].level) {
+			LOG_ERR("%s stage %s gpio %d is not %d after %d ms", seq->name, stage->name,
+				stage->pwrgd[i].gpio_num, stage->pwrgd[i].level,
+				stage->max_delay_ms);
+			return;
+		}
+	}
+	LOG_ERR("%s stage %s check failed after %d ms", seq->name, stage->name,
+		stage->max_delay_ms);
+}
+
+static void start_stage(power_seq *seq, uint8_t index, int64_t now)
+{
+	const power_seq_stage *stage = &seq->stage[index];
+
+	for (uint8_t i = 0; i < stage->enable_num; i++) {
+		if (gpio_get(stage->enable[i].gpio_num) != stage->enable[i].level) {
+			gpio_set(stage->enable[i].gpio_num, stage->enable[i].level);
+		}
+	}
+	if (stage->enter) {
+		stage->enter(seq);
+	}
+
+	seq->started |= BIT(index);
+	seq->start_ms[index] = now;
+	LOG_DBG("%s stage %s start", seq->name, stage->name);
+}
+
+/* One pass over the table, returns true if any stage changed state */
+static bool run_stages(power_seq *seq, int64_t *wake_ms)
+{
+	bool is_progress = false;
+
+	for (uint8_t i = seq->first_stage; i < seq->stage_num; i++) {
+		const power_seq_stage *stage = &seq->stage[i];
+		uint32_t bit = BIT(i);
+		int64_t now = k_uptime_get();
+
+		if ((seq->finished | seq->stopped) & bit) {
+			continue;
+		}
+
+		if (!(seq->started & bit)) {
+			if (stage->depend & seq->stopped) {
+				seq->stopped |= bit;
+				is_progress = true;
+				continue;
+			}
+			if (stage->depend & ~seq->finished) {
+				continue;
+			}
+			if (stage->condition && !stage->condition(seq)) {
+				if (stage->flags & POWER_SEQ_FLAG_SKIP) {
+					LOG_DBG("%s stage %s skip", seq->name, stage->name);
+					seq->finished |= bit;
+				} else {
+					LOG_INF("%s stop at stage %s", seq->name, stage->name);
+					seq->stopped |= bit;
+				}
+				is_progress = true;
+				continue;
+			}
+			start_stage(seq, i, now);
+			is_progress = true;
+		}
+
+		int64_t elapsed = now - seq->start_ms[i];
+		if ((elapsed >= stage->min_delay_ms) && is_stage_good(seq, stage)) {
+			if (stage->exit) {
+				stage->exit(seq);
+			}
+			seq->finished |= bit;
+			is_progress = true;
+			LOG_DBG("%s stage %s done in %d ms", seq->name, stage->name, (int)elapsed);
+			continue;
+		}
+
+		if (elapsed >= MAX(stage->min_delay_ms, stage->max_delay_ms)) {
+			log_stage_fail(seq, stage);
+			seq->result = POWER_SEQ_FAILED;
+			seq->failed_stage = i;
+			return false;
+		}
+
+		int64_t next_ms;
+		if (elapsed < stage->min_delay_ms) {
+			next_ms = seq->start_ms[i] + stage->min_delay_ms;
+		} else {
+			next_ms = seq->start_ms[i] + stage->max_delay_ms;
+			if (!(stage->flags & POWER_SEQ_FLAG_PWRGD_IRQ) || (stage->check != NULL)) {
+				next_ms = MIN(next_ms, now + POWER_SEQ_POLL_MS);
+			}
+		}
+		*wake_ms = MIN(*wake_ms, next_ms);
+	}
+
+	return is_progress;
+}
+
+static void power_seq_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	power_seq *seq = CONTAINER_OF(dwork, power_seq, work);
+	int64_t wake_ms;
+
+	k_mutex_lock(&seq->mutex, K_FOREVER);
+
+	if (seq->result != POWER_SEQ_RUNNING) {
+		k_mutex_unlock(&seq->mutex);
+		return;
+	}
+
+	do {
+		wake_ms = INT64_MAX;
+	} while (run_stages(seq, &wake_ms) && (seq->result == POWER_SEQ_RUNNING));
+
+	uint32_t all_stage = BIT_MASK(seq->stage_num) & ~BIT_MASK(seq->first_stage);
+	if ((seq->result == POWER_SEQ_RUNNING) &&
+	    (((seq->finished | seq->stopped) & all_stage) == all_stage)) {
+		seq->result = (seq->stopped & all_stage) ? POWER_SEQ_STOPPED : POWER_SEQ_SUCCESS;
+	}
+
+	if (seq->result == POWER_SEQ_RUNNING) {
+		k_work_reschedule_for_queue(&power_seq_work_q, &seq->work,
+					    K_MSEC(MAX(wake_ms - k_uptime_get(), 0)));
+		k_mutex_unlock(&seq->mutex);
+		return;
+	}
+
+	uint8_t result = seq->result;
+	LOG_INF("%s %s in %d ms", seq->name,
+		(result == POWER_SEQ_FAILED) ? "failed" :
+		(result == POWER_SEQ_STOPPED) ? "stopped" : "done",
+		(int)(k_uptime_get() - seq->begin_ms));
+	k_mutex_unlock(&seq->mutex);
+
+	if (seq->done_fn) {
+		seq->done_fn(seq, result);
+	}
+}
+
+/* Any edge may be a power-good a running stage waits on, let the sequence decide */
+static void power_seq_gpio_event_handler(const GPIO_EVENT *event, void *arg)
+{
+	ARG_UNUSED(event);
+	ARG_UNUSED(arg);
+	power_seq *seq;
+
+	k_mutex_lock(&power_seq_list_mutex, K_FOREVER);
+	SYS_SLIST_FOR_EACH_CONTAINER (&power_seq_list, seq, node) {
+		if (seq->result == POWER_SEQ_RUNNING) {
+			k_work_reschedule_for_queue(&power_seq_work_q, &seq->work, K_NO_WAIT);
+		}
+	}
+	k_mutex_unlock(&power_seq_list_mutex);
+}
+
+void power_seq_init(power_seq *seq, const char *name,
+		    void (*done_fn)(power_seq *seq, uint8_t result), void *arg)
+{
+	CHECK_NULL_ARG(seq);
+
+	k_mutex_lock(&power_seq_list_mutex, K_FOREVER);
+
+	if (!is_power_seq_q_init) {
+		k_work_queue_start(&power_seq_work_q, power_seq_stack,
+				   K_THREAD_STACK_SIZEOF(power_seq_stack),
+				   CONFIG_MAIN_THREAD_PRIORITY, NULL);
+		k_thread_name_set(&power_seq_work_q.thread, "power_seq_workq");
+		if (!gpio_event_subscribe(GPIO_EVENT_ALL_PIN, power_seq_gpio_event_handler, NULL)) {
+			LOG_WRN("Failed to subscribe gpio event, power-good is polled only");
+		}
+		is_power_seq_q_init = true;
+	}
+
+	if (!seq->is_init) {
+		k_mutex_init(&seq->mutex);
+		k_work_init_delayable(&seq->work, power_seq_work_handler);
+		sys_slist_append(&power_seq_list, &seq->node);
+		seq->is_init = true;
+	}
+
+	/* A run of an earlier init must not go on with the new settings */
+	k_mutex_lock(&seq->mutex, K_FOREVER);
+	k_work_cancel_delayable(&seq->work);
+	seq->name = name;
+	seq->done_fn = done_fn;
+	seq->arg = arg;
+	seq->stage = NULL;
+	seq->result = POWER_SEQ_IDLE;
+	k_mutex_unlock(&seq->mutex);
+
+	k_mutex_unlock(&power_seq_list_mutex);
+}
+
+bool power_seq_start(power_seq *seq, const power_seq_stage *stage, uint8_t stage_num,
+		     uint8_t first_stage)
+{
+	CHECK_NULL_ARG_WITH_RETURN(seq, false);
+	CHECK_NULL_ARG_WITH_RETURN(stage, false);
+	CHECK_ARG_WITH_RETURN(stage_num > POWER_SEQ_MAX_STAGE, false);
+	CHECK_ARG_WITH_RETURN(first_stage >= stage_num, false);
+
+	if (!seq->is_init) {
+		LOG_ERR("Power sequence is not initialized");
+		return false;
+	}
+
+	k_mutex_lock(&seq->mutex, K_FOREVER);
+
+	if (seq->result == POWER_SEQ_RUNNING) {
+		LOG_INF("%s restart, drop stage 0x%x", seq->name, seq->started & ~seq->finished);
+	}
+
+	seq->stage = stage;
+	seq->stage_num = stage_num;
+	seq->first_stage = first_stage;
+	seq->result = POWER_SEQ_RUNNING;
+	seq->failed_stage = 0;
+	seq->started = BIT_MASK(first_stage);
+	seq->finished = BIT_MASK(first_stage);
+	seq->stopped = 0;
+	seq->begin_ms = k_uptime_get();
+	k_work_reschedule_for_queue(&power_seq_work_q, &seq->work, K_NO_WAIT);
+
+	k_mutex_unlock(&seq->mutex);
+	return true;
+}
+
+void power_seq_stop(power_seq *seq)
+{
+	CHECK_NULL_ARG(seq);
+
+	if (!seq->is_init) {
+		return;
+	}
+
+	k_mutex_lock(&seq->mutex, K_FOREVER);
+	if (seq->result == POWER_SEQ_RUNNING) {
+		seq->result = POWER_SEQ_IDLE;
+	}
+	k_work_cancel_delayable(&seq->work);
+	k_mutex_unlock(&seq->mutex);
+}
+
+void power_seq_notify(power_seq *seq)
+{
+	CHECK_NULL_ARG(seq);
+
+	if (seq->is_init && (seq->result == POWER_SEQ_RUNNING)) {
+		k_work_reschedule_for_queue(&power_seq_work_q, &seq->work, K_NO_WAIT);
+	}
+}
+
+uint8_t power_seq_get_result(power_seq *seq)
+{
+	CHECK_NULL_ARG_WITH_RETURN(seq, POWER_SEQ_IDLE);
+
+	return seq->is_init ? seq->result : POWER_SEQ_IDLE;
+}
+
+bool power_seq_is_running(power_seq *seq)
+{
+	return power_seq_get_result(seq) == POWER_SEQ_RUNNING;
+}
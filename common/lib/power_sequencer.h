@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef POWER_SEQUENCER_H
+#define POWER_SEQUENCER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr.h>
+
+/* Declarative power sequencing.
+ *
+ * A sequence is a table of stages. A stage starts once every stage in its depend mask has
+ * finished: it drives its enable pins, then finishes as soon as its min delay has passed and
+ * every power-good pin reads its expected level. A stage that is not good by its max delay fails
+ * the whole run. Stages without a path between them, e.g. separate E1.S slots, progress
+ * independently, and every sequence runs on one shared work queue instead of a thread each.
+ *
+ * The engine re-evaluates a sequence on any GPIO interrupt edge, so stages waiting on pins with
+ * an interrupt finish on the edge. Pins without an interrupt are polled every POWER_SEQ_POLL_MS
+ * unless the stage sets POWER_SEQ_FLAG_PWRGD_IRQ.
+ */
+
+#define POWER_SEQ_MAX_STAGE 16
+#define POWER_SEQ_MAX_GPIO 3
+#define POWER_SEQ_POLL_MS 5
+#define POWER_SEQ_STACK_SIZE 1024
+
+#define POWER_SEQ_DEP(stage) BIT(stage)
+
+enum POWER_SEQ_RESULT {
+	POWER_SEQ_SUCCESS = 0x00,
+	/* A stage condition was false, the stages depending on it did not run */
+	POWER_SEQ_STOPPED,
+	POWER_SEQ_FAILED,
+	POWER_SEQ_RUNNING,
+	POWER_SEQ_IDLE,
+};
+
+enum POWER_SEQ_FLAG {
+	/* A false condition counts the stage as finished instead of stopping its branch */
+	POWER_SEQ_FLAG_SKIP = BIT(0),
+	/* Every power-good pin has an interrupt, wait for the edge instead of polling */
+	POWER_SEQ_FLAG_PWRGD_IRQ = BIT(1),
+};
+
+typedef struct _power_seq_gpio {
+	uint8_t gpio_num;
+	uint8_t level;
+} power_seq_gpio;
+
+struct _power_seq;
+
+typedef bool (*power_seq_cond_fn)(struct _power_seq *seq);
+typedef void (*power_seq_hook_fn)(struct _power_seq *seq);
+
+typedef struct _power_seq_stage {
+	const char *name;
+	uint32_t depend;
+	uint8_t flags;
+	/* Evaluated once all dependencies finished, NULL means always run */
+	power_seq_cond_fn condition;
+	power_seq_gpio enable[POWER_SEQ_MAX_GPIO];
+	uint8_t enable_num;
+	/* Called after the enable pins are driven */
+	power_seq_hook_fn enter;
+	power_seq_gpio pwrgd[POWER_SEQ_MAX_GPIO];
+	uint8_t pwrgd_num;
+	/* Extra power-good condition which is not a GPIO, NULL means none */
+	power_seq_cond_fn check;
+	uint16_t min_delay_ms;
+	uint16_t max_delay_ms;
+	/* Called when the stage finishes successfully */
+	power_seq_hook_fn exit;
+} power_seq_stage;
+
+typedef struct _power_seq {
+	sys_snode_t node;
+	const char *name;
+	/* User data, e.g. the slot index */
+	void *arg;
+	void (*done_fn)(struct _power_seq *seq, uint8_t result);
+
+	/* Owned by the sequencer */
+	const power_seq_stage *stage;
+	uint8_t stage_num;
+	uint8_t first_stage;
+	uint8_t result;
+	uint8_t failed_stage;
+	uint32_t started;
+	uint32_t finished;
+	uint32_t stopped;
+	int64_t begin_ms;
+	int64_t start_ms[POWER_SEQ_MAX_STAGE];
+	struct k_work_delayable work;
+	struct k_mutex mutex;
+	bool is_init;
+} power_seq;
+
+void power_seq_init(power_seq *seq, const char *name,
+		    void (*done_fn)(power_seq *seq, uint8_t result), void *arg);
+/* Start a run from first_stage, every earlier stage counts as finished. A run in progress on
+ * the same sequence is dropped without calling done_fn.
+ */
+bool power_seq_start(power_seq *seq, const power_seq_stage *stage, uint8_t stage_num,
+		     uint8_t first_stage);
+void power_seq_stop(power_seq *seq);
+/* Re-evaluate now, for conditions that do not come from a GPIO edge */
+void power_seq_notify(power_seq *seq);
+uint8_t power_seq_get_result(power_seq *seq);
+bool power_seq_is_running(power_seq *seq);
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "hal_gpio.h"
 #include "snoop.h"
+#include "boot_timeline.h"
 
 LOG_MODULE_REGISTER(power_status);
 
@@ -33,8 +34,19 @@ static bool vr_monitor_status = true;
 
 void set_DC_status(uint8_t gpio_num)
 {
+	static bool is_DC_status_init = false;
+	bool is_DC_on_before = is_DC_on;
+
 	is_DC_on = (gpio_get(gpio_num) == 1) ? true : false;
 	LOG_WRN("DC_STATUS: %s", (is_DC_on) ? "on" : "off");
+
+#ifdef ENABLE_BOOT_TIMELINE
+	/* Host already running when BIC boots up is not a boot we can time */
+	if (is_DC_status_init && !is_DC_on_before && is_DC_on) {
+		boot_timeline_start();
+	}
+#endif
+	is_DC_status_init = true;
 }
 
 bool get_DC_status()
@@ -71,12 +83,22 @@ void set_post_status(uint8_t gpio_num)
 {
 	is_post_complete = (gpio_get(gpio_num) == 1) ? false : true;
 	LOG_WRN("POST_COMPLETE: %s", (is_post_complete) ? "yes" : "no");
+#ifdef ENABLE_BOOT_TIMELINE
+	if (is_post_complete) {
+		boot_timeline_finish();
+	}
+#endif
 }
 
 void set_post_complete(bool status)
 {
 	is_post_complete = status;
 	LOG_WRN("POST_COMPLETE: %s", (status) ? "yes" : "no");
+#ifdef ENABLE_BOOT_TIMELINE
+	if (is_post_complete) {
+		boot_timeline_finish();
+	}
+#endif
 }
 
 bool get_post_status()
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_profile.h"
+#include <logging/log.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr.h>
+#include "libutil.h"
+
+LOG_MODULE_REGISTER(thread_profile);
+
+/* Thread state at the start of the window */
+typedef struct _thread_slot {
+	const struct k_thread *thread;
+	uint64_t start_cycles;
+	uint32_t start_wakeup_count;
+	uint64_t start_ready_wait_cycles;
+} thread_slot;
+
+static thread_slot slot_list[THREAD_PROFILE_MAX_THREAD];
+static uint8_t slot_num = 0;
+static thread_profile_entry result_list[THREAD_PROFILE_MAX_THREAD];
+static thread_profile_summary result_summary;
+static bool is_result_valid = false;
+
+static volatile bool is_running = false;
+static uint32_t window_start_cycle;
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+static k_isr_runtime_stats_t window_start_isr;
+#endif
+static uint32_t work_count;
+static uint64_t work_latency_total_us;
+static uint32_t work_latency_max_us;
+
+static bool is_init = false;
+static struct k_work_delayable thread_profile_work;
+static K_MUTEX_DEFINE(thread_profile_mutex);
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+static thread_slot *find_slot(const struct k_thread *thread)
+{
+	for (uint8_t i = 0; i < slot_num; i++) {
+		if (slot_list[i].thread == thread) {
+			return &slot_list[i];
+		}
+	}
+	return NULL;
+}
+
+static void get_thread_stats(const struct k_thread *thread, k_thread_runtime_stats_t *stats)
+{
+	if (k_thread_runtime_stats_get((k_tid_t)thread, stats) != 0) {
+		memset(stats, 0, sizeof(k_thread_runtime_stats_t));
+	}
+}
+#endif
+
+static void start_cb(const struct k_thread *thread, void *user_data)
+{
+	if (slot_num >= ARRAY_SIZE(slot_list)) {
+		return;
+	}
+
+	thread_slot *slot = &slot_list[slot_num++];
+	memset(slot, 0, sizeof(thread_slot));
+	slot->thread = thread;
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	k_thread_runtime_stats_t stats;
+	get_thread_stats(thread, &stats);
+	slot->start_cycles = stats.execution_cycles;
+	slot->start_wakeup_count = stats.wakeup_count;
+	slot->start_ready_wait_cycles = stats.ready_wait_cycles;
+#endif
+}
+
+static void finish_cb(const struct k_thread *thread, void *user_data)
+{
+	uint32_t window_cycles = *(uint32_t *)user_data;
+
+	if (result_summary.thread_num >= ARRAY_SIZE(result_list)) {
+		return;
+	}
+
+	thread_profile_entry *entry = &result_list[result_summary.thread_num++];
+	memset(entry, 0, sizeof(thread_profile_entry));
+
+	const char *name = k_thread_name_get((k_tid_t)thread);
+	snprintf(entry->name, sizeof(entry->name), "%s", ((name != NULL) ? name : "unknown"));
+	entry->priority = k_thread_priority_get((k_tid_t)thread);
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	/* A thread created in the window has run only in the window */
+	thread_slot start = { 0 };
+	const thread_slot *slot = find_slot(thread);
+	if (slot != NULL) {
+		start = *slot;
+	}
+
+	k_thread_runtime_stats_t stats;
+	get_thread_stats(thread, &stats);
+	uint64_t cycles = stats.execution_cycles - start.start_cycles;
+	entry->run_us = k_cyc_to_us_floor64(cycles);
+	entry->cpu_usage = MIN(cycles * 10000 / MAX(window_cycles, 1), 10000);
+	entry->wakeup_count = stats.wakeup_count - start.start_wakeup_count;
+	if (entry->wakeup_count > 0) {
+		uint64_t wait_cycles = stats.ready_wait_cycles - start.start_ready_wait_cycles;
+		entry->ready_wait_avg_us = k_cyc_to_us_floor64(wait_cycles / entry->wakeup_count);
+	}
+#else
+	entry->run_us = THREAD_PROFILE_NOT_SUPPORT;
+	entry->cpu_usage = UINT16_MAX;
+	entry->wakeup_count = THREAD_PROFILE_NOT_SUPPORT;
+	entry->ready_wait_avg_us = THREAD_PROFILE_NOT_SUPPORT;
+#endif
+
+#if defined(CONFIG_THREAD_STACK_INFO) && defined(CONFIG_INIT_STACKS)
+	size_t unused = 0;
+	entry->stack_size = thread->stack_info.size;
+	if (k_thread_stack_space_get(thread, &unused) == 0) {
+		entry->stack_used = entry->stack_size - unused;
+	}
+#endif
+}
+
+static void thread_profile_handler(struct k_work *work)
+{
+	uint32_t window_cycles = k_cycle_get_32() - window_start_cycle;
+	is_running = false;
+
+	k_mutex_lock(&thread_profile_mutex, K_FOREVER);
+
+	memset(&result_summary, 0, sizeof(result_summary));
+	result_summary.window_us = k_cyc_to_us_floor32(window_cycles);
+	k_thread_foreach_unlocked(finish_cb, &window_cycles);
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	k_isr_runtime_stats_t isr;
+	k_isr_runtime_stats_get(&isr);
+	result_summary.isr_us =
+		k_cyc_to_us_floor64(isr.execution_cycles - window_start_isr.execution_cycles);
+	result_summary.isr_count = isr.count - window_start_isr.count;
+#else
+	result_summary.isr_us = THREAD_PROFILE_NOT_SUPPORT;
+	result_summary.isr_count = THREAD_PROFILE_NOT_SUPPORT;
+#endif
+	result_summary.work_count = work_count;
+	result_summary.work_latency_avg_us =
+		(work_count > 0) ? (uint32_t)(work_latency_total_us / work_count) : 0;
+	result_summary.work_latency_max_us = work_latency_max_us;
+	is_result_valid = true;
+
+	k_mutex_unlock(&thread_profile_mutex);
+}
+
+bool thread_profile_start(uint32_t window_ms)
+{
+	if ((window_ms == 0) || (window_ms > THREAD_PROFILE_MAX_WINDOW_MS)) {
+		return false;
+	}
+
+	k_mutex_lock(&thread_profile_mutex, K_FOREVER);
+
+	if (is_running) {
+		k_mutex_unlock(&thread_profile_mutex);
+		return false;
+	}
+
+	if (!is_init) {
+		k_work_init_delayable(&thread_profile_work, thread_profile_handler);
+		is_init = true;
+	}
+
+	slot_num = 0;
+	k_thread_foreach_unlocked(start_cb, NULL);
+	work_count = 0;
+	work_latency_total_us = 0;
+	work_latency_max_us = 0;
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	k_isr_runtime_stats_get(&window_start_isr);
+#endif
+	window_start_cycle = k_cycle_get_32();
+	is_running = true;
+
+	k_mutex_unlock(&thread_profile_mutex);
+
+	k_work_schedule(&thread_profile_work, K_MSEC(window_ms));
+	LOG_INF("Thread profile window of %d ms started", window_ms);
+	return true;
+}
+
+bool thread_profile_is_running()
+{
+	return is_running;
+}
+
+bool thread_profile_get_summary(thread_profile_summary *summary)
+{
+	CHECK_NULL_ARG_WITH_RETURN(summary, false);
+
+	k_mutex_lock(&thread_profile_mutex, K_FOREVER);
+	if (is_result_valid) {
+		memcpy(summary, &result_summary, sizeof(thread_profile_summary));
+	}
+	k_mutex_unlock(&thread_profile_mutex);
+
+	return is_result_valid;
+}
+
+uint8_t thread_profile_get_threads(uint8_t start, thread_profile_entry *entry, uint8_t max_num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(entry, 0);
+
+	uint8_t num = 0;
+
+	k_mutex_lock(&thread_profile_mutex, K_FOREVER);
+	if (is_result_valid) {
+		for (uint8_t i = start; (i < result_summary.thread_num) && (num < max_num); i++) {
+			entry[num++] = result_list[i];
+		}
+	}
+	k_mutex_unlock(&thread_profile_mutex);
+
+	return num;
+}
+
+void thread_profile_record_work_latency(uint32_t latency_us)
+{
+	if (!is_running) {
+		return;
+	}
+
+	k_mutex_lock(&thread_profile_mutex, K_FOREVER);
+	work_count++;
+	work_latency_total_us += latency_us;
+	work_latency_max_us = MAX(work_latency_max_us, latency_us);
+	k_mutex_unlock(&thread_profile_mutex);
+}
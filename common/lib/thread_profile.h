@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef THREAD_PROFILE_H
+#define THREAD_PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Runtime thread profiler.
+ *
+ * A window is started on request and the CPU time, wakeups and run queue wait of each thread in
+ * it are taken from the kernel runtime stats, as is the time spent in ISRs. The wakeup and ISR
+ * counters need the kernel patch 0055 in fix_patch. Without CONFIG_THREAD_RUNTIME_STATS they read
+ * THREAD_PROFILE_NOT_SUPPORT. A thread's run queue wait is the time from being made ready to
+ * running. The util_worker job latency is the time a job waits between being due and starting to
+ * run, which includes the worker thread's own run queue wait. Nothing is counted while no window
+ * is open.
+ */
+
+#define THREAD_PROFILE_MAX_THREAD 32
+#define THREAD_PROFILE_NAME_LEN 16
+#define THREAD_PROFILE_DEFAULT_WINDOW_MS 1000
+/* The 32-bit cycle counter must not wrap within a window */
+#define THREAD_PROFILE_MAX_WINDOW_MS 10000
+#define THREAD_PROFILE_NOT_SUPPORT 0xFFFFFFFF
+
+typedef struct _thread_profile_entry {
+	char name[THREAD_PROFILE_NAME_LEN];
+	int8_t priority;
+	/* CPU time in the window in units of 0.01% */
+	uint16_t cpu_usage;
+	uint32_t run_us;
+	uint32_t wakeup_count;
+	/* Average time from being made ready to running */
+	uint32_t ready_wait_avg_us;
+	uint32_t stack_size;
+	/* Most stack ever used by the thread */
+	uint32_t stack_used;
+} thread_profile_entry;
+
+typedef struct _thread_profile_summary {
+	uint32_t window_us;
+	uint8_t thread_num;
+	uint32_t isr_us;
+	uint32_t isr_count;
+	uint32_t work_count;
+	uint32_t work_latency_avg_us;
+	uint32_t work_latency_max_us;
+} thread_profile_summary;
+
+/* Returns false if a window is already open or window_ms is out of range */
+bool thread_profile_start(uint32_t window_ms);
+bool thread_profile_is_running();
+/* Results of the last completed window */
+bool thread_profile_get_summary(thread_profile_summary *summary);
+uint8_t thread_profile_get_threads(uint8_t start, thread_profile_entry *entry, uint8_t max_num);
+void thread_profile_record_work_latency(uint32_t latency_us);
+
+#endif
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "util_mem.h"
+#include <logging/log.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr.h>
+#include "hal_i2c.h"
+#include "ipmb.h"
+#include "libutil.h"
+#include "mctp.h"
+#include "plat_def.h"
+
+LOG_MODULE_REGISTER(util_mem);
+
+/* Platforms with many IPMB channels or MCTP endpoints can size the slabs in plat_def.h */
+#ifndef UTIL_MEM_SMALL_BLOCK_NUM
+#define UTIL_MEM_SMALL_BLOCK_NUM 16
+#endif
+#ifndef UTIL_MEM_I2C_BLOCK_NUM
+#define UTIL_MEM_I2C_BLOCK_NUM 4
+#endif
+#ifndef UTIL_MEM_IPMI_BLOCK_NUM
+#define UTIL_MEM_IPMI_BLOCK_NUM 16
+#endif
+#ifndef UTIL_MEM_MCTP_BLOCK_NUM
+#define UTIL_MEM_MCTP_BLOCK_NUM 4
+#endif
+#ifndef UTIL_MEM_LARGE_REGION_SIZE
+#define UTIL_MEM_LARGE_REGION_SIZE 0
+#endif
+
+/* Worker jobs, MCTP parameters and other small buffers */
+#define UTIL_MEM_SMALL_SIZE 128
+#define UTIL_MEM_MAGIC 0x4D42
+
+/* Put in front of every block, keeps the data 8-byte aligned */
+typedef struct _mem_hdr {
+	uint32_t size;
+	uint8_t tag;
+	uint8_t pool;
+	uint16_t magic;
+} mem_hdr;
+
+typedef struct _mem_slab_cfg {
+	uint32_t size;
+	uint16_t block_num;
+} mem_slab_cfg;
+
+/* In ascending order of size */
+static const mem_slab_cfg slab_cfg[MEM_POOL_SLAB_NUM] = {
+	{ UTIL_MEM_SMALL_SIZE, UTIL_MEM_SMALL_BLOCK_NUM },
+	{ sizeof(I2C_MSG), UTIL_MEM_I2C_BLOCK_NUM },
+	{ sizeof(ipmi_msg_cfg), UTIL_MEM_IPMI_BLOCK_NUM },
+	{ MSG_ASSEMBLY_BUF_SIZE, UTIL_MEM_MCTP_BLOCK_NUM },
+};
+
+BUILD_ASSERT(UTIL_MEM_SMALL_SIZE < sizeof(I2C_MSG), "Size classes out of order");
+BUILD_ASSERT(sizeof(I2C_MSG) < sizeof(ipmi_msg_cfg), "Size classes out of order");
+BUILD_ASSERT(sizeof(ipmi_msg_cfg) < MSG_ASSEMBLY_BUF_SIZE, "Size classes out of order");
+
+const char *const util_mem_tag_name[MEM_TAG_NUM] = {
+	"ipmb", "i2c", "mctp", "pldm", "fw_update", "other",
+};
+
+static struct k_mem_slab slab[MEM_POOL_SLAB_NUM];
+static bool is_slab_ready[MEM_POOL_SLAB_NUM];
+static bool is_init = false;
+static util_mem_tag_stat tag_stat[MEM_TAG_NUM];
+static util_mem_pool_stat pool_stat[MEM_POOL_NUM];
+static K_MUTEX_DEFINE(util_mem_mutex);
+
+#if UTIL_MEM_LARGE_REGION_SIZE > 0
+K_HEAP_DEFINE(large_region, UTIL_MEM_LARGE_REGION_SIZE);
+#endif
+
+static uint32_t get_block_size(uint8_t pool)
+{
+	return ROUND_UP(slab_cfg[pool].size + sizeof(mem_hdr), sizeof(mem_hdr));
+}
+
+/* Carve the slabs before the heap has been churned, a slab that does not fit stays empty */
+static void util_mem_init()
+{
+	for (uint8_t i = 0; i < MEM_POOL_SLAB_NUM; i++) {
+		pool_stat[i].block_size = slab_cfg[i].size;
+		if (slab_cfg[i].block_num == 0) {
+			continue;
+		}
+
+		uint32_t block_size = get_block_size(i);
+		void *buf = malloc(block_size * slab_cfg[i].block_num);
+		if (buf == NULL) {
+			LOG_ERR("Failed to allocate slab of %d bytes blocks", slab_cfg[i].size);
+			continue;
+		}
+
+		if (k_mem_slab_init(&slab[i], buf, block_size, slab_cfg[i].block_num) != 0) {
+			free(buf);
+			continue;
+		}
+		pool_stat[i].block_num = slab_cfg[i].block_num;
+		is_slab_ready[i] = true;
+	}
+
+	pool_stat[MEM_POOL_LARGE].block_size = UTIL_MEM_LARGE_REGION_SIZE;
+	is_init = true;
+}
+
+static void *record_alloc(mem_hdr *hdr, uint8_t tag, size_t size, uint8_t pool)
+{
+	if (hdr == NULL) {
+		tag_stat[tag].fail_count++;
+		LOG_WRN("Failed to allocate %u bytes for %s", (uint32_t)size,
+			util_mem_tag_name[tag]);
+		return NULL;
+	}
+
+	hdr->size = size;
+	hdr->tag = tag;
+	hdr->pool = pool;
+	hdr->magic = UTIL_MEM_MAGIC;
+
+	tag_stat[tag].alloc_count++;
+	tag_stat[tag].in_use += size;
+	tag_stat[tag].peak = MAX(tag_stat[tag].peak, tag_stat[tag].in_use);
+	pool_stat[pool].used++;
+	pool_stat[pool].peak = MAX(pool_stat[pool].peak, pool_stat[pool].used);
+
+	return hdr + 1;
+}
+
+void *util_mem_alloc(uint8_t tag, size_t size)
+{
+	CHECK_ARG_WITH_RETURN(tag >= MEM_TAG_NUM, NULL);
+
+	mem_hdr *hdr = NULL;
+	uint8_t pool = MEM_POOL_HEAP;
+
+	k_mutex_lock(&util_mem_mutex, K_FOREVER);
+
+	if (!is_init) {
+		util_mem_init();
+	}
+
+	for (uint8_t i = 0; i < MEM_POOL_SLAB_NUM; i++) {
+		if (size > slab_cfg[i].size) {
+			continue;
+		}
+		if (is_slab_ready[i] &&
+		    (k_mem_slab_alloc(&slab[i], (void **)&hdr, K_NO_WAIT) == 0)) {
+			pool = i;
+		} else {
+			pool_stat[i].fallback_count++;
+		}
+		break;
+	}
+
+	if (hdr == NULL) {
+		hdr = malloc(sizeof(mem_hdr) + size);
+	}
+
+	void *ptr = record_alloc(hdr, tag, size, pool);
+	k_mutex_unlock(&util_mem_mutex);
+	return ptr;
+}
+
+void *util_mem_alloc_large(uint8_t tag, size_t size)
+{
+	CHECK_ARG_WITH_RETURN(tag >= MEM_TAG_NUM, NULL);
+
+	mem_hdr *hdr = NULL;
+	uint8_t pool = MEM_POOL_HEAP;
+
+	k_mutex_lock(&util_mem_mutex, K_FOREVER);
+
+#if UTIL_MEM_LARGE_REGION_SIZE > 0
+	hdr = k_heap_alloc(&large_region, sizeof(mem_hdr) + size, K_NO_WAIT);
+	if (hdr != NULL) {
+		pool = MEM_POOL_LARGE;
+	} else {
+		pool_stat[MEM_POOL_LARGE].fallback_count++;
+	}
+#endif
+
+	if (hdr == NULL) {
+		hdr = malloc(sizeof(mem_hdr) + size);
+	}
+
+	void *ptr = record_alloc(hdr, tag, size, pool);
+	k_mutex_unlock(&util_mem_mutex);
+	return ptr;
+}
+
+void util_mem_free(void *ptr)
+{
+	if (ptr == NULL) {
+		return;
+	}
+
+	mem_hdr *hdr = (mem_hdr *)ptr - 1;
+
+	/* Leak a block that was not allocated here or is freed twice rather than corrupt a pool */
+	if ((hdr->magic != UTIL_MEM_MAGIC) || (hdr->tag >= MEM_TAG_NUM) ||
+	    (hdr->pool >= MEM_POOL_NUM)) {
+		LOG_ERR("Free of unknown block %p", ptr);
+		return;
+	}
+
+	k_mutex_lock(&util_mem_mutex, K_FOREVER);
+
+	uint8_t pool = hdr->pool;
+	tag_stat[hdr->tag].in_use -= hdr->size;
+	pool_stat[pool].used--;
+	hdr->magic = 0;
+
+	if (pool < MEM_POOL_SLAB_NUM) {
+		k_mem_slab_free(&slab[pool], (void **)&hdr);
+	} else if (pool == MEM_POOL_LARGE) {
+#if UTIL_MEM_LARGE_REGION_SIZE > 0
+		k_heap_free(&large_region, hdr);
+#endif
+	} else {
+		free(hdr);
+	}
+
+	k_mutex_unlock(&util_mem_mutex);
+}
+
+bool util_mem_get_tag_stat(uint8_t tag, util_mem_tag_stat *stat)
+{
+	CHECK_NULL_ARG_WITH_RETURN(stat, false);
+	CHECK_ARG_WITH_RETURN(tag >= MEM_TAG_NUM, false);
+
+	k_mutex_lock(&util_mem_mutex, K_FOREVER);
+	memcpy(stat, &tag_stat[tag], sizeof(util_mem_tag_stat));
+	k_mutex_unlock(&util_mem_mutex);
+
+	return true;
+}
+
+bool util_mem_get_pool_stat(uint8_t pool, util_mem_pool_stat *stat)
+{
+	CHECK_NULL_ARG_WITH_RETURN(stat, false);
+	CHECK_ARG_WITH_RETURN(pool >= MEM_POOL_NUM, false);
+
+	k_mutex_lock(&util_mem_mutex, K_FOREVER);
+	memcpy(stat, &pool_stat[pool], sizeof(util_mem_pool_stat));
+	k_mutex_unlock(&util_mem_mutex);
+
+	return true;
+}
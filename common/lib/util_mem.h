@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_MEM_H
+#define UTIL_MEM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Tagged allocations for the service buffers.
+ *
+ * Every block is counted against the subsystem tag it was allocated for. A request that fits a
+ * size class is served from the fixed-block slab of the class, so the buffers allocated and freed
+ * over and over do not fragment the heap. The slabs are carved from the heap once, on the first
+ * allocation, and a request falls back to the heap when its slab is used up. Large update buffers
+ * come from a reserved region when the platform defines UTIL_MEM_LARGE_REGION_SIZE, otherwise
+ * from the heap too. Blocks of any source are released with util_mem_free().
+ */
+
+enum MEM_TAG {
+	MEM_TAG_IPMB = 0x00,
+	MEM_TAG_I2C,
+	MEM_TAG_MCTP,
+	MEM_TAG_PLDM,
+	MEM_TAG_FW_UPDATE,
+	MEM_TAG_OTHER,
+	MEM_TAG_NUM,
+};
+
+enum MEM_POOL {
+	/* Slabs of the size classes are 0 to MEM_POOL_SLAB_NUM - 1 */
+	MEM_POOL_SLAB_NUM = 4,
+	MEM_POOL_LARGE = MEM_POOL_SLAB_NUM,
+	MEM_POOL_HEAP,
+	MEM_POOL_NUM,
+};
+
+#define SAFE_MEM_FREE(p)                                                                           \
+	if (p) {                                                                                   \
+		util_mem_free(p);                                                                  \
+		p = NULL;                                                                          \
+	}
+
+typedef struct _util_mem_tag_stat {
+	uint32_t in_use;
+	uint32_t peak;
+	uint32_t alloc_count;
+	uint32_t fail_count;
+} util_mem_tag_stat;
+
+typedef struct _util_mem_pool_stat {
+	/* Largest request the pool serves, 0 for the heap */
+	uint32_t block_size;
+	uint16_t block_num;
+	uint16_t used;
+	uint16_t peak;
+	/* Requests of the class served by the heap because the slab was full */
+	uint32_t fallback_count;
+} util_mem_pool_stat;
+
+extern const char *const util_mem_tag_name[MEM_TAG_NUM];
+
+void *util_mem_alloc(uint8_t tag, size_t size);
+/* For firmware update images, from the reserved region when there is one */
+void *util_mem_alloc_large(uint8_t tag, size_t size);
+void util_mem_free(void *ptr);
+bool util_mem_get_tag_stat(uint8_t tag, util_mem_tag_stat *stat);
+bool util_mem_get_pool_stat(uint8_t pool, util_mem_pool_stat *stat);
+
+#endif
@@ -79,19 +79,15 @@ bool get_exponent_from_vout_mode(sensor_cfg *cfg, float *exponent)
 	CHECK_NULL_ARG_WITH_RETURN(exponent, false);
 
 	uint8_t retry = 5;
-	I2C_MSG msg;
+	uint8_t command = PMBUS_VOUT_MODE;
+	uint8_t vout_mode = 0;
 
-	msg.bus = cfg->port;
-	msg.target_addr = cfg->target_addr;
-	msg.tx_len = 1;
-	msg.rx_len = 1;
-	msg.data[0] = PMBUS_VOUT_MODE;
-
-	if (i2c_master_read(&msg, retry)) {
+	if (i2c_master_write_read_buf(cfg->port, cfg->target_addr, &command, 1, &vout_mode, 1,
+				      retry)) {
 		return false;
 	}
 
-	*exponent = slinear11_exponents[msg.data[0] & 0x1f];
+	*exponent = slinear11_exponents[vout_mode & 0x1f];
 	return true;
 }
 
@@ -102,20 +98,13 @@ int pmbus_read_command(sensor_cfg *cfg, uint8_t command, uint8_t *result, uint8_
 
 	int ret = 0;
 	uint8_t retry = 5;
-	I2C_MSG msg = { 0 };
-
-	msg.bus = cfg->port;
-	msg.target_addr = cfg->target_addr;
-	msg.tx_len = 1;
-	msg.rx_len = read_len;
-	msg.data[0] = command;
 
-	ret = i2c_master_read(&msg, retry);
+	ret = i2c_master_write_read_buf(cfg->port, cfg->target_addr, &command, 1, result, read_len,
+					retry);
 	if (ret != 0) {
 		LOG_ERR("I2C read command: 0x%x fail, ret: %d", command, ret);
 		return -1;
 	}
 
-	memcpy(result, &msg.data[0], read_len * sizeof(uint8_t));
 	return 0;
 }
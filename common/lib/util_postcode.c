@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include "util_postcode.h"
+#include "libutil.h"
+
+#include <logging/log.h>
+
+LOG_MODULE_REGISTER(util_postcode);
+
+#define RING_SIZE(ring) ((ring)->mask + 1)
+
+/* Time base of post code timestamps. */
+uint32_t postcode_timestamp_us()
+{
+	return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+/* Store one post code with its arrival time.
+ *
+ * Only one context may act as producer for a ring. This function never blocks so it is safe
+ * to call from an ISR or a driver callback.
+ */
+void postcode_ring_put(postcode_ring *ring, uint32_t code)
+{
+	CHECK_NULL_ARG(ring);
+
+	uint32_t head = (uint32_t)atomic_get(&ring->head);
+	postcode_entry *entry = &ring->buf[head & ring->mask];
+
+	entry->code = code;
+	entry->timestamp_us = postcode_timestamp_us();
+	/* Publish the entry after it is completely written */
+	atomic_inc(&ring->head);
+}
+
+/* Drop the post code history, e.g. on a new DC on. Consumer cursors are not touched. */
+void postcode_ring_clear(postcode_ring *ring)
+{
+	CHECK_NULL_ARG(ring);
+
+	atomic_set(&ring->base, atomic_get(&ring->head));
+}
+
+/* Number of post codes in history since the last clear, capped at the ring length. */
+uint32_t postcode_ring_count(postcode_ring *ring)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ring, 0);
+
+	uint32_t count = (uint32_t)atomic_get(&ring->head) - (uint32_t)atomic_get(&ring->base);
+	return MIN(count, RING_SIZE(ring));
+}
+
+uint32_t postcode_ring_head(postcode_ring *ring)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ring, 0);
+
+	return (uint32_t)atomic_get(&ring->head);
+}
+
+/* Position of the oldest post code still in history, a good starting cursor for a consumer. */
+uint32_t postcode_ring_oldest(postcode_ring *ring)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ring, 0);
+
+	uint32_t base = (uint32_t)atomic_get(&ring->base);
+	uint32_t head = (uint32_t)atomic_get(&ring->head);
+	return ((head - base) > RING_SIZE(ring)) ? (head - RING_SIZE(ring)) : base;
+}
+
+/* Number of post codes written after the consumer cursor, including overwritten ones. */
+uint32_t postcode_ring_pending(postcode_ring *ring, uint32_t cursor)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ring, 0);
+
+	return (uint32_t)atomic_get(&ring->head) - cursor;
+}
+
+/* Read post codes in arrival order starting at cursor and advance it.
+ *
+ * If the producer lapped the consumer the lost entries are skipped and added to the overrun
+ * counter.
+ *
+ * @retval number of entries copied to out
+ */
+uint16_t postcode_ring_consume(postcode_ring *ring, uint32_t *cursor, postcode_entry *out,
+			       uint16_t max_num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ring, 0);
+	CHECK_NULL_ARG_WITH_RETURN(cursor, 0);
+	CHECK_NULL_ARG_WITH_RETURN(out, 0);
+
+	uint32_t head = (uint32_t)atomic_get(&ring->head);
+	uint32_t pos = *cursor;
+	uint16_t num = 0;
+
+	if (head - pos > RING_SIZE(ring)) {
+		atomic_add(&ring->overrun, (head - pos) - RING_SIZE(ring));
+		pos = head - RING_SIZE(ring);
+	}
+
+	for (; (pos != head) && (num < max_num); pos++, num++) {
+		out[num] = ring->buf[pos & ring->mask];
+	}
+
+	/* Entries that the producer overwrote while they were being copied are not valid, the slot
+	 * right after head may be under write already.
+	 */
+	uint32_t first = pos - num;
+	uint32_t oldest_valid = (uint32_t)atomic_get(&ring->head) + 1 - RING_SIZE(ring);
+	if ((int32_t)(oldest_valid - first) > 0) {
+		uint16_t lost = MIN(oldest_valid - first, num);
+		memmove(out, &out[lost], (num - lost) * sizeof(postcode_entry));
+		num -= lost;
+		atomic_add(&ring->overrun, lost);
+	}
+
+	*cursor = pos;
+	return num;
+}
+
+/* Number of the newest entries, after skipping "skip" of them, that may be copied out. */
+static uint16_t latest_range(postcode_ring *ring, uint32_t skip, uint16_t max_num, uint32_t *head)
+{
+	uint32_t base = (uint32_t)atomic_get(&ring->base);
+	*head = (uint32_t)atomic_get(&ring->head);
+	uint32_t count = MIN(*head - base, RING_SIZE(ring));
+	if (skip >= count) {
+		return 0;
+	}
+
+	return MIN(count - skip, max_num);
+}
+
+/* Number of copied entries still valid once the producer may have wrapped onto the oldest. */
+static uint16_t latest_valid(postcode_ring *ring, uint32_t skip, uint16_t num, uint32_t head)
+{
+	uint32_t oldest_copied = head - skip - num;
+	uint32_t oldest_valid = (uint32_t)atomic_get(&ring->head) + 1 - RING_SIZE(ring);
+	if ((int32_t)(oldest_valid - oldest_copied) > 0) {
+		num -= MIN(oldest_valid - oldest_copied, num);
+	}
+	return num;
+}
+
+/* Copy the history newest first, skipping the newest "skip" entries.
+ *
+ * @retval number of entries copied to out
+ */
+uint16_t postcode_ring_copy_latest(postcode_ring *ring, uint32_t skip, postcode_entry *out,
+				   uint16_t max_num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ring, 0);
+	CHECK_NULL_ARG_WITH_RETURN(out, 0);
+
+	uint32_t head;
+	uint16_t num = latest_range(ring, skip, max_num, &head);
+	uint32_t pos = head - skip - 1;
+	for (uint16_t i = 0; i < num; i++, pos--) {
+		out[i] = ring->buf[pos & ring->mask];
+	}
+
+	return latest_valid(ring, skip, num, head);
+}
+
+/* Same as postcode_ring_copy_latest but only copy the codes, each one as code_size bytes in
+ * little endian, which is the layout the IPMI post code commands use.
+ *
+ * @retval number of codes copied to buffer
+ */
+uint16_t postcode_ring_copy_codes(postcode_ring *ring, uint32_t skip, uint8_t *buffer,
+				  uint16_t max_num, uint8_t code_size)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ring, 0);
+	CHECK_NULL_ARG_WITH_RETURN(buffer, 0);
+	CHECK_ARG_WITH_RETURN((code_size == 0) || (code_size > sizeof(uint32_t)), 0);
+
+	uint32_t head;
+	uint16_t num = latest_range(ring, skip, max_num, &head);
+	uint32_t pos = head - skip - 1;
+	for (uint16_t i = 0; i < num; i++, pos--) {
+		uint32_t code = ring->buf[pos & ring->mask].code;
+		for (uint8_t j = 0; j < code_size; j++) {
+			buffer[(i * code_size) + j] = (code >> (8 * j)) & 0xFF;
+		}
+	}
+
+	return latest_valid(ring, skip, num, head);
+}
+
+uint32_t postcode_ring_get_overrun(postcode_ring *ring)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ring, 0);
+
+	return (uint32_t)atomic_get(&ring->overrun);
+}
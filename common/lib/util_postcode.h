@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_POSTCODE_H
+#define UTIL_POSTCODE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/atomic.h>
+
+/* Post code ring shared by the 1-byte snoop path and the 4-byte PCC path.
+ *
+ * There is exactly one producer (the snoop thread or the PCC rx callback) and the producer
+ * never blocks: once the ring is full the oldest entries are overwritten. Consumers keep their
+ * own cursor and are told how many entries were overwritten before they could read them.
+ * The ring length must be a power of two.
+ */
+typedef struct {
+	uint32_t code;
+	/* Uptime in microseconds, wraps every ~71 minutes so only use it for differences */
+	uint32_t timestamp_us;
+} postcode_entry;
+
+typedef struct {
+	postcode_entry *buf;
+	uint32_t mask;
+	/* Total number of codes ever written, only modified by the producer */
+	atomic_t head;
+	/* Value of head when the history was last cleared */
+	atomic_t base;
+	/* Number of codes overwritten before the forwarding consumer read them */
+	atomic_t overrun;
+} postcode_ring;
+
+#define POSTCODE_RING_DEFINE(name, len)                                                            \
+	BUILD_ASSERT(((len) & ((len)-1)) == 0, "post code ring length must be a power of two");    \
+	static postcode_entry name##_buf[len];                                                     \
+	static postcode_ring name = { .buf = name##_buf, .mask = (len)-1 }
+
+uint32_t postcode_timestamp_us();
+void postcode_ring_put(postcode_ring *ring, uint32_t code);
+void postcode_ring_clear(postcode_ring *ring);
+uint32_t postcode_ring_count(postcode_ring *ring);
+uint32_t postcode_ring_head(postcode_ring *ring);
+uint32_t postcode_ring_oldest(postcode_ring *ring);
+uint32_t postcode_ring_pending(postcode_ring *ring, uint32_t cursor);
+uint16_t postcode_ring_consume(postcode_ring *ring, uint32_t *cursor, postcode_entry *out,
+			       uint16_t max_num);
+uint16_t postcode_ring_copy_latest(postcode_ring *ring, uint32_t skip, postcode_entry *out,
+				   uint16_t max_num);
+uint16_t postcode_ring_copy_codes(postcode_ring *ring, uint32_t skip, uint8_t *buffer,
+				  uint16_t max_num, uint8_t code_size);
+uint32_t postcode_ring_get_overrun(postcode_ring *ring);
+
+#endif
@@ -28,6 +28,7 @@
 #include "util_spi.h"
 #include "util_spi_internal.h"
 #include "util_sys.h"
+#include "util_mem.h"
 #include "libutil.h"
 #include "ipmi.h"
 #include <crypto/hash.h>
@@ -102,14 +103,14 @@ __weak int do_update(const struct device *flash_device, off_t offset, uint8_t *b
 		goto end;
 	}
 
-	op_buf = (uint8_t *)malloc(sector_sz);
+	op_buf = util_mem_alloc(MEM_TAG_FW_UPDATE, sector_sz);
 	if (op_buf == NULL) {
 		LOG_ERR("Failed to allocate op_buf.");
 		ret = -EINVAL;
 		goto end;
 	}
 
-	read_back_buf = (uint8_t *)malloc(sector_sz);
+	read_back_buf = util_mem_alloc(MEM_TAG_FW_UPDATE, sector_sz);
 	if (read_back_buf == NULL) {
 		LOG_ERR("Failed to allocate read_back_buf.");
 		ret = -EINVAL;
@@ -175,8 +176,8 @@ __weak int do_update(const struct device *flash_device, off_t offset, uint8_t *b
 	}
 
 end:
-	SAFE_FREE(op_buf);
-	SAFE_FREE(read_back_buf);
+	SAFE_MEM_FREE(op_buf);
+	SAFE_MEM_FREE(read_back_buf);
 
 	return ret;
 }
@@ -199,7 +200,7 @@ uint8_t get_fw_sha256(uint8_t *msg_buf, uint32_t offset, uint32_t length, uint8_
 		return CC_UNSPECIFIED_ERROR;
 	}
 
-	buf = (uint8_t *)malloc(length);
+	buf = util_mem_alloc(MEM_TAG_FW_UPDATE, length);
 	if (buf == NULL) {
 		LOG_ERR("Failed to allocate buf.");
 		return CC_OUT_OF_SPACE;
@@ -259,7 +260,7 @@ uint8_t get_fw_sha256(uint8_t *msg_buf, uint32_t offset, uint32_t length, uint8_
 	memcpy(msg_buf, &digest[0], sizeof(digest));
 	ret = CC_SUCCESS;
 end:
-	SAFE_FREE(buf);
+	SAFE_MEM_FREE(buf);
 
 	if (need_free_section) {
 		hash_free_session(dev, &ini);
@@ -285,11 +286,11 @@ uint8_t fw_update(uint32_t offset, uint16_t msg_len, uint8_t *msg_buf, uint8_t f
 	}
 
 	if (!is_init) {
-		SAFE_FREE(txbuf);
-		txbuf = (uint8_t *)malloc(SECTOR_SZ_64K);
+		SAFE_MEM_FREE(txbuf);
+		txbuf = util_mem_alloc_large(MEM_TAG_FW_UPDATE, SECTOR_SZ_64K);
 		if (txbuf == NULL) { // Retry alloc
 			k_msleep(100);
-			txbuf = (uint8_t *)malloc(SECTOR_SZ_64K);
+			txbuf = util_mem_alloc_large(MEM_TAG_FW_UPDATE, SECTOR_SZ_64K);
 		}
 		if (txbuf == NULL) {
 			LOG_ERR("SPI index %d, failed to allocate txbuf.", flash_position);
@@ -308,7 +309,7 @@ uint8_t fw_update(uint32_t offset, uint16_t msg_len, uint8_t *msg_buf, uint8_t f
 		if (fw_update_retry < 0) {
 			LOG_ERR("SPI index %d, retry reached max: %d", flash_position,
 				fw_update_retry);
-			SAFE_FREE(txbuf);
+			SAFE_MEM_FREE(txbuf);
 			txbuf = NULL;
 			k_msleep(10);
 			is_init = 0;
@@ -331,7 +332,7 @@ uint8_t fw_update(uint32_t offset, uint16_t msg_len, uint8_t *msg_buf, uint8_t f
 	if ((buf_offset + msg_len) > SECTOR_SZ_64K) {
 		LOG_ERR("SPI index %d, recv data over buffer length(64KB), buf_offset 0x%x, msg_len 0x%x",
 			flash_position, buf_offset, msg_len);
-		SAFE_FREE(txbuf);
+		SAFE_MEM_FREE(txbuf);
 		txbuf = NULL;
 		k_msleep(10);
 		is_init = 0;
@@ -352,7 +353,7 @@ uint8_t fw_update(uint32_t offset, uint16_t msg_len, uint8_t *msg_buf, uint8_t f
 			uint8_t rc = 0;
 			rc = spi_nor_re_init(flash_dev);
 			if (rc != 0) {
-				SAFE_FREE(txbuf);
+				SAFE_MEM_FREE(txbuf);
 				is_init = 0;
 				return rc;
 			}
@@ -365,7 +366,7 @@ uint8_t fw_update(uint32_t offset, uint16_t msg_len, uint8_t *msg_buf, uint8_t f
 		} else {
 			LOG_INF("Update success");
 		}
-		SAFE_FREE(txbuf);
+		SAFE_MEM_FREE(txbuf);
 		k_msleep(10);
 		is_init = 0;
 
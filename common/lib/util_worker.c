@@ -22,6 +22,7 @@
 #include "cmsis_os2.h"
 #include "libutil.h"
 #include "plat_def.h"
+#include "thread_profile.h"
 
 #include <logging/log.h>
 
@@ -34,55 +35,183 @@ LOG_MODULE_REGISTER(util_worker);
 #define WORKER_PRIORITY CONFIG_MAIN_THREAD_PRIORITY
 
 #define MAX_WORK_COUNT 32
-#define WARN_WORK_PROC_TIME_MS 1000
 
 K_THREAD_STACK_DEFINE(worker_stack_area, WORKER_STACK_SIZE);
 K_THREAD_STACK_DEFINE(plat_worker_stack_area, WORKER_STACK_SIZE);
 struct k_work_q plat_work_q;
 static struct k_work_q worker_work_q;
-static struct k_mutex mutex_use_count;
-static uint8_t work_count;
+
+enum WORK_STATE {
+	WORK_FREE = 0x00,
+	WORK_QUEUED,
+	WORK_RUNNING,
+	/* Canceled while its handler runs, the handler returns the entry */
+	WORK_CANCELED,
+};
 
 typedef struct {
-	union {
-		struct k_work normal_work;
-		struct k_work_delayable delay_work;
-	} work;
+	struct k_work_delayable work;
 	void (*fn)(void *, uint32_t);
 	void *ptr_arg;
 	uint32_t ui32_arg;
+	uint32_t period_ms;
+	/* Cycle count the work is due to run at */
+	uint32_t due_cycle;
+	/* Uptime the work is due to run at, the next run of a periodic work counts from it */
+	int64_t due_ms;
+	/* Bumped on every submit, so handles of earlier works no longer match */
+	uint16_t gen;
+	uint8_t state;
 	char name[MAX_WORK_NAME_LEN];
 } work_info;
 
+/* The entries are taken and returned with atomic bit operations, submitting does not lock.
+ * The state of an entry in use is changed under work_lock, which is only held for a few
+ * instructions, so works can be canceled and rescheduled from an ISR too.
+ */
+static work_info work_pool[MAX_WORK_COUNT];
+static ATOMIC_DEFINE(work_used, MAX_WORK_COUNT);
+static atomic_t work_count = ATOMIC_INIT(0);
+static atomic_t work_peak_count = ATOMIC_INIT(0);
+static atomic_t work_full_count = ATOMIC_INIT(0);
+static struct k_spinlock work_lock;
+
+static worker_job_stat stat_list[MAX_WORK_STAT_COUNT];
+static uint8_t stat_num = 0;
+static K_MUTEX_DEFINE(work_stat_mutex);
+
+static work_info *alloc_work()
+{
+	for (uint8_t i = 0; i < MAX_WORK_COUNT; i++) {
+		if (!atomic_test_and_set_bit(work_used, i)) {
+			atomic_val_t count = atomic_inc(&work_count) + 1;
+			atomic_val_t peak = atomic_get(&work_peak_count);
+			while ((count > peak) && !atomic_cas(&work_peak_count, peak, count)) {
+				peak = atomic_get(&work_peak_count);
+			}
+			return &work_pool[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Called with work_lock held or before the entry is handed out */
+static void release_work(work_info *work_job)
+{
+	work_job->state = WORK_FREE;
+	atomic_dec(&work_count);
+	atomic_clear_bit(work_used, work_job - work_pool);
+}
+
+static void set_due_time(work_info *work_job, uint32_t delay_ms)
+{
+	work_job->due_cycle = k_cycle_get_32() + k_ms_to_cyc_ceil32(delay_ms);
+	work_job->due_ms = k_uptime_get() + delay_ms;
+}
+
+static work_info *get_work_by_handle(worker_handle handle)
+{
+	uint8_t index = handle & 0xFF;
+	if (index >= MAX_WORK_COUNT) {
+		return NULL;
+	}
+
+	work_info *work_job = &work_pool[index];
+	if ((work_job->gen != (handle >> 8)) || (work_job->state == WORK_FREE)) {
+		return NULL;
+	}
+
+	return work_job;
+}
+
+static void record_work_stat(work_info *work_job, uint32_t latency_us, uint32_t run_us)
+{
+	worker_job_stat *stat = NULL;
+
+	k_mutex_lock(&work_stat_mutex, K_FOREVER);
+
+	for (uint8_t i = 0; i < stat_num; i++) {
+		if (stat_list[i].fn == work_job->fn) {
+			stat = &stat_list[i];
+			break;
+		}
+	}
+
+	if ((stat == NULL) && (stat_num < MAX_WORK_STAT_COUNT)) {
+		stat = &stat_list[stat_num++];
+		memset(stat, 0, sizeof(worker_job_stat));
+		stat->fn = work_job->fn;
+	}
+
+	if (stat != NULL) {
+		memcpy(stat->name, work_job->name, sizeof(stat->name));
+		stat->run_count++;
+		if (run_us > (WARN_WORK_PROC_TIME_MS * 1000)) {
+			stat->slow_count++;
+		}
+		stat->last_run_us = run_us;
+		stat->max_run_us = MAX(stat->max_run_us, run_us);
+		stat->total_run_us += run_us;
+		stat->max_latency_us = MAX(stat->max_latency_us, latency_us);
+	}
+
+	k_mutex_unlock(&work_stat_mutex);
+}
+
 static void work_handler(struct k_work *item)
 {
-	work_info *work_job = CONTAINER_OF(item, work_info, work);
-	uint64_t fn_start_time, fn_finish_time;
+	struct k_work_delayable *dwork = k_work_delayable_from_work(item);
+	work_info *work_job = CONTAINER_OF(dwork, work_info, work);
+
+	k_spinlock_key_t key = k_spin_lock(&work_lock);
+	if (work_job->state == WORK_CANCELED) {
+		release_work(work_job);
+		k_spin_unlock(&work_lock, key);
+		return;
+	}
+	work_job->state = WORK_RUNNING;
+	k_spin_unlock(&work_lock, key);
 
 	if (work_job->fn == NULL) {
 		LOG_ERR("work_handler function is null");
 	} else {
-		fn_start_time = k_uptime_get();
+		int32_t wait_cycle = k_cycle_get_32() - work_job->due_cycle;
+		uint32_t latency_us = k_cyc_to_us_floor32(MAX(wait_cycle, 0));
+		thread_profile_record_work_latency(latency_us);
+
+		int64_t fn_start_tick = k_uptime_ticks();
 		work_job->fn(work_job->ptr_arg, work_job->ui32_arg);
-		fn_finish_time = k_uptime_get();
-		uint64_t duration = fn_finish_time - fn_start_time;
-
-		/* Processing time too long, print warning message */
-		if (duration > WARN_WORK_PROC_TIME_MS) {
-			LOG_ERR("WARN: work %s Processing time too long, 0x%08x_%08x ms",
-				log_strdup(work_job->name), (uint32_t)(duration >> 32),
-				(uint32_t)duration);
-		}
+		uint32_t run_us = k_ticks_to_us_floor32(k_uptime_ticks() - fn_start_tick);
+		record_work_stat(work_job, latency_us, run_us);
 	}
-	if (k_mutex_lock(&mutex_use_count, K_MSEC(1000))) {
-		LOG_ERR("work_handler mutex lock fail");
-		SAFE_FREE(work_job);
-		return;
+
+	int ret = 1;
+	char name[MAX_WORK_NAME_LEN];
+
+	key = k_spin_lock(&work_lock);
+	if ((work_job->state == WORK_CANCELED) || (work_job->period_ms == 0) ||
+	    (work_job->fn == NULL)) {
+		release_work(work_job);
+	} else {
+		/* Runs missed by a late work are skipped rather than run back to back */
+		int64_t now_ms = k_uptime_get();
+		uint32_t delay_ms = MAX(work_job->due_ms + work_job->period_ms, now_ms) - now_ms;
+
+		work_job->state = WORK_QUEUED;
+		set_due_time(work_job, delay_ms);
+		ret = k_work_schedule_for_queue(&worker_work_q, &work_job->work, K_MSEC(delay_ms));
+		if (ret <= 0) {
+			/* The entry may be reused once released */
+			memcpy(name, work_job->name, sizeof(name));
+			release_work(work_job);
+		}
 	}
-	work_count--;
-	k_mutex_unlock(&mutex_use_count);
+	k_spin_unlock(&work_lock, key);
 
-	SAFE_FREE(work_job);
+	if (ret <= 0) {
+		LOG_ERR("work %s periodic run schedule fail, ret %d", log_strdup(name), ret);
+	}
 }
 
 /* Get number of works in worker now.
@@ -91,85 +220,203 @@ static void work_handler(struct k_work *item)
  */
 uint8_t get_work_count()
 {
-	return work_count;
+	return atomic_get(&work_count);
+}
+
+/* Get the largest number of works in worker at the same time.
+ *
+ * @retval number of works
+ */
+uint8_t get_work_peak_count()
+{
+	return atomic_get(&work_peak_count);
+}
+
+/* Get number of works not added because the worker was full.
+ *
+ * @retval number of works
+ */
+uint32_t get_work_full_count()
+{
+	return atomic_get(&work_full_count);
 }
 
 /* Attempt to add new work to worker.
+ *
+ * The work runs once after job->delay_ms, or every job->period_ms after that when
+ * job->period_ms is set. It does not allocate or lock, so it can be called from an ISR.
  *
  * @param job pointer to the worker_job to be added
+ * @param handle pointer to store the handle to cancel or reschedule the work, NULL if not needed
  *
  * @retval 1 if successfully queued.
  * @retval -1 if work queue is full.
- * @retval -2 if memory allocation fail.
- * @retval -3 if mutex lock fail.
+ * @retval other values if the work queue fails to queue the work.
  */
-int add_work(worker_job *job)
+int add_work_with_handle(worker_job *job, worker_handle *handle)
 {
-	if (work_count >= MAX_WORK_COUNT) {
-		LOG_ERR("add_work work queue full");
-		return -1;
-	}
+	CHECK_NULL_ARG_WITH_RETURN(job, -2);
 
-	int ret;
-	work_info *new_job;
-	new_job = malloc(sizeof(work_info));
+	work_info *new_job = alloc_work();
 	if (new_job == NULL) {
-		LOG_ERR("add_work malloc fail");
-		return -2;
+		atomic_inc(&work_full_count);
+		LOG_ERR("add_work work queue full");
+		return -1;
 	}
-	memset(new_job, 0, sizeof(work_info));
 
 	new_job->fn = job->fn;
 	new_job->ptr_arg = job->ptr_arg;
 	new_job->ui32_arg = job->ui32_arg;
-	if (job->name != NULL) {
-		snprintf(new_job->name, sizeof(new_job->name), "%s", job->name);
+	new_job->period_ms = job->period_ms;
+	snprintf(new_job->name, sizeof(new_job->name), "%s", job->name);
+	if (++new_job->gen == 0) {
+		new_job->gen = 1;
 	}
 
-	if (k_mutex_lock(&mutex_use_count, K_MSEC(1000))) {
-		LOG_ERR("add_work mutex lock fail");
-		SAFE_FREE(new_job);
-		return -3;
+	/* The handle is taken under the lock, once it is released the work may run, finish and
+	 * the entry be reused before this returns
+	 */
+	k_spinlock_key_t key = k_spin_lock(&work_lock);
+	new_job->state = WORK_QUEUED;
+	set_due_time(new_job, job->delay_ms);
+	int ret = k_work_schedule_for_queue(&worker_work_q, &new_job->work, K_MSEC(job->delay_ms));
+	if (ret <= 0) {
+		release_work(new_job);
+	} else if (handle != NULL) {
+		*handle = (new_job->gen << 8) | (new_job - work_pool);
 	}
+	k_spin_unlock(&work_lock, key);
 
-	if (job->delay_ms == 0) { /* no need to be delayed */
-		k_work_init(&(new_job->work.normal_work), work_handler);
-		ret = k_work_submit_to_queue(&worker_work_q, &(new_job->work.normal_work));
-		if (ret != 1) { /* queued fail */
-			LOG_ERR("add_work add work to queue fail");
-			goto error;
-		}
-	} else { /* need to be delayed */
-		k_work_init_delayable(&(new_job->work.delay_work), work_handler);
-		ret = k_work_schedule_for_queue(&worker_work_q, &(new_job->work.delay_work),
-						K_MSEC(job->delay_ms));
-		if (ret != 1) { /* queued fail */
-			LOG_ERR("add_work add work to queue fail");
-			goto error;
-		}
+	if (ret <= 0) {
+		LOG_ERR("add_work add work to queue fail, ret %d", ret);
+		return ret;
+	}
+
+	// work_handler() returns new_job to the pool
+	return 1;
+}
+
+/* Attempt to add new work to worker, see add_work_with_handle(). */
+int add_work(worker_job *job)
+{
+	return add_work_with_handle(job, NULL);
+}
+
+/* Cancel a work added with add_work_with_handle().
+ *
+ * A work whose handler is running completes the run, but does not run again.
+ *
+ * @param handle handle of the work
+ *
+ * @retval true if the work will not run again.
+ * @retval false if the handle is not of a work in worker.
+ */
+bool cancel_work(worker_handle handle)
+{
+	k_spinlock_key_t key = k_spin_lock(&work_lock);
+
+	work_info *work_job = get_work_by_handle(handle);
+	if ((work_job == NULL) || (work_job->state == WORK_CANCELED)) {
+		k_spin_unlock(&work_lock, key);
+		return false;
 	}
-	work_count++;
-	k_mutex_unlock(&mutex_use_count);
-	// free new_job in work_handler()
-	return ret;
 
-error:
-	SAFE_FREE(new_job);
-	k_mutex_unlock(&mutex_use_count);
-	return ret;
+	/* A work canceled while its handler runs can't be queued again until the handler returns,
+	 * so one with a handler running is returned to the pool by its handler instead
+	 */
+	int busy = k_work_delayable_busy_get(&work_job->work);
+	if (((busy & (K_WORK_DELAYED | K_WORK_QUEUED)) != 0) && ((busy & K_WORK_RUNNING) == 0)) {
+		k_work_cancel_delayable(&work_job->work);
+		release_work(work_job);
+	} else {
+		work_job->state = WORK_CANCELED;
+	}
+
+	k_spin_unlock(&work_lock, key);
+	return true;
+}
+
+/* Move the next run of a work added with add_work_with_handle().
+ *
+ * @param handle handle of the work
+ * @param delay_ms time from now to run the work at
+ *
+ * @retval 1 if successfully rescheduled.
+ * @retval -1 if the handle is not of a work in worker.
+ * @retval -2 if the work is queued to run or its handler is running.
+ */
+int reschedule_work(worker_handle handle, uint32_t delay_ms)
+{
+	k_spinlock_key_t key = k_spin_lock(&work_lock);
+
+	work_info *work_job = get_work_by_handle(handle);
+	if ((work_job == NULL) || (work_job->state == WORK_CANCELED)) {
+		k_spin_unlock(&work_lock, key);
+		return -1;
+	}
+
+	/* Only a work waiting for its delay is moved, one in the queue is about to run */
+	int busy = k_work_delayable_busy_get(&work_job->work);
+	if ((work_job->state != WORK_QUEUED) ||
+	    ((busy & (K_WORK_DELAYED | K_WORK_QUEUED)) != K_WORK_DELAYED)) {
+		k_spin_unlock(&work_lock, key);
+		return -2;
+	}
+
+	set_due_time(work_job, delay_ms);
+	k_work_reschedule_for_queue(&worker_work_q, &work_job->work, K_MSEC(delay_ms));
+
+	k_spin_unlock(&work_lock, key);
+	return 1;
+}
+
+/* Get the run statistics of the work functions.
+ *
+ * @param start index of the first statistic to get
+ * @param stat buffer of max_num statistics
+ * @param max_num number of statistics the buffer holds
+ *
+ * @retval number of statistics got
+ */
+uint8_t get_work_stats(uint8_t start, worker_job_stat *stat, uint8_t max_num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(stat, 0);
+
+	uint8_t num = 0;
+
+	k_mutex_lock(&work_stat_mutex, K_FOREVER);
+	for (uint8_t i = start; (i < stat_num) && (num < max_num); i++) {
+		stat[num++] = stat_list[i];
+	}
+	k_mutex_unlock(&work_stat_mutex);
+
+	return num;
+}
+
+void clear_work_stats()
+{
+	k_mutex_lock(&work_stat_mutex, K_FOREVER);
+	stat_num = 0;
+	k_mutex_unlock(&work_stat_mutex);
+
+	atomic_set(&work_peak_count, atomic_get(&work_count));
+	atomic_clear(&work_full_count);
 }
 
 /* Initialize worker
  *
  * Should call this function to initialize worker before use other APIs.
- * This function initialize a workqueue and mutex.
+ * This function initialize a workqueue and the work entries.
  */
 void init_worker()
 {
+	for (uint8_t i = 0; i < MAX_WORK_COUNT; i++) {
+		k_work_init_delayable(&work_pool[i].work, work_handler);
+	}
+
 	k_work_queue_start(&worker_work_q, worker_stack_area,
 			   K_THREAD_STACK_SIZEOF(worker_stack_area), WORKER_PRIORITY, NULL);
 	k_thread_name_set(&worker_work_q.thread, "util_worker");
-	k_mutex_init(&mutex_use_count);
 }
 
 /* Initialize platform work queue
@@ -17,6 +17,7 @@
 #ifndef SMC_WORKER_H
 #define SMC_WORKER_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #define MAX_WORK_NAME_LEN 32
@@ -40,15 +41,49 @@ typedef struct {
    */
 	uint32_t delay_ms;
 
+	/* Time between the runs of a periodic work,
+   * set to 0 if the function runs once.
+   */
+	uint32_t period_ms;
+
 	/* Work name. */
 	char name[MAX_WORK_NAME_LEN];
 } worker_job;
 
+/* Handle of a submitted work, valid until the work is done or canceled. */
+typedef uint32_t worker_handle;
+
+#define WORKER_INVALID_HANDLE 0
+#define MAX_WORK_STAT_COUNT 32
+#define WARN_WORK_PROC_TIME_MS 1000
+
+/* Run statistics of the works of one function. */
+typedef struct {
+	void (*fn)(void *, uint32_t);
+	/* Name of the last work run */
+	char name[MAX_WORK_NAME_LEN];
+	uint32_t run_count;
+	/* Runs longer than WARN_WORK_PROC_TIME_MS */
+	uint32_t slow_count;
+	uint32_t last_run_us;
+	uint32_t max_run_us;
+	uint64_t total_run_us;
+	/* Longest wait from the due time to the start of a run */
+	uint32_t max_latency_us;
+} worker_job_stat;
+
 extern struct k_work_q plat_work_q;
 
 void init_plat_worker(int);
 uint8_t get_work_count();
+uint8_t get_work_peak_count();
+uint32_t get_work_full_count();
 int add_work(worker_job *);
+int add_work_with_handle(worker_job *, worker_handle *);
+bool cancel_work(worker_handle);
+int reschedule_work(worker_handle, uint32_t delay_ms);
+uint8_t get_work_stats(uint8_t start, worker_job_stat *stat, uint8_t max_num);
+void clear_work_stats();
 void init_worker();
 
 #endif
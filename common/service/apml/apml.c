@@ -30,6 +30,10 @@ LOG_MODULE_REGISTER(apml);
 #define APML_HANDLER_STACK_SIZE 2048
 #define APML_MSGQ_LEN 32
 #define WAIT_TIME_MS 10
+/* First status poll interval when ALERT_L does not wake the waiter, doubled up to WAIT_TIME_MS */
+#define WAIT_TIME_MIN_MS 1
+#define HWALERT_TIMEOUT_MS (RETRY_MAX * WAIT_TIME_MS)
+#define MAILBOX_COMPLETE_TIMEOUT_MS (MAILBOX_COMPLETE_RETRY_MAX * WAIT_TIME_MS)
 
 struct k_msgq apml_msgq;
 struct k_thread apml_thread;
@@ -37,6 +41,7 @@ char __aligned(4) apml_msgq_buffer[APML_MSGQ_LEN * sizeof(apml_msg)];
 K_THREAD_STACK_DEFINE(apml_handler_stack, APML_HANDLER_STACK_SIZE);
 apml_buffer apml_resp_buffer[APML_RESP_BUFFER_SIZE];
 static bool is_fatal_error_happened;
+K_SEM_DEFINE(apml_alert_sem, 0, 1);
 
 uint8_t apml_read_byte(uint8_t bus, uint8_t addr, uint8_t offset, uint8_t *read_data)
 {
@@ -74,20 +79,85 @@ uint8_t apml_write_byte(uint8_t bus, uint8_t addr, uint8_t offset, uint8_t write
 	return APML_SUCCESS;
 }
 
-static bool wait_HwAlert_set(apml_msg *msg, uint8_t retry)
+/* Register access for sequences that already hold the bus with i2c_bus_lock() */
+static uint8_t rmi_read_reg(apml_msg *msg, uint8_t offset, uint8_t *read_data)
+{
+	uint8_t retry = 5;
+	I2C_MSG i2c_msg;
+	i2c_msg.bus = msg->bus;
+	i2c_msg.target_addr = msg->target_addr;
+	i2c_msg.tx_len = 1;
+	i2c_msg.rx_len = 1;
+	i2c_msg.data[0] = offset;
+
+	if (i2c_master_read_without_mutex(&i2c_msg, retry)) {
+		return APML_ERROR;
+	}
+	*read_data = i2c_msg.data[0];
+	return APML_SUCCESS;
+}
+
+static uint8_t rmi_write_reg(apml_msg *msg, uint8_t offset, uint8_t write_data)
+{
+	uint8_t retry = 5;
+	I2C_MSG i2c_msg;
+	i2c_msg.bus = msg->bus;
+	i2c_msg.target_addr = msg->target_addr;
+	i2c_msg.tx_len = 2;
+	i2c_msg.rx_len = 0;
+	i2c_msg.data[0] = offset;
+	i2c_msg.data[1] = write_data;
+
+	if (i2c_master_write_without_mutex(&i2c_msg, retry)) {
+		return APML_ERROR;
+	}
+	return APML_SUCCESS;
+}
+
+/* Platform calls this on APML ALERT_L so a pending wait completes without polling */
+void apml_alert_notify()
+{
+	k_sem_give(&apml_alert_sem);
+}
+
+/* Wait until (register & mask) == expect.
+ *
+ * ALERT_L wakes the wait up as soon as the processor raises HwAlertSts or SwAlertSts. Platforms
+ * without it wired to apml_alert_notify() fall back to polling, starting at WAIT_TIME_MIN_MS so
+ * fast commands are not charged a full WAIT_TIME_MS.
+ */
+static bool wait_register_state(apml_msg *msg, uint8_t offset, uint8_t mask, uint8_t expect,
+				uint32_t timeout_ms, bool check_post)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg, false);
+
+	int64_t exp_to_ms = k_uptime_get() + timeout_ms;
+	uint32_t interval = WAIT_TIME_MIN_MS;
 	uint8_t read_data = 0;
-	for (uint8_t i = 0; i < retry; i++) {
-		if (!apml_read_byte(msg->bus, msg->target_addr, SBRMI_STATUS, &read_data)) {
-			if (read_data & 0x80) {
+
+	while (1) {
+		if (!apml_read_byte(msg->bus, msg->target_addr, offset, &read_data)) {
+			if ((read_data & mask) == expect) {
 				return true;
 			}
 		}
-		k_msleep(WAIT_TIME_MS);
+		if (check_post && !get_post_status()) {
+			return false;
+		}
+		if (k_uptime_get() >= exp_to_ms) {
+			return false;
+		}
+
+		k_sem_take(&apml_alert_sem, K_MSEC(interval));
+		interval = MIN(interval * 2, WAIT_TIME_MS);
 	}
-	return false;
 }
+
+static bool wait_HwAlert_set(apml_msg *msg)
+{
+	return wait_register_state(msg, SBRMI_STATUS, 0x80, 0x80, HWALERT_TIMEOUT_MS, false);
+}
+
 /****************** MCA *********************/
 
 static uint8_t write_MCA_request(apml_msg *msg)
@@ -131,13 +201,14 @@ static uint8_t read_MCA_response(apml_msg *msg)
 static uint8_t access_MCA(apml_msg *msg)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg, APML_ERROR);
+	k_sem_reset(&apml_alert_sem);
 	if (write_MCA_request(msg)) {
 		LOG_ERR("Write MCA request failed.");
 		return APML_ERROR;
 	}
 
-	if (!wait_HwAlert_set(msg, RETRY_MAX)) {
-		LOG_ERR("HwAlert not be set, retry %d times.", RETRY_MAX);
+	if (!wait_HwAlert_set(msg)) {
+		LOG_ERR("HwAlert not be set in %d ms.", HWALERT_TIMEOUT_MS);
 	}
 
 	if (read_MCA_response(msg)) {
@@ -195,13 +266,14 @@ static uint8_t read_CPUID_response(apml_msg *msg)
 static uint8_t access_CPUID(apml_msg *msg)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg, APML_ERROR);
+	k_sem_reset(&apml_alert_sem);
 	if (write_CPUID_request(msg)) {
 		LOG_ERR("Write CPUID request failed.");
 		return APML_ERROR;
 	}
 
-	if (!wait_HwAlert_set(msg, RETRY_MAX)) {
-		LOG_ERR("HwAlert not be set, retry %d times.", RETRY_MAX);
+	if (!wait_HwAlert_set(msg)) {
+		LOG_ERR("HwAlert not be set in %d ms.", HWALERT_TIMEOUT_MS);
 	}
 
 	if (read_CPUID_response(msg)) {
@@ -218,86 +290,102 @@ static uint8_t access_CPUID(apml_msg *msg)
 
 /****************** RMI Mailbox**************/
 
-static bool check_mailbox_command_complete(apml_msg *msg, uint8_t retry)
+static bool check_mailbox_command_complete(apml_msg *msg)
 {
-	CHECK_NULL_ARG_WITH_RETURN(msg, false);
-	uint8_t read_data = 0;
-	for (uint8_t i = 0; i < retry; i++) {
-		if (!apml_read_byte(msg->bus, msg->target_addr, SBRMI_SOFTWARE_INTERRUPT,
-				    &read_data)) {
-			if (!(read_data & 0x01)) {
-				return true;
-			}
-		}
-		k_msleep(WAIT_TIME_MS);
-	}
-	return false;
+	return wait_register_state(msg, SBRMI_SOFTWARE_INTERRUPT, 0x01, 0x00,
+				   RETRY_MAX * WAIT_TIME_MS, false);
 }
 
+/* Command, data and the software interrupt go out back to back under one bus lock */
 static uint8_t write_mailbox_request(apml_msg *msg)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg, APML_ERROR);
+
+	if (i2c_bus_lock(msg->bus)) {
+		return APML_ERROR;
+	}
+
+	uint8_t ret = APML_ERROR;
 	/* indicates command be serviced by firmware */
 	uint8_t read_data;
-	if (apml_read_byte(msg->bus, msg->target_addr, SBRMI_INBANDMSG_INST7, &read_data)) {
-		return APML_ERROR;
+	if (rmi_read_reg(msg, SBRMI_INBANDMSG_INST7, &read_data)) {
+		goto exit;
 	}
 	if (!(read_data & 0x80)) {
-		if (apml_write_byte(msg->bus, msg->target_addr, SBRMI_INBANDMSG_INST7, 0x80)) {
-			return APML_ERROR;
+		if (rmi_write_reg(msg, SBRMI_INBANDMSG_INST7, 0x80)) {
+			goto exit;
 		}
 	}
 
 	/* write command and data */
 	mailbox_WrData *wr_data = (mailbox_WrData *)msg->WrData;
-	if (apml_write_byte(msg->bus, msg->target_addr, SBRMI_INBANDMSG_INST0, wr_data->command)) {
-		return APML_ERROR;
+	if (rmi_write_reg(msg, SBRMI_INBANDMSG_INST0, wr_data->command)) {
+		goto exit;
 	}
 	for (uint8_t offset = SBRMI_INBANDMSG_INST1, i = 0; offset <= SBRMI_INBANDMSG_INST4;
 	     offset++, i++) {
-		if (apml_write_byte(msg->bus, msg->target_addr, offset, wr_data->data_in[i])) {
-			return APML_ERROR;
+		if (rmi_write_reg(msg, offset, wr_data->data_in[i])) {
+			goto exit;
 		}
 	}
 
 	/* notify to execute requested command */
-	if (apml_write_byte(msg->bus, msg->target_addr, SBRMI_SOFTWARE_INTERRUPT, 0x01)) {
-		return APML_ERROR;
+	if (rmi_write_reg(msg, SBRMI_SOFTWARE_INTERRUPT, 0x01)) {
+		goto exit;
 	}
+	ret = APML_SUCCESS;
 
-	return APML_SUCCESS;
+exit:
+	i2c_bus_unlock(msg->bus);
+	return ret;
 }
 
+/* Response registers are read and SwAlertSts is cleared under one bus lock */
 static uint8_t read_mailbox_response(apml_msg *msg)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg, APML_ERROR);
-	mailbox_RdData *rd_data = (mailbox_RdData *)msg->RdData;
-	if (apml_read_byte(msg->bus, msg->target_addr, SBRMI_OUTBANDMSG_INST0, &rd_data->command)) {
+
+	if (i2c_bus_lock(msg->bus)) {
 		return APML_ERROR;
 	}
+
+	uint8_t ret = APML_ERROR;
+	mailbox_RdData *rd_data = (mailbox_RdData *)msg->RdData;
+	if (rmi_read_reg(msg, SBRMI_OUTBANDMSG_INST0, &rd_data->command)) {
+		goto exit;
+	}
 	for (uint8_t offset = SBRMI_OUTBANDMSG_INST1, i = 0; offset <= SBRMI_OUTBANDMSG_INST4;
 	     offset++, i++) {
-		if (apml_read_byte(msg->bus, msg->target_addr, offset, &rd_data->data_out[i])) {
-			return APML_ERROR;
+		if (rmi_read_reg(msg, offset, &rd_data->data_out[i])) {
+			goto exit;
 		}
 	}
-	if (apml_read_byte(msg->bus, msg->target_addr, SBRMI_OUTBANDMSG_INST7,
-			   &rd_data->error_code)) {
-		return APML_ERROR;
+	if (rmi_read_reg(msg, SBRMI_OUTBANDMSG_INST7, &rd_data->error_code)) {
+		goto exit;
 	}
-	return APML_SUCCESS;
+
+	/* clear SwAlertSts */
+	if (rmi_write_reg(msg, SBRMI_STATUS, 0x02)) {
+		LOG_ERR("Clear SwAlertSts failed.");
+		goto exit;
+	}
+	ret = APML_SUCCESS;
+
+exit:
+	i2c_bus_unlock(msg->bus);
+	return ret;
 }
 
 static uint8_t access_RMI_mailbox(apml_msg *msg)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg, APML_ERROR);
-	int i = 0;
 
-	if (!check_mailbox_command_complete(msg, RETRY_MAX)) {
+	if (!check_mailbox_command_complete(msg)) {
 		LOG_ERR("Previous command not complete.");
 		return APML_ERROR;
 	}
 
+	k_sem_reset(&apml_alert_sem);
 	if (write_mailbox_request(msg)) {
 		LOG_ERR("Write request failed.");
 		return APML_ERROR;
@@ -306,22 +394,11 @@ static uint8_t access_RMI_mailbox(apml_msg *msg)
 	is_fatal_error_happened = false;
 
 	/* wait for SwAlertSts to be set */
-	uint8_t status;
-	for (i = 0; i < MAILBOX_COMPLETE_RETRY_MAX; i++) {
-		if (apml_read_byte(msg->bus, msg->target_addr, SBRMI_STATUS, &status)) {
-			LOG_ERR("Read SwAlertSts failed.");
-			return APML_ERROR;
-		}
-		if (status & 0x02) {
-			break;
+	if (!wait_register_state(msg, SBRMI_STATUS, 0x02, 0x02, MAILBOX_COMPLETE_TIMEOUT_MS,
+				 true)) {
+		if (get_post_status()) {
+			LOG_ERR("SwAlertSts not be set in %d ms.", MAILBOX_COMPLETE_TIMEOUT_MS);
 		}
-		k_msleep(WAIT_TIME_MS);
-		if (!get_post_status()) {
-			return APML_ERROR;
-		}
-	}
-	if (i == MAILBOX_COMPLETE_RETRY_MAX) {
-		LOG_ERR("SwAlertSts not be set, retry %d times.", MAILBOX_COMPLETE_RETRY_MAX);
 		return APML_ERROR;
 	}
 
@@ -335,11 +412,6 @@ static uint8_t access_RMI_mailbox(apml_msg *msg)
 		return APML_ERROR;
 	}
 
-	/* clear SwAlertSts */
-	if (apml_write_byte(msg->bus, msg->target_addr, SBRMI_STATUS, 0x02)) {
-		LOG_ERR("Clear SwAlertSts failed.");
-		return APML_ERROR;
-	}
 	return APML_SUCCESS;
 }
 
@@ -389,7 +461,6 @@ static void apml_handler(void *arvg0, void *arvg1, void *arvg2)
 			if (msg_data.error_cb_fn) {
 				msg_data.error_cb_fn(&msg_data);
 			}
-			k_msleep(10);
 			continue;
 		}
 
@@ -417,7 +488,6 @@ static void apml_handler(void *arvg0, void *arvg1, void *arvg2)
 				msg_data.cb_fn(&msg_data);
 			}
 		}
-		k_msleep(10);
 	}
 }
 
@@ -128,6 +128,7 @@ void apml_request_callback(apml_msg *msg);
 uint8_t get_apml_response_by_index(apml_msg *msg, uint8_t index);
 uint8_t apml_read(apml_msg *msg);
 void apml_init();
+void apml_alert_notify();
 void fatal_error_happened();
 
 #endif
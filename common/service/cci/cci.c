@@ -1,5 +1,6 @@
 #include "cci.h"
 #include "mctp.h"
+#include "mctp_trans.h"
 #include <logging/log.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -15,73 +16,8 @@
 
 LOG_MODULE_REGISTER(cci);
 
-#define DEFAULT_WAIT_TO_MS 3000
-#define RESP_MSG_PROC_MUTEX_WAIT_TO_MS 1000
-#define TO_CHK_INTERVAL_MS 1000
 #define CCI_MSG_MAX_RETRY 3
 #define CCI_MSG_TIMEOUT_MS 3000
-#define CCI_READ_EVENT_SUCCESS BIT(0)
-#define CCI_READ_EVENT_TIMEOUT BIT(1)
-
-static K_MUTEX_DEFINE(wait_recv_resp_mutex);
-
-static sys_slist_t wait_recv_resp_list = SYS_SLIST_STATIC_INIT(&wait_recv_resp_list);
-
-static uint8_t mctp_cci_msg_timeout_check(sys_slist_t *list, struct k_mutex *mutex)
-{
-	CHECK_NULL_ARG_WITH_RETURN(list, MCTP_ERROR);
-	CHECK_NULL_ARG_WITH_RETURN(mutex, MCTP_ERROR);
-
-	if (k_mutex_lock(mutex, K_MSEC(RESP_MSG_PROC_MUTEX_WAIT_TO_MS))) {
-		LOG_WRN("cci mutex is locked over %d ms!!", RESP_MSG_PROC_MUTEX_WAIT_TO_MS);
-		return MCTP_ERROR;
-	}
-
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	int64_t cur_uptime = k_uptime_get();
-
-	SYS_SLIST_FOR_EACH_NODE_SAFE (list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-
-		if ((p->exp_to_ms <= cur_uptime)) {
-			printk("mctp cci msg timeout!!\n");
-			sys_slist_remove(list, pre_node, node);
-
-			if (p->msg.timeout_cb_fn)
-				p->msg.timeout_cb_fn(p->msg.timeout_cb_fn_args);
-
-			SAFE_FREE(p);
-		} else {
-			pre_node = node;
-		}
-	}
-
-	k_mutex_unlock(mutex);
-	return MCTP_SUCCESS;
-}
-
-static void mctp_cci_msg_timeout_monitor(void *dummy0, void *dummy1, void *dummy2)
-{
-	ARG_UNUSED(dummy0);
-	ARG_UNUSED(dummy1);
-	ARG_UNUSED(dummy2);
-
-	while (1) {
-		k_msleep(TO_CHK_INTERVAL_MS);
-
-		mctp_cci_msg_timeout_check(&wait_recv_resp_list, &wait_recv_resp_mutex);
-	}
-}
-
-static void cci_read_timeout_handler(void *args)
-{
-	CHECK_NULL_ARG(args);
-	struct k_msgq *msgq = (struct k_msgq *)args;
-	uint8_t status = CCI_READ_EVENT_TIMEOUT;
-	k_msgq_put(msgq, &status, K_NO_WAIT);
-}
 
 static uint8_t mctp_cci_cmd_resp_process(mctp *mctp_inst, uint8_t *buf, uint32_t len,
 					 mctp_ext_params ext_params)
@@ -89,41 +25,24 @@ static uint8_t mctp_cci_cmd_resp_process(mctp *mctp_inst, uint8_t *buf, uint32_t
 	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, MCTP_ERROR);
 	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
 
+	if (len < sizeof(mctp_cci_hdr))
+		return MCTP_ERROR;
+
 	mctp_cci_hdr *cci_hdr = (mctp_cci_hdr *)buf;
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	sys_snode_t *found_node = NULL;
+	mctp_trans_cb cb;
 
-	if (k_mutex_lock(&wait_recv_resp_mutex, K_MSEC(RESP_MSG_PROC_MUTEX_WAIT_TO_MS))) {
-		LOG_WRN("mutex is locked over %d ms!", RESP_MSG_PROC_MUTEX_WAIT_TO_MS);
-		return MCTP_ERROR;
-	}
-	SYS_SLIST_FOR_EACH_NODE_SAFE (&wait_recv_resp_list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-		/* found the proper handler */
-		if ((p->mctp_inst == mctp_inst) && (p->msg.hdr.msg_tag == cci_hdr->msg_tag) &&
-		    (p->msg.hdr.op == cci_hdr->op)) {
-			found_node = node;
-			sys_slist_remove(&wait_recv_resp_list, pre_node, node);
-			break;
-		} else {
-			pre_node = node;
-		}
-	}
-	k_mutex_unlock(&wait_recv_resp_mutex);
-
-	if (found_node) {
-		/* invoke resp handler */
-		wait_msg *p = (wait_msg *)found_node;
-		if (p->msg.recv_resp_cb_fn)
-			p->msg.recv_resp_cb_fn(
-				p->msg.recv_resp_cb_args, buf + sizeof(p->msg.hdr),
-				len - sizeof(p->msg.hdr),
-				cci_hdr->ret); /* remove mctp cci header for handler */
-		SAFE_FREE(p);
+	if (!mctp_trans_take(mctp_inst, MCTP_MSG_TYPE_CCI, cci_hdr->msg_tag, cci_hdr->op, &cb)) {
+		LOG_DBG("Drop unexpected response, op 0x%x, tag 0x%x", cci_hdr->op,
+			cci_hdr->msg_tag);
+		return MCTP_SUCCESS;
 	}
 
+	/* The CCI handler also takes the return code, see mctp_cci_send_msg */
+	cci_resp_fn resp_fn = (cci_resp_fn)cb.resp_fn;
+	if (resp_fn)
+		resp_fn(cb.resp_args, buf + sizeof(*cci_hdr), len - sizeof(*cci_hdr),
+			cci_hdr->ret); /* remove mctp cci header for handler */
+
 	return MCTP_SUCCESS;
 }
 
@@ -133,10 +52,24 @@ uint8_t mctp_cci_send_msg(void *mctp_p, mctp_cci_msg *msg)
 	CHECK_NULL_ARG_WITH_RETURN(msg, CCI_ERROR);
 
 	mctp *mctp_inst = (mctp *)mctp_p;
-	wait_msg *p = NULL;
+	uint8_t trans_id = 0;
 
 	if (!msg->hdr.cci_msg_req_resp) {
-		msg->hdr.msg_tag = mctp_inst->cci_msg_tag++;
+		/* Stored as a generic handler, mctp_cci_cmd_resp_process casts it back */
+		mctp_trans_cb cb = {
+			.resp_fn = (mctp_trans_resp_fn)msg->recv_resp_cb_fn,
+			.resp_args = msg->recv_resp_cb_args,
+			.timeout_fn = msg->timeout_cb_fn,
+			.timeout_args = msg->timeout_cb_fn_args,
+			.timeout_ms = msg->timeout_ms,
+		};
+
+		if (!mctp_trans_begin(mctp_inst, MCTP_MSG_TYPE_CCI, msg->hdr.op, &cb, &trans_id)) {
+			LOG_WRN("Register failed!");
+			return CCI_ERROR;
+		}
+
+		msg->hdr.msg_tag = trans_id;
 		msg->hdr.msg_type = MCTP_MSG_TYPE_CCI;
 		msg->ext_params.tag_owner = 1;
 	}
@@ -150,31 +83,12 @@ uint8_t mctp_cci_send_msg(void *mctp_p, mctp_cci_msg *msg)
 	}
 	LOG_HEXDUMP_DBG(buf, len, __func__);
 
-	if (!msg->hdr.cci_msg_req_resp) {
-		p = (wait_msg *)malloc(sizeof(wait_msg));
-		if (p == NULL) {
-			LOG_WRN("wait_msg alloc failed!");
-			return CCI_ERROR;
-		}
-
-		memset(p, 0, sizeof(wait_msg));
-		p->mctp_inst = mctp_inst;
-		p->msg = *msg;
-		p->exp_to_ms =
-			k_uptime_get() + (msg->timeout_ms ? msg->timeout_ms : DEFAULT_WAIT_TO_MS);
-
-		k_mutex_lock(&wait_recv_resp_mutex, K_FOREVER);
-		sys_slist_append(&wait_recv_resp_list, &p->node);
-		k_mutex_unlock(&wait_recv_resp_mutex);
-	}
-
 	uint8_t rc = mctp_send_msg(mctp_inst, buf, len, msg->ext_params);
-	if (rc == CCI_ERROR) {
+	if (rc == MCTP_ERROR) {
 		LOG_WRN("mctp_send_msg error!!");
 
-		if (p != NULL) {
-			sys_slist_find_and_remove(&wait_recv_resp_list, &p->node);
-			SAFE_FREE(p);
+		if (!msg->hdr.cci_msg_req_resp) {
+			mctp_trans_abort(trans_id);
 		}
 		return CCI_ERROR;
 	}
@@ -186,23 +100,14 @@ void cci_read_resp_handler(void *args, uint8_t *rbuf, uint16_t rlen, uint16_t re
 {
 	CHECK_NULL_ARG(args);
 	CHECK_NULL_ARG(rbuf);
-	uint8_t status = 0;
-	cci_recv_resp_arg *recv_arg = (cci_recv_resp_arg *)args;
-
-	if (rlen > recv_arg->rbuf_len) {
-		LOG_WRN("Response length(%d) is greater than buffer length(%d)!", rlen,
-			recv_arg->rbuf_len);
-		recv_arg->return_len = recv_arg->rbuf_len;
-	} else {
-		recv_arg->return_len = rlen;
-	}
-	memcpy(recv_arg->rbuf, rbuf, recv_arg->return_len);
-	if (ret_code == CCI_CC_SUCCESS) {
-		status = CCI_READ_EVENT_SUCCESS;
-	} else {
+
+	uint8_t status = MCTP_TRANS_STATUS_SUCCESS;
+	if (ret_code != CCI_CC_SUCCESS) {
 		LOG_ERR("Return code status(0x%04x)!", ret_code);
+		status = MCTP_TRANS_STATUS_CC_ERROR;
 	}
-	k_msgq_put(recv_arg->msgq, &status, K_NO_WAIT);
+
+	mctp_trans_wait_done((mctp_trans_wait_ctx *)args, rbuf, rlen, status);
 }
 
 uint16_t mctp_cci_read(void *mctp_p, mctp_cci_msg *msg, uint8_t *rbuf, uint16_t rbuf_len)
@@ -211,52 +116,24 @@ uint16_t mctp_cci_read(void *mctp_p, mctp_cci_msg *msg, uint8_t *rbuf, uint16_t
 	CHECK_NULL_ARG_WITH_RETURN(msg, 0);
 	CHECK_NULL_ARG_WITH_RETURN(rbuf, 0);
 
-	uint8_t event_msgq_buffer[1];
-	struct k_msgq *event_msgq_p = (struct k_msgq *)malloc(sizeof(struct k_msgq));
-	if (!event_msgq_p) {
-		LOG_WRN("event_msgq_p alloc failed!");
-		return 0;
-	}
-	uint16_t ret_len = 0;
-
-	k_msgq_init(event_msgq_p, event_msgq_buffer, sizeof(uint8_t), 1);
-
-	cci_recv_resp_arg *recv_arg_p = (cci_recv_resp_arg *)malloc(sizeof(cci_recv_resp_arg));
-	if (!recv_arg_p) {
-		SAFE_FREE(event_msgq_p);
-		LOG_WRN("recv_arg_p alloc failed!");
-		return 0;
-	}
-	recv_arg_p->msgq = event_msgq_p;
-	recv_arg_p->rbuf = rbuf;
-	recv_arg_p->rbuf_len = rbuf_len;
-	recv_arg_p->return_len = 0;
+	mctp_trans_wait_ctx wait_ctx;
 
 	msg->recv_resp_cb_fn = cci_read_resp_handler;
-	msg->recv_resp_cb_args = (void *)recv_arg_p;
-	msg->timeout_cb_fn = cci_read_timeout_handler;
-	msg->timeout_cb_fn_args = (void *)event_msgq_p;
+	msg->recv_resp_cb_args = (void *)&wait_ctx;
+	msg->timeout_cb_fn = mctp_trans_wait_timeout_handler;
+	msg->timeout_cb_fn_args = (void *)&wait_ctx;
 	msg->timeout_ms = CCI_MSG_TIMEOUT_MS;
 
 	for (uint8_t retry_count = 0; retry_count < CCI_MSG_MAX_RETRY; retry_count++) {
-		uint8_t event = 0;
+		mctp_trans_wait_init(&wait_ctx, rbuf, rbuf_len);
 		if (mctp_cci_send_msg(mctp_p, msg) == CCI_ERROR) {
 			LOG_WRN("send msg failed!");
 			continue;
 		}
-		if (k_msgq_get(event_msgq_p, &event, K_FOREVER)) {
-			LOG_WRN("Failed to get status from msgq!");
-			continue;
-		}
-		if (event == CCI_READ_EVENT_SUCCESS) {
-			ret_len = recv_arg_p->return_len;
-			SAFE_FREE(recv_arg_p);
-			SAFE_FREE(event_msgq_p);
-			return ret_len;
+		if (mctp_trans_wait(&wait_ctx) == MCTP_TRANS_STATUS_SUCCESS) {
+			return wait_ctx.return_len;
 		}
 	}
-	SAFE_FREE(recv_arg_p);
-	SAFE_FREE(event_msgq_p);
 	LOG_WRN("Retry reach max!");
 	return 0;
 }
@@ -364,6 +241,4 @@ bool cci_get_chip_fw_version(void *mctp_p, mctp_ext_params ext_params, uint8_t *
 	return true;
 }
 
-K_THREAD_DEFINE(monitor_cci_msg, 1024, mctp_cci_msg_timeout_monitor, NULL, NULL, NULL, 7, 0, 0);
-
 #endif
@@ -47,13 +47,6 @@ struct _cci_handler_query_entry {
 	void (*handler_query)(uint8_t *, uint16_t);
 };
 
-typedef struct _cci_recv_resp_arg {
-	struct k_msgq *msgq;
-	uint8_t *rbuf;
-	uint16_t rbuf_len;
-	uint16_t return_len;
-} cci_recv_resp_arg;
-
 typedef struct __attribute__((packed)) {
 	uint8_t msg_type : 7;
 	uint8_t ic : 1;
@@ -68,11 +61,14 @@ typedef struct __attribute__((packed)) {
 	uint16_t stat;
 } mctp_cci_hdr;
 
+/* Response handler, the last argument is the CCI return code */
+typedef void (*cci_resp_fn)(void *, uint8_t *, uint16_t, uint16_t);
+
 typedef struct {
 	mctp_cci_hdr hdr;
 	uint8_t *pl_data;
 	mctp_ext_params ext_params;
-	void (*recv_resp_cb_fn)(void *, uint8_t *, uint16_t, uint16_t);
+	cci_resp_fn recv_resp_cb_fn;
 	void *recv_resp_cb_args;
 	uint16_t timeout_ms;
 	void (*timeout_cb_fn)(void *);
@@ -104,13 +100,6 @@ typedef struct _mctp_cci_cmd_handler {
 #define CCI_ERROR 0x0001
 #define CCI_INVALID_TYPE 0x0002
 
-typedef struct _wait_msg {
-	sys_snode_t node;
-	mctp *mctp_inst;
-	int64_t exp_to_ms;
-	mctp_cci_msg msg;
-} wait_msg;
-
 /*CCI command handler */
 uint8_t mctp_cci_cmd_handler(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext_params ext_params);
 void cci_read_resp_handler(void *args, uint8_t *rbuf, uint16_t rlen, uint16_t ret_code);
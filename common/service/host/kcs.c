@@ -33,6 +33,7 @@
 LOG_MODULE_REGISTER(kcs);
 
 kcs_dev *kcs;
+static uint8_t kcs_channel_num = 0;
 static bool proc_kcs_ok = false;
 
 void kcs_write(uint8_t index, uint8_t *buf, uint32_t buf_sz)
@@ -45,6 +46,39 @@ void kcs_write(uint8_t index, uint8_t *buf, uint32_t buf_sz)
 	}
 }
 
+/* Write a response to host through the channel's preallocated buffer.
+ *
+ * @param netfn response netfn, not shifted
+ */
+void kcs_send_response(uint8_t index, uint8_t netfn, uint8_t cmd, uint8_t cmplt_code,
+		       const uint8_t *data, uint16_t data_len)
+{
+	if ((index >= kcs_channel_num) || (kcs[index].dev == NULL)) {
+		LOG_ERR("Invalid KCS channel index %d", index);
+		return;
+	}
+
+	kcs_dev *kcs_inst = &kcs[index];
+	if (k_mutex_lock(&kcs_inst->tx_mutex, K_MSEC(1000))) {
+		LOG_ERR("Failed to lock KCS %d tx mutex", index);
+		return;
+	}
+
+	if (data_len > (KCS_BUFF_SIZE - 3)) {
+		data_len = KCS_BUFF_SIZE - 3;
+	}
+
+	kcs_inst->tx_buf[0] = netfn << 2;
+	kcs_inst->tx_buf[1] = cmd;
+	kcs_inst->tx_buf[2] = cmplt_code;
+	if ((data != NULL) && (data_len != 0)) {
+		memcpy(&kcs_inst->tx_buf[3], data, data_len);
+	}
+	kcs_write(index, kcs_inst->tx_buf, data_len + 3);
+
+	k_mutex_unlock(&kcs_inst->tx_mutex);
+}
+
 bool get_kcs_ok()
 {
 	return proc_kcs_ok;
@@ -55,15 +89,191 @@ void reset_kcs_ok()
 	proc_kcs_ok = false;
 }
 
-static void kcs_read_task(void *arvg0, void *arvg1, void *arvg2)
+static void kcs_handle_immediate_response(kcs_dev *kcs_inst, struct kcs_request *req)
+{
+	/* Add SEL response carries a record ID, BMC assigns the real one */
+	static const uint8_t add_sel_resp[] = { 0x00, 0x00 };
+
+	if ((req->netfn == NETFN_STORAGE_REQ) && (req->cmd == CMD_STORAGE_ADD_SEL)) {
+		kcs_send_response(kcs_inst->index, req->netfn | BIT(0), req->cmd, CC_SUCCESS,
+				  add_sel_resp, sizeof(add_sel_resp));
+	} else {
+		kcs_send_response(kcs_inst->index, req->netfn | BIT(0), req->cmd, CC_SUCCESS, NULL,
+				  0);
+	}
+}
+
+/* Host request forwarded to BMC over PLDM and not answered yet */
+typedef struct {
+	pldm_ipmi_async_req req;
+	uint8_t kcs_index;
+	bool need_response;
+} kcs_bridge_slot;
+
+static kcs_bridge_slot kcs_bridge_slots[KCS_MAX_PENDING_BRIDGE];
+static atomic_t kcs_bridge_slot_used = ATOMIC_INIT(0);
+
+static kcs_bridge_slot *kcs_bridge_slot_alloc()
+{
+	for (uint8_t i = 0; i < KCS_MAX_PENDING_BRIDGE; i++) {
+		if (!atomic_test_and_set_bit(&kcs_bridge_slot_used, i)) {
+			return &kcs_bridge_slots[i];
+		}
+	}
+	return NULL;
+}
+
+static void kcs_bridge_slot_free(kcs_bridge_slot *slot)
+{
+	atomic_clear_bit(&kcs_bridge_slot_used, slot - kcs_bridge_slots);
+}
+
+/* Called from the MCTP receive thread for a response, or from the system workqueue when the
+ * mctp_trans slot timer expires, never from the KCS task
+ */
+static void kcs_bridge_resp_handler(pldm_ipmi_async_req *req)
+{
+	kcs_bridge_slot *slot = CONTAINER_OF(req, kcs_bridge_slot, req);
+
+	if (req->msg.completion_code == CC_TIMEOUT) {
+		LOG_WRN("BMC did not respond to KCS %d netfn 0x%x cmd 0x%x", slot->kcs_index,
+			req->msg.netfn, req->msg.cmd);
+	}
+
+	// Write MCTP/PLDM response to KCS
+	if (slot->need_response) {
+		kcs_send_response(slot->kcs_index, req->msg.netfn | BIT(0), req->msg.cmd,
+				  req->msg.completion_code, req->msg.data, req->msg.data_len);
+	}
+
+	kcs_bridge_slot_free(slot);
+}
+
+static void kcs_bridge_to_bmc(kcs_dev *kcs_inst, uint8_t *ibuf, int len)
 {
-	int rc = 0;
-	uint8_t ibuf[KCS_BUFF_SIZE];
 	ipmi_msg bridge_msg;
-	ipmi_msg_cfg current_msg;
 	ipmb_error status;
+	struct kcs_request *req = (struct kcs_request *)ibuf;
+	bool need_response = !pal_immediate_respond_from_HOST(req->netfn, req->cmd);
+
+	// Check BMC communication interface if use IPMB or not
+	if (!pal_is_interface_use_ipmb(IPMB_inf_index_map[BMC_IPMB])) {
+		/* Do not block the KCS task on the BMC round trip, the response is written to
+		 * host from kcs_bridge_resp_handler.
+		 */
+		kcs_bridge_slot *slot = kcs_bridge_slot_alloc();
+		if (slot == NULL) {
+			LOG_ERR("Too many pending KCS requests to BMC");
+			if (need_response) {
+				kcs_send_response(kcs_inst->index, req->netfn | BIT(0), req->cmd,
+						  CC_NODE_BUSY, NULL, 0);
+			}
+			return;
+		}
+
+		ipmi_msg *msg = &slot->req.msg;
+		msg->data_len = len - 2; // exclude netfn, cmd
+		msg->seq_source = 0xff; // No seq for KCS
+		msg->InF_source = HOST_KCS_1 + kcs_inst->index;
+		msg->InF_target = BMC_IPMB; // default bypassing IPMI standard command to BMC
+		msg->netfn = req->netfn;
+		msg->cmd = req->cmd;
+		if (msg->data_len != 0) {
+			memcpy(&msg->data[0], &ibuf[2], msg->data_len);
+		}
+		slot->req.resp_fn = kcs_bridge_resp_handler;
+		slot->kcs_index = kcs_inst->index;
+		slot->need_response = need_response;
 
-	struct kcs_request *req;
+		// Send request to MCTP/PLDM thread to ask BMC
+		if (pldm_send_ipmi_request_async(&slot->req) < 0) {
+			LOG_ERR("kcs_read_task send to BMC fail");
+			if (need_response) {
+				kcs_send_response(kcs_inst->index, req->netfn | BIT(0), req->cmd,
+						  CC_UNSPECIFIED_ERROR, NULL, 0);
+			}
+			kcs_bridge_slot_free(slot);
+		}
+		return;
+	}
+
+	bridge_msg.data_len = len - 2; // exclude netfn, cmd
+	bridge_msg.seq_source = 0xff; // No seq for KCS
+	bridge_msg.InF_source = HOST_KCS_1 + kcs_inst->index;
+	bridge_msg.InF_target = BMC_IPMB; // default bypassing IPMI standard command to BMC
+	bridge_msg.netfn = req->netfn;
+	bridge_msg.cmd = req->cmd;
+	if (bridge_msg.data_len != 0) {
+		memcpy(&bridge_msg.data[0], &ibuf[2], bridge_msg.data_len);
+	}
+
+	// IPMB response is written to host by the IPMB rx thread
+	status = ipmb_send_request(&bridge_msg, IPMB_inf_index_map[BMC_IPMB]);
+	if (status != IPMB_ERROR_SUCCESS) {
+		LOG_ERR("kcs_read_task send to BMC fail status: 0x%x", status);
+	}
+}
+
+static void kcs_handle_request(kcs_dev *kcs_inst, uint8_t *ibuf, int len)
+{
+	ipmi_msg_cfg current_msg = { 0 };
+	struct kcs_request *req = (struct kcs_request *)ibuf;
+
+	LOG_HEXDUMP_DBG(&ibuf[0], len, "host KCS read dump data:");
+
+	proc_kcs_ok = true;
+	req->netfn = req->netfn >> 2;
+
+	if (pal_request_msg_to_BIC_from_HOST(req->netfn,
+					     req->cmd)) { // In-band update command, not bridging to bmc
+		current_msg.buffer.InF_source = HOST_KCS_1 + kcs_inst->index;
+		current_msg.buffer.netfn = req->netfn;
+		current_msg.buffer.cmd = req->cmd;
+		current_msg.buffer.data_len = len - 2; // exclude netfn, cmd
+		if (current_msg.buffer.data_len != 0) {
+			memcpy(current_msg.buffer.data, req->data, current_msg.buffer.data_len);
+		}
+
+		LOG_DBG("KCS to ipmi netfn 0x%x, cmd 0x%x, length %d", current_msg.buffer.netfn,
+			current_msg.buffer.cmd, current_msg.buffer.data_len);
+		notify_ipmi_client(&current_msg);
+		return;
+	}
+
+	// default command for BMC, should add BIC firmware update, BMC reset, real time sensor read in future
+	if (pal_immediate_respond_from_HOST(req->netfn, req->cmd)) {
+		kcs_handle_immediate_response(kcs_inst, req);
+	}
+	if ((req->netfn == NETFN_APP_REQ) && (req->cmd == CMD_APP_SET_SYS_INFO_PARAMS) &&
+	    (req->data[0] == CMD_SYS_INFO_FW_VERSION)) {
+		int ret = pal_record_bios_fw_version(ibuf, len);
+		if (ret == -1) {
+			LOG_ERR("Record bios fw version fail");
+		}
+	}
+	if ((req->netfn == NETFN_OEM_Q_REQ) && (req->cmd == CMD_OEM_Q_SET_DIMM_INFO) &&
+	    (req->data[4] == CMD_DIMM_LOCATION)) {
+		int ret = pal_set_dimm_presence_status(ibuf);
+		if (!ret) {
+			LOG_ERR("Set dimm presence status fail");
+		}
+	}
+
+	kcs_bridge_to_bmc(kcs_inst, ibuf, len);
+}
+
+/* Called in the KCS driver ISR */
+static void kcs_rx_callback(void *arg)
+{
+	kcs_dev *kcs_inst = (kcs_dev *)arg;
+
+	k_sem_give(&kcs_inst->rx_sem);
+}
+
+static void kcs_read_task(void *arvg0, void *arvg1, void *arvg2)
+{
+	int rc = 0;
+	uint8_t ibuf[KCS_BUFF_SIZE];
 
 	ARG_UNUSED(arvg1);
 	ARG_UNUSED(arvg2);
@@ -73,125 +283,17 @@ static void kcs_read_task(void *arvg0, void *arvg1, void *arvg2)
 		return;
 	}
 
+	k_timeout_t timeout = kcs_inst->is_rx_event ? K_FOREVER : K_MSEC(KCS_POLLING_INTERVAL);
+
 	while (1) {
-		k_msleep(KCS_POLLING_INTERVAL);
+		k_sem_take(&kcs_inst->rx_sem, timeout);
 
-		rc = kcs_aspeed_read(kcs_inst->dev, ibuf, sizeof(ibuf));
-		if (rc < 0) {
-			if (rc != -ENODATA)
-				LOG_ERR("Failed to read KCS data, rc = %d", rc);
-			continue;
+		/* A request written before the wait leaves the semaphore given, read until empty */
+		while ((rc = kcs_aspeed_read(kcs_inst->dev, ibuf, sizeof(ibuf))) >= 0) {
+			kcs_handle_request(kcs_inst, ibuf, rc);
 		}
-
-		LOG_HEXDUMP_DBG(&ibuf[0], rc, "host KCS read dump data:");
-
-		proc_kcs_ok = true;
-		req = (struct kcs_request *)ibuf;
-		req->netfn = req->netfn >> 2;
-
-		if (pal_request_msg_to_BIC_from_HOST(
-			    req->netfn, req->cmd)) { // In-band update command, not bridging to bmc
-			current_msg.buffer.InF_source = HOST_KCS_1 + kcs_inst->index;
-			current_msg.buffer.netfn = req->netfn;
-			current_msg.buffer.cmd = req->cmd;
-			current_msg.buffer.data_len = rc - 2; // exclude netfn, cmd
-			if (current_msg.buffer.data_len != 0) {
-				memcpy(current_msg.buffer.data, req->data,
-				       current_msg.buffer.data_len);
-			}
-
-			LOG_DBG("KCS to ipmi netfn 0x%x, cmd 0x%x, length %d",
-				current_msg.buffer.netfn, current_msg.buffer.cmd,
-				current_msg.buffer.data_len);
-			notify_ipmi_client(&current_msg);
-		} else { // default command for BMC, should add BIC firmware update, BMC reset, real time sensor read in future
-			if (pal_immediate_respond_from_HOST(req->netfn, req->cmd)) {
-				do { // break if malloc fail.
-					uint8_t *kcs_buff;
-					kcs_buff = malloc(KCS_BUFF_SIZE * sizeof(uint8_t));
-					if (kcs_buff == NULL) {
-						LOG_ERR("Failed to malloc for kcs_buff");
-						break;
-					}
-					kcs_buff[0] = (req->netfn | BIT(0)) << 2;
-					kcs_buff[1] = req->cmd;
-					kcs_buff[2] = CC_SUCCESS;
-
-					if (((req->netfn == NETFN_STORAGE_REQ) &&
-					     (req->cmd == CMD_STORAGE_ADD_SEL))) {
-						kcs_buff[3] = 0x00;
-						kcs_buff[4] = 0x00;
-						kcs_write(kcs_inst->index, kcs_buff, 5);
-					} else {
-						kcs_write(kcs_inst->index, kcs_buff, 3);
-					}
-					SAFE_FREE(kcs_buff);
-				} while (0);
-			}
-			if ((req->netfn == NETFN_APP_REQ) &&
-			    (req->cmd == CMD_APP_SET_SYS_INFO_PARAMS) &&
-			    (req->data[0] == CMD_SYS_INFO_FW_VERSION)) {
-				int ret = pal_record_bios_fw_version(ibuf, rc);
-				if (ret == -1) {
-					LOG_ERR("Record bios fw version fail");
-				}
-			}
-			if ((req->netfn == NETFN_OEM_Q_REQ) &&
-			    (req->cmd == CMD_OEM_Q_SET_DIMM_INFO) &&
-			    (req->data[4] == CMD_DIMM_LOCATION)) {
-				int ret = pal_set_dimm_presence_status(ibuf);
-				if (!ret) {
-					LOG_ERR("Set dimm presence status fail");
-				}
-			}
-			bridge_msg.data_len = rc - 2; // exclude netfn, cmd
-			bridge_msg.seq_source = 0xff; // No seq for KCS
-			bridge_msg.InF_source = HOST_KCS_1 + kcs_inst->index;
-			bridge_msg.InF_target =
-				BMC_IPMB; // default bypassing IPMI standard command to BMC
-			bridge_msg.netfn = req->netfn;
-			bridge_msg.cmd = req->cmd;
-			if (bridge_msg.data_len != 0) {
-				memcpy(&bridge_msg.data[0], &ibuf[2], bridge_msg.data_len);
-			}
-
-			// Check BMC communication interface if use IPMB or not
-			if (!pal_is_interface_use_ipmb(IPMB_inf_index_map[BMC_IPMB])) {
-				int ret = 0;
-
-				// Send request to MCTP/PLDM thread to ask BMC
-				ret = pldm_send_ipmi_request(&bridge_msg);
-				if (ret < 0) {
-					LOG_ERR("kcs_read_task send to BMC fail");
-				}
-
-				uint8_t *kcs_buff;
-				kcs_buff = malloc(3 + bridge_msg.data_len);
-				if (kcs_buff == NULL) {
-					LOG_ERR("Memory allocation failed");
-					continue;
-				}
-
-				// Write MCTP/PLDM response to KCS
-				kcs_buff[0] = (bridge_msg.netfn | BIT(0)) << 2;
-				kcs_buff[1] = bridge_msg.cmd;
-				kcs_buff[2] = bridge_msg.completion_code;
-				memcpy(&kcs_buff[3], &bridge_msg.data, bridge_msg.data_len);
-
-				if (!pal_immediate_respond_from_HOST(req->netfn, req->cmd)) {
-					kcs_write(kcs_inst->index, kcs_buff,
-						  3 + bridge_msg.data_len);
-				}
-
-				SAFE_FREE(kcs_buff);
-			} else {
-				status = ipmb_send_request(&bridge_msg,
-							   IPMB_inf_index_map[BMC_IPMB]);
-				if (status != IPMB_ERROR_SUCCESS) {
-					LOG_ERR("kcs_read_task send to BMC fail status: 0x%x",
-						status);
-				}
-			}
+		if (rc != -ENODATA) {
+			LOG_ERR("Failed to read KCS data, rc = %d", rc);
 		}
 	}
 }
@@ -212,8 +314,10 @@ void kcs_device_init(char **config, uint8_t size)
 		SAFE_FREE(kcs);
 		return;
 	}
+	kcs_channel_num = size;
 
 	for (i = 0; i < size; i++) {
+		k_mutex_init(&kcs[i].tx_mutex);
 		kcs[i].dev = device_get_binding(config[i]);
 		if (!kcs[i].dev) {
 			LOG_ERR("Failed to find kcs device");
@@ -221,6 +325,13 @@ void kcs_device_init(char **config, uint8_t size)
 		}
 		snprintf(kcs[i].task_name, sizeof(kcs[i].task_name), "%s_polling", config[i]);
 		kcs[i].index = i;
+		k_sem_init(&kcs[i].rx_sem, 0, 1);
+		kcs[i].is_rx_event = (kcs_aspeed_register_rx_callback(kcs[i].dev, kcs_rx_callback,
+									 (void *)&kcs[i]) == 0);
+		if (!kcs[i].is_rx_event) {
+			LOG_WRN("KCS %d has no RX callback, poll every %d ms", i,
+				KCS_POLLING_INTERVAL);
+		}
 		kcs[i].task_tid = k_thread_create(&kcs[i].task_thread, kcs[i].task_stack,
 						  K_THREAD_STACK_SIZEOF(kcs[i].task_stack),
 						  kcs_read_task, (void *)&kcs[i], NULL, NULL,
@@ -24,9 +24,12 @@
 #include <zephyr.h>
 
 #define KCS_POLL_STACK_SIZE 4096
+/* Polling interval, only used when the KCS driver has no RX callback */
 #define KCS_POLLING_INTERVAL 100
 #define KCS_BUFF_SIZE 256
 #define KCS_MAX_CHANNEL_NUM 0x0F
+/* Host requests that may wait for a PLDM response from BMC at the same time, all channels */
+#define KCS_MAX_PENDING_BRIDGE 8
 
 #define CMD_SYS_INFO_FW_VERSION 0x01
 #define CMD_DIMM_LOCATION 0x01
@@ -39,6 +42,11 @@ typedef struct _kcs_dev {
 	K_KERNEL_STACK_MEMBER(task_stack, KCS_POLL_STACK_SIZE);
 	uint8_t task_name[KCS_TASK_NAME_LEN];
 	struct k_thread task_thread;
+	/* Given by the driver ISR when the host has written a request */
+	struct k_sem rx_sem;
+	bool is_rx_event;
+	struct k_mutex tx_mutex;
+	uint8_t tx_buf[KCS_BUFF_SIZE];
 } kcs_dev;
 
 struct kcs_request {
@@ -56,6 +64,8 @@ struct kcs_response {
 
 void kcs_device_init(char **config, uint8_t size);
 void kcs_write(uint8_t index, uint8_t *buf, uint32_t buf_sz);
+void kcs_send_response(uint8_t index, uint8_t netfn, uint8_t cmd, uint8_t cmplt_code,
+		       const uint8_t *data, uint16_t data_len);
 bool get_kcs_ok();
 void reset_kcs_ok();
 
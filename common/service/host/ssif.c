@@ -37,7 +37,6 @@ LOG_MODULE_REGISTER(ssif);
 
 #define SSIF_TARGET_MSGQ_SIZE 0x0A
 
-#define SSIF_STATUS_CHECK_PER_MS 100
 #define SSIF_TIMEOUT_MS 5000 // i2c bus drop off maximum time
 
 #define SSIF_RSP_PEC_EN 0
@@ -47,46 +46,17 @@ static uint8_t ssif_channel_cnt = 0;
 
 static bool proc_ssif_ok = false;
 
-bool ssif_set_data(uint8_t channel, ipmi_msg_cfg *msg_cfg)
+static uint32_t ssif_timestamp_us()
 {
-	CHECK_NULL_ARG_WITH_RETURN(msg_cfg, false);
-
-	if (channel >= ssif_channel_cnt) {
-		LOG_WRN("Invalid SSIF channel %d", channel);
-		return false;
-	}
-
-	CHECK_MUTEX_INIT_WITH_RETURN(&ssif[channel].rsp_buff_mutex, false);
-
-	if (k_mutex_lock(&ssif[channel].rsp_buff_mutex, K_MSEC(1000))) {
-		LOG_ERR("SSIF[%d] mutex lock failed", channel);
-		ssif_error_record(ssif[channel].index, SSIF_STATUS_MUTEX_ERR);
-		return false;
-	}
-
-	ssif[channel].rsp_buff[0] = msg_cfg->buffer.netfn; // Should modify outside by user
-	ssif[channel].rsp_buff[1] = msg_cfg->buffer.cmd;
-	ssif[channel].rsp_buff[2] = msg_cfg->buffer.completion_code;
-	if (msg_cfg->buffer.data_len) {
-		if (msg_cfg->buffer.data_len <= (IPMI_MSG_MAX_LENGTH - 3))
-			memcpy(&ssif[channel].rsp_buff[3], msg_cfg->buffer.data,
-			       msg_cfg->buffer.data_len);
-		else
-			memcpy(&ssif[channel].rsp_buff[3], msg_cfg->buffer.data,
-			       (IPMI_MSG_MAX_LENGTH - 3));
-	}
-
-	ssif[channel].rsp_buf_len = msg_cfg->buffer.data_len + 3;
-
-	LOG_DBG("ssif from ipmi netfn %x, cmd %x, data length %d, cc %x", ssif[channel].rsp_buff[0],
-		ssif[channel].rsp_buff[1], msg_cfg->buffer.data_len, ssif[channel].rsp_buff[2]);
-
-	k_sem_give(&ssif[channel].rsp_buff_sem);
-
-	if (k_mutex_unlock(&ssif[channel].rsp_buff_mutex))
-		LOG_ERR("SSIF[%d] mutex unlock failed", channel);
+	return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
 
-	return true;
+static void ssif_latency_add(uint32_t us, uint32_t *last_us, uint32_t *max_us,
+			     uint64_t *total_us)
+{
+	*last_us = us;
+	*max_us = MAX(*max_us, us);
+	*total_us += us;
 }
 
 bool get_ssif_ok()
@@ -142,10 +112,11 @@ static bool ssif_lock_ctl(ssif_dev *ssif_inst, bool lck_flag)
 
 	if (lck_flag == true) {
 		ssif_inst->addr_lock = true;
-		ssif_inst->exp_to_ms = k_uptime_get() + SSIF_TIMEOUT_MS;
+		k_work_reschedule(&ssif_inst->timeout_work, K_MSEC(SSIF_TIMEOUT_MS));
 		addr = 0;
 	} else {
 		ssif_inst->addr_lock = false;
+		k_work_cancel_delayable(&ssif_inst->timeout_work);
 	}
 
 	if (i2c_addr_set(ssif_inst->i2c_bus, addr))
@@ -154,6 +125,113 @@ static bool ssif_lock_ctl(ssif_dev *ssif_inst, bool lck_flag)
 	return true;
 }
 
+/* Fill the response buffer and let host read it. Only the first response of a request is taken,
+ * e.g. BMC response of an immediate-response command is dropped.
+ *
+ * @param netfn response netfn(6bit) + lun(2bit)
+ */
+static bool ssif_set_response(ssif_dev *ssif_inst, uint8_t netfn, uint8_t cmd, uint8_t cmplt_code,
+			      const uint8_t *data, uint16_t data_len)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ssif_inst, false);
+
+	if (k_mutex_lock(&ssif_inst->rsp_buff_mutex, K_MSEC(1000))) {
+		LOG_ERR("SSIF[%d] mutex lock failed", ssif_inst->index);
+		ssif_error_record(ssif_inst->index, SSIF_STATUS_MUTEX_ERR);
+		return false;
+	}
+
+	bool ret = false;
+	if (ssif_inst->rsp_pending == false) {
+		LOG_DBG("SSIF[%d] drop response netfn 0x%x cmd 0x%x without pending request",
+			ssif_inst->index, netfn, cmd);
+		goto exit;
+	}
+
+	/* A late BMC response to an earlier, timed out request must not answer this one */
+	if (((netfn >> 2) != (ssif_inst->current_ipmi_msg.buffer.netfn + 1)) ||
+	    (cmd != ssif_inst->current_ipmi_msg.buffer.cmd)) {
+		LOG_DBG("SSIF[%d] drop response netfn 0x%x cmd 0x%x of another request",
+			ssif_inst->index, netfn, cmd);
+		goto exit;
+	}
+
+	data_len = MIN(data_len, IPMI_MSG_MAX_LENGTH - 3);
+	ssif_inst->rsp_buff[0] = netfn;
+	ssif_inst->rsp_buff[1] = cmd;
+	ssif_inst->rsp_buff[2] = cmplt_code;
+	if ((data != NULL) && (data_len != 0)) {
+		memcpy(&ssif_inst->rsp_buff[3], data, data_len);
+	}
+	ssif_inst->rsp_buf_len = data_len + 3;
+	ssif_inst->rsp_pending = false;
+
+	ssif_latency_add(ssif_timestamp_us() - ssif_inst->req_done_us, &ssif_inst->stat.last_rsp_us,
+			 &ssif_inst->stat.max_rsp_us, &ssif_inst->stat.total_rsp_us);
+
+	LOG_DBG("SSIF[%d] ipmi rsp netfn 0x%x, cmd 0x%x, cc 0x%x, data length %d",
+		ssif_inst->index, netfn, cmd, cmplt_code, data_len);
+
+	/* unlock i2c bus address, under mutex so the timeout handler can't reset this response */
+	if (ssif_lock_ctl(ssif_inst, false) == false) {
+		LOG_ERR("SSIF[%d] can't unlock address after sending message", ssif_inst->index);
+		ssif_error_record(ssif_inst->index, SSIF_STATUS_ADDR_LOCK_ERR);
+		goto exit;
+	}
+	ret = true;
+
+exit:
+	if (k_mutex_unlock(&ssif_inst->rsp_buff_mutex))
+		LOG_ERR("SSIF[%d] mutex unlock failed", ssif_inst->index);
+
+	if (ret == true) {
+		/* Let HOST know data ready by i2c alert pin */
+		pal_ssif_alert_trigger(GPIO_LOW);
+	}
+
+	return ret;
+}
+
+bool ssif_set_data(uint8_t channel, ipmi_msg_cfg *msg_cfg)
+{
+	CHECK_NULL_ARG_WITH_RETURN(msg_cfg, false);
+
+	if (channel >= ssif_channel_cnt) {
+		LOG_WRN("Invalid SSIF channel %d", channel);
+		return false;
+	}
+
+	CHECK_MUTEX_INIT_WITH_RETURN(&ssif[channel].rsp_buff_mutex, false);
+
+	// netfn should modify outside by user
+	return ssif_set_response(&ssif[channel], msg_cfg->buffer.netfn, msg_cfg->buffer.cmd,
+				 msg_cfg->buffer.completion_code, msg_cfg->buffer.data,
+				 msg_cfg->buffer.data_len);
+}
+
+bool ssif_get_latency_stat(uint8_t channel, ssif_latency_stat *stat)
+{
+	CHECK_NULL_ARG_WITH_RETURN(stat, false);
+
+	if (channel >= ssif_channel_cnt) {
+		LOG_WRN("Invalid SSIF channel %d", channel);
+		return false;
+	}
+
+	*stat = ssif[channel].stat;
+	return true;
+}
+
+void ssif_reset_latency_stat(uint8_t channel)
+{
+	if (channel >= ssif_channel_cnt) {
+		LOG_WRN("Invalid SSIF channel %d", channel);
+		return;
+	}
+
+	memset(&ssif[channel].stat, 0, sizeof(ssif[channel].stat));
+}
+
 /**
  * @brief SSIF pec check function
  *
@@ -282,7 +360,10 @@ static bool ssif_status_check(ssif_dev *ssif_inst, uint8_t smb_cmd)
 		break;
 
 	case SSIF_RD_RETRY:
-		if (ssif_inst->cur_status != SSIF_STATUS_WAIT_FOR_RD_NEXT) {
+		/* The last block may be read again until the next request starts */
+		if ((ssif_inst->cur_status != SSIF_STATUS_WAIT_FOR_RD_NEXT) &&
+		    ((ssif_inst->cur_status != SSIF_STATUS_WAIT_FOR_WR_START) ||
+		     (ssif_inst->rd_buff_len == 0))) {
 			goto error;
 		}
 		ssif_state_machine(ssif_inst, SSIF_STATUS_RD_RETRY);
@@ -304,116 +385,126 @@ error:
 	return false;
 }
 
+/* Write the prepared block in rd_buff to host */
+static bool ssif_write_block(ssif_dev *ssif_inst, ssif_status_t next_status)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ssif_inst, false);
+
+	LOG_DBG("SSIF[%d] write RSP data:", ssif_inst->index);
+	LOG_HEXDUMP_DBG(ssif_inst->rd_buff, ssif_inst->rd_buff_len, "");
+
+	uint8_t rc =
+		i2c_target_write(ssif_inst->i2c_bus, ssif_inst->rd_buff, ssif_inst->rd_buff_len);
+	if (rc) {
+		LOG_ERR("SSIF[%d] i2c_target_write fail, ret %d\n", ssif_inst->index, rc);
+		ssif_error_record(ssif_inst->index, SSIF_STATUS_TARGET_WR_RD_ERROR);
+		return false;
+	}
+
+	ssif_state_machine(ssif_inst, next_status);
+	return true;
+}
+
 static bool ssif_data_handle(ssif_dev *ssif_inst, ssif_action_t action, uint8_t smb_cmd)
 {
 	CHECK_NULL_ARG_WITH_RETURN(ssif_inst, false);
 
 	switch (action) {
-	case SSIF_SEND_IPMI:
+	case SSIF_SEND_IPMI: {
+		uint8_t netfn = ssif_inst->current_ipmi_msg.buffer.netfn;
+		uint8_t cmd = ssif_inst->current_ipmi_msg.buffer.cmd;
+
+		/* The response may be set from another thread before this returns, so get ready
+		 * for it first. ssif_set_response() unlocks the address, timeout_work handles a
+		 * response that never comes.
+		 */
+		if (k_mutex_lock(&ssif_inst->rsp_buff_mutex, K_MSEC(1000))) {
+			LOG_ERR("SSIF[%d] mutex lock failed", ssif_inst->index);
+			ssif_error_record(ssif_inst->index, SSIF_STATUS_MUTEX_ERR);
+			return false;
+		}
+		ssif_inst->req_done_us = ssif_timestamp_us();
+		ssif_inst->stat.req_cnt++;
+		ssif_inst->rsp_buf_len = 0;
+		ssif_inst->rsp_pending = true;
+		ssif_state_machine(ssif_inst, SSIF_STATUS_WAIT_FOR_RD_START);
+		k_work_reschedule(&ssif_inst->timeout_work, K_MSEC(SSIF_RSP_TIMEOUT_MS));
+		k_mutex_unlock(&ssif_inst->rsp_buff_mutex);
+
 		/* Message to BIC */
-		if (pal_request_msg_to_BIC_from_HOST(ssif_inst->current_ipmi_msg.buffer.netfn,
-						     ssif_inst->current_ipmi_msg.buffer.cmd)) {
+		if (pal_request_msg_to_BIC_from_HOST(netfn, cmd)) {
 			while (k_msgq_put(&ipmi_msgq, &ssif_inst->current_ipmi_msg, K_NO_WAIT) !=
 			       0) {
 				k_msgq_purge(&ipmi_msgq);
 				LOG_WRN("SSIF[%d] retrying put ipmi msgq", ssif_inst->index);
 			}
-			/* Message to BMC */
-		} else {
-			int ret = 0;
-			if (pal_immediate_respond_from_HOST(
-				    ssif_inst->current_ipmi_msg.buffer.netfn,
-				    ssif_inst->current_ipmi_msg.buffer.cmd)) {
-				ssif_inst->current_ipmi_msg.buffer.data_len = 0;
-				ssif_inst->current_ipmi_msg.buffer.completion_code = CC_SUCCESS;
-				if (((ssif_inst->current_ipmi_msg.buffer.netfn ==
-				      NETFN_STORAGE_REQ) &&
-				     (ssif_inst->current_ipmi_msg.buffer.cmd ==
-				      CMD_STORAGE_ADD_SEL))) {
-					ssif_inst->current_ipmi_msg.buffer.data_len += 2;
-					ssif_inst->current_ipmi_msg.buffer.data[0] = 0x00;
-					ssif_inst->current_ipmi_msg.buffer.data[1] = 0x00;
-				}
-				ssif_inst->current_ipmi_msg.buffer.netfn =
-					(ssif_inst->current_ipmi_msg.buffer.netfn + 1) << 2;
-
-				if (ssif_set_data(ssif_inst->index, &ssif_inst->current_ipmi_msg) ==
-				    false) {
-					LOG_ERR("Failed to write ssif response data");
-				}
-			}
+			break;
+		}
 
-			if ((ssif_inst->current_ipmi_msg.buffer.netfn == NETFN_APP_REQ) &&
-			    (ssif_inst->current_ipmi_msg.buffer.cmd ==
-			     CMD_APP_SET_SYS_INFO_PARAMS) &&
-			    (ssif_inst->current_ipmi_msg.buffer.data[0] ==
-			     CMD_SYS_INFO_FW_VERSION)) {
-				uint8_t ipmi_buff[IPMI_MSG_MAX_LENGTH] = { 0 };
-				ipmi_buff[0] = ssif_inst->current_ipmi_msg.buffer.netfn;
-				ipmi_buff[1] = ssif_inst->current_ipmi_msg.buffer.cmd;
-				memcpy(ipmi_buff + 2, ssif_inst->current_ipmi_msg.buffer.data,
-				       ssif_inst->current_ipmi_msg.buffer.data_len);
-				ret = pal_record_bios_fw_version(
-					ipmi_buff, ssif_inst->current_ipmi_msg.buffer.data_len + 2);
-				if (ret == -1) {
-					LOG_ERR("Record bios fw version fail");
-				}
+		/* Message to BMC */
+		int ret = 0;
+		if (pal_immediate_respond_from_HOST(netfn, cmd)) {
+			/* Add SEL response carries a record ID, BMC assigns the real one */
+			static const uint8_t add_sel_resp[] = { 0x00, 0x00 };
+			bool is_add_sel =
+				(netfn == NETFN_STORAGE_REQ) && (cmd == CMD_STORAGE_ADD_SEL);
+
+			if (ssif_set_response(ssif_inst, (netfn + 1) << 2, cmd, CC_SUCCESS,
+					      is_add_sel ? add_sel_resp : NULL,
+					      is_add_sel ? sizeof(add_sel_resp) : 0) == false) {
+				LOG_ERR("Failed to write ssif response data");
 			}
-
-			do {
-				uint8_t seq_source = 0xFF;
-				ipmi_msg msg;
-				msg = construct_ipmi_message(
-					seq_source, ssif_inst->current_ipmi_msg.buffer.netfn,
-					ssif_inst->current_ipmi_msg.buffer.cmd, SELF, BMC_IPMB,
-					ssif_inst->current_ipmi_msg.buffer.data_len,
-					ssif_inst->current_ipmi_msg.buffer.data);
-				ipmb_error ipmb_ret =
-					ipmb_read(&msg, IPMB_inf_index_map[msg.InF_target]);
-				if (ipmb_ret != IPMB_ERROR_SUCCESS) {
-					LOG_ERR("SSIF[%d] Failed to send SSIF msg to BMC with ret: 0x%x",
-						ssif_inst->index, ipmb_ret);
-					break;
-				}
-
-				ipmi_msg_cfg ssif_rsp = { 0 };
-				ssif_rsp.buffer = msg;
-				ssif_rsp.buffer.netfn = ssif_rsp.buffer.netfn << 2;
-				if (ssif_set_data(ssif_inst->index, &ssif_rsp) == false) {
-					LOG_ERR("SSIF[%d] failed to write ssif response data",
-						ssif_inst->index);
-				}
-			} while (0);
 		}
 
-		if (k_sem_take(&ssif_inst->rsp_buff_sem, K_MSEC(1500)) != 0) {
-			LOG_ERR("SSIF[%d] Get ipmi response message timeout!", ssif_inst->index);
-			ssif_error_record(ssif_inst->index, SSIF_STATUS_RSP_MSG_TIMEOUT);
-			return false;
+		if ((netfn == NETFN_APP_REQ) && (cmd == CMD_APP_SET_SYS_INFO_PARAMS) &&
+		    (ssif_inst->current_ipmi_msg.buffer.data[0] == CMD_SYS_INFO_FW_VERSION)) {
+			uint8_t ipmi_buff[IPMI_MSG_MAX_LENGTH] = { 0 };
+			ipmi_buff[0] = netfn;
+			ipmi_buff[1] = cmd;
+			memcpy(ipmi_buff + 2, ssif_inst->current_ipmi_msg.buffer.data,
+			       ssif_inst->current_ipmi_msg.buffer.data_len);
+			ret = pal_record_bios_fw_version(
+				ipmi_buff, ssif_inst->current_ipmi_msg.buffer.data_len + 2);
+			if (ret == -1) {
+				LOG_ERR("Record bios fw version fail");
+			}
 		}
 
-		LOG_INF("SSIF[%d] ipmi rsp netfn 0x%x, cmd 0x%x, cc 0x%x, data length %d:",
-			ssif_inst->index, ssif_inst->rsp_buff[0], ssif_inst->rsp_buff[1],
-			ssif_inst->rsp_buff[2], ssif_inst->rsp_buf_len - 3);
-		LOG_HEXDUMP_INF(ssif_inst->rsp_buff + 3, ssif_inst->rsp_buf_len - 3, "");
-
-		/* unlock i2c bus address */
-		if (ssif_lock_ctl(ssif_inst, false) == false) {
-			LOG_ERR("SSIF[%d] can't unlock address after sending message",
-				ssif_inst->index);
-			ssif_error_record(ssif_inst->index, SSIF_STATUS_ADDR_LOCK_ERR);
-			return false;
+		/* The IPMB rx thread sets the BMC response with ssif_set_data(), it is dropped if
+		 * an immediate response is already set.
+		 */
+		uint8_t seq_source = 0xFF;
+		ipmi_msg msg;
+		msg = construct_ipmi_message(seq_source, netfn, cmd,
+					     HOST_SSIF_1 + ssif_inst->index, BMC_IPMB,
+					     ssif_inst->current_ipmi_msg.buffer.data_len,
+					     ssif_inst->current_ipmi_msg.buffer.data);
+		ipmb_error ipmb_ret = ipmb_send_request(&msg, IPMB_inf_index_map[msg.InF_target]);
+		if (ipmb_ret != IPMB_ERROR_SUCCESS) {
+			LOG_ERR("SSIF[%d] Failed to send SSIF msg to BMC with ret: 0x%x",
+				ssif_inst->index, ipmb_ret);
+			/* Fail fast instead of letting host wait for the response timeout */
+			ssif_set_response(ssif_inst, (netfn + 1) << 2, cmd, CC_UNSPECIFIED_ERROR,
+					  NULL, 0);
 		}
-
-		/* Let HOST know data ready by i2c alert pin */
-		pal_ssif_alert_trigger(GPIO_LOW);
 		break;
+	}
 
 	case SSIF_COLLECT_DATA: {
+		if (smb_cmd == SSIF_RD_RETRY) {
+			if (ssif_inst->rd_buff_len == 0) {
+				LOG_WRN("SSIF[%d] no block to read again", ssif_inst->index);
+				ssif_error_record(ssif_inst->index, SSIF_STATUS_RSP_NOT_READY);
+				return false;
+			}
+			ssif_inst->stat.rd_retry_cnt++;
+			return ssif_write_block(ssif_inst, ssif_inst->rd_next_status);
+		}
+
 		ssif_status_t next_status = SSIF_STATUS_WAIT_FOR_WR_START;
 		uint16_t wdata_len = 0;
-		uint8_t wdata[SSIF_BUFF_SIZE];
-		memset(wdata, 0, sizeof(wdata));
+		uint8_t *wdata = ssif_inst->rd_buff;
+		memset(wdata, 0, sizeof(ssif_inst->rd_buff));
 
 		if (ssif_inst->rsp_buf_len) {
 			switch (smb_cmd) {
@@ -473,18 +564,19 @@ static bool ssif_data_handle(ssif_dev *ssif_inst, ssif_action_t action, uint8_t
 				wdata_len++;
 			}
 
-			LOG_INF("SSIF[%d] write RSP data:", ssif_inst->index);
-			LOG_HEXDUMP_INF(wdata, wdata_len, "");
-
-			uint8_t rc = i2c_target_write(ssif_inst->i2c_bus, wdata, wdata_len);
-			if (rc) {
-				LOG_ERR("SSIF[%d] i2c_target_write fail, ret %d\n",
-					ssif_inst->index, rc);
-				ssif_error_record(ssif_inst->index, SSIF_STATUS_TARGET_WR_RD_ERROR);
+			ssif_inst->rd_buff_len = wdata_len;
+			ssif_inst->rd_next_status = next_status;
+			if (ssif_write_block(ssif_inst, next_status) == false) {
 				return false;
 			}
 
-			ssif_state_machine(ssif_inst, next_status);
+			if (next_status == SSIF_STATUS_WAIT_FOR_WR_START) {
+				ssif_inst->stat.xfer_cnt++;
+				ssif_latency_add(ssif_timestamp_us() - ssif_inst->req_done_us,
+						 &ssif_inst->stat.last_xfer_us,
+						 &ssif_inst->stat.max_xfer_us,
+						 &ssif_inst->stat.total_xfer_us);
+			}
 		} else {
 			LOG_WRN("SSIF[%d] data not ready", ssif_inst->index);
 			ssif_error_record(ssif_inst->index, SSIF_STATUS_RSP_NOT_READY);
@@ -520,7 +612,8 @@ static bool ssif_collect_data(uint8_t smb_cmd, uint8_t bus)
 
 	switch (smb_cmd) {
 	case SSIF_RD_START:
-	case SSIF_RD_NEXT: {
+	case SSIF_RD_NEXT:
+	case SSIF_RD_RETRY: {
 		if (ssif_status_check(ssif_inst, smb_cmd) == false)
 			goto skip_target_read;
 
@@ -537,9 +630,6 @@ static bool ssif_collect_data(uint8_t smb_cmd, uint8_t bus)
 
 		break;
 	}
-	case SSIF_RD_RETRY:
-		LOG_WRN("RETRY cmd not ready yet!");
-		goto skip_target_read;
 
 	default:
 		break;
@@ -594,32 +684,40 @@ static void ssif_bus_drop(void *arg)
 	}
 }
 
-static void ssif_timeout_monitor(void *dummy0, void *dummy1, void *dummy2)
+static void ssif_timeout_handler(struct k_work *work)
 {
-	ARG_UNUSED(dummy0);
-	ARG_UNUSED(dummy1);
-	ARG_UNUSED(dummy2);
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	ssif_dev *ssif_inst = CONTAINER_OF(dwork, ssif_dev, timeout_work);
 
-	while (1) {
-		k_msleep(SSIF_STATUS_CHECK_PER_MS);
+	if (k_mutex_lock(&ssif_inst->rsp_buff_mutex, K_MSEC(1000))) {
+		LOG_ERR("SSIF[%d] mutex lock failed", ssif_inst->index);
+		ssif_error_record(ssif_inst->index, SSIF_STATUS_MUTEX_ERR);
+		return;
+	}
 
-		for (int idx = 0; idx < ssif_channel_cnt; idx++) {
-			if (ssif[idx].addr_lock == false)
-				continue;
+	/* Response is set right before this handler runs */
+	if (ssif_inst->addr_lock == false) {
+		k_mutex_unlock(&ssif_inst->rsp_buff_mutex);
+		return;
+	}
 
-			int64_t cur_uptime = k_uptime_get();
-			if ((ssif[idx].exp_to_ms <= cur_uptime)) {
-				LOG_WRN("SSIF[%d] msg timeout, ssif unlock!!", idx);
-				ssif_error_record(ssif[idx].index, SSIF_STATUS_ADDR_LCK_TIMEOUT);
-				if (ssif_lock_ctl(&ssif[idx], false) == false) {
-					LOG_ERR("SSIF[%d] unlock failed", idx);
-					ssif_error_record(ssif[idx].index,
-							  SSIF_STATUS_ADDR_LOCK_ERR);
-				}
-				ssif_reset(&ssif[idx]);
-			}
-		}
+	if (ssif_inst->rsp_pending == true) {
+		LOG_ERR("SSIF[%d] Get ipmi response message timeout!", ssif_inst->index);
+		ssif_error_record(ssif_inst->index, SSIF_STATUS_RSP_MSG_TIMEOUT);
+		ssif_inst->rsp_pending = false;
+		ssif_inst->stat.rsp_timeout_cnt++;
+	} else {
+		LOG_WRN("SSIF[%d] msg timeout, ssif unlock!!", ssif_inst->index);
+		ssif_error_record(ssif_inst->index, SSIF_STATUS_ADDR_LCK_TIMEOUT);
+	}
+
+	if (ssif_lock_ctl(ssif_inst, false) == false) {
+		LOG_ERR("SSIF[%d] unlock failed", ssif_inst->index);
+		ssif_error_record(ssif_inst->index, SSIF_STATUS_ADDR_LOCK_ERR);
 	}
+	ssif_reset(ssif_inst);
+
+	k_mutex_unlock(&ssif_inst->rsp_buff_mutex);
 }
 
 static bool ssif_data_pre_handle(ssif_dev *ssif_inst, uint8_t smb_cmd)
@@ -672,8 +770,8 @@ static void ssif_read_task(void *arvg0, void *arvg1, void *arvg2)
 			goto cold_reset;
 		}
 
-		LOG_INF("SSIF[%d] read REQ data:", ssif_inst->index);
-		LOG_HEXDUMP_INF(rdata, rlen, "");
+		LOG_DBG("SSIF[%d] read REQ data:", ssif_inst->index);
+		LOG_HEXDUMP_DBG(rdata, rlen, "");
 
 		cur_smb_cmd = rdata[0];
 
@@ -709,6 +807,9 @@ static void ssif_read_task(void *arvg0, void *arvg1, void *arvg2)
 				goto cold_reset;
 			}
 
+			/* A new request drops the last response block */
+			ssif_inst->rd_buff_len = 0;
+
 			ssif_inst->current_ipmi_msg.buffer.InF_source =
 				HOST_SSIF_1 + ssif_inst->index;
 			ssif_inst->current_ipmi_msg.buffer.netfn = wr_start_msg->netfn >> 2;
@@ -763,6 +864,14 @@ static void ssif_read_task(void *arvg0, void *arvg1, void *arvg2)
 				goto cold_reset;
 			}
 
+			if ((ssif_inst->current_ipmi_msg.buffer.data_len + wr_middle_msg->len) >
+			    sizeof(ssif_inst->current_ipmi_msg.buffer.data)) {
+				LOG_WRN("SSIF[%d] received request over %d bytes", ssif_inst->index,
+					IPMI_MSG_MAX_LENGTH);
+				ssif_error_record(ssif_inst->index, SSIF_STATUS_INVALID_LEN);
+				goto cold_reset;
+			}
+
 			memcpy(ssif_inst->current_ipmi_msg.buffer.data +
 				       ssif_inst->current_ipmi_msg.buffer.data_len,
 			       wr_middle_msg->data, wr_middle_msg->len);
@@ -789,11 +898,13 @@ static void ssif_read_task(void *arvg0, void *arvg1, void *arvg2)
 		LOG_HEXDUMP_DBG(ssif_inst->current_ipmi_msg.buffer.data,
 				ssif_inst->current_ipmi_msg.buffer.data_len, "");
 
+		/* Hand the request over and go back to wait for the next one, the response is
+		 * written by ssif_set_data() from whichever thread handles the command.
+		 */
 		if (ssif_data_handle(ssif_inst, SSIF_SEND_IPMI, cur_smb_cmd) == false)
 			goto warm_reset;
 
 		ssif_error_record(ssif_inst->index, SSIF_STATUS_NO_ERR);
-		ssif_state_machine(ssif_inst, SSIF_STATUS_WAIT_FOR_RD_START);
 		continue;
 
 	cold_reset:
@@ -828,6 +939,12 @@ void ssif_device_init(struct ssif_init_cfg *config, uint8_t size)
 			continue;
 		}
 
+		if (k_mutex_init(&ssif[i].rsp_buff_mutex)) {
+			LOG_ERR("SSIF[%d] rd mutex initial failed", i);
+			continue;
+		}
+		k_work_init_delayable(&ssif[i].timeout_work, ssif_timeout_handler);
+
 		struct _i2c_target_config cfg;
 		memset(&cfg, 0, sizeof(cfg));
 		cfg.address = config[i].addr;
@@ -841,16 +958,6 @@ void ssif_device_init(struct ssif_init_cfg *config, uint8_t size)
 			continue;
 		}
 
-		if (k_mutex_init(&ssif->rsp_buff_mutex)) {
-			LOG_ERR("SSIF[%d] rd mutex initial failed", i);
-			continue;
-		}
-
-		if (k_sem_init(&ssif->rsp_buff_sem, 0, 1)) {
-			LOG_ERR("SSIF[%d] rd semaphore initial failed", i);
-			continue;
-		}
-
 		ssif[i].i2c_bus = config[i].i2c_bus;
 		ssif[i].addr = config[i].addr >> 1;
 		ssif[i].addr_lock = false;
@@ -874,6 +981,4 @@ void ssif_device_init(struct ssif_init_cfg *config, uint8_t size)
 	return;
 }
 
-K_THREAD_DEFINE(ssif_addr_lck_check, 1024, ssif_timeout_monitor, NULL, NULL, NULL, 7, 0, 0);
-
 #endif /* ENABLE_SSIF */
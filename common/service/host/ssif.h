@@ -39,6 +39,9 @@
 
 #define SSIF_ERR_RCD_SIZE 100
 
+/* Time allowed for an IPMI response once the whole request is received */
+#define SSIF_RSP_TIMEOUT_MS 1500
+
 typedef enum ssif_status {
 	SSIF_STATUS_WAIT_FOR_WR_START,
 	SSIF_STATUS_WAIT_FOR_WR_NEXT,
@@ -87,6 +90,23 @@ typedef enum ssif_action {
 	SSIF_COLLECT_DATA,
 } ssif_action_t;
 
+/* Host side latency of one channel in microseconds.
+ * rsp: whole request received to response ready.
+ * xfer: whole request received to last response block read by host.
+ */
+typedef struct {
+	uint32_t req_cnt;
+	uint32_t rsp_timeout_cnt;
+	uint32_t rd_retry_cnt;
+	uint32_t last_rsp_us;
+	uint32_t max_rsp_us;
+	uint64_t total_rsp_us;
+	uint32_t last_xfer_us;
+	uint32_t max_xfer_us;
+	uint64_t total_xfer_us;
+	uint32_t xfer_cnt;
+} ssif_latency_stat;
+
 struct ssif_init_cfg {
 	uint8_t i2c_bus;
 	uint8_t addr; // bic itself, 7bit
@@ -98,18 +118,26 @@ typedef struct _ssif_dev {
 	uint8_t i2c_bus;
 	uint8_t addr; // bic itself, 7bit
 	bool addr_lock;
-	int64_t exp_to_ms;
 	k_tid_t ssif_task_tid;
 	K_KERNEL_STACK_MEMBER(ssif_task_stack, SSIF_THREAD_STACK_SIZE);
 	uint8_t task_name[SSIF_TASK_NAME_LEN];
 	struct k_thread task_thread;
 	struct k_mutex rsp_buff_mutex;
-	struct k_sem rsp_buff_sem;
+	/* Address lock and response timeout, replaces periodic status polling */
+	struct k_work_delayable timeout_work;
+	bool rsp_pending; // request sent out, waiting for ssif_set_data
 	uint8_t rsp_buff[IPMI_MSG_MAX_LENGTH];
 	uint16_t rsp_buf_len; // Length of collected data
 	uint16_t remain_data_len; // Length of remain data
 	ipmi_msg_cfg current_ipmi_msg;
 	uint16_t cur_rd_blck; // for multi-read middle/end
+	/* Last block written to host, kept for read retry */
+	uint8_t rd_buff[SSIF_BUFF_SIZE];
+	uint16_t rd_buff_len;
+	ssif_status_t rd_next_status;
+
+	uint32_t req_done_us; // time the whole request is received
+	ssif_latency_stat stat;
 
 	ssif_status_t cur_status;
 	ssif_err_status_t err_status_lst[SSIF_ERR_RCD_SIZE]; // history error status
@@ -155,6 +183,8 @@ struct ssif_rd_middle {
 void ssif_device_init(struct ssif_init_cfg *config, uint8_t size);
 ssif_err_status_t ssif_get_error_status();
 bool ssif_set_data(uint8_t channel, ipmi_msg_cfg *msg_cfg);
+bool ssif_get_latency_stat(uint8_t channel, ssif_latency_stat *stat);
+void ssif_reset_latency_stat(uint8_t channel);
 void ssif_error_record(uint8_t channel, ssif_err_status_t errcode);
 ssif_dev *ssif_inst_get_by_bus(uint8_t bus);
 void pal_ssif_alert_trigger(uint8_t status);
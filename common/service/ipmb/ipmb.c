@@ -16,7 +16,9 @@
 
 #include "cmsis_os2.h"
 #include "hal_i2c.h"
+#include "i2c_scheduler.h"
 #include "ipmi.h"
+#include "latency_hist.h"
 
 #ifdef CONFIG_IPMI_KCS_ASPEED
 #include "kcs.h"
@@ -24,9 +26,13 @@
 
 #include "libutil.h"
 #include "plat_def.h"
+#ifdef ENABLE_SSIF
+#include "ssif.h"
+#endif
 #include "plat_ipmb.h"
 #include "plat_i2c.h"
 #include "timer.h"
+#include "util_mem.h"
 #include <kernel.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -83,8 +89,6 @@ static uint8_t current_seq[MAX_IPMB_IDX]; // Sequence in BIC for sending
 static bool seq_table[MAX_IPMB_IDX][SEQ_NUM]; // Sequence table in BIC for register record
 
 ipmb_error validate_checksum(uint8_t *buffer, uint8_t buffer_len);
-ipmb_error ipmb_encode(uint8_t *buffer, ipmi_msg *msg);
-ipmb_error ipmb_decode(ipmi_msg *msg, uint8_t *buffer, uint8_t len);
 
 uint8_t IPMB_inf_index_map[RESERVED]; // map IPMB source/target interface to bus
 
@@ -195,7 +199,7 @@ void insert_req_ipmi_msg(ipmi_msg_cfg *pnode, ipmi_msg *msg, uint8_t index)
 			}
 
 			pnode->next = temp->next;
-			SAFE_FREE(temp);
+			SAFE_MEM_FREE(temp);
 			seq_current_count[index]--;
 		}
 
@@ -210,7 +214,7 @@ void insert_req_ipmi_msg(ipmi_msg_cfg *pnode, ipmi_msg *msg, uint8_t index)
 		}
 
 		/* Allocate memory for the new node and put data in it.*/
-		pnode->next = malloc(sizeof(ipmi_msg_cfg));
+		pnode->next = util_mem_alloc(MEM_TAG_IPMB, sizeof(ipmi_msg_cfg));
 		if (pnode->next == NULL) {
 			k_mutex_unlock(&mutex_id[index]);
 			return;
@@ -275,6 +279,9 @@ bool find_req_ipmi_msg(ipmi_msg_cfg *pnode, ipmi_msg *msg, uint8_t index)
 		return false;
 	}
 
+	/* The timestamp is the CMSIS system timer, which counts hardware cycles */
+	latency_hist_record_since(LATENCY_HIST_IPMB, index, temp->buffer.timestamp);
+
 	// find source sequence for responding
 	msg->seq_source = temp->buffer.seq_source;
 	unregister_seq(index, temp->buffer.seq_target);
@@ -287,9 +294,9 @@ bool find_req_ipmi_msg(ipmi_msg_cfg *pnode, ipmi_msg *msg, uint8_t index)
 	/*We removed the node which is next to the pointer (which is also temp) */
 
 	/* Because we deleted the node, we no longer require the memory used for it
-   * free() will deallocate the memory.
+   * util_mem_free() will deallocate the memory.
    */
-	SAFE_FREE(temp);
+	SAFE_MEM_FREE(temp);
 	seq_current_count[index]--;
 
 	k_mutex_unlock(&mutex_id[index]);
@@ -317,7 +324,7 @@ void clear_req_ipmi_msg(ipmi_msg_cfg *pnode, ipmi_msg *msg, uint8_t index)
 		    (temp->buffer.seq == msg->seq)) {
 			pnode->next = temp->next;
 			unregister_seq(index, temp->buffer.seq_target);
-			SAFE_FREE(temp);
+			SAFE_MEM_FREE(temp);
 			seq_current_count[index]--;
 			break;
 		}
@@ -373,9 +380,10 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 	uint8_t ret = 0;
 
 	memcpy(&ipmb_cfg, (IPMB_config *)pvParameters, sizeof(IPMB_config));
+	i2c_sched_set_thread_prio(I2C_SCHED_PRIO_IPMB);
 
 	while (1) {
-		current_msg_tx = (struct ipmi_msg_cfg *)malloc(sizeof(struct ipmi_msg_cfg));
+		current_msg_tx = util_mem_alloc(MEM_TAG_IPMB, sizeof(struct ipmi_msg_cfg));
 		if (current_msg_tx == NULL) {
 			k_msleep(10);
 			continue;
@@ -404,7 +412,7 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 			if (ipmb_cfg.interface == I2C_IF) {
 				int retry = 0;
 				do {
-					i2c_msg = malloc(sizeof(I2C_MSG));
+					i2c_msg = util_mem_alloc(MEM_TAG_IPMB, sizeof(I2C_MSG));
 					if (i2c_msg == NULL) {
 						k_msleep(10);
 					} else {
@@ -423,7 +431,7 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 				memcpy(&i2c_msg->data[0], &ipmb_buffer_tx[1], resp_tx_size);
 
 				ret = i2c_master_write(i2c_msg, I2C_RETRY_TIME);
-				SAFE_FREE(i2c_msg);
+				SAFE_MEM_FREE(i2c_msg);
 			} else {
 				LOG_ERR("Unsupported interface(%d) for index(%d)",
 					ipmb_cfg.interface, ipmb_cfg.index);
@@ -464,7 +472,7 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 			if (ipmb_cfg.interface == I2C_IF) {
 				int retry = 0;
 				do {
-					i2c_msg = malloc(sizeof(I2C_MSG));
+					i2c_msg = util_mem_alloc(MEM_TAG_IPMB, sizeof(I2C_MSG));
 					if (i2c_msg == NULL) {
 						k_msleep(10);
 					} else {
@@ -502,7 +510,7 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 				}
 
 				ret = i2c_master_write(i2c_msg, I2C_RETRY_TIME);
-				SAFE_FREE(i2c_msg);
+				SAFE_MEM_FREE(i2c_msg);
 			} else {
 				LOG_ERR("Unsupported interface(%d) for index(%d)",
 					ipmb_cfg.interface, ipmb_cfg.index);
@@ -528,37 +536,28 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 						   HOST_KCS_1) {
 						// the source is KCS if the bit[7:4] are 0101b.
 #ifdef CONFIG_IPMI_KCS_ASPEED
-						uint8_t *kcs_buff;
-						kcs_buff = malloc(KCS_BUFF_SIZE * sizeof(uint8_t));
-						if (kcs_buff ==
-						    NULL) { // allocate fail, retry allocate
-							k_msleep(10);
-							kcs_buff = malloc(KCS_BUFF_SIZE *
-									  sizeof(uint8_t));
-							if (kcs_buff == NULL) {
-								LOG_ERR("IPMB_TXTask: Fail to malloc for kcs_buff");
-								SAFE_FREE(current_msg_tx);
-								continue;
-							}
-						}
 						current_msg_tx->buffer.completion_code =
 							CC_CAN_NOT_RESPOND;
-						kcs_buff[0] = current_msg_tx->buffer.netfn << 2;
-						kcs_buff[1] = current_msg_tx->buffer.cmd;
-						kcs_buff[2] =
-							current_msg_tx->buffer.completion_code;
-						if (current_msg_tx->buffer.data_len > 0) {
-							memcpy(&kcs_buff[3],
-							       &current_msg_tx->buffer.data[0],
-							       current_msg_tx->buffer.data_len);
-						}
-
-						// KCS response length = data length + NetFn + Cmd + CC
-						kcs_write(current_msg_tx->buffer.InF_source -
-								  HOST_KCS_1,
-							  kcs_buff,
-							  current_msg_tx->buffer.data_len + 3);
-						SAFE_FREE(kcs_buff);
+						kcs_send_response(
+							current_msg_tx->buffer.InF_source -
+								HOST_KCS_1,
+							current_msg_tx->buffer.netfn,
+							current_msg_tx->buffer.cmd,
+							current_msg_tx->buffer.completion_code,
+							current_msg_tx->buffer.data,
+							current_msg_tx->buffer.data_len);
+#endif
+					} else if ((current_msg_tx->buffer.InF_source & 0xF0) ==
+						   HOST_SSIF_1) {
+#ifdef ENABLE_SSIF
+						current_msg_tx->buffer.netfn =
+							(current_msg_tx->buffer.netfn + 1) << 2;
+						current_msg_tx->buffer.completion_code =
+							CC_CAN_NOT_RESPOND;
+						current_msg_tx->buffer.data_len = 0;
+						ssif_set_data(current_msg_tx->buffer.InF_source -
+								      HOST_SSIF_1,
+							      current_msg_tx);
 #endif
 					} else {
 						// Return the error code(node busy) to the source channel
@@ -591,7 +590,7 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 		}
 
 	cleanup:
-		SAFE_FREE(current_msg_tx);
+		SAFE_MEM_FREE(current_msg_tx);
 		k_msleep(IPMB_POLLING_TIME_MS);
 	}
 }
@@ -615,15 +614,15 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 	}
 
 	while (1) {
-		current_msg_rx = (struct ipmi_msg_cfg *)malloc(sizeof(struct ipmi_msg_cfg));
+		current_msg_rx = util_mem_alloc(MEM_TAG_IPMB, sizeof(struct ipmi_msg_cfg));
 		if (current_msg_rx == NULL) {
 			k_msleep(10); // allocate fail, retry later
 			continue;
 		}
 		ipmb_buffer_rx =
-			malloc((IPMI_MSG_MAX_LENGTH + IPMB_RESP_HEADER_LENGTH) * sizeof(uint8_t));
+			util_mem_alloc(MEM_TAG_IPMB, IPMI_MSG_MAX_LENGTH + IPMB_RESP_HEADER_LENGTH);
 		if (ipmb_buffer_rx == NULL) {
-			SAFE_FREE(current_msg_rx);
+			SAFE_MEM_FREE(current_msg_rx);
 			k_msleep(10); // allocate fail, retry later
 			continue;
 		}
@@ -708,38 +707,22 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 							    current_msg_rx->buffer.cmd)) {
 							goto cleanup;
 						}
-						uint8_t *kcs_buff;
-						int retry = 0;
-						do {
-							kcs_buff = malloc(KCS_BUFF_SIZE *
-									  sizeof(uint8_t));
-							if (kcs_buff == NULL) {
-								k_msleep(10);
-							} else {
-								break;
-							}
-							retry++;
-						} while (retry < MEM_ALLOCATE_RETRY_TIME);
-						if (kcs_buff == NULL) {
-							LOG_ERR("Failed to allocate memory for I2C resp msg");
-							goto cleanup;
-						}
-						kcs_buff[0] = current_msg_rx->buffer.netfn << 2;
-						kcs_buff[1] = current_msg_rx->buffer.cmd;
-						kcs_buff[2] =
-							current_msg_rx->buffer.completion_code;
-						if (current_msg_rx->buffer.data_len > 0) {
-							memcpy(&kcs_buff[3],
-							       &current_msg_rx->buffer.data[0],
-							       current_msg_rx->buffer.data_len);
-						}
-
-						// KCS response length = data length + NetFn + Cmd + CC
-						kcs_write(current_msg_rx->buffer.InF_source -
-								  HOST_KCS_1,
-							  kcs_buff,
-							  current_msg_rx->buffer.data_len + 3);
-						SAFE_FREE(kcs_buff);
+						kcs_send_response(
+							current_msg_rx->buffer.InF_source -
+								HOST_KCS_1,
+							current_msg_rx->buffer.netfn,
+							current_msg_rx->buffer.cmd,
+							current_msg_rx->buffer.completion_code,
+							current_msg_rx->buffer.data,
+							current_msg_rx->buffer.data_len);
+#endif
+					} else if ((current_msg_rx->buffer.InF_source & 0xF0) ==
+						   HOST_SSIF_1) {
+#ifdef ENABLE_SSIF
+						current_msg_rx->buffer.netfn <<= 2;
+						ssif_set_data(current_msg_rx->buffer.InF_source -
+								      HOST_SSIF_1,
+							      current_msg_rx);
 #endif
 					} else if ((current_msg_rx->buffer.InF_source) ==
 						   MPRO_PLDM) {
@@ -747,8 +730,8 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 						pldm_send_ipmb_rsp(&current_msg_rx->buffer);
 #endif
 					} else if (current_msg_rx->buffer.InF_source == ME_IPMB) {
-						ipmi_msg *bridge_msg =
-							(ipmi_msg *)malloc(sizeof(ipmi_msg));
+						ipmi_msg *bridge_msg = util_mem_alloc(
+							MEM_TAG_IPMB, sizeof(ipmi_msg));
 						if (bridge_msg == NULL) {
 							LOG_ERR("bridge_msg allocation failed");
 							goto cleanup;
@@ -789,11 +772,11 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 							LOG_ERR("Failed to send IPMB response message");
 						}
 
-						SAFE_FREE(bridge_msg);
+						SAFE_MEM_FREE(bridge_msg);
 					} else { // Bridge response to other fru
 
-						ipmi_msg *bridge_msg =
-							(ipmi_msg *)malloc(sizeof(ipmi_msg));
+						ipmi_msg *bridge_msg = util_mem_alloc(
+							MEM_TAG_IPMB, sizeof(ipmi_msg));
 						if (bridge_msg == NULL) {
 							LOG_ERR("bridge_msg allocation failed");
 							goto cleanup;
@@ -839,7 +822,7 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 							}
 						}
 
-						SAFE_FREE(bridge_msg);
+						SAFE_MEM_FREE(bridge_msg);
 					}
 				}
 
@@ -852,7 +835,8 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
                  * instead of calling IPMI handler.
                  */
 								     current_msg_rx->buffer.cmd))) {
-					ipmi_msg *bridge_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+					ipmi_msg *bridge_msg =
+						util_mem_alloc(MEM_TAG_IPMB, sizeof(ipmi_msg));
 					if (bridge_msg == NULL) {
 						LOG_ERR("bridge_msg allocation failed");
 						goto cleanup;
@@ -903,7 +887,7 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 						}
 					}
 
-					SAFE_FREE(bridge_msg);
+					SAFE_MEM_FREE(bridge_msg);
 				} else {
 					/* The received message is a request
            * Record sequence number for later response
@@ -925,8 +909,8 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 			}
 		}
 	cleanup:
-		SAFE_FREE(current_msg_rx);
-		SAFE_FREE(ipmb_buffer_rx);
+		SAFE_MEM_FREE(current_msg_rx);
+		SAFE_MEM_FREE(ipmb_buffer_rx);
 		k_msleep(IPMB_POLLING_TIME_MS);
 	}
 }
@@ -1090,6 +1074,18 @@ ipmb_error ipmb_encode(uint8_t *buffer, ipmi_msg *msg)
 	return IPMB_ERROR_SUCCESS;
 }
 
+uint8_t get_ipmb_dest_lun(const ipmi_msg *msg)
+{
+	CHECK_NULL_ARG_WITH_RETURN(msg, 0);
+
+	/* Only ipmb_decode sets dest_LUN, requests of the other interfaces don't carry one */
+	if ((msg->InF_source >= RESERVED) || (IPMB_inf_index_map[msg->InF_source] == RESERVED)) {
+		return 0;
+	}
+
+	return msg->dest_LUN & IPMB_DEST_LUN_MASK;
+}
+
 ipmb_error ipmb_decode(ipmi_msg *msg, uint8_t *buffer, uint8_t len)
 {
 	CHECK_NULL_ARG_WITH_RETURN(buffer, IPMB_ERROR_UNKNOWN);
@@ -1151,7 +1147,7 @@ void IPMB_SeqTimeout_handler(void *arug0, void *arug1, void *arug2)
 						temp = pnode->next;
 						pnode->next = temp->next;
 						unregister_seq(index, temp->buffer.seq_target);
-						SAFE_FREE(temp);
+						SAFE_MEM_FREE(temp);
 						seq_current_count[index]--;
 					}
 
@@ -1227,7 +1223,7 @@ void create_ipmb_threads(uint8_t index)
 	memset(&IPMB_RxTask_attr, 0, sizeof(IPMB_RxTask_attr));
 	memset(&seq_table[index], 0, sizeof(bool) * SEQ_NUM);
 
-	P_start[index] = (void *)malloc(sizeof(struct ipmi_msg_cfg));
+	P_start[index] = util_mem_alloc(MEM_TAG_IPMB, sizeof(struct ipmi_msg_cfg));
 	if (P_start[index] == NULL) {
 		LOG_ERR("Memory allocation failed!");
 		return;
@@ -197,6 +197,10 @@ void ipmb_init(void);
 ipmb_error ipmb_send_request(ipmi_msg *req, uint8_t index);
 ipmb_error ipmb_send_response(ipmi_msg *resp, uint8_t index);
 ipmb_error ipmb_read(ipmi_msg *msg, uint8_t bus);
+ipmb_error ipmb_encode(uint8_t *buffer, ipmi_msg *msg);
+ipmb_error ipmb_decode(ipmi_msg *msg, uint8_t *buffer, uint8_t len);
+/* LUN a request is addressed to, 0 for requests not received over IPMB */
+uint8_t get_ipmb_dest_lun(const ipmi_msg *msg);
 void ipmb_tx_suspend(uint8_t index);
 void ipmb_tx_resume(uint8_t index);
 
@@ -236,6 +236,7 @@ enum {
 	CMD_OEM_1S_SET_JTAG_TAP_STA = 0x21,
 	CMD_OEM_1S_JTAG_DATA_SHIFT = 0x22,
 	CMD_OEM_1S_ACCURACY_SENSOR_READING = 0x23,
+	CMD_OEM_1S_JTAG_SCAN_BATCH = 0x24,
 	CMD_OEM_1S_CLEAR_CMOS = 0x25,
 	CMD_OEM_1S_ASD_INIT = 0x28,
 	CMD_OEM_1S_PECI_ACCESS = 0x29,
@@ -281,6 +282,11 @@ enum {
 	CMD_OEM_1S_SET_DEVICE_ACTIVE = 0x78,
 
 	CMD_OEM_1S_MULTI_ACCURACY_SENSOR_READING = 0x88,
+	CMD_OEM_1S_GET_BOOT_TIMELINE = 0x90,
+	CMD_OEM_1S_GET_I2C_STATS = 0x91,
+	CMD_OEM_1S_THREAD_PROFILE = 0x92,
+	CMD_OEM_1S_LATENCY_HIST = 0x93,
+	CMD_OEM_1S_FAN_CONTROL = 0x94,
 	CMD_OEM_1S_GET_BOARD_ID = 0xA0,
 	CMD_OEM_1S_GET_CARD_TYPE = 0xA1,
 	CMD_OEM_1S_GET_BIOS_VERSION = 0xA2,
@@ -18,6 +18,7 @@
 #define OEM_1S_HANDLER_H
 
 #include "ipmi.h"
+#include "boot_timeline.h"
 
 enum FIRMWARE_INFO {
 	BIC_PLAT_NAME = 1,
@@ -67,6 +68,14 @@ enum GET_SET_VGPIO_OPTIONS {
 	SET_VGPIO_STATUS,
 };
 
+/* Operations of a JTAG scan batch, same fields as the set tap and data shift commands */
+enum JTAG_SCAN_BATCH_OP {
+	/* bit length, TMS bits */
+	JTAG_SCAN_OP_TAP = 0x00,
+	/* write bit length (2), write data, read bit length (2), last index */
+	JTAG_SCAN_OP_SHIFT,
+};
+
 typedef struct _ACCURACY_SENSOR_READING_REQ {
 	uint8_t sensor_num;
 	uint8_t read_option;
@@ -125,6 +134,14 @@ void OEM_1S_GET_4BYTE_POST_CODE(ipmi_msg *msg);
 void OEM_1S_GET_POST_CODE(ipmi_msg *msg);
 #endif
 
+#ifdef ENABLE_BOOT_TIMELINE
+void OEM_1S_GET_BOOT_TIMELINE(ipmi_msg *msg);
+#endif
+
+void OEM_1S_GET_I2C_STATS(ipmi_msg *msg);
+void OEM_1S_THREAD_PROFILE(ipmi_msg *msg);
+void OEM_1S_LATENCY_HIST(ipmi_msg *msg);
+
 #ifdef CONFIG_PECI
 void OEM_1S_PECI_ACCESS(ipmi_msg *msg);
 #endif
@@ -139,6 +156,7 @@ void OEM_1S_GET_APML_RESPONSE(ipmi_msg *msg);
 #ifdef CONFIG_JTAG
 void OEM_1S_SET_JTAG_TAP_STA(ipmi_msg *msg);
 void OEM_1S_JTAG_DATA_SHIFT(ipmi_msg *msg);
+void OEM_1S_JTAG_SCAN_BATCH(ipmi_msg *msg);
 
 #ifdef ENABLE_ASD
 void OEM_1S_ASD_INIT(ipmi_msg *msg);
@@ -149,6 +167,7 @@ void OEM_1S_ASD_INIT(ipmi_msg *msg);
 void OEM_1S_SET_FAN_DUTY_AUTO(ipmi_msg *msg);
 void OEM_1S_GET_FAN_DUTY(ipmi_msg *msg);
 void OEM_1S_GET_FAN_RPM(ipmi_msg *msg);
+void OEM_1S_FAN_CONTROL(ipmi_msg *msg);
 #endif
 
 #ifdef CONFIG_I3C_ASPEED
@@ -364,35 +364,16 @@ void ipmi_cmd_handle(void *parameters, void *arvg0, void *arvg1)
 	case HOST_KCS_1:
 	case HOST_KCS_2:
 	case HOST_KCS_3:
-	case HOST_KCS_4: {
-		uint8_t *kcs_buff;
-		kcs_buff = malloc(KCS_BUFF_SIZE * sizeof(uint8_t));
-		if (kcs_buff == NULL) { // allocate fail, retry allocate
-			k_msleep(10);
-			kcs_buff = malloc(KCS_BUFF_SIZE * sizeof(uint8_t));
-			if (kcs_buff == NULL) {
-				LOG_ERR("IPMI_handler: Fail to malloc for kcs_buff");
-				return;
-			}
-		}
-		kcs_buff[0] = (msg_cfg.buffer.netfn + 1) << 2; // ipmi netfn response package
-		kcs_buff[1] = msg_cfg.buffer.cmd;
-		kcs_buff[2] = msg_cfg.buffer.completion_code;
-		if (msg_cfg.buffer.data_len) {
-			if (msg_cfg.buffer.data_len <= (KCS_BUFF_SIZE - 3))
-				memcpy(&kcs_buff[3], msg_cfg.buffer.data, msg_cfg.buffer.data_len);
-			else
-				memcpy(&kcs_buff[3], msg_cfg.buffer.data, (KCS_BUFF_SIZE - 3));
-		}
-
-		LOG_DBG("kcs from ipmi netfn %x, cmd %x, length %d, cc %x", kcs_buff[0],
-			kcs_buff[1], msg_cfg.buffer.data_len, kcs_buff[2]);
-
-		kcs_write(msg_cfg.buffer.InF_source - HOST_KCS_1, kcs_buff,
-			  msg_cfg.buffer.data_len + 3);
-		SAFE_FREE(kcs_buff);
+	case HOST_KCS_4:
+		LOG_DBG("kcs from ipmi netfn %x, cmd %x, length %d, cc %x",
+			msg_cfg.buffer.netfn + 1, msg_cfg.buffer.cmd, msg_cfg.buffer.data_len,
+			msg_cfg.buffer.completion_code);
+
+		// ipmi netfn response package
+		kcs_send_response(msg_cfg.buffer.InF_source - HOST_KCS_1, msg_cfg.buffer.netfn + 1,
+				  msg_cfg.buffer.cmd, msg_cfg.buffer.completion_code,
+				  msg_cfg.buffer.data, msg_cfg.buffer.data_len);
 		break;
-	}
 #endif
 #ifdef ENABLE_SSIF
 	case HOST_SSIF_1:
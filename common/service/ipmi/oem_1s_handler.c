@@ -25,6 +25,10 @@
 #include "hal_gpio.h"
 #include "hal_vw_gpio.h"
 #include "hal_i2c.h"
+#include "i2c_health.h"
+#include "i2c_scheduler.h"
+#include "latency_hist.h"
+#include "thread_profile.h"
 #include "hal_jtag.h"
 #include "hal_peci.h"
 #include "plat_def.h"
@@ -35,6 +39,7 @@
 #include "plat_sys.h"
 #ifdef ENABLE_FAN
 #include "plat_fan.h"
+#include "fan_control.h"
 #endif
 #include "plat_ipmb.h"
 #include "power_status.h"
@@ -691,26 +696,13 @@ __weak void OEM_1S_GET_POST_CODE(ipmi_msg *msg)
 {
 	CHECK_NULL_ARG(msg);
 
-	int postcode_num = snoop_read_num;
 	if (msg->data_len != 0) {
 		msg->completion_code = CC_INVALID_LENGTH;
 		return;
 	}
 
-	if (postcode_num) {
-		uint8_t offset = 0;
-		if (snoop_read_num > POST_CODE_BUF_SIZE) {
-			postcode_num = POST_CODE_BUF_SIZE;
-			offset = snoop_read_num % POST_CODE_BUF_SIZE;
-		}
-		copy_snoop_read_buffer(offset, postcode_num, msg->data, COPY_ALL_POSTCODE);
-	}
-
-	for (int i = 0; i < (postcode_num / 2); ++i) {
-		uint8_t tmp = msg->data[i];
-		msg->data[i] = msg->data[postcode_num - i - 1];
-		msg->data[postcode_num - i - 1] = tmp;
-	}
+	// Newest post code first
+	uint16_t postcode_num = copy_snoop_read_buffer(msg->data, POST_CODE_BUF_SIZE);
 
 	msg->data_len = postcode_num;
 	msg->completion_code = CC_SUCCESS;
@@ -764,6 +756,368 @@ __weak void OEM_1S_GET_4BYTE_POST_CODE(ipmi_msg *msg)
 	return;
 }
 
+#ifdef ENABLE_BOOT_TIMELINE
+__weak void OEM_1S_GET_BOOT_TIMELINE(ipmi_msg *msg)
+{
+	CHECK_NULL_ARG(msg);
+
+	/* Request: byte 0 boot index, 0 is the latest boot
+	 * Response: flags, code number (2 bytes), total time in us (4 bytes),
+	 *           milestone number, then code (4 bytes) and time in us (4 bytes) of each milestone
+	 */
+	if (msg->data_len != 1) {
+		msg->completion_code = CC_INVALID_LENGTH;
+		return;
+	}
+
+	boot_record record;
+	if (!boot_timeline_get_record(msg->data[0], &record)) {
+		msg->data_len = 0;
+		msg->completion_code = CC_PARAM_OUT_OF_RANGE;
+		return;
+	}
+
+	uint32_t milestone[BOOT_TIMELINE_MAX_MILESTONE];
+	uint8_t milestone_num = boot_timeline_get_milestone(milestone, ARRAY_SIZE(milestone));
+
+	uint16_t index = 0;
+	msg->data[index++] = record.flags;
+	msg->data[index++] = record.code_num & 0xFF;
+	msg->data[index++] = (record.code_num >> 8) & 0xFF;
+	convert_uint32_t_to_uint8_t_pointer(record.total_us, &msg->data[index], 4, SMALL_ENDIAN);
+	index += 4;
+	msg->data[index++] = milestone_num;
+	for (uint8_t i = 0; i < milestone_num; i++) {
+		convert_uint32_t_to_uint8_t_pointer(milestone[i], &msg->data[index], 4,
+						    SMALL_ENDIAN);
+		index += 4;
+		convert_uint32_t_to_uint8_t_pointer(record.milestone_us[i], &msg->data[index], 4,
+						    SMALL_ENDIAN);
+		index += 4;
+	}
+
+	msg->data_len = index;
+	msg->completion_code = CC_SUCCESS;
+	return;
+}
+#endif
+
+__weak void OEM_1S_GET_I2C_STATS(ipmi_msg *msg)
+{
+	CHECK_NULL_ARG(msg);
+
+	/* Request: byte 0 bus, byte 1 7-bit device address (optional)
+	 * Response without address: recovery count (4 bytes), recovery failed count (4 bytes),
+	 *           then per scheduler class (IPMB, sensor, bulk) transaction count (4 bytes),
+	 *           timeout count (4 bytes), max wait in ms (4 bytes) and max queue depth,
+	 *           then device number and the address of each device
+	 * Response with address: success, NACK, timeout, arbitration lost and other error
+	 *           count (4 bytes each), quarantine count (4 bytes), quarantine time left in ms
+	 *           (4 bytes), then the count of each latency bucket (4 bytes each)
+	 */
+	if ((msg->data_len != 1) && (msg->data_len != 2)) {
+		msg->completion_code = CC_INVALID_LENGTH;
+		return;
+	}
+
+	uint8_t bus = msg->data[0];
+	if ((bus >= I2C_BUS_MAX_NUM) || (check_i2c_bus_valid(bus) < 0)) {
+		msg->data_len = 0;
+		msg->completion_code = CC_PARAM_OUT_OF_RANGE;
+		return;
+	}
+
+	uint16_t index = 0;
+	if (msg->data_len == 2) {
+		i2c_dev_health dev;
+		if (!i2c_health_get_dev(bus, msg->data[1], &dev)) {
+			msg->data_len = 0;
+			msg->completion_code = CC_PARAM_OUT_OF_RANGE;
+			return;
+		}
+
+		int64_t left_ms = MAX(dev.quarantine_until_ms - k_uptime_get(), 0);
+		for (uint8_t i = 0; i < I2C_HEALTH_RESULT_NUM; i++) {
+			convert_uint32_t_to_uint8_t_pointer(dev.count[i], &msg->data[index], 4,
+							    SMALL_ENDIAN);
+			index += 4;
+		}
+		convert_uint32_t_to_uint8_t_pointer(dev.quarantine_count, &msg->data[index], 4,
+						    SMALL_ENDIAN);
+		index += 4;
+		convert_uint32_t_to_uint8_t_pointer((uint32_t)left_ms, &msg->data[index], 4,
+						    SMALL_ENDIAN);
+		index += 4;
+		for (uint8_t i = 0; i < I2C_HEALTH_LATENCY_BUCKET_NUM; i++) {
+			convert_uint32_t_to_uint8_t_pointer(dev.latency[i], &msg->data[index], 4,
+							    SMALL_ENDIAN);
+			index += 4;
+		}
+
+		msg->data_len = index;
+		msg->completion_code = CC_SUCCESS;
+		return;
+	}
+
+	i2c_bus_health bus_health;
+	i2c_sched_stat stat;
+	uint8_t addr[I2C_HEALTH_MAX_DEV];
+	if (!i2c_health_get_bus(bus, &bus_health) || !i2c_sched_get_stat(bus, &stat)) {
+		msg->data_len = 0;
+		msg->completion_code = CC_UNSPECIFIED_ERROR;
+		return;
+	}
+
+	convert_uint32_t_to_uint8_t_pointer(bus_health.recovery_count, &msg->data[index], 4,
+					    SMALL_ENDIAN);
+	index += 4;
+	convert_uint32_t_to_uint8_t_pointer(bus_health.recovery_fail_count, &msg->data[index], 4,
+					    SMALL_ENDIAN);
+	index += 4;
+	for (uint8_t i = 0; i < I2C_SCHED_PRIO_NUM; i++) {
+		convert_uint32_t_to_uint8_t_pointer(stat.xfer_count[i], &msg->data[index], 4,
+						    SMALL_ENDIAN);
+		index += 4;
+		convert_uint32_t_to_uint8_t_pointer(stat.timeout_count[i], &msg->data[index], 4,
+						    SMALL_ENDIAN);
+		index += 4;
+		convert_uint32_t_to_uint8_t_pointer(stat.wait_max_ms[i], &msg->data[index], 4,
+						    SMALL_ENDIAN);
+		index += 4;
+		msg->data[index++] = stat.depth_max[i];
+	}
+
+	uint8_t num = i2c_health_get_dev_list(bus, addr, ARRAY_SIZE(addr));
+	msg->data[index++] = num;
+	memcpy(&msg->data[index], addr, num);
+	index += num;
+
+	msg->data_len = index;
+	msg->completion_code = CC_SUCCESS;
+	return;
+}
+
+#define THREAD_PROFILE_PAGE_NUM 6
+
+__weak void OEM_1S_THREAD_PROFILE(ipmi_msg *msg)
+{
+	/*********************************
+	Request -
+	data 0: Sub command
+	  0x00 Start a window, data 1~2: window in ms (LSB first, optional)
+	  0x01 Get summary of the last window
+	  0x02 Get threads of the last window, data 1: first thread index
+	Response -
+	data 0: Completion code
+	if request data 0 == 0x01
+	data 1: Window running
+	data 2~5: Window length in us
+	data 6: Thread number
+	data 7~10: ISR time in us, data 11~14: ISR count
+	data 15~18: Worker job count, data 19~22: average and data 23~26: max job latency in us
+	if request data 0 == 0x02
+	data 1: Thread number in this response, then per thread name (16 bytes), priority,
+	  CPU usage (0.01%, 2 bytes), run time in us, wakeup count, average run queue wait in
+	  us, stack size and max stack used (4 bytes each). Counters are LSB first, 0xFFFFFFFF if
+	  not supported.
+	***********************************/
+	CHECK_NULL_ARG(msg);
+
+	if (msg->data_len < 1) {
+		msg->completion_code = CC_INVALID_LENGTH;
+		return;
+	}
+
+	uint8_t sub_cmd = msg->data[0];
+	uint16_t index = 0;
+
+	switch (sub_cmd) {
+	case 0x00: {
+		if ((msg->data_len != 1) && (msg->data_len != 3)) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+
+		uint32_t window_ms = THREAD_PROFILE_DEFAULT_WINDOW_MS;
+		if (msg->data_len == 3) {
+			window_ms = (msg->data[2] << 8) | msg->data[1];
+		}
+		if ((window_ms == 0) || (window_ms > THREAD_PROFILE_MAX_WINDOW_MS)) {
+			msg->completion_code = CC_PARAM_OUT_OF_RANGE;
+			break;
+		}
+
+		msg->completion_code =
+			thread_profile_start(window_ms) ? CC_SUCCESS : CC_NOT_SUPP_IN_CURR_STATE;
+		break;
+	}
+	case 0x01: {
+		thread_profile_summary summary;
+		if (msg->data_len != 1) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+		if (!thread_profile_get_summary(&summary)) {
+			msg->completion_code = CC_NOT_SUPP_IN_CURR_STATE;
+			break;
+		}
+
+		uint32_t value[] = { summary.isr_us,
+				     summary.isr_count,
+				     summary.work_count,
+				     summary.work_latency_avg_us,
+				     summary.work_latency_max_us };
+		msg->data[index++] = thread_profile_is_running();
+		convert_uint32_t_to_uint8_t_pointer(summary.window_us, &msg->data[index], 4,
+						    SMALL_ENDIAN);
+		index += 4;
+		msg->data[index++] = summary.thread_num;
+		for (uint8_t i = 0; i < ARRAY_SIZE(value); i++) {
+			convert_uint32_t_to_uint8_t_pointer(value[i], &msg->data[index], 4,
+							    SMALL_ENDIAN);
+			index += 4;
+		}
+		msg->data_len = index;
+		msg->completion_code = CC_SUCCESS;
+		return;
+	}
+	case 0x02: {
+		thread_profile_entry entry[THREAD_PROFILE_PAGE_NUM];
+		if (msg->data_len != 2) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+
+		uint8_t num = thread_profile_get_threads(msg->data[1], entry, ARRAY_SIZE(entry));
+		msg->data[index++] = num;
+		for (uint8_t i = 0; i < num; i++) {
+			uint32_t value[] = { entry[i].run_us, entry[i].wakeup_count,
+					     entry[i].ready_wait_avg_us, entry[i].stack_size,
+					     entry[i].stack_used };
+			memcpy(&msg->data[index], entry[i].name, THREAD_PROFILE_NAME_LEN);
+			index += THREAD_PROFILE_NAME_LEN;
+			msg->data[index++] = entry[i].priority;
+			msg->data[index++] = entry[i].cpu_usage & 0xFF;
+			msg->data[index++] = (entry[i].cpu_usage >> 8) & 0xFF;
+			for (uint8_t j = 0; j < ARRAY_SIZE(value); j++) {
+				convert_uint32_t_to_uint8_t_pointer(value[j], &msg->data[index], 4,
+								    SMALL_ENDIAN);
+				index += 4;
+			}
+		}
+		msg->data_len = index;
+		msg->completion_code = CC_SUCCESS;
+		return;
+	}
+	default:
+		msg->completion_code = CC_INVALID_DATA_FIELD;
+		break;
+	}
+
+	msg->data_len = 0;
+	return;
+}
+
+__weak void OEM_1S_LATENCY_HIST(ipmi_msg *msg)
+{
+	/*********************************
+	Request -
+	data 0: Sub command
+	  0x00 Get keys, data 1: group
+	  0x01 Get histogram, data 1: group, data 2~3: key (LSB first)
+	  0x02 Clear, data 1: group, 0xFF for all
+	Group: 0 IPMB, 1 MCTP RX, 2 PLDM request, 3 PLDM command, 4 sensor, 5 I2C
+	Response -
+	data 0: Completion code
+	if request data 0 == 0x00
+	data 1: Key number, then each key (2 bytes, LSB first)
+	if request data 0 == 0x01
+	data 1~4: Count, data 5~8: average in us, data 9~12: max in us,
+	data 13: Bucket number, then the count of each bucket (4 bytes, LSB first).
+	Bucket 0 is under 1 us, bucket n is 2^(n-1) to 2^n us, the last one is longer.
+	***********************************/
+	CHECK_NULL_ARG(msg);
+
+	if (msg->data_len < 2) {
+		msg->completion_code = CC_INVALID_LENGTH;
+		return;
+	}
+
+	uint8_t sub_cmd = msg->data[0];
+	uint8_t group = msg->data[1];
+	uint16_t index = 0;
+
+	if ((group >= LATENCY_HIST_GROUP_NUM) &&
+	    ((sub_cmd != 0x02) || (group != LATENCY_HIST_ALL_GROUP))) {
+		msg->data_len = 0;
+		msg->completion_code = CC_PARAM_OUT_OF_RANGE;
+		return;
+	}
+
+	switch (sub_cmd) {
+	case 0x00: {
+		uint16_t key[LATENCY_HIST_MAX_ENTRY];
+		if (msg->data_len != 2) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+
+		uint8_t num = latency_hist_get_keys(group, key, ARRAY_SIZE(key));
+		msg->data[index++] = num;
+		for (uint8_t i = 0; i < num; i++) {
+			msg->data[index++] = key[i] & 0xFF;
+			msg->data[index++] = (key[i] >> 8) & 0xFF;
+		}
+		msg->data_len = index;
+		msg->completion_code = CC_SUCCESS;
+		return;
+	}
+	case 0x01: {
+		latency_hist hist;
+		if (msg->data_len != 4) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+		if (!latency_hist_get(group, (msg->data[3] << 8) | msg->data[2], &hist)) {
+			msg->completion_code = CC_PARAM_OUT_OF_RANGE;
+			break;
+		}
+
+		uint32_t value[] = { hist.count,
+				     (hist.count > 0) ? (uint32_t)(hist.total_us / hist.count) : 0,
+				     hist.max_us };
+		for (uint8_t i = 0; i < ARRAY_SIZE(value); i++) {
+			convert_uint32_t_to_uint8_t_pointer(value[i], &msg->data[index], 4,
+							    SMALL_ENDIAN);
+			index += 4;
+		}
+		msg->data[index++] = LATENCY_HIST_BUCKET_NUM;
+		for (uint8_t i = 0; i < LATENCY_HIST_BUCKET_NUM; i++) {
+			convert_uint32_t_to_uint8_t_pointer(hist.bucket[i], &msg->data[index], 4,
+							    SMALL_ENDIAN);
+			index += 4;
+		}
+		msg->data_len = index;
+		msg->completion_code = CC_SUCCESS;
+		return;
+	}
+	case 0x02:
+		if (msg->data_len != 2) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+		latency_hist_clear(group);
+		msg->completion_code = CC_SUCCESS;
+		break;
+	default:
+		msg->completion_code = CC_INVALID_DATA_FIELD;
+		break;
+	}
+
+	msg->data_len = 0;
+	return;
+}
+
 #ifdef CONFIG_PECI
 __weak void OEM_1S_PECI_ACCESS(ipmi_msg *msg)
 {
@@ -885,6 +1239,79 @@ __weak void OEM_1S_JTAG_DATA_SHIFT(ipmi_msg *msg)
 	return;
 }
 
+/* Walk the ops of a batch, only checking it when is_run is false. Returns the response length
+ * or -1 if the batch is malformed.
+ */
+static int jtag_scan_batch(uint8_t *req, uint16_t req_len, uint8_t *resp, bool is_run)
+{
+	uint16_t ofs = 0;
+	int resp_len = 0;
+
+	while (ofs < req_len) {
+		uint8_t op = req[ofs];
+
+		if (op == JTAG_SCAN_OP_TAP) {
+			if ((ofs + 3) > req_len) {
+				return -1;
+			}
+			if (is_run) {
+				jtag_set_tap(req[ofs + 2], req[ofs + 1]);
+			}
+			ofs += 3;
+		} else if (op == JTAG_SCAN_OP_SHIFT) {
+			if ((ofs + 3) > req_len) {
+				return -1;
+			}
+			uint16_t writebitlen = (req[ofs + 2] << 8) | req[ofs + 1];
+			uint16_t databyte = (writebitlen + 7) >> 3;
+			if ((ofs + 6 + databyte) > req_len) {
+				return -1;
+			}
+			uint8_t *read_field = &req[ofs + 3 + databyte];
+			uint16_t readbitlen = (read_field[1] << 8) | read_field[0];
+			uint16_t readbyte = (readbitlen + 7) >> 3;
+			if ((resp_len + readbyte) > IPMI_DATA_MAX_LENGTH) {
+				return -1;
+			}
+			if (is_run) {
+				memset(resp + resp_len, 0, readbyte);
+				jtag_shift_data(writebitlen, &req[ofs + 3], readbitlen,
+						resp + resp_len, read_field[2]);
+			}
+			resp_len += readbyte;
+			ofs += 6 + databyte;
+		} else {
+			return -1;
+		}
+	}
+
+	return resp_len;
+}
+
+__weak void OEM_1S_JTAG_SCAN_BATCH(ipmi_msg *msg)
+{
+	CHECK_NULL_ARG(msg);
+
+	if ((msg->data_len == 0) || (jtag_scan_batch(msg->data, msg->data_len, NULL, false) < 0)) {
+		msg->completion_code = CC_INVALID_LENGTH;
+		return;
+	}
+
+	/* The read data of a shift may be longer than its request and overwrite the next ops */
+	uint8_t *req = malloc(msg->data_len);
+	if (req == NULL) {
+		LOG_ERR("Failed to allocate JTAG scan batch buffer");
+		msg->completion_code = CC_OUT_OF_SPACE;
+		return;
+	}
+	memcpy(req, msg->data, msg->data_len);
+
+	msg->data_len = jtag_scan_batch(req, msg->data_len, msg->data, true);
+	msg->completion_code = CC_SUCCESS;
+	SAFE_FREE(req);
+	return;
+}
+
 #ifdef ENABLE_ASD
 __weak void OEM_1S_ASD_INIT(ipmi_msg *msg)
 {
@@ -948,6 +1375,8 @@ __weak void OEM_1S_ACCURACY_SENSOR_READING(ipmi_msg *msg)
 		return;
 	}
 
+	uint16_t sensor_num = SENSOR_ID_IPMI(get_ipmb_dest_lun(msg), req->sensor_num);
+
 	// following IPMI sensor status response
 	if (enable_sensor_poll_thread) {
 		sensor_report_status = SENSOR_EVENT_MESSAGES_ENABLE | SENSOR_SCANNING_ENABLE;
@@ -957,13 +1386,13 @@ __weak void OEM_1S_ACCURACY_SENSOR_READING(ipmi_msg *msg)
 
 	if (req->read_option == GET_FROM_CACHE) {
 		if (enable_sensor_poll_thread) {
-			status = get_sensor_reading(sensor_config, sensor_config_count,
-						    req->sensor_num, &reading, GET_FROM_CACHE);
+			status = get_sensor_reading(sensor_config, sensor_config_count, sensor_num,
+						    &reading, GET_FROM_CACHE);
 		} else {
 			status = SENSOR_POLLING_DISABLE;
 		}
 	} else if (req->read_option == GET_FROM_SENSOR) {
-		status = get_sensor_reading(sensor_config, sensor_config_count, req->sensor_num,
+		status = get_sensor_reading(sensor_config, sensor_config_count, sensor_num,
 					    &reading, GET_FROM_SENSOR);
 	} else {
 		LOG_ERR("Error: read_option was not either GET_FROM_CACHE or GET_FROM_SENSOR.");
@@ -1214,16 +1643,20 @@ __weak void OEM_1S_CONTROL_SENSOR_POLLING(ipmi_msg *msg)
 		return;
 	}
 
-	uint8_t index = 0, control_sensor_index = 0, return_data_index = 0;
+	uint8_t index = 0, return_data_index = 0;
+	uint16_t sensor_num = 0, control_sensor_index = 0;
 	uint8_t sensor_number[total_sensor_count];
 	memcpy(&sensor_number[0], &msg->data[2], total_sensor_count);
 	for (index = 0; index < total_sensor_count; ++index) {
 		// Response data is a set of two
 		return_data_index = 2 * index;
 
-		control_sensor_index = sensor_config_index_map[sensor_number[index]];
+		sensor_num = SENSOR_ID_IPMI(get_ipmb_dest_lun(msg), sensor_number[index]);
+		control_sensor_index = (sensor_num < SENSOR_NUM_MAX) ?
+					       sensor_config_index_map[sensor_num] :
+					       SENSOR_NULL;
 		msg->data[return_data_index] = sensor_number[index];
-		if (control_sensor_index != SENSOR_FAIL) {
+		if (control_sensor_index != SENSOR_NULL) {
 			// Enable or Disable sensor polling
 			sensor_config[control_sensor_index].is_enable_polling =
 				((operation == DISABLE_SENSOR_POLLING) ? DISABLE_SENSOR_POLLING :
@@ -1644,6 +2077,136 @@ __weak void OEM_1S_GET_FAN_RPM(ipmi_msg *msg)
 
 	return;
 }
+
+__weak void OEM_1S_FAN_CONTROL(ipmi_msg *msg)
+{
+	/*********************************
+	Request -
+	data 0: Sub command
+	  0x00 Get status
+	  0x01 Enable BIC fan control, data 1: 0 disable, 1 enable
+	  0x02 Set stepwise profile, data 1: zone, data 2: min duty, data 3: max duty,
+	       data 4: fail duty, data 5: hysteresis, data 6: step number,
+	       then temperature (signed degree C) and duty of each step
+	  0x03 Set PID profile, data 1: zone, data 2: min duty, data 3: max duty,
+	       data 4: fail duty, data 5: setpoint (signed degree C),
+	       data 6~11: kp, ki, kd (signed, LSB first, duty percent per degree C in 1/100 units)
+	  0x04 Reset zone profile to default, data 1: zone, 0xFF for all
+	Response -
+	data 0: Completion code
+	if request data 0 == 0x00
+	data 1: State, 0 BMC, 1 BIC, 2 failsafe
+	data 2: BIC fan control enabled
+	data 3: BMC alive
+	data 4: Zone number
+	then profile type, temperature (signed degree C, 2 bytes, LSB first) and duty of each zone
+	***********************************/
+	CHECK_NULL_ARG(msg);
+
+	if (msg->data_len < 1) {
+		msg->completion_code = CC_INVALID_LENGTH;
+		return;
+	}
+
+	uint8_t sub_cmd = msg->data[0];
+	uint8_t zone_count = fan_ctrl_get_zone_count();
+	fan_ctrl_profile profile = { 0 };
+	uint8_t index = 0;
+
+	switch (sub_cmd) {
+	case 0x00:
+		if (msg->data_len != 1) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+		msg->data[index++] = fan_ctrl_get_state();
+		msg->data[index++] = fan_ctrl_is_enabled();
+		msg->data[index++] = fan_ctrl_is_bmc_alive();
+		msg->data[index++] = zone_count;
+		for (uint8_t zone = 0; zone < zone_count; zone++) {
+			fan_ctrl_zone_status status = { 0 };
+			fan_ctrl_get_zone_status(zone, &status);
+			msg->data[index++] = status.type;
+			msg->data[index++] = status.temp & 0xFF;
+			msg->data[index++] = (status.temp >> 8) & 0xFF;
+			msg->data[index++] = status.duty;
+		}
+		msg->data_len = index;
+		msg->completion_code = CC_SUCCESS;
+		return;
+	case 0x01:
+		if (msg->data_len != 2) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+		if (msg->data[1] > 1) {
+			msg->completion_code = CC_INVALID_DATA_FIELD;
+			break;
+		}
+		fan_ctrl_enable(msg->data[1]);
+		msg->completion_code = CC_SUCCESS;
+		break;
+	case 0x02:
+		if ((msg->data_len < 7) || (msg->data[6] > FAN_CTRL_MAX_STEP) ||
+		    (msg->data_len != 7 + msg->data[6] * 2)) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+		profile.type = FAN_CTRL_TYPE_STEPWISE;
+		profile.min_duty = msg->data[2];
+		profile.max_duty = msg->data[3];
+		profile.fail_duty = msg->data[4];
+		profile.hysteresis = msg->data[5];
+		profile.step_count = msg->data[6];
+		for (uint8_t i = 0; i < profile.step_count; i++) {
+			profile.step[i].temp = (int8_t)msg->data[7 + i * 2];
+			profile.step[i].duty = msg->data[8 + i * 2];
+		}
+		msg->completion_code = fan_ctrl_set_profile(msg->data[1], &profile) ?
+					       CC_SUCCESS :
+					       CC_INVALID_DATA_FIELD;
+		break;
+	case 0x03:
+		if (msg->data_len != 12) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+		profile.type = FAN_CTRL_TYPE_PID;
+		profile.min_duty = msg->data[2];
+		profile.max_duty = msg->data[3];
+		profile.fail_duty = msg->data[4];
+		profile.setpoint = (int8_t)msg->data[5];
+		profile.kp = (int16_t)(msg->data[6] | (msg->data[7] << 8));
+		profile.ki = (int16_t)(msg->data[8] | (msg->data[9] << 8));
+		profile.kd = (int16_t)(msg->data[10] | (msg->data[11] << 8));
+		msg->completion_code = fan_ctrl_set_profile(msg->data[1], &profile) ?
+					       CC_SUCCESS :
+					       CC_INVALID_DATA_FIELD;
+		break;
+	case 0x04:
+		if (msg->data_len != 2) {
+			msg->completion_code = CC_INVALID_LENGTH;
+			break;
+		}
+		if (msg->data[1] == 0xFF) {
+			for (uint8_t zone = 0; zone < zone_count; zone++) {
+				fan_ctrl_reset_profile(zone);
+			}
+			msg->completion_code = CC_SUCCESS;
+		} else {
+			msg->completion_code = fan_ctrl_reset_profile(msg->data[1]) ?
+						       CC_SUCCESS :
+						       CC_PARAM_OUT_OF_RANGE;
+		}
+		break;
+	default:
+		msg->completion_code = CC_INVALID_DATA_FIELD;
+		break;
+	}
+
+	msg->data_len = 0;
+	return;
+}
 #endif
 
 __weak void OEM_1S_COPY_FLASH_IMAGE(ipmi_msg *msg)
@@ -2336,6 +2899,24 @@ void IPMI_OEM_1S_handler(ipmi_msg *msg)
 		LOG_DBG("Received 1S Get Post Code (4-Byte) command");
 		OEM_1S_GET_4BYTE_POST_CODE(msg);
 		break;
+#ifdef ENABLE_BOOT_TIMELINE
+	case CMD_OEM_1S_GET_BOOT_TIMELINE:
+		LOG_DBG("Received 1S Get Boot Timeline command");
+		OEM_1S_GET_BOOT_TIMELINE(msg);
+		break;
+#endif
+	case CMD_OEM_1S_GET_I2C_STATS:
+		LOG_DBG("Received 1S Get I2C Stats command");
+		OEM_1S_GET_I2C_STATS(msg);
+		break;
+	case CMD_OEM_1S_THREAD_PROFILE:
+		LOG_DBG("Received 1S Thread Profile command");
+		OEM_1S_THREAD_PROFILE(msg);
+		break;
+	case CMD_OEM_1S_LATENCY_HIST:
+		LOG_DBG("Received 1S Latency Histogram command");
+		OEM_1S_LATENCY_HIST(msg);
+		break;
 #ifdef CONFIG_PECI
 	case CMD_OEM_1S_PECI_ACCESS:
 		LOG_DBG("Received 1S Access PECI command");
@@ -2369,6 +2950,10 @@ void IPMI_OEM_1S_handler(ipmi_msg *msg)
 		LOG_DBG("Received 1S JTAG Data Shift command");
 		OEM_1S_JTAG_DATA_SHIFT(msg);
 		break;
+	case CMD_OEM_1S_JTAG_SCAN_BATCH:
+		LOG_DBG("Received 1S JTAG Scan Batch command");
+		OEM_1S_JTAG_SCAN_BATCH(msg);
+		break;
 #ifdef ENABLE_ASD
 	case CMD_OEM_1S_ASD_INIT:
 		LOG_DBG("Received 1S ASD Initialize command");
@@ -2389,6 +2974,10 @@ void IPMI_OEM_1S_handler(ipmi_msg *msg)
 		LOG_DBG("Received 1S Get Fan RPM command");
 		OEM_1S_GET_FAN_RPM(msg);
 		break;
+	case CMD_OEM_1S_FAN_CONTROL:
+		LOG_DBG("Received 1S Fan Control command");
+		OEM_1S_FAN_CONTROL(msg);
+		break;
 #endif
 	case CMD_OEM_1S_COPY_FLASH_IMAGE:
 		LOG_DBG("Received 1S Copy Flash Image command");
@@ -34,12 +34,15 @@ __weak void SENSOR_GET_SENSOR_READING(ipmi_msg *msg)
 		return;
 	}
 
+	// The LUN the request is addressed to carries the upper bits of the sensor ID
+	uint16_t sensor_num = SENSOR_ID_IPMI(get_ipmb_dest_lun(msg), msg->data[0]);
+
 	if (enable_sensor_poll_thread) {
 		// Set IPMI sensor status response
 		sensor_report_status = SENSOR_EVENT_MESSAGES_ENABLE | SENSOR_SCANNING_ENABLE;
 
 		//Get sensor reading from bic cache
-		status = get_sensor_reading(sensor_config, sensor_config_count, msg->data[0],
+		status = get_sensor_reading(sensor_config, sensor_config_count, sensor_num,
 					    &reading, GET_FROM_CACHE);
 	} else {
 		status = SENSOR_POLLING_DISABLE;
@@ -50,7 +53,7 @@ __weak void SENSOR_GET_SENSOR_READING(ipmi_msg *msg)
 	case SENSOR_READ_SUCCESS:
 	case SENSOR_READ_ACUR_SUCCESS:
 	case SENSOR_READ_4BYTE_ACUR_SUCCESS:
-		msg->data[0] = calculate_MBR(msg->data[0],
+		msg->data[0] = calculate_MBR(sensor_num,
 					     (int)((sval->integer * 1000) + sval->fraction)) /
 			       1000;
 		msg->data[1] = sensor_report_status;
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "boot_timeline.h"
 #include "fru.h"
 #include "hal_i2c.h"
 #include "hal_i3c.h"
@@ -60,6 +61,9 @@ void main(void)
 
 	wdt_init();
 	util_init_timer();
+#ifdef ENABLE_BOOT_TIMELINE
+	boot_timeline_init();
+#endif
 	util_init_I2C();
 	util_init_i3c();
 	pal_pre_init();
@@ -22,8 +22,11 @@
 #include <string.h>
 #include <sys/printk.h>
 #include <zephyr.h>
+#include "i2c_scheduler.h"
+#include "latency_hist.h"
 #include "libutil.h"
 #include "plat_def.h"
+#include "util_mem.h"
 
 LOG_MODULE_REGISTER(mctp);
 
@@ -159,15 +162,15 @@ static uint8_t bridge_msg(mctp *mctp_inst, uint8_t *buf, uint16_t len)
 	return mctp_bridge_msg(target_mctp, buf, len, target_ext_params);
 }
 
-static uint8_t mctp_pkt_assembling(mctp *mctp_inst, uint8_t *buf, uint16_t len)
+uint8_t mctp_pkt_assembling(mctp_msg_assembly *assembly, uint8_t *buf, uint16_t len)
 {
-	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, MCTP_ERROR);
+	CHECK_NULL_ARG_WITH_RETURN(assembly, MCTP_ERROR);
 	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
 	CHECK_ARG_WITH_RETURN(!len, MCTP_ERROR);
 
 	mctp_hdr *hdr = (mctp_hdr *)buf;
-	uint8_t **buf_p = &mctp_inst->temp_msg_buf[hdr->msg_tag][hdr->to].buf;
-	uint16_t *offset_p = &mctp_inst->temp_msg_buf[hdr->msg_tag][hdr->to].offset;
+	uint8_t **buf_p = &assembly->buf;
+	uint16_t *offset_p = &assembly->offset;
 
 	/* one packet message, do nothing */
 	if (hdr->som && hdr->eom)
@@ -176,11 +179,11 @@ static uint8_t mctp_pkt_assembling(mctp *mctp_inst, uint8_t *buf, uint16_t len)
 	if (hdr->som && !hdr->eom) {
 		if (*buf_p) {
 			LOG_WRN("Unexpected SOM received?");
-			free(*buf_p);
+			util_mem_free(*buf_p);
 		}
 		*offset_p = 0;
 
-		*buf_p = (uint8_t *)malloc(MSG_ASSEMBLY_BUF_SIZE);
+		*buf_p = util_mem_alloc(MEM_TAG_MCTP, MSG_ASSEMBLY_BUF_SIZE);
 		if (!*buf_p) {
 			LOG_WRN("cannot create memory...");
 			return MCTP_ERROR;
@@ -254,7 +257,8 @@ static void mctp_rx_task(void *arg, void *dummy0, void *dummy1)
 		/* handle this packet by self */
 
 		/* assembling the mctp message */
-		if (mctp_pkt_assembling(mctp_inst, read_buf, read_len) == MCTP_ERROR)
+		if (mctp_pkt_assembling(&mctp_inst->temp_msg_buf[hdr->msg_tag][hdr->to], read_buf,
+					read_len) == MCTP_ERROR)
 			LOG_WRN("Packet assemble failed ");
 
 		/* if it is not last packet, waiting for the remain data */
@@ -274,11 +278,16 @@ static void mctp_rx_task(void *arg, void *dummy0, void *dummy1)
 			}
 
 			/* handle the mctp messsage */
+			uint32_t start_cycle = k_cycle_get_32();
 			mctp_inst->rx_cb(mctp_inst, p, len, ext_params);
+			if (len > 0) {
+				latency_hist_record_since(LATENCY_HIST_MCTP_RX, p[0] & 0x7F,
+							  start_cycle);
+			}
 		}
 
 		if (mctp_inst->temp_msg_buf[hdr->msg_tag][hdr->to].buf) {
-			free(mctp_inst->temp_msg_buf[hdr->msg_tag][hdr->to].buf);
+			util_mem_free(mctp_inst->temp_msg_buf[hdr->msg_tag][hdr->to].buf);
 			mctp_inst->temp_msg_buf[hdr->msg_tag][hdr->to].buf = NULL;
 			mctp_inst->temp_msg_buf[hdr->msg_tag][hdr->to].offset = 0;
 		}
@@ -308,6 +317,8 @@ static void mctp_tx_task(void *arg, void *dummy0, void *dummy1)
 	}
 
 	LOG_INF("mctp_tx_task start %p ", mctp_inst);
+	/* Only SMBus medium writes go through the i2c scheduler */
+	i2c_sched_set_thread_prio(I2C_SCHED_PRIO_IPMB);
 
 	while (1) {
 		mctp_tx_msg mctp_msg = { 0 };
@@ -321,7 +332,7 @@ static void mctp_tx_task(void *arg, void *dummy0, void *dummy1)
 		}
 
 		if (!mctp_msg.len) {
-			free(mctp_msg.buf);
+			util_mem_free(mctp_msg.buf);
 			mctp_tx_task_response(mctp_msg.evt_msgq, MCTP_ERROR);
 			continue;
 		}
@@ -336,7 +347,7 @@ static void mctp_tx_task(void *arg, void *dummy0, void *dummy1)
 		if (mctp_msg.is_bridge_packet) {
 			ret = mctp_inst->write_data(mctp_inst, mctp_msg.buf, mctp_msg.len,
 						    mctp_msg.ext_params);
-			free(mctp_msg.buf);
+			util_mem_free(mctp_msg.buf);
 			mctp_tx_task_response(mctp_msg.evt_msgq, ret);
 			continue;
 		}
@@ -397,7 +408,7 @@ static void mctp_tx_task(void *arg, void *dummy0, void *dummy1)
 			}
 		}
 
-		free(mctp_msg.buf);
+		util_mem_free(mctp_msg.buf);
 		mctp_tx_task_response(mctp_msg.evt_msgq,
 				      (i == split_pkt_num) ? MCTP_SUCCESS : MCTP_ERROR);
 
@@ -563,7 +574,7 @@ static uint8_t mctp_pass_tx_task(mctp *mctp_inst, uint8_t *buf, uint16_t len,
 	mctp_tx_msg mctp_msg = { 0 };
 	mctp_msg.is_bridge_packet = is_bridge;
 	mctp_msg.len = len;
-	mctp_msg.buf = (uint8_t *)malloc(len);
+	mctp_msg.buf = util_mem_alloc(MEM_TAG_MCTP, len);
 	if (!mctp_msg.buf)
 		goto error;
 	memcpy(mctp_msg.buf, buf, len);
@@ -590,7 +601,7 @@ static uint8_t mctp_pass_tx_task(mctp *mctp_inst, uint8_t *buf, uint16_t len,
 
 error:
 	if (mctp_msg.buf)
-		free(mctp_msg.buf);
+		util_mem_free(mctp_msg.buf);
 
 	return MCTP_ERROR;
 }
@@ -164,6 +164,12 @@ typedef struct __attribute__((aligned(4))) {
 	struct k_msgq *evt_msgq;
 } mctp_tx_msg;
 
+/* rx message buffer that is assembling request/response */
+typedef struct _mctp_msg_assembly {
+	uint8_t *buf;
+	uint16_t offset;
+} mctp_msg_assembly;
+
 /* mctp main struct */
 typedef struct _mctp {
 	uint8_t is_servcie_start;
@@ -192,21 +198,11 @@ typedef struct _mctp {
 	/* write queue */
 	struct k_msgq mctp_tx_queue;
 
-	/* point to the rx message buffer that is assembling request/response */
-	struct {
-		uint8_t *buf;
-		uint16_t offset;
-	} temp_msg_buf[MCTP_MAX_MSG_TAG_NUM][2];
+	/* rx message buffers that are assembling request/response, by tag and tag owner */
+	mctp_msg_assembly temp_msg_buf[MCTP_MAX_MSG_TAG_NUM][2];
 
 	/* the callback when recevie mctp data */
 	mctp_fn_cb rx_cb;
-
-	/* for pldm instance id */
-	uint8_t pldm_inst_id;
-	uint32_t pldm_inst_table; // 32 bits field for instance id
-
-	/* for cci_msg_tag */
-	uint8_t cci_msg_tag;
 } mctp;
 
 typedef struct _mctp_port {
@@ -254,6 +250,9 @@ uint8_t mctp_send_msg(mctp *mctp_inst, uint8_t *buf, uint16_t len, mctp_ext_para
 /* bridge message to destination endpoint */
 uint8_t mctp_bridge_msg(mctp *mctp_inst, uint8_t *buf, uint16_t len, mctp_ext_params ext_params);
 
+/* append a received packet to the assembly buffer of its tag and tag owner */
+uint8_t mctp_pkt_assembling(mctp_msg_assembly *assembly, uint8_t *buf, uint16_t len);
+
 /* medium init/deinit */
 uint8_t mctp_smbus_init(mctp *mctp_inst, mctp_medium_conf medium_conf);
 uint8_t mctp_smbus_deinit(mctp *mctp_inst);
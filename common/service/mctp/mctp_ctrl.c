@@ -16,6 +16,7 @@
 
 #include "mctp.h"
 #include "mctp_ctrl.h"
+#include "mctp_trans.h"
 #include <logging/log.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -28,21 +29,6 @@
 LOG_MODULE_DECLARE(mctp);
 
 #define DEFAULT_WAIT_TO_MS 3000
-#define RESP_MSG_PROC_MUTEX_WAIT_TO_MS 1000
-#define TO_CHK_INTERVAL_MS 1000
-
-#define MCTP_CTRL_INST_ID_MASK 0x3F
-
-typedef struct _wait_msg {
-	sys_snode_t node;
-	mctp *mctp_inst;
-	int64_t exp_to_ms;
-	mctp_ctrl_msg msg;
-} wait_msg;
-
-static K_MUTEX_DEFINE(wait_recv_resp_mutex);
-
-static sys_slist_t wait_recv_resp_list = SYS_SLIST_STATIC_INIT(&wait_recv_resp_list);
 
 __weak int load_mctp_support_types(uint8_t *type_len, uint8_t *types)
 {
@@ -105,97 +91,22 @@ uint8_t mctp_ctrl_cmd_get_message_type_support(void *mctp_inst, uint8_t *buf, ui
 	return MCTP_SUCCESS;
 }
 
-static uint8_t mctp_ctrl_msg_timeout_check(sys_slist_t *list, struct k_mutex *mutex)
-{
-	CHECK_NULL_ARG_WITH_RETURN(list, MCTP_ERROR);
-	CHECK_NULL_ARG_WITH_RETURN(mutex, MCTP_ERROR);
-
-	if (k_mutex_lock(mutex, K_MSEC(RESP_MSG_PROC_MUTEX_WAIT_TO_MS))) {
-		LOG_WRN("pldm mutex is locked over %d ms!!", RESP_MSG_PROC_MUTEX_WAIT_TO_MS);
-		return MCTP_ERROR;
-	}
-
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	int64_t cur_uptime = k_uptime_get();
-
-	SYS_SLIST_FOR_EACH_NODE_SAFE (list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-
-		if ((p->exp_to_ms <= cur_uptime)) {
-			printk("mctp ctrl msg timeout!!\n");
-			printk("cmd %x, inst_id %x\n", p->msg.hdr.cmd, p->msg.hdr.inst_id);
-			sys_slist_remove(list, pre_node, node);
-
-			if (p->msg.timeout_cb_fn)
-				p->msg.timeout_cb_fn(p->msg.timeout_cb_fn_args);
-
-			free(p);
-		} else {
-			pre_node = node;
-		}
-	}
-
-	k_mutex_unlock(mutex);
-	return MCTP_SUCCESS;
-}
-
-static void mctp_ctrl_msg_timeout_monitor(void *dummy0, void *dummy1, void *dummy2)
-{
-	ARG_UNUSED(dummy0);
-	ARG_UNUSED(dummy1);
-	ARG_UNUSED(dummy2);
-
-	while (1) {
-		k_msleep(TO_CHK_INTERVAL_MS);
-
-		mctp_ctrl_msg_timeout_check(&wait_recv_resp_list, &wait_recv_resp_mutex);
-	}
-}
-
 static uint8_t mctp_ctrl_cmd_resp_process(mctp *mctp_inst, uint8_t *buf, uint32_t len,
 					  mctp_ext_params ext_params)
 {
 	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, MCTP_ERROR);
 	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
 
-	if (!len)
-		return MCTP_ERROR;
-
-	if (k_mutex_lock(&wait_recv_resp_mutex, K_MSEC(RESP_MSG_PROC_MUTEX_WAIT_TO_MS))) {
-		LOG_WRN("mutex is locked over %d ms!", RESP_MSG_PROC_MUTEX_WAIT_TO_MS);
+	if (len < sizeof(mctp_ctrl_hdr))
 		return MCTP_ERROR;
-	}
 
 	mctp_ctrl_hdr *hdr = (mctp_ctrl_hdr *)buf;
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	sys_snode_t *found_node = NULL;
-
-	SYS_SLIST_FOR_EACH_NODE_SAFE (&wait_recv_resp_list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-		/* found the proper handler */
-		if ((p->msg.hdr.inst_id == hdr->inst_id) && (p->mctp_inst == mctp_inst) &&
-		    (p->msg.hdr.cmd == hdr->cmd)) {
-			found_node = node;
-			sys_slist_remove(&wait_recv_resp_list, pre_node, node);
-			break;
-		} else {
-			pre_node = node;
-		}
-	}
-	k_mutex_unlock(&wait_recv_resp_mutex);
-
-	if (found_node) {
-		/* invoke resp handler */
-		wait_msg *p = (wait_msg *)found_node;
-		if (p->msg.recv_resp_cb_fn)
-			p->msg.recv_resp_cb_fn(
-				p->msg.recv_resp_cb_args, buf + sizeof(p->msg.hdr),
-				len - sizeof(p->msg.hdr)); /* remove mctp ctrl header for handler */
-		free(p);
+
+	/* remove mctp ctrl header for handler */
+	if (!mctp_trans_complete(mctp_inst, MCTP_MSG_TYPE_CTRL, hdr->inst_id, hdr->cmd,
+				 buf + sizeof(*hdr), len - sizeof(*hdr))) {
+		LOG_DBG("Drop unexpected response, cmd 0x%x, inst_id 0x%x", hdr->cmd,
+			hdr->inst_id);
 	}
 
 	return MCTP_SUCCESS;
@@ -273,42 +184,21 @@ send_msg:
 	return mctp_send_msg(mctp_inst, resp_buf, resp_len, ext_params);
 }
 
-void mctp_ctrl_read_resp_handler(void *args, uint8_t *read_buf, uint16_t read_len)
+static void mctp_ctrl_read_resp_handler(void *args, uint8_t *read_buf, uint16_t read_len)
 {
 	CHECK_NULL_ARG(args);
 	CHECK_NULL_ARG(read_buf);
 
-	uint8_t status = 0;
-	mctp_ctrl_resp_arg *resp_arg = (mctp_ctrl_resp_arg *)args;
-
-	if (read_len > resp_arg->read_len) {
-		LOG_WRN("Response length(%d) is greater than buffer length(%d)", read_len,
-			resp_arg->read_len);
-		resp_arg->return_len = resp_arg->read_len;
-	} else {
-		resp_arg->return_len = read_len;
-	}
-
 	/* Return first data is completion code */
-	if (read_buf[0] != MCTP_CTRL_CC_SUCCESS) {
-		LOG_ERR("Return code status(0x%x)", read_buf[0]);
-		status = MCTP_CTRL_READ_STATUS_CC_ERROR;
-	} else {
-		memcpy(resp_arg->read_buf, read_buf, resp_arg->return_len);
-		status = MCTP_CTRL_READ_STATUS_SUCCESS;
+	if ((read_len == 0) || (read_buf[0] != MCTP_CTRL_CC_SUCCESS)) {
+		LOG_ERR("Return code status(0x%x)", read_len ? read_buf[0] : 0xFF);
+		mctp_trans_wait_done((mctp_trans_wait_ctx *)args, NULL, 0,
+				     MCTP_CTRL_READ_STATUS_CC_ERROR);
+		return;
 	}
 
-	k_msgq_put(resp_arg->msgq, &status, K_NO_WAIT);
-}
-
-void mctp_ctrl_read_timeout_handler(void *args)
-{
-	CHECK_NULL_ARG(args);
-
-	struct k_msgq *msgq = (struct k_msgq *)args;
-	uint8_t status = MCTP_CTRL_READ_STATUS_TIMEOUT;
-
-	k_msgq_put(msgq, &status, K_NO_WAIT);
+	mctp_trans_wait_done((mctp_trans_wait_ctx *)args, read_buf, read_len,
+			     MCTP_CTRL_READ_STATUS_SUCCESS);
 }
 
 uint8_t mctp_ctrl_send_msg(void *mctp_p, mctp_ctrl_msg *msg)
@@ -321,12 +211,24 @@ uint8_t mctp_ctrl_send_msg(void *mctp_p, mctp_ctrl_msg *msg)
 	}
 
 	mctp *mctp_inst = (mctp *)mctp_p;
-	wait_msg *p = NULL;
+	uint8_t trans_id = 0;
 
 	if (msg->hdr.rq) {
-		static uint8_t inst_id;
+		mctp_trans_cb cb = {
+			.resp_fn = msg->recv_resp_cb_fn,
+			.resp_args = msg->recv_resp_cb_args,
+			.timeout_fn = msg->timeout_cb_fn,
+			.timeout_args = msg->timeout_cb_fn_args,
+			.timeout_ms = msg->timeout_ms ? msg->timeout_ms : DEFAULT_WAIT_TO_MS,
+		};
+
+		if (!mctp_trans_begin(mctp_inst, MCTP_MSG_TYPE_CTRL, msg->hdr.cmd, &cb,
+				      &trans_id)) {
+			LOG_WRN("Register failed!");
+			return MCTP_ERROR;
+		}
 
-		msg->hdr.inst_id = (inst_id++) & MCTP_CTRL_INST_ID_MASK;
+		msg->hdr.inst_id = trans_id;
 		msg->hdr.msg_type = MCTP_MSG_TYPE_CTRL;
 
 		msg->ext_params.tag_owner = 1;
@@ -340,31 +242,12 @@ uint8_t mctp_ctrl_send_msg(void *mctp_p, mctp_ctrl_msg *msg)
 
 	LOG_HEXDUMP_DBG(buf, len, __func__);
 
-	if (msg->hdr.rq) {
-		p = (wait_msg *)malloc(sizeof(*p));
-		if (!p) {
-			LOG_WRN("wait_msg alloc failed!");
-			return MCTP_ERROR;
-		}
-
-		memset(p, 0, sizeof(*p));
-		p->mctp_inst = mctp_inst;
-		p->msg = *msg;
-		p->exp_to_ms =
-			k_uptime_get() + (msg->timeout_ms ? msg->timeout_ms : DEFAULT_WAIT_TO_MS);
-
-		k_mutex_lock(&wait_recv_resp_mutex, K_FOREVER);
-		sys_slist_append(&wait_recv_resp_list, &p->node);
-		k_mutex_unlock(&wait_recv_resp_mutex);
-	}
-
 	uint8_t rc = mctp_send_msg(mctp_inst, buf, len, msg->ext_params);
 	if (rc == MCTP_ERROR) {
 		LOG_WRN("mctp_send_msg error!!");
 
-		if (p != NULL) {
-			sys_slist_find_and_remove(&wait_recv_resp_list, &p->node);
-			SAFE_FREE(p);
+		if (msg->hdr.rq) {
+			mctp_trans_abort(trans_id);
 		}
 		return MCTP_ERROR;
 	}
@@ -382,55 +265,25 @@ uint8_t mctp_ctrl_read(void *mctp_p, mctp_ctrl_msg *msg, uint8_t *read_buf, uint
 		CHECK_NULL_ARG_WITH_RETURN(msg->cmd_data, MCTP_ERROR);
 	}
 
-	uint8_t ret = MCTP_ERROR;
-	uint8_t status = 0;
-	uint8_t status_msgq_buf[1];
-	struct k_msgq *status_msgq = (struct k_msgq *)malloc(sizeof(struct k_msgq));
-	if (status_msgq == NULL) {
-		LOG_ERR("Fail to allocate status_msgq");
-		return ret;
-	}
-
-	k_msgq_init(status_msgq, status_msgq_buf, sizeof(uint8_t), 1);
-
-	mctp_ctrl_resp_arg *resp_arg = (mctp_ctrl_resp_arg *)malloc(sizeof(mctp_ctrl_resp_arg));
-	if (resp_arg == NULL) {
-		SAFE_FREE(status_msgq);
-		LOG_ERR("Fail to allocate resp_arg");
-		return ret;
-	}
-
-	resp_arg->msgq = status_msgq;
-	resp_arg->read_buf = read_buf;
-	resp_arg->read_len = read_len;
-	resp_arg->return_len = 0;
+	mctp_trans_wait_ctx wait_ctx;
+	mctp_trans_wait_init(&wait_ctx, read_buf, read_len);
 
 	msg->recv_resp_cb_fn = mctp_ctrl_read_resp_handler;
-	msg->recv_resp_cb_args = (void *)resp_arg;
-	msg->timeout_cb_fn = mctp_ctrl_read_timeout_handler;
-	msg->timeout_cb_fn_args = (void *)status_msgq;
+	msg->recv_resp_cb_args = (void *)&wait_ctx;
+	msg->timeout_cb_fn = mctp_trans_wait_timeout_handler;
+	msg->timeout_cb_fn_args = (void *)&wait_ctx;
 	msg->timeout_ms = DEFAULT_WAIT_TO_MS;
 
 	if (mctp_ctrl_send_msg(mctp_p, msg) == MCTP_ERROR) {
 		LOG_ERR("Fail to send ctrl msg");
-		goto exit;
-	}
-
-	if (k_msgq_get(status_msgq, &status, K_FOREVER)) {
-		LOG_ERR("Fail to get status from msgq");
-		goto exit;
+		return MCTP_ERROR;
 	}
 
-	if (status == MCTP_CTRL_READ_STATUS_SUCCESS) {
-		ret = MCTP_SUCCESS;
-	} else {
+	uint8_t status = mctp_trans_wait(&wait_ctx);
+	if (status != MCTP_CTRL_READ_STATUS_SUCCESS) {
 		LOG_ERR("MCTP ctrl status: 0x%x", status);
+		return MCTP_ERROR;
 	}
 
-exit:
-	SAFE_FREE(resp_arg);
-	SAFE_FREE(status_msgq);
-	return ret;
+	return MCTP_SUCCESS;
 }
-
-K_THREAD_DEFINE(monitor_tid, 1024, mctp_ctrl_msg_timeout_monitor, NULL, NULL, NULL, 0, 0, 0);
@@ -135,13 +135,6 @@ typedef struct {
 	void *timeout_cb_fn_args;
 } mctp_ctrl_msg;
 
-typedef struct _mctp_ctrl_resp_arg {
-	struct k_msgq *msgq;
-	uint8_t *read_buf;
-	uint16_t read_len;
-	uint16_t return_len;
-} mctp_ctrl_resp_arg;
-
 uint8_t mctp_ctrl_cmd_handler(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext_params ext_params);
 
 uint8_t mctp_ctrl_send_msg(void *mctp_p, mctp_ctrl_msg *msg);
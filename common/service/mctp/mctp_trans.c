@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mctp_trans.h"
+#include <logging/log.h>
+#include <string.h>
+#include <zephyr.h>
+#include "latency_hist.h"
+#include "libutil.h"
+
+LOG_MODULE_REGISTER(mctp_trans);
+
+#define MCTP_TRANS_MUTEX_TIMEOUT_MS 500
+#define MCTP_TRANS_RETRY_DELAY_MS 10
+
+typedef struct _mctp_trans_slot {
+	bool in_use;
+	mctp *mctp_inst;
+	uint8_t msg_type;
+	uint16_t match;
+	/* Allocation order, used to pick the oldest slot for message types without a tag */
+	uint32_t seq;
+	int64_t exp_to_ms;
+	uint32_t start_cycle;
+	mctp_trans_cb cb;
+	struct k_work_delayable timeout_work;
+} mctp_trans_slot;
+
+static mctp_trans_slot trans_slot[MCTP_TRANS_SLOT_NUM];
+static uint8_t next_slot = 0;
+static uint32_t next_seq = 0;
+static bool is_trans_slot_init = false;
+static K_MUTEX_DEFINE(trans_mutex);
+
+static void mctp_trans_timeout_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	mctp_trans_slot *slot = CONTAINER_OF(dwork, mctp_trans_slot, timeout_work);
+
+	if (k_mutex_lock(&trans_mutex, K_MSEC(MCTP_TRANS_MUTEX_TIMEOUT_MS))) {
+		LOG_WRN("Transaction mutex is locked over %d ms", MCTP_TRANS_MUTEX_TIMEOUT_MS);
+		k_work_reschedule(dwork, K_MSEC(MCTP_TRANS_RETRY_DELAY_MS));
+		return;
+	}
+
+	/* The slot may have completed, or even been reused, after this work was queued */
+	if (!slot->in_use || (k_uptime_get() < slot->exp_to_ms)) {
+		k_mutex_unlock(&trans_mutex);
+		return;
+	}
+
+	mctp_trans_cb cb = slot->cb;
+	slot->in_use = false;
+	LOG_WRN("MCTP msg type 0x%x id %d key 0x%x timeout", slot->msg_type,
+		(int)(slot - trans_slot), slot->match);
+	k_mutex_unlock(&trans_mutex);
+
+	if (cb.timeout_fn) {
+		cb.timeout_fn(cb.timeout_args);
+	}
+}
+
+bool mctp_trans_begin(mctp *mctp_inst, uint8_t msg_type, uint16_t match, const mctp_trans_cb *cb,
+		      uint8_t *id)
+{
+	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, false);
+	CHECK_NULL_ARG_WITH_RETURN(cb, false);
+	CHECK_NULL_ARG_WITH_RETURN(id, false);
+
+	if (k_mutex_lock(&trans_mutex, K_MSEC(MCTP_TRANS_MUTEX_TIMEOUT_MS))) {
+		LOG_WRN("Transaction mutex is locked over %d ms", MCTP_TRANS_MUTEX_TIMEOUT_MS);
+		return false;
+	}
+
+	if (!is_trans_slot_init) {
+		for (uint8_t i = 0; i < MCTP_TRANS_SLOT_NUM; i++) {
+			k_work_init_delayable(&trans_slot[i].timeout_work,
+					      mctp_trans_timeout_work_handler);
+		}
+		is_trans_slot_init = true;
+	}
+
+	/* Next fit, so a just released id, which a late response may still carry, is reused last */
+	mctp_trans_slot *slot = NULL;
+	for (uint8_t i = 0; i < MCTP_TRANS_SLOT_NUM; i++) {
+		uint8_t index = (next_slot + i) % MCTP_TRANS_SLOT_NUM;
+		if (!trans_slot[index].in_use) {
+			slot = &trans_slot[index];
+			*id = index;
+			next_slot = (index + 1) % MCTP_TRANS_SLOT_NUM;
+			break;
+		}
+	}
+
+	if (slot == NULL) {
+		k_mutex_unlock(&trans_mutex);
+		LOG_WRN("No free transaction slot for msg type 0x%x", msg_type);
+		return false;
+	}
+
+	uint16_t timeout_ms = cb->timeout_ms ? cb->timeout_ms : MCTP_TRANS_DEFAULT_TIMEOUT_MS;
+	slot->in_use = true;
+	slot->mctp_inst = mctp_inst;
+	slot->msg_type = msg_type;
+	slot->match = match;
+	slot->seq = next_seq++;
+	slot->exp_to_ms = k_uptime_get() + timeout_ms;
+	slot->start_cycle = k_cycle_get_32();
+	slot->cb = *cb;
+	k_work_reschedule(&slot->timeout_work, K_MSEC(timeout_ms));
+
+	k_mutex_unlock(&trans_mutex);
+	return true;
+}
+
+void mctp_trans_abort(uint8_t id)
+{
+	if (id >= MCTP_TRANS_SLOT_NUM) {
+		return;
+	}
+
+	k_mutex_lock(&trans_mutex, K_FOREVER);
+	trans_slot[id].in_use = false;
+	k_work_cancel_delayable(&trans_slot[id].timeout_work);
+	k_mutex_unlock(&trans_mutex);
+}
+
+static mctp_trans_slot *find_oldest_slot(mctp *mctp_inst, uint8_t msg_type, uint16_t match)
+{
+	mctp_trans_slot *found = NULL;
+
+	for (uint8_t i = 0; i < MCTP_TRANS_SLOT_NUM; i++) {
+		mctp_trans_slot *slot = &trans_slot[i];
+		if (!slot->in_use || (slot->mctp_inst != mctp_inst) ||
+		    (slot->msg_type != msg_type) || (slot->match != match)) {
+			continue;
+		}
+		if ((found == NULL) || ((int32_t)(slot->seq - found->seq) < 0)) {
+			found = slot;
+		}
+	}
+
+	return found;
+}
+
+bool mctp_trans_take(mctp *mctp_inst, uint8_t msg_type, uint8_t id, uint16_t match,
+		     mctp_trans_cb *cb)
+{
+	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, false);
+	CHECK_NULL_ARG_WITH_RETURN(cb, false);
+
+	if ((id != MCTP_TRANS_ID_ANY) && (id >= MCTP_TRANS_SLOT_NUM)) {
+		return false;
+	}
+
+	if (k_mutex_lock(&trans_mutex, K_MSEC(MCTP_TRANS_MUTEX_TIMEOUT_MS))) {
+		LOG_WRN("Transaction mutex is locked over %d ms", MCTP_TRANS_MUTEX_TIMEOUT_MS);
+		return false;
+	}
+
+	mctp_trans_slot *slot = NULL;
+	if (id == MCTP_TRANS_ID_ANY) {
+		slot = find_oldest_slot(mctp_inst, msg_type, match);
+	} else if (trans_slot[id].in_use && (trans_slot[id].mctp_inst == mctp_inst) &&
+		   (trans_slot[id].msg_type == msg_type) && (trans_slot[id].match == match)) {
+		slot = &trans_slot[id];
+	}
+
+	if (slot == NULL) {
+		k_mutex_unlock(&trans_mutex);
+		LOG_DBG("No pending msg type 0x%x id %d key 0x%x", msg_type, id, match);
+		return false;
+	}
+
+	*cb = slot->cb;
+	slot->in_use = false;
+	k_work_cancel_delayable(&slot->timeout_work);
+	uint32_t start_cycle = slot->start_cycle;
+
+	k_mutex_unlock(&trans_mutex);
+
+	/* PLDM matches on type << 8 | command, which is the histogram key */
+	if (msg_type == MCTP_MSG_TYPE_PLDM) {
+		latency_hist_record_since(LATENCY_HIST_PLDM_REQ, match, start_cycle);
+	}
+	return true;
+}
+
+bool mctp_trans_complete(mctp *mctp_inst, uint8_t msg_type, uint8_t id, uint16_t match,
+			 uint8_t *buf, uint16_t len)
+{
+	mctp_trans_cb cb;
+
+	if (!mctp_trans_take(mctp_inst, msg_type, id, match, &cb)) {
+		return false;
+	}
+
+	if (cb.resp_fn) {
+		cb.resp_fn(cb.resp_args, buf, len);
+	}
+
+	return true;
+}
+
+void mctp_trans_wait_init(mctp_trans_wait_ctx *ctx, uint8_t *rbuf, uint16_t rbuf_len)
+{
+	CHECK_NULL_ARG(ctx);
+
+	k_sem_init(&ctx->sem, 0, 1);
+	ctx->rbuf = rbuf;
+	ctx->rbuf_len = rbuf_len;
+	ctx->return_len = 0;
+	ctx->status = MCTP_TRANS_STATUS_TIMEOUT;
+}
+
+/* Copy the response, if any, to the waiter buffer and wake it up */
+void mctp_trans_wait_done(mctp_trans_wait_ctx *ctx, uint8_t *buf, uint16_t len, uint8_t status)
+{
+	CHECK_NULL_ARG(ctx);
+
+	ctx->return_len = 0;
+	if ((buf != NULL) && (ctx->rbuf != NULL)) {
+		if (len > ctx->rbuf_len) {
+			LOG_WRN("Response length(%d) is greater than buffer length(%d)!", len,
+				ctx->rbuf_len);
+		}
+		ctx->return_len = MIN(len, ctx->rbuf_len);
+		memcpy(ctx->rbuf, buf, ctx->return_len);
+	}
+	ctx->status = status;
+	k_sem_give(&ctx->sem);
+}
+
+void mctp_trans_wait_resp_handler(void *args, uint8_t *buf, uint16_t len)
+{
+	CHECK_NULL_ARG(args);
+
+	mctp_trans_wait_done((mctp_trans_wait_ctx *)args, buf, len, MCTP_TRANS_STATUS_SUCCESS);
+}
+
+void mctp_trans_wait_timeout_handler(void *args)
+{
+	CHECK_NULL_ARG(args);
+
+	mctp_trans_wait_done((mctp_trans_wait_ctx *)args, NULL, 0, MCTP_TRANS_STATUS_TIMEOUT);
+}
+
+/* Block until the transaction completes, the slot timer guarantees that it does */
+uint8_t mctp_trans_wait(mctp_trans_wait_ctx *ctx)
+{
+	CHECK_NULL_ARG_WITH_RETURN(ctx, MCTP_TRANS_STATUS_TIMEOUT);
+
+	k_sem_take(&ctx->sem, K_FOREVER);
+	return ctx->status;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _MCTP_TRANS_H
+#define _MCTP_TRANS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mctp.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr.h>
+
+/*
+ * Request/response transactions shared by every MCTP message type.
+ *
+ * Each outstanding request owns one preallocated slot. The slot index is the transaction id
+ * and the message type puts it in its own tag field (PLDM and MCTP control instance id, CCI
+ * message tag), so a response is matched by index instead of walking a list. Message types
+ * without a tag field complete with MCTP_TRANS_ID_ANY, which picks the oldest pending slot
+ * with the same key. Every slot has its own timer, nothing polls for expiry.
+ *
+ * Callbacks run without any lock held, in the MCTP rx thread for a response and in the
+ * system workqueue for a timeout.
+ */
+
+/* PLDM instance id is 5 bits */
+#define MCTP_TRANS_SLOT_NUM 32
+#define MCTP_TRANS_DEFAULT_TIMEOUT_MS 3000
+#define MCTP_TRANS_ID_ANY 0xFF
+
+enum MCTP_TRANS_STATUS {
+	MCTP_TRANS_STATUS_SUCCESS = 0x00,
+	MCTP_TRANS_STATUS_CC_ERROR,
+	MCTP_TRANS_STATUS_TIMEOUT,
+};
+
+typedef void (*mctp_trans_resp_fn)(void *args, uint8_t *buf, uint16_t len);
+typedef void (*mctp_trans_timeout_fn)(void *args);
+
+typedef struct _mctp_trans_cb {
+	mctp_trans_resp_fn resp_fn;
+	void *resp_args;
+	mctp_trans_timeout_fn timeout_fn;
+	void *timeout_args;
+	/* 0 means MCTP_TRANS_DEFAULT_TIMEOUT_MS */
+	uint16_t timeout_ms;
+} mctp_trans_cb;
+
+/* Context of a caller blocking on one transaction, it can live on the caller stack since the
+ * slot always completes, by response or by timeout, before mctp_trans_wait returns.
+ */
+typedef struct _mctp_trans_wait_ctx {
+	struct k_sem sem;
+	uint8_t *rbuf;
+	uint16_t rbuf_len;
+	uint16_t return_len;
+	uint8_t status;
+} mctp_trans_wait_ctx;
+
+/* Reserve a slot and start its timer, "match" is the message type specific key that the
+ * response must carry, e.g. PLDM type and command.
+ */
+bool mctp_trans_begin(mctp *mctp_inst, uint8_t msg_type, uint16_t match, const mctp_trans_cb *cb,
+		      uint8_t *id);
+
+/* Release a slot without invoking any callback, e.g. the request could not be sent */
+void mctp_trans_abort(uint8_t id);
+
+/* Release the slot matching a response and hand back its callbacks without invoking them */
+bool mctp_trans_take(mctp *mctp_inst, uint8_t msg_type, uint8_t id, uint16_t match,
+		     mctp_trans_cb *cb);
+
+/* Non-blocking completion, release the matching slot and invoke its response callback */
+bool mctp_trans_complete(mctp *mctp_inst, uint8_t msg_type, uint8_t id, uint16_t match,
+			 uint8_t *buf, uint16_t len);
+
+void mctp_trans_wait_init(mctp_trans_wait_ctx *ctx, uint8_t *rbuf, uint16_t rbuf_len);
+void mctp_trans_wait_done(mctp_trans_wait_ctx *ctx, uint8_t *buf, uint16_t len, uint8_t status);
+void mctp_trans_wait_resp_handler(void *args, uint8_t *buf, uint16_t len);
+void mctp_trans_wait_timeout_handler(void *args);
+uint8_t mctp_trans_wait(mctp_trans_wait_ctx *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MCTP_TRANS_H */
@@ -16,6 +16,7 @@
 
 #include "pldm.h"
 #include "mctp.h"
+#include "mctp_trans.h"
 #include <logging/log.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -23,41 +24,24 @@
 #include <sys/printk.h>
 #include <sys/slist.h>
 #include <zephyr.h>
+#include "latency_hist.h"
 #include "libutil.h"
 #include "ipmi.h"
 
 LOG_MODULE_REGISTER(pldm);
 
-#define PLDM_HDR_INST_ID_MASK 0x1F
-#define PLDM_MAX_INSTID_COUNT (PLDM_HDR_INST_ID_MASK + 1)
-#define PLDM_MSG_CHECK_PER_MS 1000
 #define PLDM_MSG_TIMEOUT_MS 5000
-#define PLDM_RESP_MSG_PROC_MUTEX_TIMEOUT_MS 500
 #define PLDM_TASK_NAME_MAX_SIZE 32
 #define PLDM_MSG_MAX_RETRY 3
 
-#define PLDM_READ_EVENT_SUCCESS BIT(0)
-#define PLDM_READ_EVENT_TIMEOUT BIT(1)
-
-typedef struct _wait_msg {
-	sys_snode_t node;
-	mctp *mctp_inst;
-	int64_t exp_to_ms;
-	pldm_msg msg;
-} wait_msg;
+/* Transaction key of a PLDM request, the instance id is the transaction id */
+#define PLDM_TRANS_MATCH(pldm_type, cmd) (((pldm_type) << 8) | (cmd))
 
 struct _pldm_handler_query_entry {
 	PLDM_TYPE type;
 	uint8_t (*handler_query)(uint8_t, void **);
 };
 
-typedef struct _pldm_recv_resp_arg {
-	struct k_msgq *msgq;
-	uint8_t *rbuf;
-	uint16_t rbuf_len;
-	uint16_t return_len;
-} pldm_recv_resp_arg;
-
 static struct _pldm_handler_query_entry query_tbl[] = {
 	{ PLDM_TYPE_BASE, pldm_base_handler_query },
 	{ PLDM_TYPE_PLAT_MON_CTRL, pldm_monitor_handler_query },
@@ -65,94 +49,6 @@ static struct _pldm_handler_query_entry query_tbl[] = {
 	{ PLDM_TYPE_OEM, pldm_oem_handler_query },
 };
 
-static K_MUTEX_DEFINE(wait_recv_resp_mutex);
-
-static sys_slist_t wait_recv_resp_list = SYS_SLIST_STATIC_INIT(&wait_recv_resp_list);
-
-static bool unregister_instid(void *mctp_p, uint8_t inst_num)
-{
-	CHECK_NULL_ARG_WITH_RETURN(mctp_p, false);
-
-	if (inst_num >= PLDM_MAX_INSTID_COUNT) {
-		LOG_ERR("Invalid instance number %d", inst_num);
-		return false;
-	}
-
-	mctp *mctp_inst = (mctp *)mctp_p;
-	if (!mctp_inst->pldm_inst_table) {
-		LOG_ERR("Instance table not init!");
-		return false;
-	}
-	if (!(mctp_inst->pldm_inst_table & BIT(inst_num))) {
-		LOG_ERR("Inatant id %d not register yet!", inst_num);
-		return false;
-	}
-	WRITE_BIT(mctp_inst->pldm_inst_table, inst_num, 0);
-
-	return true;
-}
-
-static bool register_instid(void *mctp_p, uint8_t *inst_num)
-{
-	CHECK_NULL_ARG_WITH_RETURN(mctp_p, false);
-	CHECK_NULL_ARG_WITH_RETURN(inst_num, false);
-
-	mctp *mctp_inst = (mctp *)mctp_p;
-
-	static uint8_t cur_inst_num = 0;
-
-	int retry = 0;
-	for (retry = 0; retry < PLDM_MAX_INSTID_COUNT; retry++) {
-		if (!(mctp_inst->pldm_inst_table & BIT(cur_inst_num))) {
-			break;
-		}
-		cur_inst_num = (cur_inst_num + 1) & PLDM_HDR_INST_ID_MASK;
-	}
-
-	if (retry == PLDM_MAX_INSTID_COUNT) {
-		LOG_DBG("Inatant id %d not available!", cur_inst_num);
-		return false;
-	}
-
-	WRITE_BIT(mctp_inst->pldm_inst_table, cur_inst_num, 1);
-	*inst_num = cur_inst_num;
-
-	cur_inst_num = (cur_inst_num + 1) & PLDM_HDR_INST_ID_MASK;
-
-	return true;
-}
-
-void pldm_read_resp_handler(void *args, uint8_t *rbuf, uint16_t rlen)
-{
-	CHECK_NULL_ARG(args);
-	CHECK_NULL_ARG(rbuf);
-
-	if (!rlen)
-		return;
-
-	pldm_recv_resp_arg *recv_arg = (pldm_recv_resp_arg *)args;
-
-	if (rlen > recv_arg->rbuf_len) {
-		LOG_WRN("Response length(%d) is greater than buffer length(%d)!", rlen,
-			recv_arg->rbuf_len);
-		recv_arg->return_len = recv_arg->rbuf_len;
-	} else {
-		recv_arg->return_len = rlen;
-	}
-	memcpy(recv_arg->rbuf, rbuf, recv_arg->return_len);
-	uint8_t status = PLDM_READ_EVENT_SUCCESS;
-	k_msgq_put(recv_arg->msgq, &status, K_NO_WAIT);
-}
-
-static void pldm_read_timeout_handler(void *args)
-{
-	CHECK_NULL_ARG(args);
-
-	struct k_msgq *msgq = (struct k_msgq *)args;
-	uint8_t status = PLDM_READ_EVENT_TIMEOUT;
-	k_msgq_put(msgq, &status, K_NO_WAIT);
-}
-
 /*
  * The return value is the read length from PLDM device
  */
@@ -165,163 +61,63 @@ uint16_t mctp_pldm_read(void *mctp_p, pldm_msg *msg, uint8_t *rbuf, uint16_t rbu
 	if (!rbuf_len)
 		return 0;
 
-	uint8_t event_msgq_buffer[1];
-	struct k_msgq *event_msgq_p = (struct k_msgq *)malloc(sizeof(struct k_msgq));
-	if (!event_msgq_p) {
-		LOG_WRN("Failed to allocate event_msgq_p");
-		return 0;
-	}
-	uint16_t ret_len = 0;
-
-	k_msgq_init(event_msgq_p, event_msgq_buffer, sizeof(uint8_t), 1);
+	mctp_trans_wait_ctx wait_ctx;
 
-	pldm_recv_resp_arg *recv_arg_p = (pldm_recv_resp_arg *)malloc(sizeof(pldm_recv_resp_arg));
-	if (!recv_arg_p) {
-		SAFE_FREE(event_msgq_p);
-		LOG_WRN("Failed to allocate recv_arg_p");
-		return 0;
-	}
-	recv_arg_p->msgq = event_msgq_p;
-	recv_arg_p->rbuf = rbuf;
-	recv_arg_p->rbuf_len = rbuf_len;
-	recv_arg_p->return_len = 0;
-
-	msg->recv_resp_cb_fn = pldm_read_resp_handler;
-	msg->recv_resp_cb_args = (void *)recv_arg_p;
-	msg->timeout_cb_fn = pldm_read_timeout_handler;
-	msg->timeout_cb_fn_args = (void *)event_msgq_p;
+	msg->recv_resp_cb_fn = mctp_trans_wait_resp_handler;
+	msg->recv_resp_cb_args = (void *)&wait_ctx;
+	msg->timeout_cb_fn = mctp_trans_wait_timeout_handler;
+	msg->timeout_cb_fn_args = (void *)&wait_ctx;
 	msg->timeout_ms = PLDM_MSG_TIMEOUT_MS;
 
 	for (uint8_t retry_count = 0; retry_count < PLDM_MSG_MAX_RETRY; retry_count++) {
-		uint8_t event = 0;
+		mctp_trans_wait_init(&wait_ctx, rbuf, rbuf_len);
 		if (mctp_pldm_send_msg(mctp_p, msg) == PLDM_ERROR) {
 			LOG_WRN("Send msg failed!");
 			continue;
 		}
-		if (k_msgq_get(event_msgq_p, &event, K_FOREVER)) {
-			LOG_WRN("Failed to get status from msgq!");
-			continue;
-		}
-		if (event == PLDM_READ_EVENT_SUCCESS) {
-			ret_len = recv_arg_p->return_len;
-			SAFE_FREE(recv_arg_p);
-			SAFE_FREE(event_msgq_p);
-			return ret_len;
+		if (mctp_trans_wait(&wait_ctx) == MCTP_TRANS_STATUS_SUCCESS) {
+			return wait_ctx.return_len;
 		}
 	}
-	SAFE_FREE(event_msgq_p);
-	SAFE_FREE(recv_arg_p);
 	LOG_WRN("Retry reach max!");
 	return 0;
 }
 
-static uint8_t pldm_msg_timeout_check(sys_slist_t *list, struct k_mutex *mutex)
-{
-	CHECK_NULL_ARG_WITH_RETURN(list, MCTP_ERROR);
-	CHECK_NULL_ARG_WITH_RETURN(mutex, MCTP_ERROR);
-
-	if (k_mutex_lock(mutex, K_MSEC(PLDM_RESP_MSG_PROC_MUTEX_TIMEOUT_MS))) {
-		LOG_WRN("pldm mutex is locked over %d ms!!", PLDM_RESP_MSG_PROC_MUTEX_TIMEOUT_MS);
-		return MCTP_ERROR;
-	}
-
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	int64_t cur_uptime = k_uptime_get();
-
-	SYS_SLIST_FOR_EACH_NODE_SAFE (list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-
-		if ((p->exp_to_ms <= cur_uptime)) {
-			printk("pldm msg timeout!!\n");
-			printk("cmd %x, inst_id %x\n", p->msg.hdr.cmd, p->msg.hdr.inst_id);
-			sys_slist_remove(list, pre_node, node);
-
-			if (unregister_instid(p->mctp_inst, p->msg.hdr.inst_id) == false) {
-				LOG_ERR("Unregister failed!");
-				return PLDM_ERROR;
-			}
-
-			if (p->msg.timeout_cb_fn)
-				p->msg.timeout_cb_fn(p->msg.timeout_cb_fn_args);
-
-			free(p);
-		} else {
-			pre_node = node;
-		}
-	}
-
-	k_mutex_unlock(mutex);
-	return MCTP_SUCCESS;
-}
-
-static void pldm_msg_timeout_monitor(void *dummy0, void *dummy1, void *dummy2)
-{
-	ARG_UNUSED(dummy0);
-	ARG_UNUSED(dummy1);
-	ARG_UNUSED(dummy2);
-
-	while (1) {
-		k_msleep(PLDM_MSG_CHECK_PER_MS);
-
-		pldm_msg_timeout_check(&wait_recv_resp_list, &wait_recv_resp_mutex);
-	}
-}
-
 static uint8_t pldm_resp_msg_process(mctp *const mctp_inst, uint8_t *buf, uint32_t len,
 				     mctp_ext_params ext_params)
 {
 	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, PLDM_ERROR);
 	CHECK_NULL_ARG_WITH_RETURN(buf, PLDM_ERROR);
 
-	if (!len)
+	if (len < sizeof(pldm_hdr))
 		return PLDM_ERROR;
 
 	pldm_hdr *hdr = (pldm_hdr *)buf;
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	sys_snode_t *found_node = NULL;
 
-	if (k_mutex_lock(&wait_recv_resp_mutex, K_MSEC(PLDM_RESP_MSG_PROC_MUTEX_TIMEOUT_MS))) {
-		LOG_WRN("pldm mutex is locked over %d ms!!", PLDM_RESP_MSG_PROC_MUTEX_TIMEOUT_MS);
-		return PLDM_ERROR;
+	/* remove pldm header for handler */
+	if (!mctp_trans_complete(mctp_inst, MCTP_MSG_TYPE_PLDM, hdr->inst_id,
+				 PLDM_TRANS_MATCH(hdr->pldm_type, hdr->cmd), buf + sizeof(*hdr),
+				 len - sizeof(*hdr))) {
+		LOG_DBG("Drop unexpected response, cmd 0x%x, inst_id 0x%x", hdr->cmd,
+			hdr->inst_id);
 	}
 
-	SYS_SLIST_FOR_EACH_NODE_SAFE (&wait_recv_resp_list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-
-		/* found the proper handler */
-		if ((p->msg.hdr.inst_id == hdr->inst_id) &&
-		    (p->msg.hdr.pldm_type == hdr->pldm_type) && (p->msg.hdr.cmd == hdr->cmd) &&
-		    (p->mctp_inst == mctp_inst)) {
-			found_node = node;
-			sys_slist_remove(&wait_recv_resp_list, pre_node, node);
-
-			if (unregister_instid(mctp_inst, p->msg.hdr.inst_id) == false) {
-				LOG_ERR("Unregister failed!");
-				k_mutex_unlock(&wait_recv_resp_mutex);
-				return PLDM_ERROR;
-			}
+	return PLDM_SUCCESS;
+}
+
+pldm_cmd_proc_fn pldm_get_cmd_handler(uint8_t pldm_type, uint8_t cmd)
+{
+	void *handler = NULL;
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(query_tbl); i++) {
+		if (pldm_type == query_tbl[i].type) {
+			if (query_tbl[i].handler_query(cmd, &handler) == PLDM_ERROR)
+				return NULL;
 			break;
-		} else {
-			pre_node = node;
 		}
 	}
-	k_mutex_unlock(&wait_recv_resp_mutex);
-
-	if (found_node) {
-		/* invoke resp handler */
-		wait_msg *p = (wait_msg *)found_node;
-		if (p->msg.recv_resp_cb_fn)
-			/* remove pldm header for handler */
-			p->msg.recv_resp_cb_fn(p->msg.recv_resp_cb_args, buf + sizeof(p->msg.hdr),
-					       len - sizeof(p->msg.hdr));
-		free(p);
-	}
 
-	return PLDM_SUCCESS;
+	return (pldm_cmd_proc_fn)handler;
 }
 
 uint8_t mctp_pldm_cmd_handler(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext_params ext_params)
@@ -347,6 +143,8 @@ uint8_t mctp_pldm_cmd_handler(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext
 	if (!hdr->rq)
 		return pldm_resp_msg_process(mctp_inst, buf, len, ext_params);
 
+	uint32_t start_cycle = k_cycle_get_32();
+
 	/* the message is a request, find the proper handler to handle it */
 
 	/* initial response data */
@@ -364,40 +162,26 @@ uint8_t mctp_pldm_cmd_handler(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext
 	/* default one byte response data - completion code */
 	uint8_t *comp = resp_buf + sizeof(*hdr);
 
-	void *handler = NULL;
-	uint8_t (*handler_query)(uint8_t, void **) = NULL;
-
-	uint8_t i;
-	for (i = 0; i < ARRAY_SIZE(query_tbl); i++) {
-		if (hdr->pldm_type == query_tbl[i].type) {
-			handler_query = query_tbl[i].handler_query;
-			break;
-		}
-	}
-
-	if (!handler_query) {
-		*comp = PLDM_ERROR_UNSUPPORTED_PLDM_CMD;
-		goto send_msg;
-	}
-
 	uint8_t rc = PLDM_ERROR;
 	/* found the proper cmd handler in the pldm_type_cmd table */
-	rc = handler_query(hdr->cmd, &handler);
-	if (rc == PLDM_ERROR || !handler) {
+	pldm_cmd_proc_fn handler = pldm_get_cmd_handler(hdr->pldm_type, hdr->cmd);
+	if (!handler) {
 		*comp = PLDM_ERROR_UNSUPPORTED_PLDM_CMD;
 		goto send_msg;
 	}
 
-	rc = ((pldm_cmd_proc_fn)handler)(mctp_inst, buf + sizeof(*hdr), len - sizeof(*hdr),
-					 (hdr->req_d_id) & 0x1F, resp_buf + sizeof(*hdr), &resp_len,
-					 &ext_params);
+	rc = handler(mctp_inst, buf + sizeof(*hdr), len - sizeof(*hdr), (hdr->req_d_id) & 0x1F,
+		     resp_buf + sizeof(*hdr), &resp_len, &ext_params);
 	if (rc == PLDM_LATER_RESP)
 		return PLDM_SUCCESS;
 
 send_msg:
 	/* send the pldm response data */
 	resp_len = sizeof(*hdr) + resp_len;
-	return mctp_send_msg(mctp_inst, resp_buf, resp_len, ext_params);
+	rc = mctp_send_msg(mctp_inst, resp_buf, resp_len, ext_params);
+	latency_hist_record_since(LATENCY_HIST_PLDM_CMD, PLDM_TRANS_MATCH(hdr->pldm_type, hdr->cmd),
+				  start_cycle);
+	return rc;
 }
 
 uint8_t mctp_pldm_send_msg(void *mctp_p, pldm_msg *msg)
@@ -406,21 +190,30 @@ uint8_t mctp_pldm_send_msg(void *mctp_p, pldm_msg *msg)
 	CHECK_NULL_ARG_WITH_RETURN(msg, PLDM_ERROR);
 
 	mctp *mctp_inst = (mctp *)mctp_p;
-	uint8_t get_inst_id = 0xff;
-	wait_msg *p = NULL;
+	uint8_t trans_id = 0;
 
 	/*
 	* The request should be set inst_id/msg_type/mctp_tag_owner in the
 	* header
 	*/
 	if (msg->hdr.rq) {
-		if (register_instid(mctp_p, &get_inst_id) == false) {
+		mctp_trans_cb cb = {
+			.resp_fn = msg->recv_resp_cb_fn,
+			.resp_args = msg->recv_resp_cb_args,
+			.timeout_fn = msg->timeout_cb_fn,
+			.timeout_args = msg->timeout_cb_fn_args,
+			.timeout_ms = msg->timeout_ms ? msg->timeout_ms : PLDM_MSG_TIMEOUT_MS,
+		};
+
+		if (!mctp_trans_begin(mctp_inst, MCTP_MSG_TYPE_PLDM,
+				      PLDM_TRANS_MATCH(msg->hdr.pldm_type, msg->hdr.cmd), &cb,
+				      &trans_id)) {
 			LOG_ERR("Register failed!");
 			return PLDM_ERROR;
 		}
 
 		/* set pldm header */
-		msg->hdr.inst_id = get_inst_id;
+		msg->hdr.inst_id = trans_id;
 		msg->hdr.msg_type = MCTP_MSG_TYPE_PLDM;
 
 		/* set mctp extra parameters */
@@ -430,51 +223,23 @@ uint8_t mctp_pldm_send_msg(void *mctp_p, pldm_msg *msg)
 	uint16_t len = sizeof(msg->hdr) + msg->len;
 	uint8_t buf[len];
 
-	LOG_HEXDUMP_DBG(buf, len, __func__);
-
 	memcpy(buf, &msg->hdr, sizeof(msg->hdr));
 	memcpy(buf + sizeof(msg->hdr), msg->buf, msg->len);
 
-	if (msg->hdr.rq) {
-		p = (wait_msg *)malloc(sizeof(*p));
-		if (!p) {
-			LOG_WRN("wait_msg alloc failed!");
-			goto error;
-		}
-
-		memset(p, 0, sizeof(*p));
-		p->mctp_inst = mctp_inst;
-		p->msg = *msg;
-		p->exp_to_ms =
-			k_uptime_get() + (msg->timeout_ms ? msg->timeout_ms : PLDM_MSG_TIMEOUT_MS);
-
-		k_mutex_lock(&wait_recv_resp_mutex, K_FOREVER);
-		sys_slist_append(&wait_recv_resp_list, &p->node);
-		k_mutex_unlock(&wait_recv_resp_mutex);
-	}
+	LOG_HEXDUMP_DBG(buf, len, __func__);
 
 	uint8_t rc = mctp_send_msg(mctp_inst, buf, len, msg->ext_params);
 	if (rc == MCTP_ERROR) {
 		LOG_ERR("mctp_send_msg error!!");
 
-		if (p != NULL) {
-			sys_slist_find_and_remove(&wait_recv_resp_list, &p->node);
-			SAFE_FREE(p);
+		if (msg->hdr.rq) {
+			mctp_trans_abort(trans_id);
 		}
 
-		goto error;
+		return PLDM_ERROR;
 	}
 
 	return PLDM_SUCCESS;
-
-error:
-	if (msg->hdr.rq) {
-		if (unregister_instid(mctp_p, get_inst_id) == false) {
-			LOG_ERR("Unregister failed!");
-		}
-	}
-
-	return PLDM_ERROR;
 }
 
 /**
@@ -595,58 +360,51 @@ int pldm_send_ipmi_response(uint8_t interface, ipmi_msg *msg)
 	return 0;
 }
 
-// Send IPMI request to MCTP/PLDM thread and get response
-int pldm_send_ipmi_request(ipmi_msg *msg)
+static void *pldm_ipmi_request_build(ipmi_msg *msg, pldm_msg *pmsg, uint8_t *req_buf)
 {
-	CHECK_NULL_ARG_WITH_RETURN(msg, -1);
-
-	pldm_msg pmsg = { 0 };
-	uint8_t req_buf[PLDM_MAX_DATA_SIZE] = { 0 };
-	memset(&pmsg, 0, sizeof(pmsg));
-	memset(req_buf, 0, sizeof(req_buf));
-
 	uint8_t target_interface = msg->InF_target;
 	int medium_type = pal_get_medium_type(target_interface);
 	if (medium_type < 0) {
-		return -1;
+		return NULL;
 	}
 	int target = pal_get_target(target_interface);
 	if (target < 0) {
-		return -1;
+		return NULL;
 	}
 
 	// Set PLDM header
-	pmsg.ext_params.type = medium_type;
-	pmsg.ext_params.i3c_ext_params.addr = target;
+	pmsg->ext_params.type = medium_type;
+	pmsg->ext_params.i3c_ext_params.addr = target;
 
-	pmsg.hdr.msg_type = MCTP_MSG_TYPE_PLDM;
-	pmsg.hdr.pldm_type = PLDM_TYPE_OEM;
-	pmsg.hdr.cmd = PLDM_OEM_IPMI_BRIDGE;
-	pmsg.hdr.rq = PLDM_REQUEST;
+	pmsg->hdr.msg_type = MCTP_MSG_TYPE_PLDM;
+	pmsg->hdr.pldm_type = PLDM_TYPE_OEM;
+	pmsg->hdr.cmd = PLDM_OEM_IPMI_BRIDGE;
+	pmsg->hdr.rq = PLDM_REQUEST;
 
-	pmsg.buf = req_buf;
+	pmsg->buf = req_buf;
 
-	struct _ipmi_cmd_req *cmd_req = (struct _ipmi_cmd_req *)pmsg.buf;
+	struct _ipmi_cmd_req *cmd_req = (struct _ipmi_cmd_req *)pmsg->buf;
 	set_iana(cmd_req->iana, sizeof(cmd_req->iana));
 	cmd_req->netfn_lun = msg->netfn << 2;
 	cmd_req->cmd = msg->cmd;
 	memcpy(&cmd_req->first_data, msg->data, msg->data_len);
 
 	// Total data len = IANA + ipmi netfn + ipmi cmd + ipmi request data len
-	pmsg.len = sizeof(struct _ipmi_cmd_req) - 1 + msg->data_len;
+	pmsg->len = sizeof(struct _ipmi_cmd_req) - 1 + msg->data_len;
 
-	uint8_t rbuf[PLDM_MAX_DATA_SIZE];
-	// Send request to PLDM/MCTP thread and get response
-	uint8_t res_len =
-		mctp_pldm_read(pal_get_mctp(medium_type, target), &pmsg, rbuf, sizeof(rbuf));
-
-	if (!res_len) {
-		LOG_ERR("mctp_pldm_read fail");
-		return false;
-	}
+	return pal_get_mctp(medium_type, target);
+}
 
+static void pldm_ipmi_response_parse(ipmi_msg *msg, uint8_t *rbuf, uint16_t res_len)
+{
 	struct _pldm_ipmi_cmd_resp *resp = (struct _pldm_ipmi_cmd_resp *)rbuf;
 
+	if (res_len < 4) {
+		msg->completion_code = CC_UNSPECIFIED_ERROR;
+		msg->data_len = 0;
+		return;
+	}
+
 	if ((resp->completion_code != MCTP_SUCCESS)) {
 		resp->ipmi_comp_code = CC_UNSPECIFIED_ERROR;
 	}
@@ -656,13 +414,86 @@ int pldm_send_ipmi_request(ipmi_msg *msg)
 	msg->cmd = resp->cmd;
 	// MCTP CC, Netfn, cmd, ipmi CC
 	if (res_len > 4) {
-		msg->data_len = res_len - 4;
+		msg->data_len = MIN(res_len - 4, sizeof(msg->data));
 		memcpy(msg->data, &rbuf[4], msg->data_len);
 	} else {
 		msg->data_len = 0;
 	}
+}
+
+// Send IPMI request to MCTP/PLDM thread and get response
+int pldm_send_ipmi_request(ipmi_msg *msg)
+{
+	CHECK_NULL_ARG_WITH_RETURN(msg, -1);
+
+	pldm_msg pmsg = { 0 };
+	uint8_t req_buf[PLDM_MAX_DATA_SIZE] = { 0 };
 
+	void *mctp_inst = pldm_ipmi_request_build(msg, &pmsg, req_buf);
+	if (mctp_inst == NULL) {
+		return -1;
+	}
+
+	uint8_t rbuf[PLDM_MAX_DATA_SIZE];
+	// Send request to PLDM/MCTP thread and get response
+	uint8_t res_len = mctp_pldm_read(mctp_inst, &pmsg, rbuf, sizeof(rbuf));
+
+	if (!res_len) {
+		LOG_ERR("mctp_pldm_read fail");
+		return false;
+	}
+
+	pldm_ipmi_response_parse(msg, rbuf, res_len);
 	return 0;
 }
 
-K_THREAD_DEFINE(pldm_wait_resp_to, 1024, pldm_msg_timeout_monitor, NULL, NULL, NULL, 7, 0, 0);
+static void pldm_ipmi_async_resp_handler(void *args, uint8_t *rbuf, uint16_t rlen)
+{
+	pldm_ipmi_async_req *req = (pldm_ipmi_async_req *)args;
+
+	pldm_ipmi_response_parse(&req->msg, rbuf, rlen);
+	req->resp_fn(req);
+}
+
+static void pldm_ipmi_async_timeout_handler(void *args)
+{
+	pldm_ipmi_async_req *req = (pldm_ipmi_async_req *)args;
+
+	req->msg.completion_code = CC_TIMEOUT;
+	req->msg.data_len = 0;
+	req->resp_fn(req);
+}
+
+/* Send IPMI request to MCTP/PLDM thread without waiting for the response.
+ *
+ * req is owned by the caller and must stay valid until req->resp_fn is called, which happens
+ * exactly once: from the MCTP receive thread for a response, or from the system workqueue when
+ * the mctp_trans slot timer of the request expires. On timeout the completion code is
+ * CC_TIMEOUT. Nothing is called back if this function fails.
+ */
+int pldm_send_ipmi_request_async(pldm_ipmi_async_req *req)
+{
+	CHECK_NULL_ARG_WITH_RETURN(req, -1);
+	CHECK_NULL_ARG_WITH_RETURN(req->resp_fn, -1);
+
+	pldm_msg pmsg = { 0 };
+	uint8_t req_buf[PLDM_MAX_DATA_SIZE] = { 0 };
+
+	void *mctp_inst = pldm_ipmi_request_build(&req->msg, &pmsg, req_buf);
+	if (mctp_inst == NULL) {
+		return -1;
+	}
+
+	pmsg.recv_resp_cb_fn = pldm_ipmi_async_resp_handler;
+	pmsg.recv_resp_cb_args = (void *)req;
+	pmsg.timeout_cb_fn = pldm_ipmi_async_timeout_handler;
+	pmsg.timeout_cb_fn_args = (void *)req;
+	pmsg.timeout_ms = PLDM_MSG_TIMEOUT_MS;
+
+	if (mctp_pldm_send_msg(mctp_inst, &pmsg) == PLDM_ERROR) {
+		LOG_ERR("Failed to send IPMI request over PLDM");
+		return -1;
+	}
+
+	return 0;
+}
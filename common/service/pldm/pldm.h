@@ -126,6 +126,15 @@ struct _pldm_ipmi_cmd_resp {
 	uint8_t first_data;
 } __attribute__((packed));
 
+/* IPMI request bridged over PLDM, the response is written back to msg */
+typedef struct _pldm_ipmi_async_req {
+	ipmi_msg msg;
+	void (*resp_fn)(struct _pldm_ipmi_async_req *req);
+} pldm_ipmi_async_req;
+
+/* the handler of a pldm command BIC serves, NULL if not supported */
+pldm_cmd_proc_fn pldm_get_cmd_handler(uint8_t pldm_type, uint8_t cmd);
+
 /* the pldm command handler */
 uint8_t mctp_pldm_cmd_handler(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext_params ext_params);
 
@@ -133,6 +142,7 @@ uint8_t mctp_pldm_cmd_handler(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext
 uint8_t mctp_pldm_send_msg(void *mctp_p, pldm_msg *msg);
 int pldm_send_ipmi_response(uint8_t interface, ipmi_msg *msg);
 int pldm_send_ipmi_request(ipmi_msg *msg);
+int pldm_send_ipmi_request_async(pldm_ipmi_async_req *req);
 
 uint16_t mctp_pldm_read(void *mctp_p, pldm_msg *msg, uint8_t *rbuf, uint16_t rbuf_len);
 
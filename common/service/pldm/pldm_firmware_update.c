@@ -20,7 +20,9 @@
 #include <logging/log.h>
 #include "util_spi.h"
 #include "util_sys.h"
+#include "util_mem.h"
 #include "libutil.h"
+#include "i2c_scheduler.h"
 #include "pldm_firmware_update.h"
 #include "xdpe12284c.h"
 #include "isl69259.h"
@@ -122,7 +124,7 @@ uint8_t pldm_vr_update(void *fw_update_param)
 			LOG_ERR("previous hex_buff doesn't clean up!");
 			goto exit;
 		}
-		hex_buff = malloc(fw_update_cfg.image_size);
+		hex_buff = util_mem_alloc_large(MEM_TAG_FW_UPDATE, fw_update_cfg.image_size);
 		if (!hex_buff) {
 			LOG_ERR("Failed to malloc hex_buff");
 			return 1;
@@ -168,7 +170,7 @@ uint8_t pldm_vr_update(void *fw_update_param)
 
 	ret = 0;
 exit:
-	SAFE_FREE(hex_buff);
+	SAFE_MEM_FREE(hex_buff);
 	return ret;
 }
 
@@ -412,25 +414,27 @@ void req_fw_update_handler(void *mctp_p, void *ext_params, void *arg)
 	if (!mctp_p || !ext_params) {
 		LOG_ERR("Pass argument is NULL");
 		pldm_status_reset();
-		SAFE_FREE(ext_params);
+		SAFE_MEM_FREE(ext_params);
 		return;
 	}
 
 	LOG_INF("Component %d start update process...", cur_update_comp_id);
+	/* The thread only runs the update, keep its transfers behind IPMB and sensor polling */
+	i2c_sched_set_thread_prio(I2C_SCHED_PRIO_BULK);
 
 	pldm_fw_update_info_t *fw_info = find_update_info(cur_update_comp_id);
 
 	if (!fw_info) {
 		LOG_ERR("Can't find component id(%d) info", cur_update_comp_id);
 		pldm_status_reset();
-		SAFE_FREE(ext_params);
+		SAFE_MEM_FREE(ext_params);
 		return;
 	} else {
 		if (!fw_info->update_func) {
 			LOG_ERR("The update function of component id(%d) is NULL",
 				cur_update_comp_id);
 			pldm_status_reset();
-			SAFE_FREE(ext_params);
+			SAFE_MEM_FREE(ext_params);
 			return;
 		}
 	}
@@ -590,7 +594,7 @@ exit:
 	if (fw_update_tid) {
 		fw_update_tid = NULL;
 	}
-	SAFE_FREE(ext_params);
+	SAFE_MEM_FREE(ext_params);
 	return;
 }
 
@@ -819,7 +823,7 @@ static uint8_t update_component(void *mctp_inst, uint8_t *buf, uint16_t len, uin
 	memcpy(cur_update_comp_str, buf + sizeof(struct pldm_update_component_req),
 	       req_p->comp_ver_str_len);
 
-	mctp_ext_params *extra_data = (mctp_ext_params *)malloc(sizeof(mctp_ext_params));
+	mctp_ext_params *extra_data = util_mem_alloc(MEM_TAG_PLDM, sizeof(mctp_ext_params));
 
 	if (!extra_data) {
 		LOG_ERR("Allocate memory failed");
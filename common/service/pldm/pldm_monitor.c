@@ -134,14 +134,14 @@ uint8_t pldm_get_sensor_reading(void *mctp_inst, uint8_t *buf, uint16_t len, uin
 		res_p->sensor_operational_state = PLDM_SENSOR_STATUSUNKOWN;
 		goto ret;
 	}
-	/* Only support one byte range of sensor number */
-	if (req_p->sensor_id > PLDM_MONITOR_SENSOR_SUPPORT_MAX) {
+	/* PLDM sensor IDs are the 16-bit sensor IDs of the sensor core */
+	if (req_p->sensor_id >= SENSOR_NUM_MAX) {
 		res_p->completion_code = PLDM_PLATFORM_INVALID_SENSOR_ID;
 		res_p->sensor_operational_state = PLDM_SENSOR_STATUSUNKOWN;
 		goto ret;
 	}
 
-	uint8_t sensor_number = (uint8_t)req_p->sensor_id;
+	uint16_t sensor_number = req_p->sensor_id;
 	uint8_t status;
 	int reading = 0;
 
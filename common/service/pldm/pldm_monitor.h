@@ -43,7 +43,6 @@ typedef enum pldm_platform_monitor_commands {
 #define PLDM_MONITOR_EVENT_DATA_SIZE_MAX 7
 /* The default maximum event message number in the queue */
 #define PLDM_MONITOR_EVENT_QUEUE_MSG_NUM_MAX_DEFAULT 10
-#define PLDM_MONITOR_SENSOR_SUPPORT_MAX 0xFF
 #define PLDM_MONITOR_SENSOR_EVENT_SENSOR_OP_STATE_DATA_LENGTH 2
 #define PLDM_MONITOR_SENSOR_EVENT_STATE_SENSOR_STATE_DATA_LENGTH 3
 #define PLDM_MONITOR_SENSOR_EVENT_NUMERIC_SENSOR_STATE_MIN_DATA_LENGTH 4
@@ -35,8 +35,8 @@ extern const int SDR_TABLE_SIZE;
 
 SDR_Full_sensor *full_sdr_table;
 
-uint8_t sensor_config_size = 0;
-uint8_t sdr_count = 0;
+uint16_t sensor_config_size = 0;
+uint16_t sdr_count = 0;
 
 void SDR_clear_ID(void)
 {
@@ -82,20 +82,20 @@ __weak void pal_extend_full_sdr_table(void)
 	return;
 }
 
-int get_sdr_index(uint8_t sensor_num)
+int get_sdr_index(uint16_t sensor_num)
 {
 	if (full_sdr_table == NULL) {
 		LOG_ERR("full_sdr_table is NULL");
 		return -1;
 	}
 
-	uint8_t i = 0;
+	uint16_t i = 0;
 	for (i = 0; i < sdr_count; ++i) {
-		if (sensor_num == full_sdr_table[i].sensor_num) {
+		if (sensor_num == SDR_SENSOR_ID(&full_sdr_table[i])) {
 			return i;
 		}
 	}
-	return SENSOR_NUM_MAX;
+	return SENSOR_NULL;
 }
 
 void add_full_sdr_table(SDR_Full_sensor add_item)
@@ -105,15 +105,15 @@ void add_full_sdr_table(SDR_Full_sensor add_item)
 		return;
 	}
 
-	int index = get_sdr_index(add_item.sensor_num);
+	int index = get_sdr_index(SDR_SENSOR_ID(&add_item));
 	if (index == -1) {
 		LOG_ERR("Fail to get sdr index");
 		return;
 	}
 
-	if (index != SENSOR_NUM_MAX) {
+	if (index != SENSOR_NULL) {
 		memcpy(&full_sdr_table[index], &add_item, sizeof(SDR_Full_sensor));
-		LOG_ERR("Replace the sensor[0x%02x] SDR", add_item.sensor_num);
+		LOG_ERR("Replace the sensor[0x%04x] SDR", SDR_SENSOR_ID(&add_item));
 		return;
 	}
 	// Check SDR table size before adding SDR
@@ -124,7 +124,7 @@ void add_full_sdr_table(SDR_Full_sensor add_item)
 	}
 }
 
-void change_sensor_threshold(uint8_t sensor_num, uint8_t threshold_type, uint8_t change_value)
+void change_sensor_threshold(uint16_t sensor_num, uint8_t threshold_type, uint8_t change_value)
 {
 	if (full_sdr_table == NULL) {
 		LOG_ERR("full_sdr_table is NULL");
@@ -132,8 +132,8 @@ void change_sensor_threshold(uint8_t sensor_num, uint8_t threshold_type, uint8_t
 	}
 
 	int sdr_index = get_sdr_index(sensor_num);
-	if ((sdr_index == SENSOR_NUM_MAX) || (sdr_index == -1)) {
-		LOG_ERR("Failed to find sensor index, sensor number(0x%02x), sdr index(%d)",
+	if ((sdr_index == SENSOR_NULL) || (sdr_index == -1)) {
+		LOG_ERR("Failed to find sensor index, sensor number(0x%04x), sdr index(%d)",
 			sensor_num, sdr_index);
 		return;
 	}
@@ -162,7 +162,7 @@ void change_sensor_threshold(uint8_t sensor_num, uint8_t threshold_type, uint8_t
 	}
 }
 
-void change_sensor_mbr(uint8_t sensor_num, uint8_t mbr_type, uint16_t change_value)
+void change_sensor_mbr(uint16_t sensor_num, uint8_t mbr_type, uint16_t change_value)
 {
 	if (full_sdr_table == NULL) {
 		LOG_ERR("full_sdr_table is NULL");
@@ -170,8 +170,8 @@ void change_sensor_mbr(uint8_t sensor_num, uint8_t mbr_type, uint16_t change_val
 	}
 
 	int sdr_index = get_sdr_index(sensor_num);
-	if ((sdr_index == SENSOR_NUM_MAX) || (sdr_index == -1)) {
-		LOG_ERR("Failed to find sensor index, sensor number(0x%02x), sdr index(%d)",
+	if ((sdr_index == SENSOR_NULL) || (sdr_index == -1)) {
+		LOG_ERR("Failed to find sensor index, sensor number(0x%04x), sdr index(%d)",
 			sensor_num, sdr_index);
 		return;
 	}
@@ -236,7 +236,7 @@ uint8_t sdr_init(void)
 	return true;
 }
 
-uint8_t plat_get_sdr_size()
+uint16_t plat_get_sdr_size()
 {
 	return SDR_TABLE_SIZE;
 }
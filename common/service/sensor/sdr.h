@@ -447,12 +447,20 @@ enum {
 	MBR_R,
 };
 
-extern uint8_t sdr_count;
+/* A 16-bit sensor ID maps onto IPMI as the sensor number in the low byte and the sensor owner
+ * LUN above it, so IDs below 0x100 keep their 8-bit number on LUN 0
+ */
+#define SENSOR_ID_IPMI(lun, num) ((((lun)&0x03) << 8) | ((num)&0xFF))
+#define SENSOR_ID_TO_IPMI_NUM(id) ((id)&0xFF)
+#define SENSOR_ID_TO_IPMI_LUN(id) (((id) >> 8) & 0x03)
+#define SDR_SENSOR_ID(sdr) SENSOR_ID_IPMI((sdr)->owner_lun, (sdr)->sensor_num)
+
+extern uint16_t sdr_count;
 extern bool is_sdr_not_init;
 // Mapping sensor number to sdr config index
-extern uint8_t sdr_index_map[];
+extern uint16_t sdr_index_map[];
 extern SDR_Full_sensor *full_sdr_table;
-extern uint8_t sensor_config_size;
+extern uint16_t sensor_config_size;
 extern const int negative_ten_power[16];
 #define SDR_M(sensor_num)                                                                          \
 	(((full_sdr_table[sdr_index_map[sensor_num]].M_tolerance & 0xC0) << 2) |                   \
@@ -460,7 +468,7 @@ extern const int negative_ten_power[16];
 #define SDR_R(sensor_num) ((full_sdr_table[sdr_index_map[sensor_num]].RexpBexp >> 4) & 0x0F)
 #define SDR_Rexp(sensor_num) negative_ten_power[SDR_R(sensor_num)]
 
-static inline uint8_t round_add(uint8_t sensor_num, int val)
+static inline uint8_t round_add(uint16_t sensor_num, int val)
 {
 	return (SDR_R(sensor_num) > 0) ?
 		       (((negative_ten_power[((SDR_R(sensor_num) + 1) & 0xF)] * val) % 10) > 5 ?
@@ -475,11 +483,11 @@ uint16_t SDR_get_RSV_ID(uint8_t rsv_table_index);
 bool SDR_RSV_ID_check(uint16_t ID, uint8_t rsv_table_index);
 uint8_t sdr_init(void);
 void pal_fix_full_sdr_table(void);
-bool check_sdr_num_exist(uint8_t sensor_num);
+bool check_sdr_num_exist(uint16_t sensor_num);
 void add_full_sdr_table(SDR_Full_sensor add_item);
-void change_sensor_threshold(uint8_t sensor_num, uint8_t threshold_type, uint8_t change_value);
-void change_sensor_mbr(uint8_t sensor_num, uint8_t mbr_type, uint16_t change_value);
-uint8_t plat_get_sdr_size();
+void change_sensor_threshold(uint16_t sensor_num, uint8_t threshold_type, uint8_t change_value);
+void change_sensor_mbr(uint16_t sensor_num, uint8_t mbr_type, uint16_t change_value);
+uint16_t plat_get_sdr_size();
 void load_sdr_table(void);
 
 #endif
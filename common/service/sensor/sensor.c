@@ -23,6 +23,8 @@
 #include "power_status.h"
 #include "sdr.h"
 #include "hal_i2c.h"
+#include "i2c_health.h"
+#include "latency_hist.h"
 #include "plat_sensor_table.h"
 #include "plat_sdr_table.h"
 #ifdef CONFIG_ADC_ASPEED
@@ -55,20 +57,21 @@ extern const int SENSOR_CONFIG_SIZE;
 struct k_thread sensor_poll;
 K_KERNEL_STACK_MEMBER(sensor_poll_stack, SENSOR_POLL_STACK_SIZE);
 
-uint8_t sensor_config_index_map[SENSOR_NUM_MAX];
-uint8_t sdr_index_map[SENSOR_NUM_MAX];
+uint16_t sensor_config_index_map[SENSOR_NUM_MAX];
+uint16_t sdr_index_map[SENSOR_NUM_MAX];
 
 bool enable_sensor_poll_thread = true;
 static bool sensor_poll_enable_flag = true;
 static bool is_sensor_initial_done = false;
 static bool is_sensor_ready_flag = false;
+static sensor_poll_stat poll_stat;
 
 const int negative_ten_power[16] = { 1,	    1,		1,	   1,	     1,	      1,
 				     1,	    1000000000, 100000000, 10000000, 1000000, 100000,
 				     10000, 1000,	100,	   10 };
 
 sensor_cfg *sensor_config = NULL;
-uint8_t sensor_config_count = 0;
+uint16_t sensor_config_count = 0;
 
 sensor_monitor_table_info *sensor_monitor_table;
 uint16_t sensor_monitor_count = 0;
@@ -250,46 +253,38 @@ struct sensor_drive_api {
 static void init_sensor_num(void)
 {
 	for (int i = 0; i < SENSOR_NUM_MAX; i++) {
-		sdr_index_map[i] = 0xFF;
-		sensor_config_index_map[i] = 0xFF;
+		sdr_index_map[i] = SENSOR_NULL;
+		sensor_config_index_map[i] = SENSOR_NULL;
 	}
 }
 
 void map_sensor_num_to_sdr_cfg(void)
 {
-	uint8_t i, j;
-
-	for (i = 0; i < SENSOR_NUM_MAX; i++) {
-		for (j = 0; j < sdr_count; j++) {
-			if (i == full_sdr_table[j].sensor_num) {
-				sdr_index_map[i] = j;
-				break;
-			} else if (i == sdr_count) {
-				sdr_index_map[i] = SENSOR_NULL;
-			} else {
-				continue;
-			}
+	/* Walk the tables once instead of searching them for every possible ID, the first entry of
+	 * a duplicated ID wins as before
+	 */
+	for (uint16_t i = 0; i < sdr_count; i++) {
+		uint16_t sensor_num = SDR_SENSOR_ID(&full_sdr_table[i]);
+		if ((sensor_num < SENSOR_NUM_MAX) && (sdr_index_map[sensor_num] == SENSOR_NULL)) {
+			sdr_index_map[sensor_num] = i;
 		}
-		for (j = 0; j < sdr_count; j++) {
-			if (i == sensor_config[j].num) {
-				sensor_config_index_map[i] = j;
-				break;
-			} else if (i == sdr_count) {
-				sensor_config_index_map[i] = SENSOR_NULL;
-			} else {
-				continue;
-			}
+	}
+
+	for (uint16_t i = 0; i < sensor_config_count; i++) {
+		uint16_t sensor_num = sensor_config[i].num;
+		if ((sensor_num < SENSOR_NUM_MAX) &&
+		    (sensor_config_index_map[sensor_num] == SENSOR_NULL)) {
+			sensor_config_index_map[sensor_num] = i;
 		}
 	}
-	return;
 }
 
-sensor_cfg *find_sensor_cfg_via_sensor_num(sensor_cfg *cfg_table, uint8_t cfg_count,
-					   uint8_t sensor_num)
+sensor_cfg *find_sensor_cfg_via_sensor_num(sensor_cfg *cfg_table, uint16_t cfg_count,
+					   uint16_t sensor_num)
 {
 	CHECK_NULL_ARG_WITH_RETURN(cfg_table, false);
 
-	uint8_t index = 0;
+	uint16_t index = 0;
 
 	for (index = 0; index < cfg_count; ++index) {
 		if (cfg_table[index].num == sensor_num) {
@@ -300,9 +295,9 @@ sensor_cfg *find_sensor_cfg_via_sensor_num(sensor_cfg *cfg_table, uint8_t cfg_co
 	return NULL;
 }
 
-bool access_check(uint8_t sensor_num)
+bool access_check(uint16_t sensor_num)
 {
-	bool (*access_checker)(uint8_t);
+	bool (*access_checker)(uint16_t);
 
 	access_checker = sensor_config[sensor_config_index_map[sensor_num]].access_checker;
 	return (access_checker)(sensor_config[sensor_config_index_map[sensor_num]].num);
@@ -316,9 +311,11 @@ void clear_unaccessible_sensor_cache(sensor_cfg *cfg)
 		cfg->cache = SENSOR_FAIL;
 		cfg->cache_status = SENSOR_INIT_STATUS;
 	}
+	/* Time without access is not staleness */
+	cfg->update_time_ms = 0;
 }
 
-uint8_t get_sensor_reading(sensor_cfg *cfg_table, uint8_t cfg_count, uint8_t sensor_num,
+uint8_t get_sensor_reading(sensor_cfg *cfg_table, uint16_t cfg_count, uint16_t sensor_num,
 			   int *reading, uint8_t read_mode)
 {
 	CHECK_NULL_ARG_WITH_RETURN(cfg_table, SENSOR_UNSPECIFIED_ERROR);
@@ -337,6 +334,7 @@ uint8_t get_sensor_reading(sensor_cfg *cfg_table, uint8_t cfg_count, uint8_t sen
 	*reading = 0; // Initial return reading value
 	uint8_t current_status = SENSOR_UNSPECIFIED_ERROR;
 	bool post_ret = false;
+	uint32_t start_cycle;
 
 	if (cfg->cache_status == SENSOR_NOT_PRESENT) {
 		return cfg->cache_status;
@@ -350,6 +348,7 @@ uint8_t get_sensor_reading(sensor_cfg *cfg_table, uint8_t cfg_count, uint8_t sen
 
 	switch (read_mode) {
 	case GET_FROM_SENSOR:
+		start_cycle = k_cycle_get_32();
 		if (cfg->pre_sensor_read_hook) {
 			if (cfg->pre_sensor_read_hook(cfg, cfg->pre_sensor_read_args) == false) {
 				LOG_ERR("Failed to do pre sensor read function, sensor number: 0x%x",
@@ -365,6 +364,7 @@ uint8_t get_sensor_reading(sensor_cfg *cfg_table, uint8_t cfg_count, uint8_t sen
 
 		if (cfg->read) {
 			current_status = cfg->read(cfg, reading);
+			latency_hist_record_since(LATENCY_HIST_SENSOR, cfg->type, start_cycle);
 		}
 
 		if (current_status == SENSOR_READ_SUCCESS ||
@@ -390,6 +390,15 @@ uint8_t get_sensor_reading(sensor_cfg *cfg_table, uint8_t cfg_count, uint8_t sen
 			}
 			memcpy(&cfg->cache, reading, sizeof(*reading));
 			cfg->cache_status = SENSOR_READ_4BYTE_ACUR_SUCCESS;
+
+			int64_t now = k_uptime_get();
+			if (cfg->update_time_ms != 0) {
+				uint32_t gap_ms = now - cfg->update_time_ms;
+				if (gap_ms > poll_stat.max_update_gap_ms) {
+					poll_stat.max_update_gap_ms = gap_ms;
+				}
+			}
+			cfg->update_time_ms = now;
 			return cfg->cache_status;
 		} else {
 			/* Return current status if retry reach max retry count, otherwise return cache status instead of current status */
@@ -463,11 +472,23 @@ bool get_sensor_poll_enable_flag()
 	return sensor_poll_enable_flag;
 }
 
+void get_sensor_poll_stat(sensor_poll_stat *stat)
+{
+	CHECK_NULL_ARG(stat);
+
+	memcpy(stat, &poll_stat, sizeof(sensor_poll_stat));
+}
+
+void clear_sensor_poll_stat()
+{
+	memset(&poll_stat, 0, sizeof(sensor_poll_stat));
+}
+
 void sensor_poll_handler(void *arug0, void *arug1, void *arug2)
 {
 	uint16_t table_index = 0;
-	uint8_t sensor_index = 0;
-	uint8_t sensor_num = 0;
+	uint16_t sensor_index = 0;
+	uint16_t sensor_num = 0;
 	int sensor_poll_interval_ms = 0;
 	int reading = 0;
 	bool ret = false;
@@ -477,6 +498,10 @@ void sensor_poll_handler(void *arug0, void *arug1, void *arug2)
 	pal_set_sensor_poll_interval(&sensor_poll_interval_ms);
 
 	while (1) {
+		uint32_t sweep_start_cycle = k_cycle_get_32();
+		uint32_t sweep_start_i2c_count = i2c_health_get_attempt_count();
+		uint16_t read_count = 0;
+
 		for (table_index = 0; table_index < sensor_monitor_count; ++table_index) {
 			sensor_monitor_table_info *table_info = &sensor_monitor_table[table_index];
 
@@ -494,7 +519,8 @@ void sensor_poll_handler(void *arug0, void *arug1, void *arug2)
 				continue;
 			}
 
-			uint8_t sensor_count = table_info->cfg_count;
+			uint16_t sensor_count = table_info->cfg_count;
+			bool is_table_entered = false;
 			for (sensor_index = 0; sensor_index < sensor_count; ++sensor_index) {
 				if (sensor_poll_enable_flag ==
 				    false) { /* skip if disable sensor poll */
@@ -521,6 +547,19 @@ void sensor_poll_handler(void *arug0, void *arug1, void *arug2)
 					}
 				}
 
+				// Enter the table only once a sensor in it is due
+				if ((is_table_entered == false) &&
+				    (table_info->enter_monitor_table != NULL)) {
+					ret = table_info->enter_monitor_table(
+						table_info->pre_post_monitor_arg);
+					if (ret != true) {
+						LOG_ERR("Enter monitor table fail, table index: 0x%x",
+							table_index);
+						break;
+					}
+					is_table_entered = true;
+				}
+
 				if (table_info->pre_monitor != NULL) {
 					ret = table_info->pre_monitor(
 						sensor_num, table_info->pre_post_monitor_arg);
@@ -533,6 +572,7 @@ void sensor_poll_handler(void *arug0, void *arug1, void *arug2)
 
 				get_sensor_reading(cfg_table, sensor_count, sensor_num, &reading,
 						   GET_FROM_SENSOR);
+				read_count++;
 
 				if (table_info->post_monitor != NULL) {
 					ret = table_info->post_monitor(
@@ -545,15 +585,30 @@ void sensor_poll_handler(void *arug0, void *arug1, void *arug2)
 				}
 			}
 
+			if (is_table_entered && (table_info->leave_monitor_table != NULL)) {
+				ret = table_info->leave_monitor_table(
+					table_info->pre_post_monitor_arg);
+				if (ret != true) {
+					LOG_ERR("Leave monitor table fail, table index: 0x%x",
+						table_index);
+				}
+			}
+
 			k_yield();
 		}
 
+		poll_stat.sweep_count++;
+		poll_stat.last_sweep_us = k_cyc_to_us_floor32(k_cycle_get_32() - sweep_start_cycle);
+		poll_stat.max_sweep_us = MAX(poll_stat.max_sweep_us, poll_stat.last_sweep_us);
+		poll_stat.last_read_count = read_count;
+		poll_stat.last_i2c_count = i2c_health_get_attempt_count() - sweep_start_i2c_count;
+
 		is_sensor_ready_flag = true;
 		k_msleep(sensor_poll_interval_ms);
 	}
 }
 
-__weak bool pal_is_time_to_poll(uint8_t sensor_num, int poll_time)
+__weak bool pal_is_time_to_poll(uint16_t sensor_num, int poll_time)
 {
 	return true;
 }
@@ -569,12 +624,12 @@ __weak void pal_extend_sensor_config(void)
 	return;
 }
 
-__weak uint8_t pal_get_extend_sdr()
+__weak uint16_t pal_get_extend_sdr()
 {
 	return 0;
 }
 
-__weak uint8_t pal_get_extend_sensor_config()
+__weak uint16_t pal_get_extend_sensor_config()
 {
 	return 0;
 }
@@ -591,10 +646,10 @@ __weak void plat_fill_monitor_sensor_table()
 
 void check_init_sensor_size()
 {
-	uint8_t init_sdr_size = plat_get_sdr_size();
-	uint8_t init_sensor_config_size = plat_get_config_size();
-	uint8_t extend_sdr_size = pal_get_extend_sdr();
-	uint8_t extend_sensor_config_size = pal_get_extend_sensor_config();
+	uint16_t init_sdr_size = plat_get_sdr_size();
+	uint16_t init_sensor_config_size = plat_get_config_size();
+	uint16_t extend_sdr_size = pal_get_extend_sdr();
+	uint16_t extend_sensor_config_size = pal_get_extend_sensor_config();
 
 	init_sdr_size += extend_sdr_size;
 	init_sensor_config_size += extend_sensor_config_size;
@@ -609,22 +664,22 @@ void check_init_sensor_size()
 	sensor_config_size = init_sdr_size;
 }
 
-bool stby_access(uint8_t sensor_num)
+bool stby_access(uint16_t sensor_num)
 {
 	return true;
 }
 
-bool dc_access(uint8_t sensor_num)
+bool dc_access(uint16_t sensor_num)
 {
 	return get_DC_on_delayed_status();
 }
 
-bool post_access(uint8_t sensor_num)
+bool post_access(uint16_t sensor_num)
 {
 	return get_post_status();
 }
 
-bool me_access(uint8_t sensor_num)
+bool me_access(uint16_t sensor_num)
 {
 	if (get_me_mode() == ME_NORMAL_MODE) {
 		return get_post_status();
@@ -633,7 +688,7 @@ bool me_access(uint8_t sensor_num)
 	}
 }
 
-bool vr_access(uint8_t sensor_num)
+bool vr_access(uint16_t sensor_num)
 {
 	if (get_DC_on_delayed_status() == false) {
 		return false;
@@ -641,7 +696,7 @@ bool vr_access(uint8_t sensor_num)
 	return get_vr_monitor_status();
 }
 
-bool vr_stby_access(uint8_t sensor_num)
+bool vr_stby_access(uint16_t sensor_num)
 {
 	return get_vr_monitor_status();
 }
@@ -655,23 +710,23 @@ void sensor_poll_init()
 	return;
 }
 
-uint8_t get_sensor_config_index(uint8_t sensor_num)
+uint16_t get_sensor_config_index(uint16_t sensor_num)
 {
-	uint8_t i = 0;
+	uint16_t i = 0;
 	for (i = 0; i < sensor_config_count; ++i) {
 		if (sensor_num == sensor_config[i].num) {
 			return i;
 		}
 	}
-	return SENSOR_NUM_MAX;
+	return SENSOR_NULL;
 }
 
 void add_sensor_config(sensor_cfg config)
 {
-	uint8_t index = get_sensor_config_index(config.num);
-	if (index != SENSOR_NUM_MAX) {
+	uint16_t index = get_sensor_config_index(config.num);
+	if (index != SENSOR_NULL) {
 		memcpy(&sensor_config[index], &config, sizeof(sensor_cfg));
-		LOG_ERR("Replace the sensor[0x%02x] configuration", config.num);
+		LOG_ERR("Replace the sensor[0x%04x] configuration", config.num);
 		return;
 	}
 	// Check config table size before adding sensor config
@@ -703,6 +758,8 @@ void init_sensor_monitor_table()
 			sensor_monitor_table[0].access_checker = NULL;
 			sensor_monitor_table[0].pre_monitor = NULL;
 			sensor_monitor_table[0].post_monitor = NULL;
+			sensor_monitor_table[0].enter_monitor_table = NULL;
+			sensor_monitor_table[0].leave_monitor_table = NULL;
 			snprintf(sensor_monitor_table[0].table_name,
 				 sizeof(sensor_monitor_table[0].table_name), "%s",
 				 common_sensor_table_name);
@@ -753,7 +810,7 @@ static void drive_init(void)
 
 	bool ret = false;
 	uint16_t table_index = 0;
-	uint8_t sensor_index = 0;
+	uint16_t sensor_index = 0;
 	uint16_t current_drive = 0;
 
 	for (table_index = 0; table_index < sensor_monitor_count; ++table_index) {
@@ -773,6 +830,15 @@ static void drive_init(void)
 			continue;
 		}
 
+		if (table_info->enter_monitor_table != NULL) {
+			ret = table_info->enter_monitor_table(table_info->pre_post_monitor_arg);
+			if (ret != true) {
+				LOG_ERR("Enter monitor table fail cause drive init fail, table index: 0x%x",
+					table_index);
+				continue;
+			}
+		}
+
 		for (sensor_index = 0; sensor_index < sensor_monitor_table[table_index].cfg_count;
 		     ++sensor_index) {
 			sensor_cfg *cfg = &cfg_table[sensor_index];
@@ -813,6 +879,13 @@ static void drive_init(void)
 				cfg->read = NULL;
 			}
 		}
+
+		if (table_info->leave_monitor_table != NULL) {
+			ret = table_info->leave_monitor_table(table_info->pre_post_monitor_arg);
+			if (ret != true) {
+				LOG_ERR("Leave monitor table fail, table index: 0x%x", table_index);
+			}
+		}
 	}
 }
 
@@ -872,7 +945,7 @@ bool check_is_sensor_ready()
 	return is_sensor_ready_flag;
 }
 
-uint8_t plat_get_config_size()
+uint16_t plat_get_config_size()
 {
 	return SENSOR_CONFIG_SIZE;
 }
@@ -885,10 +958,10 @@ __weak void load_sensor_config(void)
 	pal_extend_sensor_config();
 }
 
-void control_sensor_polling(uint8_t sensor_num, uint8_t optional, uint8_t cache_status)
+void control_sensor_polling(uint16_t sensor_num, uint8_t optional, uint8_t cache_status)
 {
-	if ((sensor_num == SENSOR_NOT_SUPPORT) ||
-	    (sensor_config_index_map[sensor_num] == SENSOR_FAIL)) {
+	if ((sensor_num == SENSOR_NOT_SUPPORT) || (sensor_num >= SENSOR_NUM_MAX) ||
+	    (sensor_config_index_map[sensor_num] == SENSOR_NULL)) {
 		return;
 	}
 
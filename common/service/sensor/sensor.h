@@ -34,9 +34,13 @@
 #define GET_FROM_CACHE 0x00
 #define GET_FROM_SENSOR 0x01
 
-#define SENSOR_NULL 0xFF
+/* Index map entry of a sensor ID without config or SDR */
+#define SENSOR_NULL 0xFFFF
 #define SENSOR_FAIL 0xFF
+/* Sensor IDs are 16-bit, a platform with more than 255 sensors raises this in plat_def.h */
+#ifndef SENSOR_NUM_MAX
 #define SENSOR_NUM_MAX 0xFF
+#endif
 #define SENSOR_NOT_SUPPORT 0xFF
 #define DIMM_NOT_PRESENT 0xFF
 
@@ -179,7 +183,7 @@ struct tca9548 {
 	uint8_t chan;
 };
 
-static inline int calculate_accurate_MBR(uint8_t sensor_num, int val)
+static inline int calculate_accurate_MBR(uint16_t sensor_num, int val)
 { // for better accuracy, enlarge SDR to two byte scale
 	if (SDR_M(sensor_num) == 0) {
 		return ((val << 8) * SDR_Rexp(sensor_num));
@@ -187,7 +191,7 @@ static inline int calculate_accurate_MBR(uint8_t sensor_num, int val)
 	return ((val << 8) / SDR_M(sensor_num) * SDR_Rexp(sensor_num));
 }
 
-static inline int calculate_MBR(uint8_t sensor_num, int val)
+static inline int calculate_MBR(uint16_t sensor_num, int val)
 {
 	if (SDR_M(sensor_num) == 0) {
 		return (val * SDR_Rexp(sensor_num) + round_add(sensor_num, val));
@@ -195,7 +199,7 @@ static inline int calculate_MBR(uint8_t sensor_num, int val)
 	return (val * SDR_Rexp(sensor_num) / SDR_M(sensor_num) + round_add(sensor_num, val));
 }
 
-static inline float convert_MBR_to_reading(uint8_t sensor_num, uint8_t val)
+static inline float convert_MBR_to_reading(uint16_t sensor_num, uint8_t val)
 {
 	if (SDR_M(sensor_num) == 0) {
 		return (val - round_add(sensor_num, val)) / SDR_Rexp(sensor_num);
@@ -225,12 +229,12 @@ enum {
 enum { SENSOR_INIT_SUCCESS, SENSOR_INIT_UNSPECIFIED_ERROR };
 
 typedef struct _sensor_cfg_ {
-	uint8_t num;
+	uint16_t num;
 	uint8_t type;
 	uint8_t port; // port, bus, channel, etc.
 	uint8_t target_addr;
 	uint16_t offset;
-	bool (*access_checker)(uint8_t);
+	bool (*access_checker)(uint16_t);
 	int arg0;
 	int arg1;
 	int sample_count;
@@ -243,6 +247,8 @@ typedef struct _sensor_cfg_ {
 	bool (*post_sensor_read_hook)(struct _sensor_cfg_ *, void *, int *);
 	void *post_sensor_read_args;
 	void *init_args;
+	/* uptime of the last cache update from the device, 0 while there is none */
+	int64_t update_time_ms;
 
 	/* if there is new parameter should be added, please add on above */
 	void *priv_data;
@@ -253,18 +259,35 @@ typedef struct _sensor_cfg_ {
 
 typedef struct _sensor_monitor_table_info {
 	sensor_cfg *monitor_sensor_cfg;
-	uint8_t cfg_count;
+	uint16_t cfg_count;
 	bool (*access_checker)(uint8_t);
 	uint8_t access_checker_arg;
-	bool (*pre_monitor)(uint8_t, void *);
-	bool (*post_monitor)(uint8_t, void *);
+	bool (*pre_monitor)(uint16_t, void *);
+	bool (*post_monitor)(uint16_t, void *);
 	void *pre_post_monitor_arg;
 	void *priv_data;
 	char table_name[MAX_SENSOR_NAME_LENGTH];
+	/* Called once around all the sensors of the table due in a sweep, with
+	 * pre_post_monitor_arg. pre_monitor and post_monitor still run for each sensor inside.
+	 */
+	bool (*enter_monitor_table)(void *);
+	bool (*leave_monitor_table)(void *);
 } sensor_monitor_table_info;
 
+typedef struct _sensor_poll_stat {
+	uint32_t sweep_count;
+	uint32_t last_sweep_us;
+	uint32_t max_sweep_us;
+	/* Sensors read from the device in the last sweep */
+	uint16_t last_read_count;
+	/* I2C attempts on all buses during the last sweep, other threads included */
+	uint32_t last_i2c_count;
+	/* Longest time a sensor cache went without an update from the device */
+	uint32_t max_update_gap_ms;
+} sensor_poll_stat;
+
 typedef struct _sensor_poll_time_cfg {
-	uint8_t sensor_num;
+	uint16_t sensor_num;
 	int64_t last_access_time;
 } sensor_poll_time_cfg;
 
@@ -648,39 +671,41 @@ typedef struct _mp2985_init_arg {
 extern bool enable_sensor_poll_thread;
 extern sensor_cfg *sensor_config;
 // Mapping sensor number to sensor config index
-extern uint8_t sensor_config_index_map[SENSOR_NUM_MAX];
-extern uint8_t sensor_config_count;
+extern uint16_t sensor_config_index_map[SENSOR_NUM_MAX];
+extern uint16_t sensor_config_count;
 extern sensor_monitor_table_info *sensor_monitor_table;
 extern uint16_t sensor_monitor_count;
 extern const char *const sensor_type_name[];
 
 void clear_unaccessible_sensor_cache(sensor_cfg *cfg);
-uint8_t get_sensor_reading(sensor_cfg *cfg_table, uint8_t cfg_count, uint8_t sensor_num,
+uint8_t get_sensor_reading(sensor_cfg *cfg_table, uint16_t cfg_count, uint16_t sensor_num,
 			   int *reading, uint8_t read_mode);
 void pal_set_sensor_poll_interval(int *interval_ms);
-bool stby_access(uint8_t sensor_num);
-bool dc_access(uint8_t sensor_num);
-bool post_access(uint8_t sensor_num);
-bool me_access(uint8_t sensor_num);
-bool vr_access(uint8_t sensor_num);
-bool vr_stby_access(uint8_t sensor_num);
+bool stby_access(uint16_t sensor_num);
+bool dc_access(uint16_t sensor_num);
+bool post_access(uint16_t sensor_num);
+bool me_access(uint16_t sensor_num);
+bool vr_access(uint16_t sensor_num);
+bool vr_stby_access(uint16_t sensor_num);
 bool sensor_init(void);
 void disable_sensor_poll();
 void enable_sensor_poll();
 bool get_sensor_poll_enable_flag();
+void get_sensor_poll_stat(sensor_poll_stat *stat);
+void clear_sensor_poll_stat();
 void pal_extend_sensor_config(void);
-bool check_sensor_num_exist(uint8_t sensor_num);
+bool check_sensor_num_exist(uint16_t sensor_num);
 void add_sensor_config(sensor_cfg config);
 bool check_is_sensor_ready();
-bool pal_is_time_to_poll(uint8_t sensor_num, int poll_time);
-uint8_t plat_get_config_size();
+bool pal_is_time_to_poll(uint16_t sensor_num, int poll_time);
+uint16_t plat_get_config_size();
 void load_sensor_config(void);
-void control_sensor_polling(uint8_t sensor_num, uint8_t optional, uint8_t cache_status);
+void control_sensor_polling(uint16_t sensor_num, uint8_t optional, uint8_t cache_status);
 bool check_reading_pointer_null_is_allowed(sensor_cfg *cfg);
 bool init_drive_type_delayed(sensor_cfg *cfg);
 uint8_t pal_get_monitor_sensor_count();
 void plat_fill_monitor_sensor_table();
-sensor_cfg *find_sensor_cfg_via_sensor_num(sensor_cfg *cfg_table, uint8_t cfg_count,
-					   uint8_t sensor_num);
+sensor_cfg *find_sensor_cfg_via_sensor_num(sensor_cfg *cfg_table, uint16_t cfg_count,
+					   uint16_t sensor_num);
 
 #endif
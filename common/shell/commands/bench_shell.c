@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench_shell.h"
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr.h>
+#include "ipmb.h"
+#include "ipmi.h"
+#include "latency_hist.h"
+#include "mctp.h"
+#include "pldm.h"
+#include "sensor.h"
+#include "util_mem.h"
+
+/* The encoded message length is kept in one byte by ipmb_decode */
+#define BENCH_IPMB_MAX_DATA_LEN (UINT8_MAX - IPMB_RESP_HEADER_LENGTH - 1)
+
+static ipmi_msg bench_msg;
+static uint8_t bench_buf[IPMI_MSG_MAX_LENGTH];
+static uint8_t bench_pldm_req[PLDM_MAX_DATA_SIZE];
+static uint8_t bench_pldm_resp[PLDM_MAX_DATA_SIZE];
+static mctp_msg_assembly bench_assembly;
+
+typedef struct _bench_result {
+	latency_hist hist;
+	uint32_t start_cycle;
+	uint32_t fail_count;
+	/* Bytes of util_mem allocations in use when the bench started */
+	uint32_t mem_in_use;
+} bench_result;
+
+/* The malloc arena keeps no statistics, allocations through util_mem are what is counted */
+static uint32_t get_mem_in_use()
+{
+	util_mem_tag_stat stat;
+	uint32_t in_use = 0;
+
+	for (uint8_t i = 0; i < MEM_TAG_NUM; i++) {
+		if (util_mem_get_tag_stat(i, &stat)) {
+			in_use += stat.in_use;
+		}
+	}
+
+	return in_use;
+}
+
+static bool get_count_arg(const struct shell *shell, const char *arg, uint32_t *count)
+{
+	*count = strtoul(arg, NULL, 10);
+	if ((*count == 0) || (*count > BENCH_MAX_COUNT)) {
+		shell_error(shell, "Count should be 1 to %d", BENCH_MAX_COUNT);
+		return false;
+	}
+
+	return true;
+}
+
+static void bench_start(bench_result *result)
+{
+	memset(result, 0, sizeof(bench_result));
+	result->mem_in_use = get_mem_in_use();
+	result->start_cycle = k_cycle_get_32();
+}
+
+/* Time of one run in ns, the histogram buckets count ns here */
+static void bench_add(bench_result *result, uint32_t run_start_cycle, bool is_success)
+{
+	latency_hist_add(&result->hist, k_cyc_to_ns_floor32(k_cycle_get_32() - run_start_cycle));
+	if (!is_success) {
+		result->fail_count++;
+	}
+}
+
+static void bench_print(const struct shell *shell, const char *name, bench_result *result)
+{
+	uint32_t total_us = MAX(k_cyc_to_us_floor32(k_cycle_get_32() - result->start_cycle), 1);
+	latency_hist *hist = &result->hist;
+
+	if (hist->count == 0) {
+		return;
+	}
+
+	uint32_t op_per_sec = (uint64_t)hist->count * 1000000 / total_us;
+
+	shell_print(shell, "%-8s | %-8s | %-8s | %-10s | %-10s | %-10s | %-10s | %s", "bench",
+		    "count", "fail", "op/s", "avg(ns)", "p50(ns)", "p99(ns)", "max(ns)");
+	shell_print(shell, "%-8s | %-8d | %-8d | %-10d | %-10d | <%-9d | <%-9d | %d", name,
+		    hist->count, result->fail_count, op_per_sec,
+		    (uint32_t)(hist->total_us / hist->count), latency_hist_percentile(hist, 50),
+		    latency_hist_percentile(hist, 99), hist->max_us);
+	shell_print(shell, "memory in use: %d bytes before, %d bytes after", result->mem_in_use,
+		    get_mem_in_use());
+}
+
+void cmd_bench_ipmb(const struct shell *shell, size_t argc, char **argv)
+{
+	uint32_t count = BENCH_DEFAULT_COUNT;
+
+	if ((argc != 2) && (argc != 3)) {
+		shell_warn(shell, "Help: platform bench ipmb <data_len> [count]");
+		return;
+	}
+
+	uint16_t data_len = strtoul(argv[1], NULL, 10);
+	if (data_len > BENCH_IPMB_MAX_DATA_LEN) {
+		shell_error(shell, "Data length should be 0 to %d", BENCH_IPMB_MAX_DATA_LEN);
+		return;
+	}
+
+	if ((argc == 3) && !get_count_arg(shell, argv[2], &count)) {
+		return;
+	}
+
+	bench_result result;
+	bench_start(&result);
+
+	for (uint32_t i = 0; i < count; i++) {
+		memset(&bench_msg, 0, sizeof(bench_msg));
+		bench_msg.dest_addr = 0x20;
+		bench_msg.src_addr = 0x40;
+		bench_msg.netfn = NETFN_OEM_1S_REQ;
+		bench_msg.cmd = 0x01;
+		bench_msg.seq = i & 0x3F;
+		bench_msg.data_len = data_len;
+		for (uint16_t j = 0; j < data_len; j++) {
+			bench_msg.data[j] = i + j;
+		}
+
+		uint8_t encode_len = data_len + IPMB_REQ_HEADER_LENGTH + 1;
+
+		uint32_t run_start_cycle = k_cycle_get_32();
+		bool is_success = (ipmb_encode(bench_buf, &bench_msg) == IPMB_ERROR_SUCCESS) &&
+				  (ipmb_decode(&bench_msg, bench_buf, encode_len) ==
+				   IPMB_ERROR_SUCCESS);
+		bench_add(&result, run_start_cycle, is_success && (bench_msg.data_len == data_len));
+	}
+
+	bench_print(shell, "ipmb", &result);
+}
+
+void cmd_bench_pldm(const struct shell *shell, size_t argc, char **argv)
+{
+	uint32_t count;
+
+	if (argc < 5) {
+		shell_warn(shell, "Help: platform bench pldm <count> <mctp_eid> <pldm_type> <cmd> "
+				  "<data...>");
+		return;
+	}
+
+	if (!get_count_arg(shell, argv[1], &count)) {
+		return;
+	}
+
+	uint8_t mctp_eid = strtol(argv[2], NULL, 16);
+	uint8_t pldm_type = strtol(argv[3], NULL, 16);
+	uint8_t pldm_cmd = strtol(argv[4], NULL, 16);
+	uint16_t req_len = argc - 5;
+
+	if (req_len > sizeof(bench_pldm_req)) {
+		shell_error(shell, "Request data too long");
+		return;
+	}
+
+	/* The handler is run with the instance of the port the request would come from */
+	mctp *mctp_inst = NULL;
+	mctp_ext_params ext_params = { 0 };
+	if (get_mctp_info_by_eid(mctp_eid, &mctp_inst, &ext_params) == false) {
+		shell_error(shell, "Failed to get mctp info by eid 0x%x", mctp_eid);
+		return;
+	}
+
+	pldm_cmd_proc_fn handler = pldm_get_cmd_handler(pldm_type, pldm_cmd);
+	if (!handler) {
+		shell_error(shell, "PLDM type 0x%x cmd 0x%x not supported", pldm_type, pldm_cmd);
+		return;
+	}
+
+	for (uint16_t i = 0; i < req_len; i++) {
+		bench_pldm_req[i] = strtol(argv[5 + i], NULL, 16);
+	}
+
+	bench_result result;
+	bench_start(&result);
+
+	for (uint32_t i = 0; i < count; i++) {
+		uint16_t resp_len = 1;
+
+		uint32_t run_start_cycle = k_cycle_get_32();
+		uint8_t rc = handler(mctp_inst, bench_pldm_req, req_len, i & 0x1F, bench_pldm_resp,
+				     &resp_len, &ext_params);
+		if (rc == PLDM_LATER_RESP) {
+			shell_error(shell, "Command responds later, not able to bench");
+			return;
+		}
+		bench_add(&result, run_start_cycle,
+			  (rc == PLDM_SUCCESS) && (bench_pldm_resp[0] == PLDM_SUCCESS));
+	}
+
+	bench_print(shell, "pldm", &result);
+}
+
+void cmd_bench_mctp(const struct shell *shell, size_t argc, char **argv)
+{
+	uint32_t count = BENCH_DEFAULT_COUNT;
+
+	if ((argc != 2) && (argc != 3)) {
+		shell_warn(shell, "Help: platform bench mctp <msg_len> [count]");
+		return;
+	}
+
+	uint16_t msg_len = strtoul(argv[1], NULL, 10);
+	if ((msg_len == 0) || (msg_len > MSG_ASSEMBLY_BUF_SIZE)) {
+		shell_error(shell, "Message length should be 1 to %d", MSG_ASSEMBLY_BUF_SIZE);
+		return;
+	}
+
+	if ((argc == 3) && !get_count_arg(shell, argv[2], &count)) {
+		return;
+	}
+
+	bench_result result;
+	bench_start(&result);
+
+	for (uint32_t i = 0; i < count; i++) {
+		uint8_t tag = i & MCTP_HDR_TAG_MASK;
+		bool is_success = true;
+
+		uint32_t run_start_cycle = k_cycle_get_32();
+		for (uint16_t offset = 0; offset < msg_len; offset += MCTP_DEFAULT_MSG_MAX_SIZE) {
+			uint16_t len = MIN(msg_len - offset, MCTP_DEFAULT_MSG_MAX_SIZE);
+			uint8_t seq = (offset / MCTP_DEFAULT_MSG_MAX_SIZE) & MCTP_HDR_SEQ_MASK;
+
+			/* Packets as the receive task gets them, SOM, EOM, sequence, TO and tag */
+			bench_buf[0] = MCTP_HDR_HDR_VER;
+			bench_buf[1] = MCTP_DEFAULT_ENDPOINT;
+			bench_buf[2] = MCTP_NULL_EID;
+			bench_buf[3] = ((offset == 0) << 7) | ((offset + len == msg_len) << 6) |
+				       (seq << 4) | (1 << 3) | tag;
+			memset(&bench_buf[MCTP_TRANSPORT_HEADER_SIZE], i, len);
+			if (mctp_pkt_assembling(&bench_assembly, bench_buf,
+						MCTP_TRANSPORT_HEADER_SIZE + len) != MCTP_SUCCESS) {
+				is_success = false;
+				break;
+			}
+		}
+
+		/* A single packet message is handled in place without a buffer */
+		if (bench_assembly.buf) {
+			is_success = is_success && (bench_assembly.offset == msg_len);
+			util_mem_free(bench_assembly.buf);
+			bench_assembly.buf = NULL;
+			bench_assembly.offset = 0;
+		}
+		bench_add(&result, run_start_cycle, is_success);
+	}
+
+	bench_print(shell, "mctp", &result);
+}
+
+void cmd_bench_sensor(const struct shell *shell, size_t argc, char **argv)
+{
+	uint32_t count = BENCH_DEFAULT_COUNT;
+	int reading;
+
+	if ((argc != 2) && (argc != 3)) {
+		shell_warn(shell, "Help: platform bench sensor <sensor_num> [count]");
+		return;
+	}
+
+	uint16_t sensor_num = strtol(argv[1], NULL, 16);
+	if ((argc == 3) && !get_count_arg(shell, argv[2], &count)) {
+		return;
+	}
+
+	bench_result result;
+	bench_start(&result);
+
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t run_start_cycle = k_cycle_get_32();
+		uint8_t status = get_sensor_reading(sensor_config, sensor_config_count, sensor_num,
+						    &reading, GET_FROM_SENSOR);
+		bench_add(&result, run_start_cycle,
+			  (status == SENSOR_READ_SUCCESS) || (status == SENSOR_READ_ACUR_SUCCESS));
+	}
+
+	bench_print(shell, "sensor", &result);
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_SHELL_H
+#define BENCH_SHELL_H
+
+#include <shell/shell.h>
+
+#define BENCH_DEFAULT_COUNT 1000
+#define BENCH_MAX_COUNT 100000
+
+void cmd_bench_ipmb(const struct shell *shell, size_t argc, char **argv);
+void cmd_bench_pldm(const struct shell *shell, size_t argc, char **argv);
+void cmd_bench_mctp(const struct shell *shell, size_t argc, char **argv);
+void cmd_bench_sensor(const struct shell *shell, size_t argc, char **argv);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_bench_cmds,
+	SHELL_CMD(ipmb, NULL, "IPMB encode and decode of a request with <data_len> bytes.",
+		  cmd_bench_ipmb),
+	SHELL_CMD(pldm, NULL, "Handler of a PLDM command BIC serves, without sending the response.",
+		  cmd_bench_pldm),
+	SHELL_CMD(mctp, NULL, "MCTP receive assembly of a message of <msg_len> bytes.",
+		  cmd_bench_mctp),
+	SHELL_CMD(sensor, NULL, "Sensor read from the device.", cmd_bench_sensor),
+	SHELL_SUBCMD_SET_END);
+
+#endif
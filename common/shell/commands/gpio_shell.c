@@ -19,6 +19,7 @@
 #include "plat_gpio.h"
 #include <drivers/gpio.h>
 #include <stdio.h>
+#include <string.h>
 
 /*
  * Constants
@@ -351,6 +352,34 @@ void cmd_gpio_muti_fn_ctl_list(const struct shell *shell, size_t argc, char **ar
 	shell_print(shell, "\n");
 }
 
+void cmd_gpio_event_count(const struct shell *shell, size_t argc, char **argv)
+{
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform gpio event [clear]");
+		return;
+	}
+
+	if (argc == 2) {
+		if (strcmp(argv[1], "clear")) {
+			shell_warn(shell, "Help: platform gpio event [clear]");
+			return;
+		}
+		gpio_event_reset_count();
+		return;
+	}
+
+	shell_print(shell, "[gpio] %-32s %10s %10s", "name", "edge", "overflow");
+	for (int gpio_idx = 0; gpio_idx < TOTAL_GPIO_NUM; gpio_idx++) {
+		uint32_t edge_count = 0, overflow_count = 0;
+		if (!gpio_event_get_count(gpio_idx, &edge_count, &overflow_count) ||
+		    ((edge_count == 0) && (overflow_count == 0))) {
+			continue;
+		}
+		shell_print(shell, "[%4d] %-32s %10u %10u", gpio_idx, gpio_name[gpio_idx],
+			    edge_count, overflow_count);
+	}
+}
+
 /* GPIO sub command */
 void device_gpio_name_get(size_t idx, struct shell_static_entry *entry)
 {
@@ -27,6 +27,7 @@ void cmd_gpio_cfg_get(const struct shell *shell, size_t argc, char **argv);
 void cmd_gpio_cfg_set_val(const struct shell *shell, size_t argc, char **argv);
 void cmd_gpio_cfg_set_int_type(const struct shell *shell, size_t argc, char **argv);
 void cmd_gpio_muti_fn_ctl_list(const struct shell *shell, size_t argc, char **argv);
+void cmd_gpio_event_count(const struct shell *shell, size_t argc, char **argv);
 void device_gpio_name_get(size_t idx, struct shell_static_entry *entry);
 
 SHELL_DYNAMIC_CMD_CREATE(gpio_device_name, device_gpio_name_get);
@@ -47,6 +48,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(
 	SHELL_CMD(set, &sub_gpio_set_cmds, "Set GPIO config", NULL),
 	SHELL_CMD(multifnctl, NULL, "List all GPIO multi-function control regs.",
 		  cmd_gpio_muti_fn_ctl_list),
+	SHELL_CMD(event, NULL, "List or clear per-pin edge and overflow counts.",
+		  cmd_gpio_event_count),
 	SHELL_SUBCMD_SET_END);
 
 #endif
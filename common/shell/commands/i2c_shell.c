@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "i2c_shell.h"
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr.h>
+#include "hal_i2c.h"
+#include "i2c_fault.h"
+#include "i2c_health.h"
+#include "i2c_scheduler.h"
+#include "i2c_sim.h"
+#include "plat_i2c.h"
+#include "sensor.h"
+
+static const char *const i2c_prio_name[I2C_SCHED_PRIO_NUM] = { "ipmb", "sensor", "bulk" };
+
+static bool get_bus_arg(const struct shell *shell, size_t argc, char **argv, uint8_t *bus)
+{
+	if (argc < 2) {
+		return false;
+	}
+
+	*bus = strtol(argv[1], NULL, 10);
+	if ((*bus >= I2C_BUS_MAX_NUM) || (check_i2c_bus_valid(*bus) < 0)) {
+		shell_error(shell, "i2c bus %d is invalid", *bus);
+		return false;
+	}
+	return true;
+}
+
+static void print_bus_health(const struct shell *shell, uint8_t bus)
+{
+	i2c_bus_health bus_health;
+	i2c_dev_health dev;
+	uint8_t addr[I2C_HEALTH_MAX_DEV];
+
+	if (!i2c_health_get_bus(bus, &bus_health)) {
+		return;
+	}
+
+	uint8_t num = i2c_health_get_dev_list(bus, addr, ARRAY_SIZE(addr));
+	if ((num == 0) && (bus_health.recovery_count == 0)) {
+		return;
+	}
+
+	shell_print(shell, "[bus %d] recovery: %d, recovery failed: %d", bus,
+		    bus_health.recovery_count, bus_health.recovery_fail_count);
+
+	int64_t now = k_uptime_get();
+	for (uint8_t i = 0; i < num; i++) {
+		if (!i2c_health_get_dev(bus, addr[i], &dev)) {
+			continue;
+		}
+		shell_print(shell, "0x%-4x | %-10d | %-8d | %-8d | %-8d | %-8d | %-10d | %d",
+			    dev.addr, dev.count[I2C_HEALTH_SUCCESS], dev.count[I2C_HEALTH_NACK],
+			    dev.count[I2C_HEALTH_TIMEOUT], dev.count[I2C_HEALTH_ARB_LOST],
+			    dev.count[I2C_HEALTH_OTHER], dev.quarantine_count,
+			    (int)MAX(dev.quarantine_until_ms - now, 0));
+	}
+}
+
+void cmd_i2c_health(const struct shell *shell, size_t argc, char **argv)
+{
+	uint8_t bus;
+
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform i2c health [bus]");
+		return;
+	}
+
+	shell_print(shell, "%-6s | %-10s | %-8s | %-8s | %-8s | %-8s | %-10s | %s", "addr",
+		    "success", "nack", "timeout", "arb lost", "other", "quarantine", "left(ms)");
+	if (argc == 2) {
+		if (get_bus_arg(shell, argc, argv, &bus)) {
+			print_bus_health(shell, bus);
+		}
+		return;
+	}
+
+	for (bus = 0; bus < I2C_BUS_MAX_NUM; bus++) {
+		if (check_i2c_bus_valid(bus) == 0) {
+			print_bus_health(shell, bus);
+		}
+	}
+}
+
+void cmd_i2c_latency(const struct shell *shell, size_t argc, char **argv)
+{
+	uint8_t bus;
+	i2c_dev_health dev;
+
+	if ((argc != 3) || !get_bus_arg(shell, argc, argv, &bus)) {
+		shell_warn(shell, "Help: platform i2c latency <bus> <7-bit address>");
+		return;
+	}
+
+	uint8_t addr = strtol(argv[2], NULL, 16);
+	if (!i2c_health_get_dev(bus, addr, &dev)) {
+		shell_error(shell, "No transfer to bus %d addr 0x%x yet", bus, addr);
+		return;
+	}
+
+	for (uint8_t i = 0; i < I2C_HEALTH_LATENCY_BUCKET_NUM; i++) {
+		if (i2c_health_latency_bound_us[i] == UINT32_MAX) {
+			shell_print(shell, "> %-8d us: %d", i2c_health_latency_bound_us[i - 1],
+				    dev.latency[i]);
+		} else {
+			shell_print(shell, "<= %-7d us: %d", i2c_health_latency_bound_us[i],
+				    dev.latency[i]);
+		}
+	}
+}
+
+void cmd_i2c_sched(const struct shell *shell, size_t argc, char **argv)
+{
+	i2c_sched_stat stat;
+
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform i2c sched [bus]");
+		return;
+	}
+
+	uint8_t bus, last_bus = I2C_BUS_MAX_NUM - 1;
+	if (argc == 2) {
+		if (!get_bus_arg(shell, argc, argv, &bus)) {
+			return;
+		}
+		last_bus = bus;
+	} else {
+		bus = 0;
+	}
+
+	shell_print(shell, "%-4s | %-6s | %-10s | %-8s | %-10s | %-8s | %s", "bus", "class",
+		    "count", "timeout", "avg wait", "max wait", "depth/max");
+	for (; bus <= last_bus; bus++) {
+		if ((check_i2c_bus_valid(bus) < 0) || !i2c_sched_get_stat(bus, &stat)) {
+			continue;
+		}
+		for (uint8_t i = 0; i < I2C_SCHED_PRIO_NUM; i++) {
+			uint32_t avg = stat.xfer_count[i] ?
+					       (stat.wait_total_ms[i] / stat.xfer_count[i]) :
+					       0;
+			shell_print(shell, "%-4d | %-6s | %-10d | %-8d | %-10d | %-8d | %d/%d", bus,
+				    i2c_prio_name[i], stat.xfer_count[i], stat.timeout_count[i],
+				    avg, stat.wait_max_ms[i], stat.depth[i], stat.depth_max[i]);
+		}
+	}
+}
+
+void cmd_i2c_clear(const struct shell *shell, size_t argc, char **argv)
+{
+	uint8_t bus = 0xFF;
+
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform i2c clear [bus]");
+		return;
+	}
+
+	if ((argc == 2) && !get_bus_arg(shell, argc, argv, &bus)) {
+		return;
+	}
+
+	i2c_health_clear(bus);
+	for (uint8_t i = 0; i < I2C_BUS_MAX_NUM; i++) {
+		if ((bus == 0xFF) || (bus == i)) {
+			i2c_sched_reset_stat(i);
+		}
+	}
+	shell_print(shell, "Cleared");
+}
+
+void cmd_i2c_fault_set(const struct shell *shell, size_t argc, char **argv)
+{
+	i2c_fault_rule rule = { 0 };
+
+	if ((argc != 6) || !get_bus_arg(shell, argc, argv, &rule.bus)) {
+		shell_warn(shell, "Help: platform i2c fault set <bus> <7-bit address, ff for all> "
+				  "<delay_us> <nack_interval> <stuck>");
+		return;
+	}
+
+	rule.addr = strtol(argv[2], NULL, 16);
+	rule.delay_us = strtoul(argv[3], NULL, 10);
+	rule.nack_interval = strtoul(argv[4], NULL, 10);
+	rule.is_stuck = (strtol(argv[5], NULL, 10) != 0);
+
+	if (!i2c_fault_set(&rule)) {
+		shell_error(shell, "Failed to set the rule, at most %d rules and %d us delay",
+			    I2C_FAULT_MAX_RULE, I2C_FAULT_MAX_DELAY_US);
+		return;
+	}
+	shell_print(shell, "Set");
+}
+
+void cmd_i2c_fault_list(const struct shell *shell, size_t argc, char **argv)
+{
+	i2c_fault_rule rule[I2C_FAULT_MAX_RULE];
+
+	uint8_t num = i2c_fault_get_rules(rule, ARRAY_SIZE(rule));
+	shell_print(shell, "%-4s | %-6s | %-10s | %-8s | %-5s | %-10s | %s", "bus", "addr",
+		    "delay(us)", "nack int", "stuck", "attempt", "injected");
+	for (uint8_t i = 0; i < num; i++) {
+		shell_print(shell, "%-4d | 0x%-4x | %-10d | %-8d | %-5d | %-10d | %d", rule[i].bus,
+			    rule[i].addr, rule[i].delay_us, rule[i].nack_interval, rule[i].is_stuck,
+			    rule[i].attempt_count, rule[i].inject_count);
+	}
+}
+
+void cmd_i2c_fault_clear(const struct shell *shell, size_t argc, char **argv)
+{
+	uint8_t bus = I2C_FAULT_ALL_BUS;
+
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform i2c fault clear [bus]");
+		return;
+	}
+
+	if ((argc == 2) && !get_bus_arg(shell, argc, argv, &bus)) {
+		return;
+	}
+
+	i2c_fault_clear(bus);
+	shell_print(shell, "Cleared");
+}
+
+void cmd_i2c_sim_add(const struct shell *shell, size_t argc, char **argv)
+{
+	i2c_sim_dev dev = { 0 };
+
+	if (((argc != 4) && (argc != 5) && (argc != 7)) ||
+	    !get_bus_arg(shell, argc, argv, &dev.bus)) {
+		shell_warn(shell, "Help: platform i2c sim add <bus> <7-bit address> "
+				  "<mux|vr|hsc|tmp75|nvme> [latency_us] "
+				  "[7-bit mux address] [mux channel]");
+		return;
+	}
+
+	dev.addr = strtol(argv[2], NULL, 16);
+	for (dev.type = 0; dev.type < I2C_SIM_DEV_TYPE_MAX; dev.type++) {
+		if (!strcmp(argv[3], i2c_sim_dev_type_name[dev.type])) {
+			break;
+		}
+	}
+	if (argc > 4) {
+		dev.latency_us = strtoul(argv[4], NULL, 10);
+	}
+	if (argc > 5) {
+		dev.mux_addr = strtol(argv[5], NULL, 16);
+		dev.mux_channel = strtoul(argv[6], NULL, 10);
+	}
+
+	if (!i2c_sim_add(&dev)) {
+		shell_error(shell, "Failed to add the model, at most %d models and %d us latency",
+			    I2C_SIM_MAX_DEV, I2C_SIM_MAX_LATENCY_US);
+		return;
+	}
+	shell_print(shell, "Added");
+}
+
+static uint8_t get_sensor_sim_type(uint8_t sensor_type)
+{
+	switch (sensor_type) {
+	case sensor_dev_tmp75:
+	case sensor_dev_lm75bd118:
+		return I2C_SIM_DEV_TMP75;
+	case sensor_dev_nvme:
+		return I2C_SIM_DEV_NVME_MI;
+	case sensor_dev_adm1278:
+	case sensor_dev_adm1272:
+	case sensor_dev_mp5990:
+	case sensor_dev_ltc4282:
+	case sensor_dev_ltc4286:
+	case sensor_dev_q50sn120a1:
+	case sensor_dev_ina233:
+		return I2C_SIM_DEV_PMBUS_HSC;
+	case sensor_dev_isl69259:
+	case sensor_dev_tps53689:
+	case sensor_dev_xdpe15284:
+	case sensor_dev_isl69254iraz_t:
+	case sensor_dev_xdpe12284c:
+	case sensor_dev_raa229621:
+	case sensor_dev_xdpe19283b:
+	case sensor_dev_mp2856gut:
+	case sensor_dev_mp2971:
+	case sensor_dev_mp2985:
+	case sensor_dev_bmr351:
+		return I2C_SIM_DEV_PMBUS_VR;
+	default:
+		return I2C_SIM_DEV_TYPE_MAX;
+	}
+}
+
+/* A model for each TMP75, NVMe, HSC and VR target of the sensor table, once per address */
+void cmd_i2c_sim_sensor(const struct shell *shell, size_t argc, char **argv)
+{
+	i2c_sim_dev dev = { 0 };
+	uint16_t skip_num = 0;
+
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform i2c sim sensor [latency_us]");
+		return;
+	}
+
+	if (argc == 2) {
+		dev.latency_us = strtoul(argv[1], NULL, 10);
+	}
+
+	for (uint16_t i = 0; i < sensor_config_count; i++) {
+		dev.type = get_sensor_sim_type(sensor_config[i].type);
+		dev.bus = sensor_config[i].port;
+		dev.addr = sensor_config[i].target_addr;
+		if (dev.type == I2C_SIM_DEV_TYPE_MAX) {
+			skip_num++;
+			continue;
+		}
+
+		if (!i2c_sim_has_dev(dev.bus, dev.addr) && !i2c_sim_add(&dev)) {
+			shell_error(shell, "Failed to add the model of sensor 0x%x",
+				    sensor_config[i].num);
+			return;
+		}
+	}
+
+	shell_print(shell, "Added, %d sensors are not on a modeled device", skip_num);
+	shell_print(shell, "Add the muxes with \"platform i2c sim add\", the sweep time and "
+			   "staleness are in \"platform sensor poll_stat\"");
+}
+
+void cmd_i2c_sim_list(const struct shell *shell, size_t argc, char **argv)
+{
+	i2c_sim_dev dev[I2C_SIM_MAX_DEV];
+
+	uint8_t num = i2c_sim_get_devs(dev, ARRAY_SIZE(dev));
+	shell_print(shell, "%-4s | %-6s | %-5s | %-8s | %-11s | %-10s | %s", "bus", "addr", "type",
+		    "mux", "latency(us)", "xfer", "nack");
+	for (uint8_t i = 0; i < num; i++) {
+		shell_print(shell, "%-4d | 0x%-4x | %-5s | 0x%-2x/%-2d | %-11d | %-10d | %d",
+			    dev[i].bus, dev[i].addr, i2c_sim_dev_type_name[dev[i].type],
+			    dev[i].mux_addr, dev[i].mux_channel, dev[i].latency_us,
+			    dev[i].xfer_count, dev[i].nack_count);
+	}
+}
+
+void cmd_i2c_sim_clear(const struct shell *shell, size_t argc, char **argv)
+{
+	uint8_t bus = I2C_SIM_ALL_BUS;
+
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform i2c sim clear [bus]");
+		return;
+	}
+
+	if ((argc == 2) && !get_bus_arg(shell, argc, argv, &bus)) {
+		return;
+	}
+
+	i2c_sim_clear(bus);
+	shell_print(shell, "Cleared");
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef I2C_SHELL_H
+#define I2C_SHELL_H
+
+#include <shell/shell.h>
+
+void cmd_i2c_health(const struct shell *shell, size_t argc, char **argv);
+void cmd_i2c_latency(const struct shell *shell, size_t argc, char **argv);
+void cmd_i2c_sched(const struct shell *shell, size_t argc, char **argv);
+void cmd_i2c_clear(const struct shell *shell, size_t argc, char **argv);
+void cmd_i2c_fault_set(const struct shell *shell, size_t argc, char **argv);
+void cmd_i2c_fault_list(const struct shell *shell, size_t argc, char **argv);
+void cmd_i2c_fault_clear(const struct shell *shell, size_t argc, char **argv);
+void cmd_i2c_sim_add(const struct shell *shell, size_t argc, char **argv);
+void cmd_i2c_sim_sensor(const struct shell *shell, size_t argc, char **argv);
+void cmd_i2c_sim_list(const struct shell *shell, size_t argc, char **argv);
+void cmd_i2c_sim_clear(const struct shell *shell, size_t argc, char **argv);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_i2c_fault_cmds,
+	SHELL_CMD(set, NULL, "Delay, NACK every N attempts or stuck bus on a target.",
+		  cmd_i2c_fault_set),
+	SHELL_CMD(list, NULL, "Fault rules and their counters.", cmd_i2c_fault_list),
+	SHELL_CMD(clear, NULL, "Remove the fault rules of a bus or all.", cmd_i2c_fault_clear),
+	SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_i2c_sim_cmds,
+	SHELL_CMD(add, NULL, "Model a mux, VR, HSC, TMP75 or NVMe-MI target.", cmd_i2c_sim_add),
+	SHELL_CMD(sensor, NULL, "Model the targets of the sensor table.", cmd_i2c_sim_sensor),
+	SHELL_CMD(list, NULL, "Models and their counters.", cmd_i2c_sim_list),
+	SHELL_CMD(clear, NULL, "Remove the models of a bus or all.", cmd_i2c_sim_clear),
+	SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_i2c_cmds,
+	SHELL_CMD(health, NULL, "Per device transfer counters and quarantine state.",
+		  cmd_i2c_health),
+	SHELL_CMD(latency, NULL, "Transfer latency histogram of a device.", cmd_i2c_latency),
+	SHELL_CMD(sched, NULL, "Per bus scheduler queue depth and wait time.", cmd_i2c_sched),
+	SHELL_CMD(clear, NULL, "Clear health and scheduler counters.", cmd_i2c_clear),
+	SHELL_CMD(fault, &sub_i2c_fault_cmds, "Fault injection below the I2C HAL.", NULL),
+	SHELL_CMD(sim, &sub_i2c_sim_cmds, "Simulated targets in place of the I2C controller.",
+		  NULL),
+	SHELL_SUBCMD_SET_END);
+
+#endif
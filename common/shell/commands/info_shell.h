@@ -20,10 +20,17 @@
 #include <shell/shell.h>
 
 int cmd_info_print(const struct shell *shell, size_t argc, char **argv);
+void cmd_info_thread(const struct shell *shell, size_t argc, char **argv);
+void cmd_info_mem(const struct shell *shell, size_t argc, char **argv);
+void cmd_info_worker(const struct shell *shell, size_t argc, char **argv);
 
 /* Sensor sub command */
-SHELL_STATIC_SUBCMD_SET_CREATE(sub_info_cmds,
-			       SHELL_CMD(all, NULL, "List all platform info.", cmd_info_print),
-			       SHELL_SUBCMD_SET_END);
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_info_cmds, SHELL_CMD(all, NULL, "List all platform info.", cmd_info_print),
+	SHELL_CMD(thread, NULL, "Profile thread CPU, wakeup and stack usage over a window.",
+		  cmd_info_thread),
+	SHELL_CMD(mem, NULL, "List tagged allocations and slab pool usage.", cmd_info_mem),
+	SHELL_CMD(worker, NULL, "List worker run statistics, or clear them.", cmd_info_worker),
+	SHELL_SUBCMD_SET_END);
 
 #endif
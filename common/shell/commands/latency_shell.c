@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "latency_shell.h"
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr.h>
+#include "latency_hist.h"
+
+static bool get_group_arg(const struct shell *shell, const char *arg, uint8_t *group)
+{
+	for (uint8_t i = 0; i < LATENCY_HIST_GROUP_NUM; i++) {
+		if (!strcmp(arg, latency_hist_group_name[i])) {
+			*group = i;
+			return true;
+		}
+	}
+
+	shell_error(shell, "Unknown group %s", arg);
+	return false;
+}
+
+static void print_group(const struct shell *shell, uint8_t group)
+{
+	uint16_t key[LATENCY_HIST_MAX_ENTRY];
+	latency_hist hist;
+
+	uint8_t num = latency_hist_get_keys(group, key, ARRAY_SIZE(key));
+	for (uint8_t i = 0; i < num; i++) {
+		if (!latency_hist_get(group, key[i], &hist) || (hist.count == 0)) {
+			continue;
+		}
+		shell_print(shell, "%-8s | 0x%-4x | %-10d | %-8d | <%-7d | <%-7d | %d",
+			    latency_hist_group_name[group], key[i], hist.count,
+			    (uint32_t)(hist.total_us / hist.count),
+			    latency_hist_percentile(&hist, 50), latency_hist_percentile(&hist, 99),
+			    hist.max_us);
+	}
+}
+
+void cmd_latency_show(const struct shell *shell, size_t argc, char **argv)
+{
+	uint8_t group;
+
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform latency show [group]");
+		return;
+	}
+
+	if ((argc == 2) && !get_group_arg(shell, argv[1], &group)) {
+		return;
+	}
+
+	shell_print(shell, "%-8s | %-6s | %-10s | %-8s | %-8s | %-8s | %s", "group", "key", "count",
+		    "avg(us)", "p50(us)", "p99(us)", "max(us)");
+	if (argc == 2) {
+		print_group(shell, group);
+	} else {
+		for (group = 0; group < LATENCY_HIST_GROUP_NUM; group++) {
+			print_group(shell, group);
+		}
+	}
+
+	if (latency_hist_get_dropped()) {
+		shell_warn(shell, "%d samples dropped, no free histogram",
+			   latency_hist_get_dropped());
+	}
+}
+
+void cmd_latency_hist(const struct shell *shell, size_t argc, char **argv)
+{
+	uint8_t group;
+	latency_hist hist;
+
+	if ((argc != 3) || !get_group_arg(shell, argv[1], &group)) {
+		shell_warn(shell, "Help: platform latency hist <group> <key>");
+		return;
+	}
+
+	uint16_t key = strtol(argv[2], NULL, 16);
+	if (!latency_hist_get(group, key, &hist)) {
+		shell_error(shell, "No sample of %s key 0x%x yet", argv[1], key);
+		return;
+	}
+
+	for (uint8_t i = 0; i < LATENCY_HIST_BUCKET_NUM; i++) {
+		if (hist.bucket[i] == 0) {
+			continue;
+		}
+		if (i == LATENCY_HIST_BUCKET_NUM - 1) {
+			shell_print(shell, ">= %-8d us: %d", BIT(i - 1), hist.bucket[i]);
+		} else {
+			shell_print(shell, "<  %-8d us: %d", BIT(i), hist.bucket[i]);
+		}
+	}
+}
+
+void cmd_latency_clear(const struct shell *shell, size_t argc, char **argv)
+{
+	uint8_t group = LATENCY_HIST_ALL_GROUP;
+
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform latency clear [group]");
+		return;
+	}
+
+	if ((argc == 2) && !get_group_arg(shell, argv[1], &group)) {
+		return;
+	}
+
+	latency_hist_clear(group);
+	shell_print(shell, "Cleared");
+}
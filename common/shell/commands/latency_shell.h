@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LATENCY_SHELL_H
+#define LATENCY_SHELL_H
+
+#include <shell/shell.h>
+
+void cmd_latency_show(const struct shell *shell, size_t argc, char **argv);
+void cmd_latency_hist(const struct shell *shell, size_t argc, char **argv);
+void cmd_latency_clear(const struct shell *shell, size_t argc, char **argv);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_latency_cmds,
+	SHELL_CMD(show, NULL, "Count, average, p50, p99 and max of each histogram.",
+		  cmd_latency_show),
+	SHELL_CMD(hist, NULL, "Buckets of one histogram.", cmd_latency_hist),
+	SHELL_CMD(clear, NULL, "Clear the histograms of a group or all.", cmd_latency_clear),
+	SHELL_SUBCMD_SET_END);
+
+#endif
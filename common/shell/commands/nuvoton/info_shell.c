@@ -15,7 +15,14 @@
  */
 
 #include "info_shell.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr.h>
 #include "plat_version.h"
+#include "thread_profile.h"
+#include "util_mem.h"
+#include "util_worker.h"
 #include "util_sys.h"
 
 #ifndef CONFIG_BOARD
@@ -48,3 +55,134 @@ int cmd_info_print(const struct shell *shell, size_t argc, char **argv)
 		"========================{SHELL COMMAND INFO}========================================");
 	return 0;
 }
+
+static void print_value(const struct shell *shell, const char *title, uint32_t value)
+{
+	if (value == THREAD_PROFILE_NOT_SUPPORT) {
+		shell_print(shell, "%s: not supported", title);
+	} else {
+		shell_print(shell, "%s: %d", title, value);
+	}
+}
+
+void cmd_info_thread(const struct shell *shell, size_t argc, char **argv)
+{
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform info thread [window ms]");
+		return;
+	}
+
+	uint32_t window_ms = THREAD_PROFILE_DEFAULT_WINDOW_MS;
+	if (argc == 2) {
+		window_ms = strtol(argv[1], NULL, 10);
+	}
+
+	/* A window started by the OEM command is waited for instead */
+	if (!thread_profile_is_running() && !thread_profile_start(window_ms)) {
+		shell_error(shell, "Window must be 1 to %d ms", THREAD_PROFILE_MAX_WINDOW_MS);
+		return;
+	}
+	while (thread_profile_is_running()) {
+		k_msleep(100);
+	}
+
+	thread_profile_summary summary;
+	thread_profile_entry entry;
+	if (!thread_profile_get_summary(&summary)) {
+		shell_error(shell, "Failed to get thread profile");
+		return;
+	}
+
+	shell_print(shell, "window: %d us", summary.window_us);
+	print_value(shell, "isr time(us)", summary.isr_us);
+	print_value(shell, "isr count", summary.isr_count);
+	shell_print(shell, "worker jobs: %d, latency avg: %d us, max: %d us", summary.work_count,
+		    summary.work_latency_avg_us, summary.work_latency_max_us);
+	shell_print(shell, "%-16s | %-4s | %-7s | %-10s | %-10s | %-10s | %s", "thread", "prio",
+		    "cpu(%)", "run(us)", "wakeup", "wait(us)", "stack used/size");
+	for (uint8_t i = 0; thread_profile_get_threads(i, &entry, 1) == 1; i++) {
+		if (entry.run_us == THREAD_PROFILE_NOT_SUPPORT) {
+			shell_print(shell, "%-16s | %-4d | %-7s | %-10s | %-10s | %-10s | %d/%d",
+				    entry.name, entry.priority, "-", "-", "-", "-",
+				    entry.stack_used, entry.stack_size);
+			continue;
+		}
+		shell_print(shell, "%-16s | %-4d | %3d.%02d  | %-10d | %-10d | %-10d | %d/%d",
+			    entry.name, entry.priority, entry.cpu_usage / 100,
+			    entry.cpu_usage % 100, entry.run_us, entry.wakeup_count,
+			    entry.ready_wait_avg_us, entry.stack_used, entry.stack_size);
+	}
+}
+
+void cmd_info_mem(const struct shell *shell, size_t argc, char **argv)
+{
+	util_mem_tag_stat tag_stat;
+	util_mem_pool_stat pool_stat;
+
+	shell_print(shell, "%-10s | %-10s | %-10s | %-10s | %s", "tag", "in use", "peak", "alloc",
+		    "fail");
+	for (uint8_t i = 0; i < MEM_TAG_NUM; i++) {
+		if (!util_mem_get_tag_stat(i, &tag_stat)) {
+			continue;
+		}
+		shell_print(shell, "%-10s | %-10d | %-10d | %-10d | %d", util_mem_tag_name[i],
+			    tag_stat.in_use, tag_stat.peak, tag_stat.alloc_count,
+			    tag_stat.fail_count);
+	}
+
+	shell_print(shell, "%-10s | %-10s | %-10s | %-10s | %s", "pool", "block size", "used/num",
+		    "peak", "fallback");
+	for (uint8_t i = 0; i < MEM_POOL_NUM; i++) {
+		if (!util_mem_get_pool_stat(i, &pool_stat)) {
+			continue;
+		}
+		if (i == MEM_POOL_HEAP) {
+			shell_print(shell, "%-10s | %-10s | %-10d | %-10d | %s", "heap", "-",
+				    pool_stat.used, pool_stat.peak, "-");
+			continue;
+		}
+
+		char name[16];
+		if (i == MEM_POOL_LARGE) {
+			snprintf(name, sizeof(name), "large");
+		} else {
+			snprintf(name, sizeof(name), "slab%d", i);
+		}
+		shell_print(shell, "%-10s | %-10d | %4d/%-5d | %-10d | %d", name,
+			    pool_stat.block_size, pool_stat.used, pool_stat.block_num,
+			    pool_stat.peak, pool_stat.fallback_count);
+	}
+}
+
+void cmd_info_worker(const struct shell *shell, size_t argc, char **argv)
+{
+	if ((argc > 2) || ((argc == 2) && strcmp(argv[1], "clear"))) {
+		shell_warn(shell, "Help: platform info worker [clear]");
+		return;
+	}
+
+	if (argc == 2) {
+		clear_work_stats();
+		shell_print(shell, "Worker statistics cleared");
+		return;
+	}
+
+	worker_job_stat stat;
+
+	shell_print(shell, "works: %d, peak: %d, full: %d", get_work_count(), get_work_peak_count(),
+		    get_work_full_count());
+	shell_print(shell, "%-24s | %-8s | %-6s | %-10s | %-10s | %-10s | %s", "work", "runs",
+		    "slow", "last(us)", "avg(us)", "max(us)", "late max(us)");
+	for (uint8_t i = 0; get_work_stats(i, &stat, 1) == 1; i++) {
+		char name[MAX_WORK_NAME_LEN];
+		if (stat.name[0] != '\0') {
+			snprintf(name, sizeof(name), "%s", stat.name);
+		} else {
+			snprintf(name, sizeof(name), "%p", stat.fn);
+		}
+		shell_print(shell, "%-24s | %-8d | %-6d | %-10d | %-10d | %-10d | %d", name,
+			    stat.run_count, stat.slow_count, stat.last_run_us,
+			    (uint32_t)(stat.total_run_us / MAX(stat.run_count, 1)), stat.max_run_us,
+			    stat.max_latency_us);
+	}
+}
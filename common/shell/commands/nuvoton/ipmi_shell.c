@@ -32,7 +32,7 @@ void cmd_ipmi_raw(const struct shell *shell, size_t argc, char **argv)
 	int cmd = strtol(argv[2], NULL, 16);
 	int data_len = argc - 3;
 
-	ipmi_msg_cfg msg;
+	ipmi_msg_cfg msg = { 0 };
 	msg.buffer.InF_source = SELF;
 	msg.buffer.InF_target = SELF;
 	msg.buffer.netfn = netfn;
@@ -71,7 +71,7 @@ void cmd_ipmi_list(const struct shell *shell, size_t argc, char **argv)
 	uint8_t tmp_cmd_saver[255];
 	uint8_t tmp_cmd_num = 0;
 
-	ipmi_msg_cfg msg;
+	ipmi_msg_cfg msg = { 0 };
 	msg.buffer.InF_source = SELF;
 	msg.buffer.InF_target = SELF;
 	msg.buffer.data_len = ARRAY_SIZE(dummy_msg);
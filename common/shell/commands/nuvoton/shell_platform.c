@@ -24,7 +24,7 @@
 
 /* MAIN command */
 SHELL_STATIC_SUBCMD_SET_CREATE(
-	sub_platform_cmds, SHELL_CMD(info, NULL, "Platform info.", cmd_info_print),
+	sub_platform_cmds, SHELL_CMD(info, &sub_info_cmds, "Platform info.", cmd_info_print),
 	SHELL_CMD(gpio, &sub_gpio_cmds, "GPIO relative command.", NULL),
 	SHELL_CMD(sensor, &sub_sensor_cmds, "SENSOR relative command.", NULL),
 	SHELL_CMD(flash, &sub_flash_cmds, "FLASH(spi) relative command.", NULL),
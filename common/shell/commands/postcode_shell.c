@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "postcode_shell.h"
+#include "boot_timeline.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <zephyr.h>
+
+#define SHELL_CODES_PER_READ 16
+
+#ifdef ENABLE_BOOT_TIMELINE
+static void print_boot_record(const struct shell *shell, uint8_t index)
+{
+	boot_record record;
+	uint32_t milestone[BOOT_TIMELINE_MAX_MILESTONE];
+
+	if (!boot_timeline_get_record(index, &record)) {
+		return;
+	}
+
+	uint8_t milestone_num = boot_timeline_get_milestone(milestone, ARRAY_SIZE(milestone));
+
+	shell_print(shell, "[boot %d]%s%s", index,
+		    (record.flags & BOOT_RECORD_POST_COMPLETE) ? " post complete" : "",
+		    (record.flags & BOOT_RECORD_CODE_OVERFLOW) ? " code table full" : "");
+	shell_print(shell, "* codes: %d, last code: 0x%x, last code at: %d ms", record.code_num,
+		    record.last_code, record.total_us / 1000);
+
+	uint32_t prev_us = 0;
+	for (uint8_t i = 0; i < milestone_num; i++) {
+		if (record.milestone_us[i] == BOOT_TIMELINE_NOT_SEEN) {
+			shell_print(shell, "* milestone 0x%x: not seen", milestone[i]);
+			continue;
+		}
+		shell_print(shell, "* milestone 0x%x: at %d ms, +%d ms", milestone[i],
+			    record.milestone_us[i] / 1000, (record.milestone_us[i] - prev_us) / 1000);
+		prev_us = record.milestone_us[i];
+	}
+}
+#endif
+
+void cmd_postcode_timeline(const struct shell *shell, size_t argc, char **argv)
+{
+#ifdef ENABLE_BOOT_TIMELINE
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform postcode timeline [boot index]");
+		return;
+	}
+
+	shell_print(shell, "------------------------------------");
+	if (argc == 2) {
+		print_boot_record(shell, strtol(argv[1], NULL, 10));
+	} else {
+		for (uint8_t i = 0; i < BOOT_TIMELINE_HISTORY_NUM; i++) {
+			print_boot_record(shell, i);
+		}
+	}
+	shell_print(shell, "------------------------------------");
+#else
+	shell_warn(shell, "Boot timeline is not supported");
+#endif
+}
+
+void cmd_postcode_codes(const struct shell *shell, size_t argc, char **argv)
+{
+#ifdef ENABLE_BOOT_TIMELINE
+	boot_code_record code[SHELL_CODES_PER_READ];
+	uint16_t start = 0, num;
+
+	shell_print(shell, "%-10s | %-10s | %-10s | %s", "code", "first(ms)", "last(ms)", "count");
+	while ((num = boot_timeline_get_codes(start, code, ARRAY_SIZE(code))) != 0) {
+		for (uint16_t i = 0; i < num; i++) {
+			shell_print(shell, "0x%-8x | %-10d | %-10d | %d", code[i].code,
+				    code[i].first_us / 1000, code[i].last_us / 1000, code[i].count);
+		}
+		start += num;
+	}
+#else
+	shell_warn(shell, "Boot timeline is not supported");
+#endif
+}
+
+void cmd_postcode_milestone(const struct shell *shell, size_t argc, char **argv)
+{
+#ifdef ENABLE_BOOT_TIMELINE
+	uint32_t milestone[BOOT_TIMELINE_MAX_MILESTONE];
+
+	if (argc == 1) {
+		uint8_t num = boot_timeline_get_milestone(milestone, ARRAY_SIZE(milestone));
+		for (uint8_t i = 0; i < num; i++) {
+			shell_print(shell, "* milestone %d: 0x%x", i, milestone[i]);
+		}
+		return;
+	}
+
+	if ((argc - 1) > BOOT_TIMELINE_MAX_MILESTONE) {
+		shell_warn(shell, "Help: platform postcode milestone [code1] ... [code%d]",
+			   BOOT_TIMELINE_MAX_MILESTONE);
+		return;
+	}
+
+	for (int i = 1; i < argc; i++) {
+		milestone[i - 1] = strtoul(argv[i], NULL, 16);
+	}
+
+	if (!boot_timeline_set_milestone(milestone, argc - 1)) {
+		shell_error(shell, "Failed to set milestone");
+		return;
+	}
+	shell_print(shell, "Set %d milestone, boot timeline history cleared", (int)(argc - 1));
+#else
+	shell_warn(shell, "Boot timeline is not supported");
+#endif
+}
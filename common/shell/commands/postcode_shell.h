@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef POSTCODE_SHELL_H
+#define POSTCODE_SHELL_H
+
+#include <shell/shell.h>
+
+void cmd_postcode_timeline(const struct shell *shell, size_t argc, char **argv);
+void cmd_postcode_codes(const struct shell *shell, size_t argc, char **argv);
+void cmd_postcode_milestone(const struct shell *shell, size_t argc, char **argv);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_postcode_cmds,
+	SHELL_CMD(timeline, NULL, "Boot timeline summary of the latest boots.",
+		  cmd_postcode_timeline),
+	SHELL_CMD(codes, NULL, "First and last seen time of each post code in the latest boot.",
+		  cmd_postcode_codes),
+	SHELL_CMD(milestone, NULL, "Get or set boot milestone post codes.", cmd_postcode_milestone),
+	SHELL_SUBCMD_SET_END);
+
+#endif
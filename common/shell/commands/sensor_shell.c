@@ -83,7 +83,7 @@ static sensor_cfg *sensor_get_idx_by_sensor_num(uint16_t table_idx, uint16_t sen
 			return NULL;
 		}
 
-		uint8_t cfg_count = sensor_monitor_table[table_idx].cfg_count;
+		uint16_t cfg_count = sensor_monitor_table[table_idx].cfg_count;
 
 		return find_sensor_cfg_via_sensor_num(cfg_table, cfg_count, sensor_num);
 	} else {
@@ -92,10 +92,10 @@ static sensor_cfg *sensor_get_idx_by_sensor_num(uint16_t table_idx, uint16_t sen
 	}
 }
 
-static int get_sdr_index_by_sensor_num(uint8_t sensor_num)
+static int get_sdr_index_by_sensor_num(uint16_t sensor_num)
 {
 	for (int index = 0; index < sdr_count; ++index) {
-		if (sensor_num == full_sdr_table[index].sensor_num) {
+		if (sensor_num == SDR_SENSOR_ID(&full_sdr_table[index])) {
 			return index;
 		}
 	}
@@ -224,7 +224,7 @@ void cmd_sensor_cfg_list_all_sensor(const struct shell *shell, size_t argc, char
 
 	int sdr_index = -1;
 	uint16_t table_idx = 0;
-	uint8_t sensor_idx = 0;
+	uint16_t sensor_idx = 0;
 	char *keyword = NULL;
 	if (argc == 2)
 		keyword = argv[1];
@@ -303,7 +303,7 @@ void cmd_sensor_cfg_get_table_all_sensor(const struct shell *shell, size_t argc,
 		return;
 	}
 
-	uint8_t sensor_idx = 0;
+	uint16_t sensor_idx = 0;
 	char table_name[MAX_SENSOR_NAME_LENGTH] = { 0 };
 	char check_access = ((table_access_check(table_idx) == true) ? 'O' : 'X');
 	sensor_cfg *cfg_table = sensor_monitor_table[table_idx].monitor_sensor_cfg;
@@ -355,7 +355,7 @@ void cmd_sensor_cfg_get_table_single_sensor(const struct shell *shell, size_t ar
 	}
 
 	uint8_t table_idx = strtol(argv[1], NULL, 16);
-	uint8_t sensor_num = strtol(argv[2], NULL, 16);
+	uint16_t sensor_num = strtol(argv[2], NULL, 16);
 	sensor_cfg *cfg = sensor_get_idx_by_sensor_num(table_idx, sensor_num);
 	if (cfg == NULL) {
 		shell_warn(shell, "[%s] fail to get sensor cfg, table idx: 0x%x, sensor num: 0x%x",
@@ -401,7 +401,7 @@ void cmd_control_sensor_polling(const struct shell *shell, size_t argc, char **a
 		}
 
 		uint16_t table_idx = 0;
-		uint8_t sensor_index = 0;
+		uint16_t sensor_index = 0;
 
 		for (table_idx = 0; table_idx < sensor_monitor_count; ++table_idx) {
 			sensor_cfg *cfg_table = sensor_monitor_table[table_idx].monitor_sensor_cfg;
@@ -425,7 +425,7 @@ void cmd_control_sensor_polling(const struct shell *shell, size_t argc, char **a
 	}
 
 	uint8_t table_idx = strtol(argv[1], NULL, 16);
-	uint8_t sensor_num = strtol(argv[2], NULL, 16);
+	uint16_t sensor_num = strtol(argv[2], NULL, 16);
 	uint8_t operation = strtol(argv[3], NULL, 16);
 
 	uint8_t is_set_all = 0;
@@ -450,7 +450,7 @@ void cmd_control_sensor_polling(const struct shell *shell, size_t argc, char **a
 	}
 
 	if (is_set_all) {
-		uint8_t sensor_index = 0;
+		uint16_t sensor_index = 0;
 		sensor_cfg *cfg_table = sensor_monitor_table[table_idx].monitor_sensor_cfg;
 		if (cfg_table == NULL) {
 			shell_warn(
@@ -477,3 +477,68 @@ void cmd_control_sensor_polling(const struct shell *shell, size_t argc, char **a
 		    ((operation == DISABLE_SENSOR_POLLING) ? "disable" : "enable"));
 	return;
 }
+
+void cmd_sensor_poll_stat(const struct shell *shell, size_t argc, char **argv)
+{
+	if (shell == NULL) {
+		return;
+	}
+
+	if (argc > 2) {
+		shell_warn(shell, "Help: platform sensor poll_stat <stale_ms(optional)>");
+		return;
+	}
+
+	sensor_poll_stat stat;
+	get_sensor_poll_stat(&stat);
+
+	shell_print(shell, "sweep: %d, last: %d us, max: %d us", stat.sweep_count,
+		    stat.last_sweep_us, stat.max_sweep_us);
+	shell_print(shell, "last sweep sensor read: %d, i2c attempt: %d", stat.last_read_count,
+		    stat.last_i2c_count);
+	shell_print(shell, "max cache update gap: %d ms", stat.max_update_gap_ms);
+
+	if (argc != 2) {
+		return;
+	}
+
+	/* Sensors whose cache is older than stale_ms, or never read with access */
+	uint32_t stale_ms = strtoul(argv[1], NULL, 10);
+	int64_t now = k_uptime_get();
+
+	shell_print(shell, "%-5s | %-6s | %-10s | %s", "table", "sensor", "age(ms)", "status");
+	for (uint16_t table_idx = 0; table_idx < sensor_monitor_count; ++table_idx) {
+		sensor_cfg *cfg_table = sensor_monitor_table[table_idx].monitor_sensor_cfg;
+		uint16_t cfg_count = sensor_monitor_table[table_idx].cfg_count;
+		if (cfg_table == NULL) {
+			continue;
+		}
+
+		for (uint16_t sensor_idx = 0; sensor_idx < cfg_count; ++sensor_idx) {
+			sensor_cfg *cfg = &cfg_table[sensor_idx];
+			if ((cfg->cache_status == SENSOR_NOT_PRESENT) ||
+			    (cfg->is_enable_polling == DISABLE_SENSOR_POLLING)) {
+				continue;
+			}
+
+			if (cfg->update_time_ms == 0) {
+				shell_print(shell, "0x%-3x | 0x%-4x | %-10s | 0x%x", table_idx,
+					    cfg->num, "none", cfg->cache_status);
+			} else if ((now - cfg->update_time_ms) > stale_ms) {
+				shell_print(shell, "0x%-3x | 0x%-4x | %-10d | 0x%x", table_idx,
+					    cfg->num, (uint32_t)(now - cfg->update_time_ms),
+					    cfg->cache_status);
+			}
+		}
+	}
+}
+
+void cmd_sensor_clear_poll_stat(const struct shell *shell, size_t argc, char **argv)
+{
+	if (shell == NULL) {
+		return;
+	}
+
+	clear_sensor_poll_stat();
+	shell_print(shell, "Cleared");
+}
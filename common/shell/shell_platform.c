@@ -21,16 +21,24 @@
 #include "commands/ipmi_shell.h"
 #include "commands/power_shell.h"
 #include "commands/pldm_shell.h"
+#include "commands/postcode_shell.h"
+#include "commands/i2c_shell.h"
+#include "commands/latency_shell.h"
+#include "commands/bench_shell.h"
 
 /* MAIN command */
 SHELL_STATIC_SUBCMD_SET_CREATE(
-	sub_platform_cmds, SHELL_CMD(info, NULL, "Platform info.", cmd_info_print),
+	sub_platform_cmds, SHELL_CMD(info, &sub_info_cmds, "Platform info.", cmd_info_print),
 	SHELL_CMD(gpio, &sub_gpio_cmds, "GPIO relative command.", NULL),
 	SHELL_CMD(sensor, &sub_sensor_cmds, "SENSOR relative command.", NULL),
 	SHELL_CMD(flash, &sub_flash_cmds, "FLASH(spi) relative command.", NULL),
 	SHELL_CMD(ipmi, &sub_ipmi_cmds, "IPMI relative command.", NULL),
 	SHELL_CMD(power, &sub_power_cmds, "POWER relative command.", NULL),
 	SHELL_CMD(pldm, &sub_pldm_cmds, "PLDM over MCTP relative command.", NULL),
+	SHELL_CMD(postcode, &sub_postcode_cmds, "POST code relative command.", NULL),
+	SHELL_CMD(i2c, &sub_i2c_cmds, "I2C health and scheduler relative command.", NULL),
+	SHELL_CMD(latency, &sub_latency_cmds, "Hot path latency histogram relative command.", NULL),
+	SHELL_CMD(bench, &sub_bench_cmds, "Benchmark of the message and sensor cores.", NULL),
 	SHELL_SUBCMD_SET_END);
 
 SHELL_CMD_REGISTER(platform, &sub_platform_cmds, "Platform commands", NULL);
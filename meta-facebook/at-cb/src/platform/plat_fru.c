@@ -413,6 +413,12 @@ void pal_load_fru_config(void)
 	memcpy(&fru_config, &plat_fru_config, sizeof(plat_fru_config));
 }
 
+/* Accelerator cards are hot-pluggable */
+bool pal_is_fru_cacheable(uint8_t fru_id)
+{
+	return (fru_id == CB_FRU_ID) || (fru_id == FIO_FRU_ID);
+}
+
 bool pal_accl_fru_id_map_accl_id_dev_id(uint8_t accl_fru_id, uint8_t *accl_id, uint8_t *dev_id)
 {
 	CHECK_NULL_ARG_WITH_RETURN(accl_id, false);
@@ -765,41 +765,57 @@ bool post_pex89000_read(sensor_cfg *cfg, void *args, int *reading)
 	return true;
 }
 
-bool pre_accl_mux_switch(uint8_t sensor_num, void *arg)
+bool post_accl_mux_switch(uint16_t sensor_num, void *arg)
 {
 	CHECK_NULL_ARG_WITH_RETURN(arg, false);
 
-	bool ret = false;
 	mux_config accl_mux = { 0 };
-	mux_config channel_mux = { 0 };
 	uint8_t *card_id = (uint8_t *)arg;
 
 	if (get_accl_mux_config(*card_id, &accl_mux) != true) {
 		return false;
 	}
 
-	if (get_mux_channel_config(*card_id, sensor_num, &channel_mux) != true) {
+	int unlock_status = 0;
+	struct k_mutex *mutex = get_i2c_mux_mutex(accl_mux.bus);
+	if (mutex->lock_count != 0) {
+		unlock_status = k_mutex_unlock(mutex);
+	}
+
+	if (unlock_status != 0) {
+		LOG_ERR("Mutex unlock fail, status: %d", unlock_status);
 		return false;
 	}
 
-	int mutex_status = 0;
-	struct k_mutex *mutex = get_i2c_mux_mutex(accl_mux.bus);
+	return true;
+}
 
-	mutex_status = k_mutex_lock(mutex, K_MSEC(MUTEX_LOCK_INTERVAL_MS));
-	if (mutex_status != 0) {
-		LOG_ERR("Mutex lock fail, status: %d", mutex_status);
+/* An ACCL table session takes the mux mutex and switches the card mux once for all the due
+ * sensors of the card, the channel mux behind it is only rewritten when the channel changes.
+ */
+static mux_config accl_session_channel = { 0 };
+static bool is_accl_session_channel_valid = false;
+
+bool enter_accl_mux_table(void *arg)
+{
+	CHECK_NULL_ARG_WITH_RETURN(arg, false);
+
+	mux_config accl_mux = { 0 };
+	uint8_t *card_id = (uint8_t *)arg;
+
+	if (get_accl_mux_config(*card_id, &accl_mux) != true) {
 		return false;
 	}
 
-	ret = set_mux_channel(accl_mux, MUTEX_LOCK_ENABLE);
-	if (ret == false) {
-		LOG_ERR("ACCL switch mux fail");
-		k_mutex_unlock(mutex);
+	struct k_mutex *mutex = get_i2c_mux_mutex(accl_mux.bus);
+	int mutex_status = k_mutex_lock(mutex, K_MSEC(MUTEX_LOCK_INTERVAL_MS));
+	if (mutex_status != 0) {
+		LOG_ERR("Mutex lock fail, status: %d", mutex_status);
 		return false;
 	}
 
-	ret = set_mux_channel(channel_mux, MUTEX_LOCK_ENABLE);
-	if (ret == false) {
+	is_accl_session_channel_valid = false;
+	if (set_mux_channel(accl_mux, MUTEX_LOCK_ENABLE) == false) {
 		LOG_ERR("ACCL switch mux fail");
 		k_mutex_unlock(mutex);
 		return false;
@@ -808,28 +824,37 @@ bool pre_accl_mux_switch(uint8_t sensor_num, void *arg)
 	return true;
 }
 
-bool post_accl_mux_switch(uint8_t sensor_num, void *arg)
+bool leave_accl_mux_table(void *arg)
+{
+	is_accl_session_channel_valid = false;
+	return post_accl_mux_switch(0, arg);
+}
+
+bool pre_accl_channel_switch(uint16_t sensor_num, void *arg)
 {
 	CHECK_NULL_ARG_WITH_RETURN(arg, false);
 
-	mux_config accl_mux = { 0 };
+	mux_config channel_mux = { 0 };
 	uint8_t *card_id = (uint8_t *)arg;
 
-	if (get_accl_mux_config(*card_id, &accl_mux) != true) {
+	if (get_mux_channel_config(*card_id, sensor_num, &channel_mux) != true) {
 		return false;
 	}
 
-	int unlock_status = 0;
-	struct k_mutex *mutex = get_i2c_mux_mutex(accl_mux.bus);
-	if (mutex->lock_count != 0) {
-		unlock_status = k_mutex_unlock(mutex);
+	if (is_accl_session_channel_valid && (accl_session_channel.bus == channel_mux.bus) &&
+	    (accl_session_channel.target_addr == channel_mux.target_addr) &&
+	    (accl_session_channel.channel == channel_mux.channel)) {
+		return true;
 	}
 
-	if (unlock_status != 0) {
-		LOG_ERR("Mutex unlock fail, status: %d", unlock_status);
+	if (set_mux_channel(channel_mux, MUTEX_LOCK_ENABLE) == false) {
+		LOG_ERR("ACCL switch channel mux fail");
+		is_accl_session_channel_valid = false;
 		return false;
 	}
 
+	accl_session_channel = channel_mux;
+	is_accl_session_channel_valid = true;
 	return true;
 }
 
@@ -56,8 +56,10 @@ bool pre_pex89000_read(sensor_cfg *cfg, void *args);
 bool post_pex89000_read(sensor_cfg *cfg, void *args, int *reading);
 bool pre_xdpe15284_read(sensor_cfg *cfg, void *args);
 bool post_xdpe15284_read(sensor_cfg *cfg, void *args, int *reading);
-bool pre_accl_mux_switch(uint8_t sensor_num, void *arg);
-bool post_accl_mux_switch(uint8_t sensor_num, void *arg);
+bool post_accl_mux_switch(uint16_t sensor_num, void *arg);
+bool enter_accl_mux_table(void *arg);
+bool leave_accl_mux_table(void *arg);
+bool pre_accl_channel_switch(uint16_t sensor_num, void *arg);
 bool pre_accl_nvme_read(sensor_cfg *cfg, void *args);
 
 #endif
@@ -1380,41 +1380,53 @@ const int ACCL_SENSOR_CONFIG_SIZE = ARRAY_SIZE(plat_accl1_sensor_config);
 
 sensor_monitor_table_info plat_monitor_table[] = {
 	{ plat_accl1_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_1,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[0],
-	  (void *)&plat_monitor_table_arg[0], "ACCL 1 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[0],
+	  (void *)&plat_monitor_table_arg[0], "ACCL 1 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl2_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_2,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[1],
-	  (void *)&plat_monitor_table_arg[1], "ACCL 2 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[1],
+	  (void *)&plat_monitor_table_arg[1], "ACCL 2 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl3_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_3,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[2],
-	  (void *)&plat_monitor_table_arg[2], "ACCL 3 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[2],
+	  (void *)&plat_monitor_table_arg[2], "ACCL 3 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl4_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_4,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[3],
-	  (void *)&plat_monitor_table_arg[3], "ACCL 4 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[3],
+	  (void *)&plat_monitor_table_arg[3], "ACCL 4 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl5_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_5,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[4],
-	  (void *)&plat_monitor_table_arg[4], "ACCL 5 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[4],
+	  (void *)&plat_monitor_table_arg[4], "ACCL 5 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl6_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_6,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[5],
-	  (void *)&plat_monitor_table_arg[5], "ACCL 6 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[5],
+	  (void *)&plat_monitor_table_arg[5], "ACCL 6 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl7_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_7,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[6],
-	  (void *)&plat_monitor_table_arg[6], "ACCL 7 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[6],
+	  (void *)&plat_monitor_table_arg[6], "ACCL 7 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl8_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_8,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[7],
-	  (void *)&plat_monitor_table_arg[7], "ACCL 8 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[7],
+	  (void *)&plat_monitor_table_arg[7], "ACCL 8 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl9_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_9,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[8],
-	  (void *)&plat_monitor_table_arg[8], "ACCL 9 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[8],
+	  (void *)&plat_monitor_table_arg[8], "ACCL 9 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl10_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_10,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[9],
-	  (void *)&plat_monitor_table_arg[9], "ACCL 10 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[9],
+	  (void *)&plat_monitor_table_arg[9], "ACCL 10 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl11_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_11,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[10],
-	  (void *)&plat_monitor_table_arg[10], "ACCL 11 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[10],
+	  (void *)&plat_monitor_table_arg[10], "ACCL 11 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 	{ plat_accl12_sensor_config, ACCL_SENSOR_CONFIG_SIZE, is_pcie_device_access, PCIE_CARD_12,
-	  pre_accl_mux_switch, post_accl_mux_switch, (void *)&plat_monitor_table_arg[11],
-	  (void *)&plat_monitor_table_arg[11], "ACCL 12 sensor table" },
+	  pre_accl_channel_switch, NULL, (void *)&plat_monitor_table_arg[11],
+	  (void *)&plat_monitor_table_arg[11], "ACCL 12 sensor table", enter_accl_mux_table,
+	  leave_accl_mux_table },
 };
 
 bool accl_card_init_status[] = { false, false, false, false, false, false,
@@ -1429,7 +1441,7 @@ void load_sensor_config(void)
 	pal_extend_sensor_config();
 }
 
-uint8_t pal_get_extend_sensor_config()
+uint16_t pal_get_extend_sensor_config()
 {
 	uint8_t extend_sensor_config_size = 0;
 	uint8_t hsc_module = get_hsc_module();
@@ -1598,7 +1610,7 @@ bool is_accl_power_good(uint8_t card_id)
 	return (msg.data[0] & power_good_bit);
 }
 
-bool is_dc_access(uint8_t sensor_num)
+bool is_dc_access(uint16_t sensor_num)
 {
 	return is_acb_power_good();
 }
@@ -1626,11 +1638,12 @@ bool is_pcie_device_access(uint8_t card_id)
 		is_power_good = is_accl_power_good(card_id);
 
 		if (is_power_good) {
-			if (accl_card_init_status[card_id] == false) {
+			if ((accl_card_init_status[card_id] == false) &&
+			    (enter_accl_mux_table((void *)&card_id) == true)) {
 				for (index = 0; index < cfg_count; ++index) {
 					sensor_cfg *cfg = &cfg_table[index];
 
-					if (pre_accl_mux_switch(cfg->num, (void *)&card_id) !=
+					if (pre_accl_channel_switch(cfg->num, (void *)&card_id) !=
 					    true) {
 						LOG_ERR("Fail to pre-switch ACCL mux to check access, card id: 0x%x",
 							card_id);
@@ -1638,15 +1651,13 @@ bool is_pcie_device_access(uint8_t card_id)
 					}
 
 					if (init_drive_type_delayed(cfg) != true) {
-						post_accl_mux_switch(cfg->num, (void *)&card_id);
 						break;
 					}
+				}
 
-					if (post_accl_mux_switch(cfg->num, (void *)&card_id) !=
-					    true) {
-						LOG_ERR("Fail to post-switch ACCL mux to check access, card id: 0x%x",
-							card_id);
-					}
+				if (leave_accl_mux_table((void *)&card_id) != true) {
+					LOG_ERR("Fail to post-switch ACCL mux to check access, card id: 0x%x",
+						card_id);
 				}
 
 				if (index >= cfg_count) {
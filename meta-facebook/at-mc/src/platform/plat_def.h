@@ -22,4 +22,9 @@
 #define ENABLE_PM8702
 #define FW_UPDATE_RETRY_MAX_COUNT 4
 
+/* 64K SPI update buffer of fw_update() plus the region overhead, the malloc arena no longer
+ * needs room for it
+ */
+#define UTIL_MEM_LARGE_REGION_SIZE 0x10400
+
 #endif
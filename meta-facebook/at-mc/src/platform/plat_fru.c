@@ -145,6 +145,12 @@ void pal_load_fru_config(void)
 	memcpy(&fru_config, &plat_fru_config, sizeof(plat_fru_config));
 }
 
+/* CXL cards are hot-pluggable and the debug config is written without FRU_write */
+bool pal_is_fru_cacheable(uint8_t fru_id)
+{
+	return (fru_id == MC_FRU_ID);
+}
+
 uint8_t pal_cxl_map_mux0_channel(uint8_t cxl_fru_id)
 {
 	uint8_t channel = 0;
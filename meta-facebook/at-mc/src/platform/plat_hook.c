@@ -670,7 +670,7 @@ bool post_sq52205_read(sensor_cfg *cfg, void *args, int *reading)
 	return true;
 }
 
-bool pre_cxl_switch_mux(uint8_t sensor_num, void *arg)
+bool pre_cxl_switch_mux(uint16_t sensor_num, void *arg)
 {
 	CHECK_NULL_ARG_WITH_RETURN(arg, false);
 
@@ -710,7 +710,7 @@ bool pre_cxl_switch_mux(uint8_t sensor_num, void *arg)
 	return true;
 }
 
-bool post_cxl_switch_mux(uint8_t sensor_num, void *arg)
+bool post_cxl_switch_mux(uint16_t sensor_num, void *arg)
 {
 	ARG_UNUSED(arg);
 
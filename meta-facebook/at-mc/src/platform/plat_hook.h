@@ -58,8 +58,8 @@ bool pre_nvme_read(sensor_cfg *cfg, void *args);
 bool post_nvme_read(sensor_cfg *cfg, void *args, int *reading);
 bool pre_sq52205_read(sensor_cfg *cfg, void *args);
 bool post_sq52205_read(sensor_cfg *cfg, void *args, int *reading);
-bool pre_cxl_switch_mux(uint8_t sensor_num, void *arg);
-bool post_cxl_switch_mux(uint8_t sensor_num, void *arg);
+bool pre_cxl_switch_mux(uint16_t sensor_num, void *arg);
+bool post_cxl_switch_mux(uint16_t sensor_num, void *arg);
 bool pre_cxl_vr_read(sensor_cfg *cfg, void *args);
 bool post_cxl_xdpe12284c_read(sensor_cfg *cfg, void *args, int *reading);
 bool pre_pm8702_read(sensor_cfg *cfg, void *args);
@@ -3041,7 +3041,7 @@ const int SDR_TABLE_SIZE = ARRAY_SIZE(plat_sdr_table);
 const int HSC_SDR_TABLE_SIZE = ARRAY_SIZE(plat_hsc_sdr_table);
 const int EVT2_EXTAND_SDR_TABLE_SIZE = ARRAY_SIZE(evt2_extand_sdr_table);
 
-uint8_t pal_get_extend_sdr()
+uint16_t pal_get_extend_sdr()
 {
 	uint8_t extend_sdr_table_size = 0;
 	uint8_t board_revision = get_board_revision();
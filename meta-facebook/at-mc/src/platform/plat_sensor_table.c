@@ -1760,7 +1760,7 @@ void load_sensor_config(void)
 	pal_extend_sensor_config();
 }
 
-uint8_t pal_get_extend_sensor_config()
+uint16_t pal_get_extend_sensor_config()
 {
 	uint8_t extend_sensor_config_size = 0;
 
@@ -1819,12 +1819,12 @@ sensor_cfg *get_cxl_sensor_cfg_info(uint8_t cxl_id, uint8_t *cfg_count)
 	return cfg;
 }
 
-bool is_dc_access(uint8_t sensor_num)
+bool is_dc_access(uint16_t sensor_num)
 {
 	return get_DC_status();
 }
 
-bool is_e1s_access(uint8_t sensor_num)
+bool is_e1s_access(uint16_t sensor_num)
 {
 	int ret = false;
 	uint8_t card_id = 0;
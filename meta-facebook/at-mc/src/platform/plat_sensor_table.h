@@ -168,8 +168,8 @@
 extern const int CXL_SENSOR_CONFIG_SIZE;
 
 void load_sensor_config(void);
-bool is_dc_access(uint8_t sensor_num);
-bool is_e1s_access(uint8_t sensor_num);
+bool is_dc_access(uint16_t sensor_num);
+bool is_e1s_access(uint16_t sensor_num);
 bool is_cxl_access(uint8_t cxl_id);
 struct k_mutex *get_i2c_mux_mutex(uint8_t i2c_bus);
 bool get_pcie_card_mux_config(uint8_t cxl_id, uint8_t sensor_num, mux_config *card_mux_cfg,
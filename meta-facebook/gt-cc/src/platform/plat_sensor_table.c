@@ -1420,7 +1420,7 @@ void pal_extend_sensor_config()
 	}
 }
 
-uint8_t pal_get_extend_sensor_config()
+uint16_t pal_get_extend_sensor_config()
 {
 	uint8_t extend_sensor_config_size = 0;
 	uint8_t stage = get_stage_by_rev_id();
@@ -1605,7 +1605,7 @@ static int check_vr_type(void)
 	return -1;
 }
 
-bool is_e1s_access(uint8_t sensor_num)
+bool is_e1s_access(uint16_t sensor_num)
 {
 	uint8_t group = (sensor_num >> 4) % 8;
 	uint8_t index = ((sensor_num & BIT_MASK(4)) / 4);
@@ -1613,14 +1613,14 @@ bool is_e1s_access(uint8_t sensor_num)
 	return (!gpio_get(e1s_prsnt_pin[group][index]) && is_mb_dc_on());
 }
 
-bool is_nic_access(uint8_t sensor_num)
+bool is_nic_access(uint16_t sensor_num)
 {
 	uint8_t pin_index = ((sensor_num >> 4) * 3) + ((sensor_num & BIT_MASK(4)) / 5);
 
 	return !gpio_get(nic_prsnt_pin[pin_index]) ? true : false;
 }
 
-bool is_dc_access(uint8_t sensor_num)
+bool is_dc_access(uint16_t sensor_num)
 {
 	return is_mb_dc_on();
 }
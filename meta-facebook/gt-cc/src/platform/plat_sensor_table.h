@@ -273,10 +273,10 @@
 #define SENSOR_NUM_VR_TYPE 0xF1
 #define SENSOR_NUM_ADC_TYPE 0xF2
 
-uint8_t plat_get_config_size();
+uint16_t plat_get_config_size();
 void load_sensor_config(void);
-bool is_e1s_access(uint8_t sensor_num);
-bool is_nic_access(uint8_t sensor_num);
-bool is_dc_access(uint8_t sensor_num);
+bool is_e1s_access(uint16_t sensor_num);
+bool is_nic_access(uint16_t sensor_num);
+bool is_dc_access(uint16_t sensor_num);
 
 #endif
@@ -18,6 +18,7 @@
 #include <stdlib.h>
 #include <logging/log.h>
 #include "ipmi.h"
+#include "i2c_scheduler.h"
 #include "libutil.h"
 #include "pt5161l.h"
 #include "m88rt51632.h"
@@ -65,14 +66,12 @@ void OEM_1S_GET_SET_M2(ipmi_msg *msg)
 	switch (action) {
 	case DEVICE_POWER_OFF:
 		notify_cpld_e1s_present(device_index, GPIO_HIGH);
-		abort_e1s_power_thread(device_index);
-		e1s_power_off_thread(device_index);
+		start_e1s_power_off_sequence(device_index);
 		msg->completion_code = CC_SUCCESS;
 		break;
 	case DEVICE_POWER_ON:
 		notify_cpld_e1s_present(device_index, GPIO_LOW);
-		abort_e1s_power_thread(device_index);
-		e1s_power_on_thread(device_index, E1S_POWER_ON_STAGE0);
+		start_e1s_power_on_sequence(device_index, E1S_POWER_ON_STAGE0);
 		msg->completion_code = CC_SUCCESS;
 		break;
 	case DEVICE_PRESENT:
@@ -230,6 +229,7 @@ void OEM_1S_FW_UPDATE(ipmi_msg *msg)
 		I2C_MSG i2c_msg;
 		i2c_msg.bus = I2C_BUS4;
 		i2c_msg.target_addr = EXPA_RETIMER_ADDR;
+		uint8_t i2c_prio = i2c_sched_set_thread_prio(I2C_SCHED_PRIO_BULK);
 
 		switch (retimer_type) {
 		case RETIMER_TYPE_PT5161L:
@@ -244,6 +244,7 @@ void OEM_1S_FW_UPDATE(ipmi_msg *msg)
 			LOG_ERR("firmware update unknown pcie retimer type");
 			break;
 		}
+		i2c_sched_set_thread_prio(i2c_prio);
 		break;
 	default:
 		msg->completion_code = CC_INVALID_DATA_FIELD;
@@ -296,8 +297,7 @@ void OEM_1S_PRE_POWER_OFF_CONTROL(ipmi_msg *msg)
 	}
 
 	if (gpio_get(FM_EXP_MAIN_PWR_EN) == GPIO_HIGH) {
-		abort_power_thread();
-		init_power_off_thread();
+		start_power_off_sequence(E1S_POWER_OFF_START);
 		msg->completion_code = CC_SUCCESS;
 	} else {
 		LOG_ERR("Already power off");
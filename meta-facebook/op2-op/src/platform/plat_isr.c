@@ -16,7 +16,6 @@
 
 #include <zephyr.h>
 #include <stdio.h>
-#include <string.h>
 #include <stdlib.h>
 #include <logging/log.h>
 #include "ipmi.h"
@@ -36,10 +35,6 @@
 
 LOG_MODULE_REGISTER(plat_isr);
 
-K_THREAD_STACK_DEFINE(power_thread, POWER_SEQ_CTRL_STACK_SIZE);
-struct k_thread power_thread_handler;
-k_tid_t power_tid;
-
 static bool is_e1s_P12V_fault_assert[MAX_E1S_IDX] = { false, false, false, false, false };
 static bool is_e1s_P3V3_fault_assert[MAX_E1S_IDX] = { false, false, false, false, false };
 
@@ -81,52 +76,15 @@ void control_power_sequence()
 {
 	if (gpio_get(FM_EXP_MAIN_PWR_EN) == POWER_ON) { // op power on
 		if (!is_all_sequence_done(POWER_ON)) {
-			abort_power_thread();
-			init_power_on_thread(BOARD_POWER_ON_STAGE0);
+			start_power_on_sequence(BOARD_POWER_ON_STAGE0);
 		}
 	} else { // op power off
 		if (!is_all_sequence_done(POWER_OFF)) {
-			abort_power_thread();
-			init_power_off_thread();
+			start_power_off_sequence(E1S_POWER_OFF_START);
 		}
 	}
 }
 
-void init_power_on_thread(uint8_t initial_stage)
-{
-	// Avoid re-create thread by checking thread status and thread id
-	if (power_tid != NULL && strcmp(k_thread_state_str(power_tid), "dead") != 0) {
-		return;
-	}
-
-	int stage = initial_stage + 1;
-	power_tid = k_thread_create(&power_thread_handler, power_thread,
-				    K_THREAD_STACK_SIZEOF(power_thread), control_power_on_sequence,
-				    (void *)stage, NULL, NULL, CONFIG_MAIN_THREAD_PRIORITY, 0,
-				    K_NO_WAIT);
-	k_thread_name_set(&power_thread_handler, "power_on_sequence_thread");
-}
-
-void init_power_off_thread()
-{
-	// Avoid re-create thread by checking thread status and thread id
-	if (power_tid != NULL && strcmp(k_thread_state_str(power_tid), "dead") != 0) {
-		return;
-	}
-
-	power_tid = k_thread_create(&power_thread_handler, power_thread,
-				    K_THREAD_STACK_SIZEOF(power_thread), control_power_off_sequence,
-				    NULL, NULL, NULL, CONFIG_MAIN_THREAD_PRIORITY, 0, K_NO_WAIT);
-	k_thread_name_set(&power_thread_handler, "power_off_sequence_thread");
-}
-
-void abort_power_thread()
-{
-	if (power_tid != NULL && strcmp(k_thread_state_str(power_tid), "dead") != 0) {
-		k_thread_abort(power_tid);
-	}
-}
-
 void ISR_FM_EXP_MAIN_PWR_EN()
 {
 	set_DC_status(FM_EXP_MAIN_PWR_EN);
@@ -139,11 +97,9 @@ void ISR_CPU_PCIE_PERST()
 	uint8_t gpio_num =
 		(card_type == CARD_TYPE_OPA) ? OPA_RST_PCIE_EXP_PERST0_N : OPB_RST_CPLD_PERST1_N;
 	if (gpio_get(gpio_num) == GPIO_HIGH) {
-		abort_power_thread();
-		init_power_on_thread(RETIMER_POWER_ON_STAGE1);
+		start_power_on_sequence(RETIMER_POWER_ON_STAGE1);
 	} else {
-		abort_cpu_perst_low_thread();
-		cpu_perst_low_thread();
+		control_cpu_perst_low();
 	}
 }
 
@@ -197,14 +153,12 @@ void ISR_E1S_0_PRSNT_N()
 		send_system_status_event(IPMI_EVENT_TYPE_SENSOR_SPECIFIC,
 					 IPMI_EVENT_OFFSET_STS_E1S_PRESENT, E1S_0);
 
-		abort_e1s_power_thread(E1S_0);
-		e1s_power_on_thread(E1S_0, E1S_POWER_ON_STAGE0);
+		start_e1s_power_on_sequence(E1S_0, E1S_POWER_ON_STAGE0);
 	} else {
 		send_system_status_event(IPMI_OEM_EVENT_TYPE_DEASSERT,
 					 IPMI_EVENT_OFFSET_STS_E1S_PRESENT, E1S_0);
 
-		abort_e1s_power_thread(E1S_0);
-		e1s_power_off_thread(E1S_0);
+		start_e1s_power_off_sequence(E1S_0);
 	}
 }
 
@@ -216,14 +170,12 @@ void ISR_E1S_1_PRSNT_N()
 		send_system_status_event(IPMI_EVENT_TYPE_SENSOR_SPECIFIC,
 					 IPMI_EVENT_OFFSET_STS_E1S_PRESENT, E1S_1);
 
-		abort_e1s_power_thread(E1S_1);
-		e1s_power_on_thread(E1S_1, E1S_POWER_ON_STAGE0);
+		start_e1s_power_on_sequence(E1S_1, E1S_POWER_ON_STAGE0);
 	} else {
 		send_system_status_event(IPMI_OEM_EVENT_TYPE_DEASSERT,
 					 IPMI_EVENT_OFFSET_STS_E1S_PRESENT, E1S_1);
 
-		abort_e1s_power_thread(E1S_1);
-		e1s_power_off_thread(E1S_1);
+		start_e1s_power_off_sequence(E1S_1);
 	}
 }
 
@@ -235,14 +187,12 @@ void ISR_E1S_2_PRSNT_N()
 		send_system_status_event(IPMI_EVENT_TYPE_SENSOR_SPECIFIC,
 					 IPMI_EVENT_OFFSET_STS_E1S_PRESENT, E1S_2);
 
-		abort_e1s_power_thread(E1S_2);
-		e1s_power_on_thread(E1S_2, E1S_POWER_ON_STAGE0);
+		start_e1s_power_on_sequence(E1S_2, E1S_POWER_ON_STAGE0);
 	} else {
 		send_system_status_event(IPMI_OEM_EVENT_TYPE_DEASSERT,
 					 IPMI_EVENT_OFFSET_STS_E1S_PRESENT, E1S_2);
 
-		abort_e1s_power_thread(E1S_2);
-		e1s_power_off_thread(E1S_2);
+		start_e1s_power_off_sequence(E1S_2);
 	}
 }
 
@@ -253,14 +203,12 @@ void ISR_E1S_3_PRSNT_N()
 		send_system_status_event(IPMI_EVENT_TYPE_SENSOR_SPECIFIC,
 					 IPMI_EVENT_OFFSET_STS_E1S_PRESENT, E1S_3);
 
-		abort_e1s_power_thread(E1S_3);
-		e1s_power_on_thread(E1S_3, E1S_POWER_ON_STAGE0);
+		start_e1s_power_on_sequence(E1S_3, E1S_POWER_ON_STAGE0);
 	} else {
 		send_system_status_event(IPMI_OEM_EVENT_TYPE_DEASSERT,
 					 IPMI_EVENT_OFFSET_STS_E1S_PRESENT, E1S_3);
 
-		abort_e1s_power_thread(E1S_3);
-		e1s_power_off_thread(E1S_3);
+		start_e1s_power_off_sequence(E1S_3);
 	}
 }
 
@@ -271,13 +219,11 @@ void ISR_E1S_4_PRSNT_N()
 		send_system_status_event(IPMI_EVENT_TYPE_SENSOR_SPECIFIC,
 					 IPMI_EVENT_OFFSET_STS_E1S_PRESENT, E1S_4);
 
-		abort_e1s_power_thread(E1S_4);
-		e1s_power_on_thread(E1S_4, E1S_POWER_ON_STAGE0);
+		start_e1s_power_on_sequence(E1S_4, E1S_POWER_ON_STAGE0);
 	} else {
 		send_system_status_event(IPMI_OEM_EVENT_TYPE_DEASSERT,
 					 IPMI_EVENT_OFFSET_STS_E1S_PRESENT, E1S_4);
 
-		abort_e1s_power_thread(E1S_4);
-		e1s_power_off_thread(E1S_4);
+		start_e1s_power_off_sequence(E1S_4);
 	}
 }
@@ -28,9 +28,6 @@ enum INA233_ALERT_INDEX {
 };
 
 void control_power_sequence();
-void init_power_on_thread(uint8_t initial_stage);
-void init_power_off_thread();
-void abort_power_thread();
 void ISR_FM_EXP_MAIN_PWR_EN();
 void ISR_CPU_PCIE_PERST();
 void ISR_E1S_0_INA233_ALERT();
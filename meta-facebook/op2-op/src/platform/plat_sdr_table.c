@@ -2320,7 +2320,7 @@ void pal_change_sdr_config_number_and_name(void)
 	}
 }
 
-uint8_t pal_get_extend_sdr()
+uint16_t pal_get_extend_sdr()
 {
 	uint8_t extend_sdr_table_size = 0;
 	uint8_t card_type = get_card_type();
@@ -30,8 +30,8 @@
 
 LOG_MODULE_REGISTER(plat_sensor);
 
-bool e1s_access(uint8_t sensor_num);
-bool retimer_access(uint8_t sensor_num);
+bool e1s_access(uint16_t sensor_num);
+bool retimer_access(uint16_t sensor_num);
 
 sensor_cfg plat_sensor_config[] = {
 	/*  number,
@@ -353,7 +353,7 @@ void load_sensor_config(void)
 	}
 }
 
-uint8_t pal_get_extend_sensor_config()
+uint16_t pal_get_extend_sensor_config()
 {
 	uint8_t extend_sensor_table_size = 0;
 	uint8_t card_type = get_card_type();
@@ -541,12 +541,12 @@ void pal_extend_sensor_config()
 		break;
 	}
 }
-bool retimer_access(uint8_t sensor_num)
+bool retimer_access(uint16_t sensor_num)
 {
 	return is_retimer_done();
 }
 
-bool e1s_access(uint8_t sensor_num)
+bool e1s_access(uint16_t sensor_num)
 {
 	sensor_cfg *sensor_cfgs = &sensor_config[sensor_config_index_map[sensor_num]];
 	uint8_t e1s_index = 0xff;
@@ -203,7 +203,7 @@ enum SENSOR_NUM {
 void pal_change_sensor_config_number(void);
 void pal_extend_sensor_config(void);
 void load_sensor_config(void);
-uint8_t pal_get_extend_sensor_config(void);
+uint16_t pal_get_extend_sensor_config(void);
 void change_ina233_sensor_addr(void);
 void change_power_monitor_config_for_sq5220x(void);
 int check_pwr_monitor_type(void);
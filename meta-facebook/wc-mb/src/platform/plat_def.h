@@ -22,4 +22,9 @@
 
 #define BMC_USB_PORT "CDC_ACM_0"
 
+/* 64K SPI update buffer of fw_update() plus the region overhead, the malloc arena no longer
+ * needs room for it
+ */
+#define UTIL_MEM_LARGE_REGION_SIZE 0x10400
+
 #endif
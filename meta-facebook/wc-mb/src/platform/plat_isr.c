@@ -21,6 +21,8 @@
 #include "power_status.h"
 #include "sensor.h"
 #include "snoop.h"
+#include "boot_timeline.h"
+#include "libutil.h"
 #include "plat_gpio.h"
 #include "plat_ipmi.h"
 #include "plat_sensor_table.h"
@@ -576,3 +578,18 @@ void ISR_SMI()
 		}
 	}
 }
+
+#ifdef ENABLE_BOOT_TIMELINE
+/* AMI progress codes: PEI core started, DXE IPL started (memory ready), DXE core started,
+ * BDS started and ready to boot
+ */
+static const uint32_t boot_milestone[] = { 0x10, 0x4F, 0x60, 0x90, 0xAD };
+
+const uint32_t *pal_get_boot_milestone(uint8_t *num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(num, NULL);
+
+	*num = ARRAY_SIZE(boot_milestone);
+	return boot_milestone;
+}
+#endif
@@ -355,7 +355,7 @@ void pal_extend_sensor_config()
 	}
 }
 
-bool pal_is_time_to_poll(uint8_t sensor_num, int poll_time)
+bool pal_is_time_to_poll(uint16_t sensor_num, int poll_time)
 {
 	int i = 0;
 	int table_size = sizeof(diff_poll_time_sensor_table) / sizeof(sensor_poll_time_cfg);
@@ -130,7 +130,7 @@ typedef struct _dimm_pmic_mapping_cfg {
 	uint8_t mapping_pmic_sensor_num;
 } dimm_pmic_mapping_cfg;
 
-uint8_t plat_get_config_size();
+uint16_t plat_get_config_size();
 void load_sensor_config(void);
 bool disable_dimm_pmic_sensor(uint8_t sensor_num);
 
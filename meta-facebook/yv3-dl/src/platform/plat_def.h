@@ -24,4 +24,9 @@
 
 #define WORKER_STACK_SIZE 4096
 
+/* 64K SPI update buffer of fw_update() plus the region overhead, the malloc arena no longer
+ * needs room for it
+ */
+#define UTIL_MEM_LARGE_REGION_SIZE 0x10400
+
 #endif
@@ -365,7 +365,7 @@ void load_sensor_config(void)
 	pal_extend_sensor_config();
 }
 
-uint8_t pal_get_extend_sensor_config()
+uint16_t pal_get_extend_sensor_config()
 {
 	uint8_t extend_sensor_config_size = 0;
 	uint8_t hsc_module = get_hsc_module();
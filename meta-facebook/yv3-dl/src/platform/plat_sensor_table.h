@@ -126,8 +126,8 @@ enum {
 	VR_RNS,
 };
 
-uint8_t plat_get_config_size();
+uint16_t plat_get_config_size();
 void load_sensor_config(void);
-uint8_t pal_get_extend_sensor_config();
+uint16_t pal_get_extend_sensor_config();
 
 #endif
@@ -21,4 +21,9 @@
 
 #define ADC_CALIBRATION 1
 
+/* 64K SPI update buffer of fw_update() plus the region overhead, the malloc arena no longer
+ * needs room for it
+ */
+#define UTIL_MEM_LARGE_REGION_SIZE 0x10400
+
 #endif
@@ -155,7 +155,7 @@ uint8_t rst_edsff(uint8_t idx, uint8_t val)
 	return 0;
 }
 
-bool is_m2_sen_readable(uint8_t sen_num)
+bool is_m2_sen_readable(uint16_t sen_num)
 {
 	uint8_t prefix = sen_num & PREFIX_MASK;
 
@@ -168,7 +168,7 @@ bool is_m2_sen_readable(uint8_t sen_num)
 	return (m2_pwrgd(idx) && get_dev_pwrgd(idx)) ? true : false;
 }
 
-bool is_nvme_temp_readable(uint8_t sen_num)
+bool is_nvme_temp_readable(uint16_t sen_num)
 {
 	uint8_t idx = m2_sensornum2idx(sen_num);
 	uint8_t bus = m2_idx2bus(idx);
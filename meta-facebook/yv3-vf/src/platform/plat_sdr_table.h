@@ -55,7 +55,7 @@
 #define HSC_T_SEN_FACTOR_M 0x01
 #define HSC_T_SEN_FACTOR_EXP_RB 0x00
 
-uint8_t plat_get_sdr_size();
+uint16_t plat_get_sdr_size();
 void load_sdr_table(void);
 
 #endif
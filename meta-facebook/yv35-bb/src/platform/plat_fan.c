@@ -18,6 +18,8 @@
 #include <drivers/sensor.h>
 #include <drivers/pwm.h>
 #include "plat_fan.h"
+#include "plat_sensor_table.h"
+#include "fan_control.h"
 #include "ipmi.h"
 #include <logging/log.h>
 
@@ -39,6 +41,64 @@ static struct fan_handle {
 static uint8_t ctrl_fan_mode;
 static int pwm_record[2][4] = { { 0, 0, 0, 0 }, //[0][x] - slot1 BMC
 				{ 0, 0, 0, 0 } }; // [1][x] - slot3 BMC
+static uint8_t local_pwm_record[MAX_FAN_PWM_INDEX_COUNT] = { 0 }; // BIC fan control
+
+static const fan_ctrl_zone_cfg fan_zone_cfg[] = {
+	// Inlet curve
+	{
+		.sensor_num = { SENSOR_NUM_TEMP_TMP75_IN },
+		.sensor_count = 1,
+		.pwm_mask = BIT_MASK(MAX_FAN_PWM_INDEX_COUNT),
+		.profile = {
+			.type = FAN_CTRL_TYPE_STEPWISE,
+			.min_duty = 20,
+			.max_duty = MAX_FAN_DUTY_VALUE,
+			.fail_duty = MAX_FAN_DUTY_VALUE,
+			.hysteresis = 2,
+			.step_count = 6,
+			.step = { { 20, 20 },
+				  { 25, 30 },
+				  { 30, 40 },
+				  { 35, 55 },
+				  { 40, 75 },
+				  { 45, MAX_FAN_DUTY_VALUE } },
+		},
+		.failsafe = {
+			.type = FAN_CTRL_TYPE_STEPWISE,
+			.min_duty = DEFAULT_FAN_DUTY_VALUE,
+			.max_duty = MAX_FAN_DUTY_VALUE,
+			.fail_duty = MAX_FAN_DUTY_VALUE,
+			.hysteresis = 2,
+			.step_count = 2,
+			.step = { { 0, DEFAULT_FAN_DUTY_VALUE }, { 35, MAX_FAN_DUTY_VALUE } },
+		},
+	},
+	// Outlet and HSC loop
+	{
+		.sensor_num = { SENSOR_NUM_TEMP_TMP75_OUT, SENSOR_NUM_TEMP_HSC },
+		.sensor_count = 2,
+		.pwm_mask = BIT_MASK(MAX_FAN_PWM_INDEX_COUNT),
+		.profile = {
+			.type = FAN_CTRL_TYPE_PID,
+			.min_duty = 20,
+			.max_duty = MAX_FAN_DUTY_VALUE,
+			.fail_duty = MAX_FAN_DUTY_VALUE,
+			.setpoint = 55,
+			.kp = 300,
+			.ki = 20,
+			.kd = 0,
+		},
+		.failsafe = {
+			.type = FAN_CTRL_TYPE_STEPWISE,
+			.min_duty = DEFAULT_FAN_DUTY_VALUE,
+			.max_duty = MAX_FAN_DUTY_VALUE,
+			.fail_duty = MAX_FAN_DUTY_VALUE,
+			.hysteresis = 3,
+			.step_count = 2,
+			.step = { { 0, DEFAULT_FAN_DUTY_VALUE }, { 65, MAX_FAN_DUTY_VALUE } },
+		},
+	},
+};
 
 void init_fan_mode()
 {
@@ -63,6 +123,8 @@ void init_fan_duty()
 			LOG_ERR("FAN PWM%d init failed status%d", i, ret);
 		}
 	}
+
+	fan_ctrl_init(fan_zone_cfg, ARRAY_SIZE(fan_zone_cfg), MAX_FAN_PWM_INDEX_COUNT);
 }
 
 int pal_get_fan_ctrl_mode(uint8_t *ctrl_mode)
@@ -145,7 +207,8 @@ int pal_set_fan_duty(uint8_t pwm_id, uint8_t duty, uint8_t slot_index)
 	}
 
 	if (ctrl_fan_mode == FAN_AUTO_MODE) {
-		// Auto mode need to compare slot1 and slot3, and set the higher one
+		fan_ctrl_bmc_heartbeat();
+		// Auto mode need to compare slot1, slot3 and BIC fan control, set the highest one
 		if (slot_index == INDEX_SLOT1) {
 			if (duty >= pwm_record[1][pwm_id]) {
 				final_duty = duty;
@@ -164,6 +227,7 @@ int pal_set_fan_duty(uint8_t pwm_id, uint8_t duty, uint8_t slot_index)
 			        slot_index);
 			return -1;
 		}
+		final_duty = MAX(final_duty, local_pwm_record[pwm_id]);
 
 	} else if (ctrl_fan_mode == FAN_MANUAL_MODE) {
 		final_duty = duty;
@@ -190,3 +254,38 @@ int pal_set_fan_duty(uint8_t pwm_id, uint8_t duty, uint8_t slot_index)
 
 	return ret;
 }
+
+int pal_fan_ctrl_set_duty(uint8_t pwm_id, uint8_t duty)
+{
+	const struct device *pwm_dev;
+	uint8_t final_duty = duty;
+	int ret = 0;
+
+	if (pwm_id >= MAX_FAN_PWM_INDEX_COUNT) {
+		return -1;
+	}
+
+	local_pwm_record[pwm_id] = duty;
+
+	// Manual mode is a BMC override, the duty only applies once back in auto mode
+	if (ctrl_fan_mode != FAN_AUTO_MODE) {
+		return 0;
+	}
+
+	pwm_dev = device_get_binding(PWM_DEVICE_NAME);
+	if (pwm_dev == NULL) {
+		LOG_ERR("PWM device not found");
+		return -1;
+	}
+
+	// BMC requests only count while the BMC is alive, a stale request must not pin the fans
+	if (fan_ctrl_is_bmc_alive()) {
+		final_duty = MAX(final_duty, MAX(pwm_record[0][pwm_id], pwm_record[1][pwm_id]));
+	}
+
+	ret = pwm_pin_set_cycles(pwm_dev, pwm_id, MAX_FAN_DUTY_VALUE, final_duty, 0);
+	if (ret < 0) {
+		LOG_ERR("FAN PWM%d set failed status%d", pwm_id, ret);
+	}
+	return ret;
+}
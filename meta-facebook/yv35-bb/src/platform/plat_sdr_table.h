@@ -21,7 +21,7 @@
 
 #define MAX_SENSOR_SIZE 60
 
-uint8_t plat_get_sdr_size();
+uint16_t plat_get_sdr_size();
 void load_sdr_table(void);
 
 #endif
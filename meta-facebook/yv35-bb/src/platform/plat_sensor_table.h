@@ -79,7 +79,7 @@
 #define SENSOR_NUM_POWER_DETECT 0xE1
 #define SENSOR_NUM_BUTTON_DETECT 0xE2
 
-uint8_t plat_get_config_size();
+uint16_t plat_get_config_size();
 void load_sensor_config(void);
 
 #endif
@@ -3662,7 +3662,7 @@ void load_sdr_table(void)
 	pal_extend_full_sdr_table();
 }
 
-uint8_t pal_get_extend_sdr()
+uint16_t pal_get_extend_sdr()
 {
 	uint8_t extend_sdr_size = 0;
 	uint8_t hsc_module = get_hsc_module();
@@ -142,8 +142,8 @@ typedef struct _dimm_pmic_mapping_cfg {
 	uint8_t mapping_pmic_sensor_num;
 } dimm_pmic_mapping_cfg;
 
-uint8_t plat_get_config_size();
-uint8_t pal_get_extend_sensor_config();
+uint16_t plat_get_config_size();
+uint16_t pal_get_extend_sensor_config();
 void load_sensor_config(void);
 bool disable_dimm_pmic_sensor(uint8_t sensor_num);
 uint8_t get_dimm_status(uint8_t dimm_index);
@@ -20,6 +20,7 @@
 #include "libipmi.h"
 #include "libutil.h"
 #include "snoop.h"
+#include "boot_timeline.h"
 #include "ipmb.h"
 #include "ipmi.h"
 #include "power_status.h"
@@ -517,3 +518,18 @@ void ISR_FM_ADR_MODE0(uint8_t gpio_value)
 	k_work_init_delayable(&adr_mode0.work, adr_mode0_handler);
 	k_work_schedule(&adr_mode0.work, K_MSEC(10));
 }
+
+#ifdef ENABLE_BOOT_TIMELINE
+/* AMI progress codes: PEI core started, DXE IPL started (memory ready), DXE core started,
+ * BDS started and ready to boot
+ */
+static const uint32_t boot_milestone[] = { 0x10, 0x4F, 0x60, 0x90, 0xAD };
+
+const uint32_t *pal_get_boot_milestone(uint8_t *num)
+{
+	CHECK_NULL_ARG_WITH_RETURN(num, NULL);
+
+	*num = ARRAY_SIZE(boot_milestone);
+	return boot_milestone;
+}
+#endif
@@ -382,6 +382,9 @@ static void send_apml_alert(struct k_work *work)
 
 void ISR_APML_ALERT()
 {
+	/* ALERT_L also signals mailbox, CPUID and MCA completion */
+	apml_alert_notify();
+
 	uint8_t ras_status;
 	if (apml_read_byte(APML_BUS, SB_RMI_ADDR, SBRMI_RAS_STATUS, &ras_status)) {
 		LOG_ERR("Failed to read RAS status.");
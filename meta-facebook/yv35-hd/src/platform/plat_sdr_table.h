@@ -19,7 +19,7 @@
 
 #include <stdint.h>
 
-uint8_t plat_get_sdr_size();
+uint16_t plat_get_sdr_size();
 void load_sdr_table(void);
 
 #endif
@@ -131,7 +131,7 @@
 #define SENSOR_NUM_HDT_PRESENT 0xBD
 #define SENSOR_NUM_PMIC_ERROR 0xB4
 
-uint8_t plat_get_config_size();
+uint16_t plat_get_config_size();
 void load_sensor_config(void);
 
 #endif
@@ -42,7 +42,7 @@ bool get_mpro_status()
 	return is_mpro_ready;
 }
 
-bool mpro_access(uint8_t sensor_num)
+bool mpro_access(uint16_t sensor_num)
 {
 	return get_mpro_status();
 }
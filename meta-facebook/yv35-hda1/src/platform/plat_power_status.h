@@ -21,7 +21,7 @@
 
 void set_mpro_status();
 bool get_mpro_status();
-bool mpro_access(uint8_t sensor_num);
+bool mpro_access(uint16_t sensor_num);
 void bic_heart_beat_init();
 
 #endif
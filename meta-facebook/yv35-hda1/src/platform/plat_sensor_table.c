@@ -386,7 +386,7 @@ void pal_extend_sensor_config()
 	}
 }
 
-uint8_t pal_get_extend_sensor_config()
+uint16_t pal_get_extend_sensor_config()
 {
 	uint8_t extend_sensor_config_size = 0;
 	uint8_t hsc_module = get_hsc_module();
@@ -413,7 +413,7 @@ uint8_t pal_get_extend_sensor_config()
 	return extend_sensor_config_size;
 }
 
-bool pal_is_time_to_poll(uint8_t sensor_num, int poll_time)
+bool pal_is_time_to_poll(uint16_t sensor_num, int poll_time)
 {
 	int i = 0;
 	int table_size = sizeof(diff_poll_time_sensor_table) / sizeof(sensor_poll_time_cfg);
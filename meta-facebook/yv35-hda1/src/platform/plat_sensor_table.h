@@ -138,7 +138,7 @@
 #define SENSOR_NUM_VR_FAULT 0xB3
 #define SENSOR_NUM_PMIC_ERROR 0xB4
 
-uint8_t plat_get_config_size();
+uint16_t plat_get_config_size();
 void load_sensor_config(void);
 
 #endif
@@ -18,4 +18,9 @@
 #define PLAT_DEF_H
 #define BMC_USB_PORT "CDC_ACM_0"
 
+/* 64K SPI update buffer of fw_update() plus the region overhead, the malloc arena no longer
+ * needs room for it
+ */
+#define UTIL_MEM_LARGE_REGION_SIZE 0x10400
+
 #endif
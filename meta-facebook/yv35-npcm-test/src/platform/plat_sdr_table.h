@@ -21,9 +21,9 @@
 
 #define MAX_SENSOR_SIZE 60
 
-uint8_t plat_get_sdr_size();
+uint16_t plat_get_sdr_size();
 void load_sdr_table(void);
 void pal_extend_full_sdr_table();
-uint8_t pal_get_extend_sdr();
+uint16_t pal_get_extend_sdr();
 
 #endif
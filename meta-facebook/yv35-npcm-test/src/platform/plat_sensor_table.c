@@ -118,7 +118,7 @@ void load_sensor_config(void)
 	pal_extend_sensor_config();
 }
 
-uint8_t pal_get_extend_sensor_config()
+uint16_t pal_get_extend_sensor_config()
 {
 	return 0;
 #if 0
@@ -391,7 +391,7 @@ void pal_extend_sensor_config()
 	}
 }
 
-bool pal_is_time_to_poll(uint8_t sensor_num, int poll_time)
+bool pal_is_time_to_poll(uint16_t sensor_num, int poll_time)
 {
 	int i = 0;
 	int table_size = sizeof(diff_poll_time_sensor_table) / sizeof(sensor_poll_time_cfg);
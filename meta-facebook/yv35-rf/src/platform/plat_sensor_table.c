@@ -406,7 +406,7 @@ void pal_extend_sensor_config()
 	}
 }
 
-uint8_t pal_get_extend_sensor_config()
+uint16_t pal_get_extend_sensor_config()
 {
 	uint8_t extend_sensor_config_size = 0;
 	extend_sensor_config_size += ARRAY_SIZE(ina233_sensor_config_table);